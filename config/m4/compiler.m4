@@ -246,6 +246,21 @@ CHECK_SPECIFIC_ATTRIBUTE([optimize], [NOOPTIMIZE],
                          [int foo (int arg) __attribute__ ((optimize("O0")));])
 
 
+#
+# Check for compiler attributes which enable an instruction set per-function,
+# used to select vectorized routines at runtime.
+#
+CHECK_SPECIFIC_ATTRIBUTE([target_avx2], [TARGET_AVX2],
+                         [#include <immintrin.h>
+                          void __attribute__ ((target("avx2"))) foo (void *p)
+                          { _mm256_stream_si256(p, _mm256_setzero_si256()); }])
+
+CHECK_SPECIFIC_ATTRIBUTE([target_avx512], [TARGET_AVX512],
+                         [#include <immintrin.h>
+                          void __attribute__ ((target("avx512f"))) foo (void *p)
+                          { _mm512_stream_si512(p, _mm512_setzero_si512()); }])
+
+
 #
 # Check for C++11 support
 #
@@ -37,7 +37,9 @@ typedef enum {
     UCX_PERF_CMD_CSWAP,
     UCX_PERF_CMD_TAG,
     UCX_PERF_CMD_TAG_SYNC,
+    UCX_PERF_CMD_TAG_BATCH,
     UCX_PERF_CMD_STREAM,
+    UCX_PERF_CMD_MEMCPY,
     UCX_PERF_CMD_LAST
 } ucx_perf_cmd_t;
 
@@ -46,6 +48,8 @@ typedef enum {
     UCX_PERF_TEST_TYPE_PINGPONG,         /* Ping-pong mode */
     UCX_PERF_TEST_TYPE_STREAM_UNI,       /* Unidirectional stream */
     UCX_PERF_TEST_TYPE_STREAM_BI,        /* Bidirectional stream */
+    UCX_PERF_TEST_TYPE_MANY2ONE,         /* Unidirectional stream from all
+                                            processes to the first one */
     UCX_PERF_TEST_TYPE_LAST
 } ucx_perf_test_type_t;
 
@@ -185,6 +189,7 @@ typedef struct ucx_perf_params {
         unsigned               nonblocking_mode; /* TBD */
         ucp_perf_datatype_t    send_datatype;
         ucp_perf_datatype_t    recv_datatype;
+        unsigned               batch_size;  /* Messages per batched send */
     } ucp;
 
 } ucx_perf_params_t;
@@ -464,6 +464,9 @@ static ucs_status_t uct_perf_test_check_capabilities(ucx_perf_params_t *params,
                          perf_atomic_fop, params, status);
         max_size = 8;
         break;
+    case UCX_PERF_CMD_MEMCPY:
+        /* local copy, does not use the transport */
+        return ucx_perf_test_check_params(params);
     default:
         if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
             ucs_error("Invalid test command");
@@ -807,6 +810,14 @@ static ucs_status_t ucp_perf_test_fill_params(ucx_perf_params_t *params,
         }
 
         break;
+    case UCX_PERF_CMD_TAG_BATCH:
+        if (params->ucp.batch_size < 1) {
+            if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+                ucs_error("batch size, need to be at least 1");
+            }
+            return UCS_ERR_INVALID_PARAM;
+        }
+        /* Fall through */
     case UCX_PERF_CMD_TAG:
     case UCX_PERF_CMD_TAG_SYNC:
         ucp_params->features    |= UCP_FEATURE_TAG;
@@ -818,6 +829,11 @@ static ucs_status_t ucp_perf_test_fill_params(ucx_perf_params_t *params,
         ucp_params->field_mask  |= UCP_PARAM_FIELD_REQUEST_SIZE;
         ucp_params->request_size = sizeof(ucp_perf_request_t);
         break;
+    case UCX_PERF_CMD_AM:
+        ucp_params->features    |= UCP_FEATURE_AM;
+        ucp_params->field_mask  |= UCP_PARAM_FIELD_REQUEST_SIZE;
+        ucp_params->request_size = sizeof(ucp_perf_request_t);
+        break;
     default:
         if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
             ucs_error("Invalid test command");
@@ -10,6 +10,7 @@
 #define LIBPERF_INT_H_
 
 #include <tools/perf/api/libperf.h>
+#include <ucp/api/ucpx.h>
 
 BEGIN_C_DECLS
 
@@ -21,16 +21,30 @@ class ucp_perf_test_runner {
 public:
     static const ucp_tag_t TAG      = 0x1337a880u;
     static const ucp_tag_t TAG_MASK = (FLAGS & UCX_PERF_TEST_FLAG_TAG_WILDCARD) ? 0 : -1;
+    static const uint16_t  AM_ID    = 0x1337u;
 
     typedef uint8_t psn_t;
 
     ucp_perf_test_runner(ucx_perf_context_t &perf) :
         m_perf(perf),
         m_outstanding(0),
-        m_max_outstanding(m_perf.params.max_outstanding)
+        m_max_outstanding(m_perf.params.max_outstanding),
+        m_am_received(0),
+        m_batch(NULL),
+        m_batch_count(0)
 
     {
         ucs_assert_always(m_max_outstanding > 0);
+        if (CMD == UCX_PERF_CMD_TAG_BATCH) {
+            m_batch = (ucp_tag_send_batch_entry_t*)
+                      malloc(sizeof(*m_batch) * m_perf.params.ucp.batch_size);
+            ucs_assert_always(m_batch != NULL);
+        }
+    }
+
+    ~ucp_perf_test_runner()
+    {
+        free(m_batch);
     }
 
     void create_iov_buffer(ucp_dt_iov_t *iov, void *buffer)
@@ -133,6 +147,15 @@ public:
         ucp_request_release(request);
     }
 
+    static ucs_status_t am_handler(void *arg, void *data, size_t length,
+                                   ucp_ep_h reply_ep, unsigned flags)
+    {
+        ucp_perf_test_runner *receiver = (ucp_perf_test_runner*)arg;
+
+        ++receiver->m_am_received;
+        return UCS_OK;
+    }
+
     void UCS_F_ALWAYS_INLINE wait_window(unsigned n)
     {
         while (m_outstanding >= (m_max_outstanding - n + 1)) {
@@ -140,17 +163,49 @@ public:
         }
     }
 
+    ucs_status_t UCS_F_ALWAYS_INLINE send_batch(ucp_datatype_t datatype)
+    {
+        void *request;
+
+        if (m_batch_count == 0) {
+            return UCS_OK;
+        }
+
+        wait_window(1);
+        request = ucp_tag_send_batch_nb(m_perf.ucp.worker, m_batch,
+                                        m_batch_count, datatype, send_cb);
+        m_batch_count = 0;
+        if (ucs_likely(!UCS_PTR_IS_PTR(request))) {
+            return UCS_PTR_STATUS(request);
+        }
+        reinterpret_cast<ucp_perf_request_t*>(request)->context = this;
+        send_started();
+        return UCS_OK;
+    }
+
     ucs_status_t UCS_F_ALWAYS_INLINE
     send(ucp_ep_h ep, void *buffer, unsigned length, ucp_datatype_t datatype,
          uint8_t sn, uint64_t remote_addr, ucp_rkey_h rkey)
     {
+        ucp_tag_send_batch_entry_t *entry;
         void *request;
 
         /* coverity[switch_selector_expr_is_constant] */
         switch (CMD) {
+        case UCX_PERF_CMD_TAG_BATCH:
+            entry         = &m_batch[m_batch_count++];
+            entry->ep     = ep;
+            entry->buffer = buffer;
+            entry->count  = length;
+            entry->tag    = TAG;
+            if (m_batch_count < m_perf.params.ucp.batch_size) {
+                return UCS_OK;
+            }
+            return send_batch(datatype);
         case UCX_PERF_CMD_TAG:
         case UCX_PERF_CMD_TAG_SYNC:
         case UCX_PERF_CMD_STREAM:
+        case UCX_PERF_CMD_AM:
             wait_window(1);
             /* coverity[switch_selector_expr_is_constant] */
             switch (CMD) {
@@ -166,6 +221,10 @@ public:
                 request = ucp_stream_send_nb(ep, buffer, length, datatype,
                                              send_cb, 0);
                 break;
+            case UCX_PERF_CMD_AM:
+                request = ucp_am_send_nb(ep, AM_ID, buffer, length, datatype,
+                                         send_cb, 0);
+                break;
             default:
                 request = UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM);
                 break;
@@ -229,6 +288,7 @@ public:
         switch (CMD) {
         case UCX_PERF_CMD_TAG:
         case UCX_PERF_CMD_TAG_SYNC:
+        case UCX_PERF_CMD_TAG_BATCH:
             if (FLAGS & UCX_PERF_TEST_FLAG_TAG_UNEXP_PROBE) {
                 ucp_tag_recv_info_t tag_info;
                 while (ucp_tag_probe_nb(worker, TAG, TAG_MASK, 0, &tag_info) == NULL) {
@@ -271,6 +331,12 @@ public:
             } else {
                 return recv_stream(ep, buffer, length, datatype, sn);
             }
+        case UCX_PERF_CMD_AM:
+            while (m_am_received == 0) {
+                progress_responder();
+            }
+            --m_am_received;
+            return UCS_OK;
         default:
             return UCS_ERR_INVALID_PARAM;
         }
@@ -400,6 +466,10 @@ public:
                 ucx_perf_update(&m_perf, 1, length);
                 ++sn;
             }
+            if (CMD == UCX_PERF_CMD_TAG_BATCH) {
+                /* Send the remainder of the last batch */
+                send_batch(send_datatype);
+            }
         }
 
         wait_window(m_max_outstanding);
@@ -414,7 +484,7 @@ public:
         return UCS_OK;
     }
 
-    ucs_status_t run()
+    ucs_status_t run_test()
     {
         /* coverity[switch_selector_expr_is_constant] */
         switch (TYPE) {
@@ -428,6 +498,25 @@ public:
         }
     }
 
+    ucs_status_t run()
+    {
+        ucs_status_t status;
+
+        if (CMD != UCX_PERF_CMD_AM) {
+            return run_test();
+        }
+
+        status = ucp_worker_set_am_handler(m_perf.ucp.worker, AM_ID,
+                                           am_handler, this, 0);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        status = run_test();
+        ucp_worker_set_am_handler(m_perf.ucp.worker, AM_ID, NULL, NULL, 0);
+        return status;
+    }
+
 private:
     ucs_status_t UCS_F_ALWAYS_INLINE
     recv_stream_data(ucp_ep_h ep, unsigned length, ucp_datatype_t datatype,
@@ -492,6 +581,9 @@ private:
     ucx_perf_context_t &m_perf;
     unsigned           m_outstanding;
     const unsigned     m_max_outstanding;
+    unsigned           m_am_received;
+    ucp_tag_send_batch_entry_t *m_batch;       /* Messages of the next batch */
+    unsigned           m_batch_count;
 };
 
 
@@ -548,9 +640,13 @@ ucs_status_t ucp_perf_test_dispatch(ucx_perf_context_t *perf)
         (UCX_PERF_CMD_TAG,      UCX_PERF_TEST_TYPE_PINGPONG),
         (UCX_PERF_CMD_TAG,      UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_TAG_SYNC, UCX_PERF_TEST_TYPE_PINGPONG),
-        (UCX_PERF_CMD_TAG_SYNC, UCX_PERF_TEST_TYPE_STREAM_UNI)
+        (UCX_PERF_CMD_TAG_SYNC, UCX_PERF_TEST_TYPE_STREAM_UNI),
+        (UCX_PERF_CMD_TAG_BATCH, UCX_PERF_TEST_TYPE_STREAM_UNI)
         );
 
+    TEST_CASE(perf, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_PINGPONG,   0, 0)
+    TEST_CASE(perf, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_STREAM_UNI, 0, 0)
+
     UCS_PP_FOREACH(TEST_CASE_ALL_STREAM, perf,
         (UCX_PERF_CMD_STREAM,   UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_STREAM,   UCX_PERF_TEST_TYPE_PINGPONG)
@@ -9,6 +9,8 @@
 #include <tools/perf/lib/libperf_int.h>
 
 extern "C" {
+#include <ucs/arch/cpu.h>
+#include <ucs/config/global_opts.h>
 #include <ucs/debug/log.h>
 #include <ucs/sys/preprocessor.h>
 #include <ucs/sys/math.h>
@@ -25,7 +27,8 @@ public:
     uct_perf_test_runner(ucx_perf_context_t &perf) :
         m_perf(perf),
         m_max_outstanding(m_perf.params.max_outstanding),
-        m_send_b_count(0)
+        m_send_b_count(0),
+        m_num_senders_done(0)
 
     {
         ucs_assert_always(m_max_outstanding > 0);
@@ -144,6 +147,18 @@ public:
         return UCS_OK;
     }
 
+    static ucs_status_t am_many2one_handler(void *arg, void *data,
+                                            size_t length, unsigned flags)
+    {
+        uct_perf_test_runner *self = (uct_perf_test_runner*)arg;
+
+        /* data messages carry sn 0, the last message of every sender carries 1 */
+        if (*(psn_t*)data != 0) {
+            ++self->m_num_senders_done;
+        }
+        return UCS_OK;
+    }
+
     static size_t pack_cb(void *dest, void *arg)
     {
         uct_perf_test_runner *self = (uct_perf_test_runner *)arg;
@@ -499,6 +514,105 @@ public:
         return UCS_OK;
     }
 
+    ucs_status_t run_many2one()
+    {
+        bool zcopy = (DATA == UCT_PERF_DATA_LAYOUT_ZCOPY);
+        unsigned group_size;
+        unsigned my_index;
+        unsigned length;
+        ucs_status_t status;
+        uct_ep_h ep;
+
+        length = ucx_perf_get_message_size(&m_perf.params);
+        ucs_assert(length >= sizeof(psn_t));
+
+        memset(m_perf.send_buffer, 0, length);
+        memset(m_perf.recv_buffer, 0, length);
+
+        uct_perf_test_prepare_iov_buffer();
+
+        group_size          = rte_call(&m_perf, group_size);
+        my_index            = rte_call(&m_perf, group_index);
+        m_num_senders_done  = 0;
+
+        /* all senders write to the same receiver, so the sequence numbers
+         * cannot be tracked in the receive buffer */
+        status = uct_iface_set_am_handler(m_perf.uct.iface, UCT_PERF_TEST_AM_ID,
+                                          am_many2one_handler, this, 0);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        uct_perf_barrier(&m_perf);
+
+        ucx_perf_test_start_clock(&m_perf);
+
+        if (my_index == 0) {
+            /* Wait for the last message from every sender */
+            while (m_num_senders_done < group_size - 1) {
+                progress_responder();
+            }
+        } else {
+            ep = m_perf.uct.peers[0].ep;
+            UCX_PERF_TEST_FOREACH(&m_perf) {
+                wait_for_window(zcopy);
+                send_b(ep, 0, 0, m_perf.send_buffer, length, 0, 0,
+                       &m_completion);
+                ucx_perf_update(&m_perf, 1, length);
+            }
+
+            wait_for_window(zcopy);
+            send_b(ep, 1, 0, m_perf.send_buffer, length, 0, 0, &m_completion);
+        }
+
+        uct_perf_iface_flush_b(&m_perf);
+        ucx_perf_get_time(&m_perf);
+        ucs_assert(outstanding() == 0);
+        if (my_index != 0) {
+            ucx_perf_update(&m_perf, 0, 0);
+        }
+
+        return UCS_OK;
+    }
+
+    ucs_status_t run_memcpy()
+    {
+        size_t length;
+
+        length = ucx_perf_get_message_size(&m_perf.params);
+
+        memset(m_perf.send_buffer, 0, length);
+        memset(m_perf.recv_buffer, 0, length);
+
+        uct_perf_barrier(&m_perf);
+
+        ucx_perf_test_start_clock(&m_perf);
+
+        UCX_PERF_TEST_FOREACH(&m_perf) {
+            /* coverity[switch_selector_expr_is_constant] */
+            switch (DATA) {
+            case UCT_PERF_DATA_LAYOUT_SHORT:
+                memcpy(m_perf.recv_buffer, m_perf.send_buffer, length);
+                break;
+            case UCT_PERF_DATA_LAYOUT_BCOPY:
+                ucs_memcpy_relaxed(m_perf.recv_buffer, m_perf.send_buffer,
+                                   length, length,
+                                   ucs_global_opts.memcpy_nt_thresh);
+                break;
+            case UCT_PERF_DATA_LAYOUT_ZCOPY:
+                ucs_memcpy_nontemporal(m_perf.recv_buffer, m_perf.send_buffer,
+                                       length);
+                break;
+            default:
+                return UCS_ERR_INVALID_PARAM;
+            }
+            ucx_perf_update(&m_perf, 1, length);
+        }
+
+        ucx_perf_get_time(&m_perf);
+        return UCS_OK;
+    }
+
     ucs_status_t run()
     {
         bool zcopy = (DATA == UCT_PERF_DATA_LAYOUT_ZCOPY);
@@ -534,6 +648,16 @@ public:
                                           true, /* Waiting for replies */
                                           true /* For atomics, data goes both ways, but
                                                      the request is easier to predict */ );
+            case UCX_PERF_CMD_MEMCPY:
+                return run_memcpy();
+            default:
+                return UCS_ERR_INVALID_PARAM;
+            }
+        case UCX_PERF_TEST_TYPE_MANY2ONE:
+            /* coverity[switch_selector_expr_is_constant] */
+            switch (CMD) {
+            case UCX_PERF_CMD_AM:
+                return run_many2one();
             default:
                 return UCS_ERR_INVALID_PARAM;
             }
@@ -552,6 +676,7 @@ private:
     const unsigned     m_max_outstanding;
     uct_completion_t   m_completion;
     int                m_send_b_count;
+    unsigned           m_num_senders_done;
     const static int   N_SEND_B_PER_PROGRESS = 16;
 };
 
@@ -580,12 +705,14 @@ ucs_status_t uct_perf_test_dispatch(ucx_perf_context_t *perf)
         (UCX_PERF_CMD_PUT, UCX_PERF_TEST_TYPE_PINGPONG),
         (UCX_PERF_CMD_ADD, UCX_PERF_TEST_TYPE_PINGPONG),
         (UCX_PERF_CMD_AM,  UCX_PERF_TEST_TYPE_STREAM_UNI),
+        (UCX_PERF_CMD_AM,  UCX_PERF_TEST_TYPE_MANY2ONE),
         (UCX_PERF_CMD_PUT, UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_GET, UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_ADD, UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_FADD, UCX_PERF_TEST_TYPE_STREAM_UNI),
         (UCX_PERF_CMD_SWAP, UCX_PERF_TEST_TYPE_STREAM_UNI),
-        (UCX_PERF_CMD_CSWAP, UCX_PERF_TEST_TYPE_STREAM_UNI)
+        (UCX_PERF_CMD_CSWAP, UCX_PERF_TEST_TYPE_STREAM_UNI),
+        (UCX_PERF_CMD_MEMCPY, UCX_PERF_TEST_TYPE_STREAM_UNI)
         );
 
     ucs_error("Invalid test case");
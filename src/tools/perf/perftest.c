@@ -37,7 +37,7 @@
 
 #define MAX_BATCH_FILES         32
 #define TL_RESOURCE_NAME_NONE   "<none>"
-#define TEST_PARAMS_ARGS        "t:n:s:W:O:w:D:i:H:oSCqM:r:T:d:x:A:BUm:"
+#define TEST_PARAMS_ARGS        "t:n:s:W:O:w:D:i:H:oSCqM:r:T:d:x:A:BUm:k:"
 
 
 enum {
@@ -111,6 +111,9 @@ test_type_t tests[] = {
     {"add_mr", UCX_PERF_API_UCT, UCX_PERF_CMD_ADD, UCX_PERF_TEST_TYPE_STREAM_UNI,
      "atomic add message rate"},
 
+    {"am_many2one", UCX_PERF_API_UCT, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_MANY2ONE,
+     "active message many-to-one message rate (per sender)"},
+
     {"tag_lat", UCX_PERF_API_UCP, UCX_PERF_CMD_TAG, UCX_PERF_TEST_TYPE_PINGPONG,
      "tag match latency"},
 
@@ -123,6 +126,9 @@ test_type_t tests[] = {
     {"tag_sync_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_TAG_SYNC, UCX_PERF_TEST_TYPE_STREAM_UNI,
      "tag sync match bandwidth"},
 
+    {"tag_batch_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_TAG_BATCH, UCX_PERF_TEST_TYPE_STREAM_UNI,
+     "tag match bandwidth / message rate with batched sends"},
+
     {"ucp_put_lat", UCX_PERF_API_UCP, UCX_PERF_CMD_PUT, UCX_PERF_TEST_TYPE_PINGPONG,
      "put latency"},
 
@@ -150,6 +156,15 @@ test_type_t tests[] = {
     {"stream_lat", UCX_PERF_API_UCP, UCX_PERF_CMD_STREAM, UCX_PERF_TEST_TYPE_PINGPONG,
      "stream latency"},
 
+    {"ucp_am_lat", UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_PINGPONG,
+     "active message latency"},
+
+    {"ucp_am_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_STREAM_UNI,
+     "active message bandwidth / message rate"},
+
+    {"memcpy_bw", UCX_PERF_API_UCT, UCX_PERF_CMD_MEMCPY, UCX_PERF_TEST_TYPE_STREAM_UNI,
+     "local memory copy bandwidth"},
+
      {NULL}
 };
 
@@ -394,6 +409,10 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("                        bcopy - copy-out (cannot be used for atomics)\n");
     printf("                        zcopy - zero-copy (cannot be used for atomics)\n");
     printf("                        iov    - scatter-gather list (iovec)\n");
+    printf("                    for memcpy_bw, selects the copy routine:\n");
+    printf("                        short - memcpy()\n");
+    printf("                        bcopy - non-temporal above UCX_MEMCPY_NT_THRESH\n");
+    printf("                        zcopy - non-temporal\n");
     printf("     -W <count>     flow control window size, for active messages (%u)\n",
                                 ctx->params.uct.fc_window);
     printf("     -H <size>      active message header size (%zu)\n",
@@ -414,6 +433,8 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("                        iov    - Scatter-gather list\n");
     printf("     -C             use wild-card tag for tag tests\n");
     printf("     -U             force unexpected flow by using tag probe\n");
+    printf("     -k <count>     number of messages in a batched send (%u)\n",
+                                ctx->params.ucp.batch_size);
     printf("     -r <mode>      receive mode for stream tests (recv)\n");
     printf("                        recv       : Use ucp_stream_recv_nb\n");
     printf("                        recv_data  : Use ucp_stream_recv_data_nb\n");
@@ -522,6 +543,7 @@ static void init_test_params(ucx_perf_params_t *params)
     params->iov_stride      = 0;
     params->ucp.send_datatype = UCP_PERF_DATATYPE_CONTIG;
     params->ucp.recv_datatype = UCP_PERF_DATATYPE_CONTIG;
+    params->ucp.batch_size    = 16;
     strcpy(params->uct.dev_name, TL_RESOURCE_NAME_NONE);
     strcpy(params->uct.tl_name,  TL_RESOURCE_NAME_NONE);
 
@@ -614,6 +636,9 @@ static ucs_status_t parse_test_params(ucx_perf_params_t *params, char opt, const
     case 'U':
         params->flags |= UCX_PERF_TEST_FLAG_TAG_UNEXP_PROBE;
         return UCS_OK;
+    case 'k':
+        params->ucp.batch_size = atoi(optarg);
+        return UCS_OK;
     case 'M':
         if (!strcmp(optarg, "single")) {
             params->thread_mode = UCS_THREAD_MODE_SINGLE;
@@ -2849,6 +2849,58 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
                                    ucp_datatype_t *datatype_p);
 
 
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Create a strided datatype.
+ *
+ * This routine creates a strided datatype object, which describes @a count
+ * contiguous blocks of @a elem_size bytes each, where the beginnings of
+ * consecutive blocks are @a stride bytes apart. For example, a column of a
+ * row-major matrix of doubles with @e N columns is described by
+ * @a elem_size = 8 and @a stride = 8 * @e N.
+ * When a communication routine is passed a datatype count greater than 1,
+ * consecutive datatype items are placed one extent apart, where the extent is
+ * (@a count - 1) * @a stride + @a elem_size bytes.
+ * The application is responsible to release the @a datatype_p object using
+ * @ref ucp_dt_destroy "ucp_dt_destroy()" routine.
+ *
+ * @param [in]  elem_size    Size of a contiguous block, in bytes.
+ * @param [in]  count        Number of blocks.
+ * @param [in]  stride       Distance between the beginnings of consecutive
+ *                           blocks, in bytes.
+ * @param [out] datatype_p   A pointer to datatype object.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_dt_create_strided(size_t elem_size, size_t count, size_t stride,
+                                   ucp_datatype_t *datatype_p);
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Create a vector of a contiguous or strided datatype.
+ *
+ * This routine creates a strided datatype object, which describes @a count
+ * items of @a datatype, where the beginnings of consecutive items are
+ * @a stride bytes apart. It allows building nested strided layouts, such as
+ * a sub-block of a multi-dimensional array. @a datatype may be a contiguous
+ * datatype or a datatype created by @ref ucp_dt_create_strided or by this
+ * routine; it can be destroyed right after this routine returns.
+ * The application is responsible to release the @a datatype_p object using
+ * @ref ucp_dt_destroy "ucp_dt_destroy()" routine.
+ *
+ * @param [in]  datatype     Datatype of a single item.
+ * @param [in]  count        Number of items.
+ * @param [in]  stride       Distance between the beginnings of consecutive
+ *                           items, in bytes.
+ * @param [out] datatype_p   A pointer to datatype object.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_dt_create_vector(ucp_datatype_t datatype, size_t count,
+                                  size_t stride, ucp_datatype_t *datatype_p);
+
+
 /**
  * @ingroup UCP_DATATYPE
  * @brief Destroy a datatype and release its resources.
@@ -2856,7 +2908,9 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
  * This routine destroys the @a datatype object and
  * releases any resources that are associated with the object.
  * The @a datatype object must be allocated using @ref ucp_dt_create_generic
- * "ucp_dt_create_generic()" routine.
+ * "ucp_dt_create_generic()", @ref ucp_dt_create_strided
+ * "ucp_dt_create_strided()" or @ref ucp_dt_create_vector
+ * "ucp_dt_create_vector()" routine.
  *
  * @warning
  * @li Once the @a datatype object is released an access to this object may
@@ -20,6 +20,172 @@
 BEGIN_C_DECLS
 
 
+/**
+ * @ingroup UCP_CONTEXT
+ * @brief Experimental UCP context features, in addition to @ref ucp_feature.
+ */
+enum ucpx_feature {
+    UCP_FEATURE_AM     = UCS_BIT(6)   /**< Request active message support */
+};
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Flags for @ref ucp_am_send_nb.
+ */
+enum ucp_send_am_flags {
+    UCP_AM_SEND_REPLY  = UCS_BIT(0)   /**< Pass the receiver an endpoint to
+                                           reply on, as @a reply_ep argument
+                                           of @ref ucp_am_callback_t */
+};
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Flags passed to @ref ucp_am_callback_t.
+ */
+enum ucp_cb_param_flags {
+    UCP_CB_PARAM_FLAG_DATA = UCS_BIT(0) /**< The data may be kept after the
+                                             callback returns, by returning
+                                             UCS_INPROGRESS from it */
+};
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Callback to process an incoming active message.
+ *
+ * The callback is invoked from @ref ucp_worker_progress when an active
+ * message sent by @ref ucp_am_send_nb arrives.
+ *
+ * @param [in]  arg       User-defined argument, as passed to
+ *                        @ref ucp_worker_set_am_handler.
+ * @param [in]  data      Points to the received data. The data is delivered
+ *                        in place, without an additional copy.
+ * @param [in]  length    Length of the data.
+ * @param [in]  reply_ep  Endpoint to reply on, if the sender has set
+ *                        @ref UCP_AM_SEND_REPLY, or NULL otherwise.
+ * @param [in]  flags     Flags from @ref ucp_cb_param_flags.
+ *
+ * @return UCS_INPROGRESS - the data is kept by the user, and must be released
+ *                          later by @ref ucp_am_data_release. Can be returned
+ *                          only if @a flags has @ref UCP_CB_PARAM_FLAG_DATA.
+ * @return otherwise      - the data may not be accessed after the callback
+ *                          returns.
+ */
+typedef ucs_status_t (*ucp_am_callback_t)(void *arg, void *data, size_t length,
+                                          ucp_ep_h reply_ep, unsigned flags);
+
+
+/**
+ * @ingroup UCP_WORKER
+ * @brief Set a handler for active messages with a given ID.
+ *
+ * @param [in]  worker    Worker which receives the active messages.
+ *                        Its context must be created with @ref UCP_FEATURE_AM.
+ * @param [in]  id        Active message ID, chosen by the user.
+ * @param [in]  cb        Active message callback, NULL to remove the handler.
+ * @param [in]  arg       User-defined argument passed to @a cb.
+ * @param [in]  flags     Reserved for future use, must be 0.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_worker_set_am_handler(ucp_worker_h worker, uint16_t id,
+                                       ucp_am_callback_t cb, void *arg,
+                                       uint32_t flags);
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Send an active message.
+ *
+ * This routine sends a message to the handler registered with @a id on the
+ * remote worker of @a ep. Small messages are sent eagerly in a single packet,
+ * and large messages are sent by rendezvous protocol. Messages are not
+ * matched, so there is no need to post receive operations.
+ *
+ * @param [in]  ep        Destination endpoint.
+ * @param [in]  id        Active message ID.
+ * @param [in]  buffer    Pointer to the message buffer.
+ * @param [in]  count     Number of elements to send.
+ * @param [in]  datatype  Datatype descriptor for the elements in the buffer.
+ * @param [in]  cb        Callback which is invoked when the buffer can be
+ *                        reused, if the send is not completed immediately.
+ * @param [in]  flags     Flags from @ref ucp_send_am_flags.
+ *
+ * @return NULL                 - The send operation was completed immediately.
+ * @return UCS_PTR_IS_ERR(_ptr) - The send operation failed.
+ * @return otherwise            - Operation was scheduled for send and can be
+ *                                completed in any point in time. The request
+ *                                handle is returned to the application, and
+ *                                must be released by @ref ucp_request_free.
+ */
+ucs_status_ptr_t ucp_am_send_nb(ucp_ep_h ep, uint16_t id, const void *buffer,
+                                size_t count, ucp_datatype_t datatype,
+                                ucp_send_callback_t cb, unsigned flags);
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Release active message data which was kept by the user.
+ *
+ * @param [in]  worker    Worker which received the active message.
+ * @param [in]  data      Data pointer which was passed to
+ *                        @ref ucp_am_callback_t, which has returned
+ *                        UCS_INPROGRESS.
+ */
+void ucp_am_data_release(ucp_worker_h worker, void *data);
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Entry of a batched tagged send, see @ref ucp_tag_send_batch_nb.
+ */
+typedef struct ucp_tag_send_batch_entry {
+    ucp_ep_h           ep;       /**< Destination endpoint */
+    const void         *buffer;  /**< Pointer to the message buffer */
+    size_t             count;    /**< Number of elements to send */
+    ucp_tag_t          tag;      /**< Message tag */
+} ucp_tag_send_batch_entry_t;
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Send a batch of tagged messages.
+ *
+ * This routine sends every entry of @a entries as if it was passed to
+ * @ref ucp_tag_send_nb, in the order of the array. The worker lock is taken
+ * once for the whole batch, and a single request tracks the completion of all
+ * messages, so the per-message cost is lower than calling
+ * @ref ucp_tag_send_nb repeatedly. The same buffer may appear in several
+ * entries, for example to send one message to many endpoints.
+ *
+ * If an entry fails to start, the following entries are not sent, and the
+ * error is returned once the entries which were already started complete.
+ *
+ * @param [in]  worker       Worker of all destination endpoints.
+ * @param [in]  entries      Array of messages to send.
+ * @param [in]  num_entries  Number of entries in @a entries.
+ * @param [in]  datatype     Datatype descriptor for the elements of all
+ *                           messages.
+ * @param [in]  cb           Callback which is invoked when all buffers can be
+ *                           reused, if the batch is not completed immediately.
+ *
+ * @return NULL                 - All messages were sent immediately.
+ * @return UCS_PTR_IS_ERR(_ptr) - The batch failed, and none of its messages
+ *                                are still in progress.
+ * @return otherwise            - Some of the messages are in progress. The
+ *                                request handle is completed with the status
+ *                                of the batch, and must be released by
+ *                                @ref ucp_request_free.
+ */
+ucs_status_ptr_t ucp_tag_send_batch_nb(ucp_worker_h worker,
+                                       const ucp_tag_send_batch_entry_t *entries,
+                                       size_t num_entries,
+                                       ucp_datatype_t datatype,
+                                       ucp_send_callback_t cb);
+
+
 END_C_DECLS
 
 #endif
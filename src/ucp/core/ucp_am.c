@@ -0,0 +1,591 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "ucp_am.h"
+#include "ucp_ep.h"
+#include "ucp_ep.inl"
+#include "ucp_worker.h"
+#include "ucp_context.h"
+#include "ucp_request.inl"
+
+#include <ucp/proto/proto.h>
+#include <ucp/proto/proto_am.inl>
+#include <ucp/tag/rndv.h>
+#include <ucp/dt/dt.h>
+#include <ucp/dt/dt.inl>
+#include <string.h>
+
+
+void ucp_am_init(ucp_worker_h worker)
+{
+    worker->am.cbs     = NULL;
+    worker->am.cbs_num = 0;
+}
+
+void ucp_am_cleanup(ucp_worker_h worker)
+{
+    ucs_free(worker->am.cbs);
+    worker->am.cbs     = NULL;
+    worker->am.cbs_num = 0;
+}
+
+ucs_status_t ucp_worker_set_am_handler(ucp_worker_h worker, uint16_t id,
+                                       ucp_am_callback_t cb, void *arg,
+                                       uint32_t flags)
+{
+    ucp_worker_am_entry_t *cbs;
+    ucs_status_t status;
+    unsigned num;
+
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_AM,
+                                    return UCS_ERR_INVALID_PARAM);
+
+    if (flags != 0) {
+        ucs_error("invalid active message handler flags 0x%x", flags);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    if (id >= worker->am.cbs_num) {
+        num = ucs_roundup_pow2(id + 1);
+        cbs = ucs_realloc(worker->am.cbs, num * sizeof(*cbs), "ucp_am_cbs");
+        if (cbs == NULL) {
+            ucs_error("failed to grow active message handlers array to %u",
+                      num);
+            status = UCS_ERR_NO_MEMORY;
+            goto out;
+        }
+
+        memset(cbs + worker->am.cbs_num, 0,
+               (num - worker->am.cbs_num) * sizeof(*cbs));
+        worker->am.cbs     = cbs;
+        worker->am.cbs_num = num;
+    }
+
+    worker->am.cbs[id].cb    = cb;
+    worker->am.cbs[id].arg   = arg;
+    worker->am.cbs[id].flags = flags;
+    status                   = UCS_OK;
+
+out:
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+    return status;
+}
+
+static UCS_F_ALWAYS_INLINE size_t ucp_am_hdr_size(const ucp_am_hdr_t *hdr)
+{
+    return (hdr->flags & UCP_AM_HDR_FLAG_REPLY) ? sizeof(ucp_am_reply_hdr_t) :
+                                                  sizeof(ucp_am_hdr_t);
+}
+
+static size_t ucp_am_pack_hdr(void *dest, ucp_request_t *req)
+{
+    ucp_am_reply_hdr_t *reply_hdr = dest;
+
+    reply_hdr->super.u64 = req->send.tag.tag;
+    if (!(reply_hdr->super.flags & UCP_AM_HDR_FLAG_REPLY)) {
+        return sizeof(ucp_am_hdr_t);
+    }
+
+    reply_hdr->ep_ptr = ucp_request_get_dest_ep_ptr(req);
+    return sizeof(*reply_hdr);
+}
+
+static ucs_status_t ucp_am_contig_short(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucs_status_t status;
+
+    req->send.lane = ucp_ep_get_am_lane(req->send.ep);
+    status         = uct_ep_am_short(ucp_ep_get_am_uct_ep(req->send.ep),
+                                     UCP_AM_ID_AM_SINGLE, req->send.tag.tag,
+                                     req->send.buffer, req->send.length);
+    if (ucs_likely(status == UCS_OK)) {
+        ucp_request_complete_send(req, UCS_OK);
+    }
+    return status;
+}
+
+static size_t ucp_am_pack_single(void *dest, void *arg)
+{
+    ucp_request_t *req = arg;
+    size_t hdr_size, length;
+
+    ucs_assert(req->send.state.dt.offset == 0);
+
+    hdr_size = ucp_am_pack_hdr(dest, req);
+    length   = ucp_dt_pack(req->send.ep->worker, req->send.datatype,
+                           req->send.mem_type,
+                           UCS_PTR_BYTE_OFFSET(dest, hdr_size),
+                           req->send.buffer, &req->send.state.dt,
+                           req->send.length, req->send.length);
+    ucs_assert(length == req->send.length);
+    return hdr_size + length;
+}
+
+static ucs_status_t ucp_am_bcopy_single(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucs_status_t status;
+
+    status = ucp_do_am_bcopy_single(self, UCP_AM_ID_AM_SINGLE,
+                                    ucp_am_pack_single);
+    if (status == UCS_OK) {
+        ucp_request_send_generic_dt_finish(req);
+        ucp_request_complete_send(req, UCS_OK);
+    }
+    return status;
+}
+
+static ucs_status_t ucp_am_zcopy_single(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_am_reply_hdr_t hdr;
+    size_t hdr_size;
+
+    hdr_size = ucp_am_pack_hdr(&hdr, req);
+    return ucp_do_am_zcopy_single(self, UCP_AM_ID_AM_SINGLE, &hdr, hdr_size,
+                                  ucp_proto_am_zcopy_req_complete);
+}
+
+static ucs_status_t ucp_am_progress_rndv_rts(uct_pending_req_t *self)
+{
+    /* The active message header is sent as the tag of the RTS */
+    return ucp_do_am_bcopy_single(self, UCP_AM_ID_AM_RTS,
+                                  ucp_tag_rndv_rts_pack);
+}
+
+/*
+ * Active messages are never fragmented: ucp_am_send_req() selects rendezvous
+ * for anything that does not fit a single packet, so the multi-fragment
+ * progress functions are not defined.
+ */
+static const ucp_proto_t ucp_am_proto = {
+    .contig_short            = ucp_am_contig_short,
+    .bcopy_single            = ucp_am_bcopy_single,
+    .bcopy_multi             = NULL,
+    .zcopy_single            = ucp_am_zcopy_single,
+    .zcopy_multi             = NULL,
+    .zcopy_completion        = ucp_proto_am_zcopy_completion,
+    .only_hdr_size           = sizeof(ucp_am_hdr_t),
+    .first_hdr_size          = sizeof(ucp_am_hdr_t),
+    .mid_hdr_size            = sizeof(ucp_am_hdr_t)
+};
+
+static const ucp_proto_t ucp_am_reply_proto = {
+    .contig_short            = NULL,
+    .bcopy_single            = ucp_am_bcopy_single,
+    .bcopy_multi             = NULL,
+    .zcopy_single            = ucp_am_zcopy_single,
+    .zcopy_multi             = NULL,
+    .zcopy_completion        = ucp_proto_am_zcopy_completion,
+    .only_hdr_size           = sizeof(ucp_am_reply_hdr_t),
+    .first_hdr_size          = sizeof(ucp_am_reply_hdr_t),
+    .mid_hdr_size            = sizeof(ucp_am_reply_hdr_t)
+};
+
+static ucs_status_t ucp_am_send_start_rndv(ucp_request_t *sreq)
+{
+    ucs_status_t status;
+
+    ucp_trace_req(sreq, "am start_rndv to %s buffer %p length %zu",
+                  ucp_ep_peer_name(sreq->send.ep), sreq->send.buffer,
+                  sreq->send.length);
+
+    status = ucp_ep_resolve_dest_ep_ptr(sreq->send.ep, sreq->send.lane);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucp_rndv_send_buffer_reg(sreq);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    sreq->send.uct.func = ucp_am_progress_rndv_rts;
+    return UCS_OK;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
+ucp_am_send_req(ucp_request_t *req, size_t count, ucp_send_callback_t cb,
+                const ucp_proto_t *proto)
+{
+    const ucp_ep_config_t *config    = ucp_ep_config(req->send.ep);
+    const ucp_ep_msg_config_t *msg   = &config->am;
+    size_t max_bcopy                 = msg->max_bcopy - proto->only_hdr_size;
+    size_t max_zcopy                 = 0;
+    ssize_t max_short                = -1;
+    size_t rndv_thresh, zcopy_thresh;
+    ucs_status_t status;
+
+    if (UCP_DT_IS_CONTIG(req->send.datatype)) {
+        rndv_thresh = ucs_min(config->tag.rndv.rma_thresh,
+                              config->tag.rndv.am_thresh);
+        if (msg->max_zcopy > proto->only_hdr_size) {
+            max_zcopy = msg->max_zcopy - proto->only_hdr_size;
+        }
+    } else {
+        rndv_thresh = config->tag.rndv.am_thresh;
+    }
+
+    /* Use rendezvous for messages which do not fit in a single packet */
+    if (max_zcopy > max_bcopy) {
+        rndv_thresh  = ucs_min(rndv_thresh, max_zcopy + 1);
+        zcopy_thresh = ucs_min(ucp_proto_get_zcopy_threshold(req, msg, count,
+                                                             rndv_thresh),
+                               max_bcopy + 1);
+    } else {
+        rndv_thresh  = ucs_min(rndv_thresh, max_bcopy + 1);
+        zcopy_thresh = rndv_thresh;
+    }
+
+    if (proto->contig_short != NULL) {
+        max_short = ucp_proto_get_short_max(req, msg);
+    }
+
+    ucs_trace_req("select am request(%p) progress algorithm datatype=%lx "
+                  "buffer=%p length=%zu max_short=%zd rndv_thresh=%zu "
+                  "zcopy_thresh=%zu", req, req->send.datatype,
+                  req->send.buffer, req->send.length, max_short, rndv_thresh,
+                  zcopy_thresh);
+
+    status = ucp_request_send_start(req, max_short, zcopy_thresh, rndv_thresh,
+                                    count, msg, proto);
+    if (status == UCS_ERR_NO_PROGRESS) {
+        ucs_assert(req->send.length >= rndv_thresh);
+        status = ucp_am_send_start_rndv(req);
+    }
+    if (status != UCS_OK) {
+        return UCS_STATUS_PTR(status);
+    }
+
+    /*
+     * Start the request.
+     * If it is completed immediately, release the request and return the status.
+     * Otherwise, return the request.
+     */
+    status = ucp_request_send(req, 0);
+    if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
+        ucs_trace_req("releasing send request %p, returning status %s", req,
+                      ucs_status_string(status));
+        ucp_request_put(req);
+        return UCS_STATUS_PTR(status);
+    }
+
+    ucp_request_set_callback(req, send.cb, cb)
+    ucs_trace_req("returning send request %p", req);
+    return req + 1;
+}
+
+UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_am_send_nb,
+                 (ep, id, buffer, count, datatype, cb, flags),
+                 ucp_ep_h ep, uint16_t id, const void *buffer, size_t count,
+                 ucp_datatype_t datatype, ucp_send_callback_t cb,
+                 unsigned flags)
+{
+    ucp_am_hdr_t hdr;
+    ucp_request_t *req;
+    ucs_status_t status;
+    ucs_status_ptr_t ret;
+    size_t length;
+
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(ep->worker->context, UCP_FEATURE_AM,
+                                    return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
+
+    ucs_trace_req("am_send_nb buffer %p count %zu id %u to %s cb %p flags %u",
+                  buffer, count, id, ucp_ep_peer_name(ep), cb, flags);
+
+    if (ucs_unlikely(flags & ~UCP_AM_SEND_REPLY)) {
+        ret = UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM);
+        goto out;
+    }
+
+    hdr.am_id   = id;
+    hdr.flags   = (flags & UCP_AM_SEND_REPLY) ? UCP_AM_HDR_FLAG_REPLY : 0;
+    hdr.padding = 0;
+
+    if (ucs_likely(!(flags & UCP_AM_SEND_REPLY) &&
+                   UCP_DT_IS_CONTIG(datatype))) {
+        length = ucp_contig_dt_length(datatype, count);
+        if ((ssize_t)length <= ucp_ep_config(ep)->am.max_short) {
+            UCS_STATIC_ASSERT(sizeof(hdr) == sizeof(uint64_t));
+            status = uct_ep_am_short(ucp_ep_get_am_uct_ep(ep),
+                                     UCP_AM_ID_AM_SINGLE, hdr.u64, buffer,
+                                     length);
+            if (ucs_likely(status != UCS_ERR_NO_RESOURCE)) {
+                ret = UCS_STATUS_PTR(status); /* UCS_OK also goes here */
+                goto out;
+            }
+        }
+    }
+
+    if (flags & UCP_AM_SEND_REPLY) {
+        status = ucp_ep_resolve_dest_ep_ptr(ep, ep->am_lane);
+        if (status != UCS_OK) {
+            ret = UCS_STATUS_PTR(status);
+            goto out;
+        }
+    }
+
+    req = ucp_request_get(ep->worker);
+    if (ucs_unlikely(req == NULL)) {
+        ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+        goto out;
+    }
+
+    req->flags             = 0;
+    req->send.ep           = ep;
+    req->send.buffer       = (void*)buffer;
+    req->send.datatype     = datatype;
+    req->send.tag.tag      = hdr.u64;
+    ucp_request_send_state_init(req, datatype, count);
+    req->send.length       = ucp_dt_length(datatype, count, buffer,
+                                           &req->send.state.dt);
+    ucp_memory_type_detect_mds(ep->worker->context, (void*)buffer,
+                               req->send.length, &req->send.mem_type);
+    req->send.lane         = ep->am_lane;
+    req->send.pending_lane = UCP_NULL_LANE;
+
+    ret = ucp_am_send_req(req, count, cb, (flags & UCP_AM_SEND_REPLY) ?
+                          &ucp_am_reply_proto : &ucp_am_proto);
+
+out:
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
+    return ret;
+}
+
+static UCS_F_ALWAYS_INLINE ucp_worker_am_entry_t *
+ucp_am_get_entry(ucp_worker_h worker, uint16_t id)
+{
+    if (ucs_unlikely((id >= worker->am.cbs_num) ||
+                     (worker->am.cbs[id].cb == NULL))) {
+        ucs_warn("active message with id %u was received, but there is no"
+                 " registered handler for it", id);
+        return NULL;
+    }
+
+    return &worker->am.cbs[id];
+}
+
+static ucs_status_t
+ucp_am_handler(void *arg, void *data, size_t length, unsigned am_flags)
+{
+    ucp_worker_h worker            = arg;
+    ucp_am_reply_hdr_t *reply_hdr  = data;
+    ucp_ep_h reply_ep              = NULL;
+    ucp_worker_am_entry_t *entry;
+    ucp_recv_desc_t *rdesc;
+    ucs_status_t status;
+    size_t hdr_size;
+    unsigned flags;
+    void *payload;
+
+    entry = ucp_am_get_entry(worker, reply_hdr->super.am_id);
+    if (entry == NULL) {
+        return UCS_OK;
+    }
+
+    hdr_size = ucp_am_hdr_size(&reply_hdr->super);
+    if (reply_hdr->super.flags & UCP_AM_HDR_FLAG_REPLY) {
+        reply_ep = ucp_worker_get_ep_by_ptr(worker, reply_hdr->ep_ptr);
+    }
+
+    /* The data may be kept by the user only if it is a UCT descriptor */
+    flags   = (am_flags & UCT_CB_PARAM_FLAG_DESC) ? UCP_CB_PARAM_FLAG_DATA : 0;
+    payload = UCS_PTR_BYTE_OFFSET(data, hdr_size);
+    status  = entry->cb(entry->arg, payload, length - hdr_size, reply_ep,
+                        flags);
+    if (status != UCS_INPROGRESS) {
+        return UCS_OK;
+    }
+
+    if (!(flags & UCP_CB_PARAM_FLAG_DATA)) {
+        ucs_error("active message handler of id %u returned UCS_INPROGRESS, "
+                  "but the data cannot be kept", reply_hdr->super.am_id);
+        return UCS_OK;
+    }
+
+    /* Put the receive descriptor over the header, so it could be found by
+     * ucp_am_data_release() */
+    rdesc              = (ucp_recv_desc_t*)payload - 1;
+    rdesc->flags       = UCP_RECV_DESC_FLAG_UCT_DESC;
+    rdesc->priv_length = -(int16_t)hdr_size;
+    return UCS_INPROGRESS;
+}
+
+static void ucp_am_rndv_recv_completion(void *request, ucs_status_t status,
+                                        ucp_tag_recv_info_t *info)
+{
+    ucp_request_t *rreq = (ucp_request_t*)request - 1;
+    ucp_worker_h worker = rreq->recv.worker;
+    ucp_recv_desc_t *rdesc;
+    ucp_worker_am_entry_t *entry;
+    ucp_am_hdr_t hdr;
+
+    hdr.u64 = info->sender_tag;
+    rdesc   = (ucp_recv_desc_t*)rreq->recv.buffer - 1;
+
+    if (status != UCS_OK) {
+        ucs_error("failed to receive active message with id %u: %s",
+                  hdr.am_id, ucs_status_string(status));
+        goto out;
+    }
+
+    entry = ucp_am_get_entry(worker, hdr.am_id);
+    if ((entry != NULL) &&
+        (entry->cb(entry->arg, rreq->recv.buffer, info->length,
+                   rreq->recv.tag.am_reply_ep, UCP_CB_PARAM_FLAG_DATA) ==
+         UCS_INPROGRESS)) {
+        return;
+    }
+
+out:
+    ucs_free(rdesc);
+}
+
+static size_t ucp_am_rndv_pack_ats(void *dest, void *arg)
+{
+    *(ucp_reply_hdr_t*)dest = *(const ucp_reply_hdr_t*)arg;
+    return sizeof(ucp_reply_hdr_t);
+}
+
+/* Reply to a rendezvous active message which could not be received, so the
+ * sender would complete its request with the error status. There is no request
+ * to retry the reply from, so it's sent only if there are resources for it. */
+static void ucp_am_rndv_reject(ucp_worker_h worker,
+                               const ucp_rndv_rts_hdr_t *rndv_rts_hdr,
+                               ucs_status_t status)
+{
+    ucp_ep_h ep = ucp_worker_get_ep_by_ptr(worker, rndv_rts_hdr->sreq.ep_ptr);
+    ucp_reply_hdr_t reply_hdr;
+    ssize_t packed_len;
+
+    reply_hdr.reqptr = rndv_rts_hdr->sreq.reqptr;
+    reply_hdr.status = status;
+    packed_len       = uct_ep_am_bcopy(ucp_ep_get_am_uct_ep(ep),
+                                       UCP_AM_ID_RNDV_ATS,
+                                       ucp_am_rndv_pack_ats, &reply_hdr, 0);
+    if (packed_len < 0) {
+        ucs_error("failed to reject active message rendezvous: %s",
+                  ucs_status_string((ucs_status_t)packed_len));
+    }
+}
+
+static ucs_status_t
+ucp_am_rndv_rts_handler(void *arg, void *data, size_t length, unsigned tl_flags)
+{
+    ucp_worker_h worker              = arg;
+    ucp_rndv_rts_hdr_t *rndv_rts_hdr = data;
+    ucp_recv_desc_t *rdesc;
+    ucp_request_t *rreq;
+    ucp_am_hdr_t hdr;
+    size_t size;
+
+    rreq = ucp_request_get(worker);
+    if (rreq == NULL) {
+        ucs_error("failed to allocate active message rendezvous request");
+        ucp_am_rndv_reject(worker, rndv_rts_hdr, UCS_ERR_NO_MEMORY);
+        return UCS_OK;
+    }
+
+    /* Receive to a malloc'ed buffer, which is passed to the user with a
+     * descriptor in front of it */
+    size  = rndv_rts_hdr->size;
+    rdesc = ucs_malloc(sizeof(*rdesc) + size, "ucp am rndv data");
+    if (rdesc == NULL) {
+        ucs_error("failed to allocate %zu bytes for active message", size);
+        ucp_request_put(rreq);
+        ucp_am_rndv_reject(worker, rndv_rts_hdr, UCS_ERR_NO_MEMORY);
+        return UCS_OK;
+    }
+
+    rdesc->flags          = UCP_RECV_DESC_FLAG_MALLOC;
+    rdesc->length         = size;
+    rdesc->payload_offset = 0;
+
+    hdr.u64                    = rndv_rts_hdr->super.tag;
+    rreq->flags                = UCP_REQUEST_FLAG_RECV |
+                                 UCP_REQUEST_FLAG_CALLBACK |
+                                 UCP_REQUEST_FLAG_RELEASED;
+    rreq->status               = UCS_OK;
+    rreq->recv.worker          = worker;
+    rreq->recv.buffer          = rdesc + 1;
+    rreq->recv.datatype        = ucp_dt_make_contig(1);
+    rreq->recv.length          = size;
+    rreq->recv.mem_type        = UCT_MD_MEM_TYPE_HOST;
+    rreq->recv.tag.cb          = ucp_am_rndv_recv_completion;
+    rreq->recv.tag.am_reply_ep = (hdr.flags & UCP_AM_HDR_FLAG_REPLY) ?
+                                 ucp_worker_get_ep_by_ptr(worker,
+                                                          rndv_rts_hdr->sreq.ep_ptr) :
+                                 NULL;
+    ucp_dt_recv_state_init(&rreq->recv.state, rreq->recv.buffer,
+                           rreq->recv.datatype, size);
+
+    ucp_rndv_matched(worker, rreq, rndv_rts_hdr);
+    return UCS_OK;
+}
+
+UCS_PROFILE_FUNC_VOID(ucp_am_data_release, (worker, data),
+                      ucp_worker_h worker, void *data)
+{
+    ucp_recv_desc_t *rdesc = (ucp_recv_desc_t*)data - 1;
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    if (rdesc->flags & UCP_RECV_DESC_FLAG_MALLOC) {
+        ucs_free(rdesc);
+    } else {
+        ucp_recv_desc_release(rdesc);
+    }
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+}
+
+static void ucp_am_dump(ucp_worker_h worker, uct_am_trace_type_t type,
+                        uint8_t id, const void *data, size_t length,
+                        char *buffer, size_t max)
+{
+    const ucp_am_reply_hdr_t *reply_hdr  = data;
+    const ucp_rndv_rts_hdr_t *rts_hdr    = data;
+    ucp_am_hdr_t hdr;
+    size_t hdr_size;
+    char *p;
+
+    switch (id) {
+    case UCP_AM_ID_AM_SINGLE:
+        hdr_size = ucp_am_hdr_size(&reply_hdr->super);
+        if (reply_hdr->super.flags & UCP_AM_HDR_FLAG_REPLY) {
+            snprintf(buffer, max, "AM id %u reply ep_ptr 0x%lx",
+                     reply_hdr->super.am_id, reply_hdr->ep_ptr);
+        } else {
+            snprintf(buffer, max, "AM id %u", reply_hdr->super.am_id);
+        }
+        p = buffer + strlen(buffer);
+        ucp_dump_payload(worker->context, p, buffer + max - p,
+                         UCS_PTR_BYTE_OFFSET(data, hdr_size),
+                         length - hdr_size);
+        break;
+    case UCP_AM_ID_AM_RTS:
+        hdr.u64 = rts_hdr->super.tag;
+        snprintf(buffer, max, "AM_RTS id %u flags 0x%x ep_ptr 0x%lx sreq 0x%lx "
+                 "address 0x%"PRIx64" size %zu", hdr.am_id, hdr.flags,
+                 rts_hdr->sreq.ep_ptr, rts_hdr->sreq.reqptr,
+                 rts_hdr->address, rts_hdr->size);
+        break;
+    default:
+        return;
+    }
+}
+
+UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_AM_SINGLE, ucp_am_handler,
+              ucp_am_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_AM_RTS, ucp_am_rndv_rts_handler,
+              ucp_am_dump, 0);
+
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_AM_SINGLE);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_AM_RTS);
@@ -0,0 +1,57 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_AM_H_
+#define UCP_AM_H_
+
+#include "ucp_types.h"
+
+#include <ucp/api/ucpx.h>
+
+
+enum {
+    UCP_AM_HDR_FLAG_REPLY = UCS_BIT(0)  /* Header is followed by reply ep_ptr */
+};
+
+
+/*
+ * Header of a user active message
+ */
+typedef union {
+    struct {
+        uint16_t             am_id;    /* User active message ID */
+        uint16_t             flags;    /* Header flags */
+        uint32_t             padding;
+    };
+    uint64_t                 u64;      /* Sent as a single word by am_short,
+                                          and as a tag by rendezvous protocol */
+} UCS_S_PACKED ucp_am_hdr_t;
+
+
+/*
+ * Header of a user active message which allows to reply
+ */
+typedef struct {
+    ucp_am_hdr_t             super;
+    uintptr_t                ep_ptr;   /* Remote endpoint to reply on */
+} UCS_S_PACKED ucp_am_reply_hdr_t;
+
+
+/*
+ * User active message handler, registered on a worker
+ */
+typedef struct {
+    ucp_am_callback_t        cb;       /* Callback, NULL if not registered */
+    void                     *arg;     /* User-defined argument */
+    uint32_t                 flags;    /* Registration flags */
+} ucp_worker_am_entry_t;
+
+
+void ucp_am_init(ucp_worker_h worker);
+
+void ucp_am_cleanup(ucp_worker_h worker);
+
+#endif
@@ -117,6 +117,13 @@ static ucs_config_field_t ucp_config_table[] = {
    "Relevant only if UCX_RNDV_THRESH is set to \"auto\".",
    ucs_offsetof(ucp_config_t, ctx.rndv_send_nbr_thresh), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"STREAM_RNDV_THRESH", "inf",
+   "Threshold for switching from eager to rendezvous protocol in stream send.\n"
+   "The receiver buffers rendezvous data which arrives before a receive with\n"
+   "room for it is posted, so it is disabled by default. \"auto\" uses the\n"
+   "tag-matching rendezvous threshold.",
+   ucs_offsetof(ucp_config_t, ctx.stream_rndv_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
   {"RNDV_THRESH_FALLBACK", "inf",
    "Message size to start using the rendezvous protocol in case the calculated threshold "
    "is zero or negative",
@@ -211,6 +218,34 @@ static ucs_config_field_t ucp_config_table[] = {
    "cases (non-contig buffer, or sender wildcard).",
    ucs_offsetof(ucp_config_t, ctx.tm_force_thresh), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"TM_HASH_SIZE", "1024",
+   "Initial number of buckets in the hash tables of expected and unexpected\n"
+   "tags. The value is rounded up to a power of 2.",
+   ucs_offsetof(ucp_config_t, ctx.tm_hash_size), UCS_CONFIG_TYPE_UINT},
+
+  {"TM_MAX_HASH_SIZE", "1048576",
+   "Maximal number of buckets in the hash tables of expected and unexpected\n"
+   "tags. The tables are doubled when the number of hashed receive requests and\n"
+   "unexpected messages exceeds the number of buckets, up to this limit.",
+   ucs_offsetof(ucp_config_t, ctx.tm_max_hash_size), UCS_CONFIG_TYPE_UINT},
+
+  {"TM_MAX_UNEXP_SIZE", "inf",
+   "Maximal total size of unexpected tag messages and fragments which are kept\n"
+   "by a worker. Above this limit, all peers are asked to send tag messages by\n"
+   "rendezvous protocol instead of eager, until the unexpected messages are\n"
+   "consumed down to half of the limit.",
+   ucs_offsetof(ucp_config_t, ctx.tm_max_unexp_size), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"ADAPTIVE_THRESH", "n",
+   "Tune the zero copy threshold of tag send operations at runtime, according\n"
+   "to the measured completion time of eager bcopy and zcopy. It is tuned only\n"
+   "if it is set to \"auto\".",
+   ucs_offsetof(ucp_config_t, ctx.adaptive_thresh), UCS_CONFIG_TYPE_BOOL},
+
+  {"ADAPTIVE_THRESH_INTERVAL", "1000",
+   "Number of measured send operations between updates of the adaptive thresholds.",
+   ucs_offsetof(ucp_config_t, ctx.adaptive_thresh_interval), UCS_CONFIG_TYPE_UINT},
+
   {"NUM_EPS", "auto",
    "An optimization hint of how many endpoints would be created on this context.\n"
    "Does not affect semantics, but only transport selection criteria and the\n"
@@ -664,6 +699,8 @@ static const char* ucp_feature_flag_str(unsigned feature_flag)
         return "UCP_FEATURE_WAKEUP";
     case UCP_FEATURE_STREAM:
         return "UCP_FEATURE_STREAM";
+    case UCP_FEATURE_AM:
+        return "UCP_FEATURE_AM";
     default:
         ucs_fatal("Unknown feature flag value %u", feature_flag);
     }
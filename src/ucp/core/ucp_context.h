@@ -13,6 +13,7 @@
 #include "ucp_thread.h"
 
 #include <ucp/api/ucp.h>
+#include <ucp/api/ucpx.h>
 #include <uct/api/uct.h>
 #include <ucs/datastruct/mpool.h>
 #include <ucs/datastruct/queue_types.h>
@@ -38,6 +39,8 @@ typedef struct ucp_context_config {
     /** Threshold for switching UCP to rendezvous protocol
      *  in ucp_tag_send_nbr() */
     size_t                                 rndv_send_nbr_thresh;
+    /** Threshold for switching UCP to rendezvous protocol in stream send */
+    size_t                                 stream_rndv_thresh;
     /** Threshold for switching UCP to rendezvous protocol in case the calculated
      *  threshold is zero or negative */
     size_t                                 rndv_thresh_fallback;
@@ -62,6 +65,17 @@ typedef struct ucp_context_config {
     /** Upper bound for posting tm offload receives with internal UCP
      *  preregistered bounce buffers. */
     size_t                                 tm_max_bb_size;
+    /** Initial number of buckets in the tag matching hash tables */
+    unsigned                               tm_hash_size;
+    /** Maximal number of buckets the tag matching hash tables can grow to */
+    unsigned                               tm_max_hash_size;
+    /** Maximal total size of unexpected tag messages before throttling the
+     *  eager senders */
+    size_t                                 tm_max_unexp_size;
+    /** Whether to tune the protocol thresholds at runtime */
+    int                                    adaptive_thresh;
+    /** Number of samples between updates of the adaptive thresholds */
+    unsigned                               adaptive_thresh_interval;
     /** Maximal size of worker name for debugging */
     unsigned                               max_worker_name;
     /** Atomic mode */
@@ -13,6 +13,7 @@
 #include <ucp/wireup/wireup.h>
 #include <ucp/tag/eager.h>
 #include <ucp/tag/offload.h>
+#include <ucp/proto/proto_tune.h>
 #include <ucp/stream/stream.h>
 #include <ucp/core/ucp_listener.h>
 #include <ucs/datastruct/queue.h>
@@ -31,7 +32,8 @@ static ucs_stats_class_t ucp_ep_stats_class = {
     .counter_names  = {
         [UCP_EP_STAT_TAG_TX_EAGER]      = "tx_eager",
         [UCP_EP_STAT_TAG_TX_EAGER_SYNC] = "tx_eager_sync",
-        [UCP_EP_STAT_TAG_TX_RNDV]       = "tx_rndv"
+        [UCP_EP_STAT_TAG_TX_RNDV]       = "tx_rndv",
+        [UCP_EP_STAT_TAG_TX_THROTTLED]  = "tx_throttled"
     }
 };
 #endif
@@ -926,6 +928,14 @@ static void ucp_ep_config_set_am_rndv_thresh(ucp_context_h context, uct_iface_at
         rndv_nbr_thresh = context->config.ext.rndv_thresh;
     }
 
+    /* Stream rendezvous uses the same RMA lanes as tag-matching, but it never
+     * uses tag offload */
+    if (context->config.ext.stream_rndv_thresh == UCS_CONFIG_MEMUNITS_AUTO) {
+        stream_rndv_thresh = rndv_thresh;
+    } else {
+        stream_rndv_thresh = context->config.ext.stream_rndv_thresh;
+    }
+
     config->tag.rndv.am_thresh = ucp_ep_thresh(rndv_thresh,
                                                iface_attr->cap.am.min_zcopy,
                                                max_rndv_thresh);
@@ -946,7 +956,7 @@ static void ucp_ep_config_set_rndv_thresh(ucp_worker_t *worker,
 {
     ucp_context_t *context = worker->context;
     ucp_rsc_index_t rsc_index;
-    size_t rndv_thresh, rndv_nbr_thresh;
+    size_t rndv_thresh, rndv_nbr_thresh, stream_rndv_thresh;
     uct_iface_attr_t *iface_attr;
     uct_md_attr_t *md_attr;
 
@@ -983,8 +993,13 @@ static void ucp_ep_config_set_rndv_thresh(ucp_worker_t *worker,
                                                          iface_attr->cap.get.min_zcopy,
                                                          max_rndv_thresh);
 
-    ucs_trace("rndv threshold is %zu (send_nbr: %zu)",
-              config->tag.rndv.rma_thresh, config->tag.rndv_send_nbr.rma_thresh);
+    config->stream.rndv_thresh = ucp_ep_thresh(stream_rndv_thresh,
+                                               iface_attr->cap.get.min_zcopy,
+                                               max_rndv_thresh);
+
+    ucs_trace("rndv threshold is %zu (send_nbr: %zu, stream: %zu)",
+              config->tag.rndv.rma_thresh, config->tag.rndv_send_nbr.rma_thresh,
+              config->stream.rndv_thresh);
 }
 
 static void ucp_ep_config_init_attrs(ucp_worker_t *worker, ucp_rsc_index_t rsc_index,
@@ -1090,6 +1105,7 @@ void ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config)
     config->tag.rndv.rkey_size          = ucp_rkey_packed_size(context,
                                                                config->key.rma_bw_md_map);
     config->stream.proto                = &ucp_stream_am_proto;
+    config->stream.rndv_thresh          = SIZE_MAX;
     config->tag.offload.max_eager_short = -1;
     config->tag.max_eager_short         = -1;
     max_rndv_thresh                     = SIZE_MAX;
@@ -1469,6 +1485,13 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
                                        tag_config->zcopy_thresh[0],
                                        config->tag.rndv.rma_thresh,
                                        config->tag.rndv.am_thresh);
+         if (config->tag.tune != NULL) {
+             ucp_ep_config_print_tag_proto(stream, "tag_send(tuned)",
+                                           tag_config->max_short,
+                                           config->tag.tune->zcopy.thresh,
+                                           config->tag.rndv.rma_thresh,
+                                           config->tag.rndv.am_thresh);
+         }
          ucp_ep_config_print_tag_proto(stream, "tag_send_nbr",
                                        tag_config->max_short,
                                        /* disable zcopy */
@@ -1482,6 +1505,13 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
                                        config->tag.rndv.am_thresh);
      }
 
+     if (context->config.features & UCP_FEATURE_STREAM) {
+         ucp_ep_config_print_tag_proto(stream, "stream_send",
+                                       config->am.max_short,
+                                       config->am.zcopy_thresh[0],
+                                       config->stream.rndv_thresh, SIZE_MAX);
+     }
+
      if (context->config.features & UCP_FEATURE_RMA) {
          for (lane = 0; lane < config->key.num_lanes; ++lane) {
              if (ucp_ep_config_get_multi_lane_prio(config->key.rma_lanes, lane) == -1) {
@@ -47,6 +47,12 @@ enum {
                                                         worker address from the client) */
     UCP_EP_FLAG_CONNECT_PRE_REQ_QUEUED = UCS_BIT(9), /* Pre-Connection request was queued */
     UCP_EP_FLAG_CLOSED                 = UCS_BIT(10),/* EP was closed */
+    UCP_EP_FLAG_TAG_THROTTLED          = UCS_BIT(11),/* Remote peer is out of memory for
+                                                        unexpected messages, send tag
+                                                        messages by rendezvous */
+    UCP_EP_FLAG_STREAM_RNDV            = UCS_BIT(12),/* Stream rendezvous send is in
+                                                        progress, next stream sends
+                                                        wait in ext.stream.send_q */
 
     /* DEBUG bits */
     UCP_EP_FLAG_CONNECT_REQ_SENT       = UCS_BIT(16),/* DEBUG: Connection request was sent */
@@ -69,6 +75,7 @@ enum {
     UCP_EP_STAT_TAG_TX_EAGER,
     UCP_EP_STAT_TAG_TX_EAGER_SYNC,
     UCP_EP_STAT_TAG_TX_RNDV,
+    UCP_EP_STAT_TAG_TX_THROTTLED,
     UCP_EP_STAT_LAST
 };
 
@@ -243,12 +250,17 @@ typedef struct ucp_ep_config {
             /* Maximal total size for RNDV offload */
             size_t          max_rndv_zcopy;
         } offload;
+
+        /* Runtime tuner of the protocol thresholds, NULL if disabled */
+        ucp_proto_tune_t    *tune;
     } tag;
 
     struct {
         /* Protocols used for stream operations
          * (currently it's only AM based). */
         const ucp_proto_t   *proto;
+        /* Threshold for switching from eager to rendezvous */
+        size_t              rndv_thresh;
     } stream;
 } ucp_ep_config_t;
 
@@ -316,6 +328,8 @@ typedef struct {
         ucs_list_link_t           ready_list;    /* List entry in worker's EP list */
         ucs_queue_head_t          match_q;       /* Queue of receive data or requests,
                                                     depends on UCP_EP_FLAG_STREAM_HAS_DATA */
+        ucs_queue_head_t          send_q;        /* Queue of send requests waiting
+                                                    for a rendezvous send to complete */
     } stream;
 } ucp_ep_ext_proto_t;
 
@@ -203,6 +203,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_request_memory_reg,
 {
     size_t iov_it, iovcnt;
     const ucp_dt_iov_t *iov;
+    ucp_dt_strided_t *dt_strided;
     ucp_dt_reg_t *dt_reg;
     ucs_status_t status;
     int flags;
@@ -216,6 +217,12 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_request_memory_reg,
     switch (datatype & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
         ucs_assert(ucs_popcount(md_map) <= UCP_MAX_OP_MDS);
+        if (length == 0) {
+            /* Nothing to register, as for empty IOV entries below */
+            state->dt.contig.md_map = 0;
+            break;
+        }
+
         status = ucp_mem_rereg_mds(context, md_map, buffer, length, flags,
                                    NULL, mem_type, NULL, state->dt.contig.memh,
                                    &state->dt.contig.md_map);
@@ -250,6 +257,23 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_request_memory_reg,
         }
         state->dt.iov.dt_reg = dt_reg;
         break;
+    case UCP_DATATYPE_STRIDED:
+        /* Register the whole span of the buffer once, rather than every block */
+        ucs_assert(ucs_popcount(md_map) <= UCP_MAX_OP_MDS);
+        if (length == 0) {
+            state->dt.strided.md_map = 0;
+            break;
+        }
+
+        dt_strided = ucp_dt_strided(datatype);
+        status     = ucp_mem_rereg_mds(context, md_map, buffer,
+                                       ucp_dt_strided_span(dt_strided, length),
+                                       flags, NULL, mem_type, NULL,
+                                       state->dt.strided.memh,
+                                       &state->dt.strided.md_map);
+        ucp_trace_req(req_dbg, "mem reg strided md_map 0x%"PRIx64"/0x%"PRIx64,
+                      state->dt.strided.md_map, md_map);
+        break;
     default:
         status = UCS_ERR_INVALID_PARAM;
         ucs_error("Invalid data type %lx", datatype);
@@ -285,6 +309,9 @@ UCS_PROFILE_FUNC_VOID(ucp_request_memory_dereg, (context, datatype, state, req_d
             state->dt.iov.dt_reg = NULL;
         }
         break;
+    case UCP_DATATYPE_STRIDED:
+        ucp_request_dt_dereg(context, &state->dt.strided, 1, req_dbg);
+        break;
     default:
         break;
     }
@@ -352,6 +379,9 @@ ucp_request_send_start(ucp_request_t *req, ssize_t max_short,
                 multi = ucp_dt_iov_count_nonempty(req->send.buffer, dt_count) >
                         msg_config->max_iov;
             }
+        } else if (ucs_unlikely(UCP_DT_IS_STRIDED(req->send.datatype))) {
+            multi = ucp_dt_strided_block_count(ucp_dt_strided(req->send.datatype),
+                                               0, length) > msg_config->max_iov;
         } else {
             multi = 0;
         }
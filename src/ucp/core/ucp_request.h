@@ -37,9 +37,11 @@ enum {
     UCP_REQUEST_FLAG_CALLBACK             = UCS_BIT(6),
     UCP_REQUEST_FLAG_RECV                 = UCS_BIT(7),
     UCP_REQUEST_FLAG_SYNC                 = UCS_BIT(8),
+    UCP_REQUEST_FLAG_PROTO_TUNE           = UCS_BIT(9),
     UCP_REQUEST_FLAG_OFFLOADED            = UCS_BIT(10),
     UCP_REQUEST_FLAG_BLOCK_OFFLOAD        = UCS_BIT(11),
     UCP_REQUEST_FLAG_STREAM_RECV_WAITALL  = UCS_BIT(12),
+    UCP_REQUEST_FLAG_STREAM_RNDV          = UCS_BIT(13),
 
 #if ENABLE_ASSERT
     UCP_REQUEST_FLAG_STREAM_RECV          = UCS_BIT(14),
@@ -71,7 +73,8 @@ enum {
     UCP_RECV_DESC_FLAG_EAGER_ONLY     = UCS_BIT(2), /* Eager tag message with single fragment */
     UCP_RECV_DESC_FLAG_EAGER_SYNC     = UCS_BIT(3), /* Eager tag message which requires reply */
     UCP_RECV_DESC_FLAG_EAGER_OFFLOAD  = UCS_BIT(4), /* Eager tag from offload */
-    UCP_RECV_DESC_FLAG_RNDV           = UCS_BIT(5)  /* Rendezvous request */
+    UCP_RECV_DESC_FLAG_RNDV           = UCS_BIT(5), /* Rendezvous request */
+    UCP_RECV_DESC_FLAG_MALLOC         = UCS_BIT(6)  /* Descriptor allocated by malloc */
 };
 
 
@@ -102,6 +105,8 @@ struct ucp_request {
             size_t                length;   /* Total length, in bytes */
             uct_memory_type_t     mem_type; /* Memory type */
             ucp_send_callback_t   cb;       /* Completion callback */
+            ucp_request_t         *batch;   /* Batch request to complete, if
+                                               the send is part of a batch */
 
             union {
 
@@ -195,6 +200,13 @@ struct ucp_request {
                     uintptr_t              req;  /* Remote atomic request pointer */
                     ucp_atomic_reply_t     data; /* Atomic reply data */
                 } atomic_reply;
+
+                struct {
+                    ucs_queue_elem_t       queue; /* Elem in endpoint's queue of
+                                                     sends waiting for a stream
+                                                     rendezvous */
+                    size_t                 count; /* Number of datatype elements */
+                } stream;
             };
 
             /* This structure holds all mutable fields, and everything else
@@ -206,6 +218,13 @@ struct ucp_request {
                 uct_completion_t  uct_comp; /* UCT completion */
             } state;
 
+            /* Protocol selected by the runtime tuner */
+            struct {
+                ucs_time_t        start;    /* Time when the send was started */
+                uint8_t           proto;    /* Measured protocol */
+                ucp_ep_cfg_index_t cfg_idx; /* Endpoint configuration index */
+            } tune;
+
             ucp_lane_index_t      pending_lane; /* Lane on which request was moved
                                                  * to pending state */
             ucp_lane_index_t      lane;     /* Lane on which this request is being sent */
@@ -236,12 +255,25 @@ struct ucp_request {
                     ucp_worker_iface_t      *wiface;  /* Cached iface this request
                                                          is received on. Used in
                                                          tag offload expected callbacks*/
+                    union {
+                        ucp_ep_h            am_reply_ep; /* Reply endpoint of user
+                                                            active message received
+                                                            by rendezvous */
+                        struct {
+                            ucp_ep_h        ep;   /* Endpoint of the stream */
+                            ucp_request_t   *req; /* Stream receive request
+                                                     which gets the data */
+                        } stream;               /* Stream data received
+                                                   by rendezvous */
+                    };
                 } tag;
 
                 struct {
                     ucp_stream_recv_callback_t cb;     /* Completion callback */
                     size_t                     offset; /* Receive data offset */
                     size_t                     length; /* Completion info to fill */
+                    unsigned                   rndv_count; /* Rendezvous receives
+                                                              in progress */
                 } stream;
             };
         } recv;
@@ -253,6 +285,11 @@ struct ucp_request {
             int                   comp_count; /* Countdown to request completion */
             ucp_ep_ext_gen_t      *next_ep; /* Next endpoint to flush */
         } flush_worker;
+
+        struct {
+            ucp_send_callback_t   cb;       /* Completion callback */
+            unsigned              comp_count; /* Countdown to request completion */
+        } send_batch;
     };
 };
 
@@ -271,6 +308,8 @@ struct ucp_request {
  * Some protocols (i. e. tag offload) may need some space right before the
  * incoming data to add specific headers needed for further message processing.
  * Note: priv_length value should be in [0, UCP_WORKER_HEADROOM_PRIV_SIZE] range.
+ * User active messages place ucp_recv_desc right before the payload, on top of
+ * the protocol header, and set priv_length to minus the header length.
  */
 struct ucp_recv_desc {
     union {
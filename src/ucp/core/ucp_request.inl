@@ -13,6 +13,9 @@
 
 #include <ucp/core/ucp_worker.h>
 #include <ucp/dt/dt.h>
+#include <ucp/proto/proto_tune.h>
+#include <ucp/stream/stream.h>
+#include <ucs/config/global_opts.h>
 #include <ucs/profile/profile.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucp/dt/dt.inl>
@@ -94,6 +97,13 @@ ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_send", status);
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_PROTO_TUNE)) {
+        ucp_proto_tune_complete(req, status);
+    }
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_STREAM_RNDV)) {
+        ucp_stream_send_rndv_complete(req, status);
+        return;
+    }
     ucp_request_complete(req, send.cb, status);
 }
 
@@ -132,6 +142,11 @@ ucp_request_complete_stream_recv(ucp_request_t *req, ucp_ep_ext_proto_t* ep_ext,
 static UCS_F_ALWAYS_INLINE int
 ucp_request_can_complete_stream_recv(ucp_request_t *req)
 {
+    /* Rendezvous data is still written to the reserved part of the buffer */
+    if (ucs_unlikely(req->recv.stream.rndv_count > 0)) {
+        return 0;
+    }
+
     /* NOTE: first check is needed to avoid heavy "%" operation if request is
      *       completely filled */
     if (req->recv.stream.offset == req->recv.length) {
@@ -251,6 +266,9 @@ ucp_request_send_state_init(ucp_request_t *req, ucp_datatype_t datatype,
         req->send.state.dt.dt.iov.iovcnt        = dt_count;
         req->send.state.dt.dt.iov.dt_reg        = NULL;
         return;
+    case UCP_DATATYPE_STRIDED:
+        req->send.state.dt.dt.strided.md_map    = 0;
+        return;
     case UCP_DATATYPE_GENERIC:
         dt_gen    = ucp_dt_generic(datatype);
         state_gen = dt_gen->ops.start_pack(dt_gen->context, req->send.buffer,
@@ -433,8 +451,10 @@ ucp_request_recv_data_unpack(ucp_request_t *req, const void *data,
     case UCP_DATATYPE_CONTIG:
         if ((ucs_likely(UCP_MEM_IS_HOST(req->recv.mem_type))) ||
             (ucs_likely(UCP_MEM_IS_CUDA_MANAGED(req->recv.mem_type)))) {
-            UCS_PROFILE_NAMED_CALL("memcpy_recv", memcpy, req->recv.buffer + offset,
-                                   data, length);
+            UCS_PROFILE_NAMED_CALL_VOID("memcpy_recv", ucs_memcpy_relaxed,
+                                        req->recv.buffer + offset, data, length,
+                                        req->recv.length,
+                                        ucs_global_opts.memcpy_nt_thresh);
         } else {
             ucp_mem_type_unpack(req->recv.worker, req->recv.buffer + offset,
                                 data, length, req->recv.mem_type);
@@ -456,6 +476,12 @@ ucp_request_recv_data_unpack(ucp_request_t *req, const void *data,
         req->recv.state.offset += length;
         return UCS_OK;
 
+    case UCP_DATATYPE_STRIDED:
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_unpack,
+                              ucp_dt_strided(req->recv.datatype),
+                              req->recv.buffer, data, offset, length);
+        return UCS_OK;
+
     case UCP_DATATYPE_GENERIC:
         dt_gen = ucp_dt_generic(req->recv.datatype);
         status = UCS_PROFILE_NAMED_CALL("dt_unpack", dt_gen->ops.unpack,
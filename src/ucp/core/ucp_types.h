@@ -50,6 +50,7 @@ typedef struct ucp_proto                ucp_proto_t;
 typedef struct ucp_worker_iface         ucp_worker_iface_t;
 typedef struct ucp_rma_proto            ucp_rma_proto_t;
 typedef struct ucp_amo_proto            ucp_amo_proto_t;
+typedef struct ucp_proto_tune           ucp_proto_tune_t;
 
 
 /**
@@ -85,6 +86,19 @@ enum {
     UCP_AM_ID_ATOMIC_REP        =  21, /* Remote memory atomic reply */
     UCP_AM_ID_CMPL              =  22, /* Remote memory operation completion */
 
+    UCP_AM_ID_EAGER_THROTTLE    =  23, /* Receiver is out of unexpected memory,
+                                          stop sending eager TAG messages */
+    UCP_AM_ID_EAGER_UNTHROTTLE  =  24, /* Resume sending eager TAG messages */
+
+    UCP_AM_ID_AM_SINGLE         =  25, /* Single packet user active message */
+    UCP_AM_ID_AM_RTS            =  26, /* Ready-to-Send for a user active message
+                                          sent by rendezvous protocol */
+
+    UCP_AM_ID_STREAM_RTS        =  27, /* Ready-to-Send for stream data
+                                          sent by rendezvous protocol */
+    UCP_AM_ID_STREAM_NAK        =  28, /* Stream receiver has no buffer for
+                                          the rendezvous, send the data eagerly */
+
     UCP_AM_ID_LAST
 };
 
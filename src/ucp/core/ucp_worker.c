@@ -13,6 +13,7 @@
 #include <ucp/wireup/wireup_ep.h>
 #include <ucp/tag/eager.h>
 #include <ucp/tag/offload.h>
+#include <ucp/proto/proto_tune.h>
 #include <ucp/stream/stream.h>
 #include <ucs/config/parser.h>
 #include <ucs/datastruct/mpool.inl>
@@ -1318,6 +1319,7 @@ unsigned ucp_worker_get_ep_config(ucp_worker_h worker,
 {
     ucp_ep_config_t *config;
     unsigned config_idx;
+    ucs_status_t status;
 
     /* Search for the given key in the ep_config array */
     for (config_idx = 0; config_idx < worker->ep_config_count; ++config_idx) {
@@ -1339,6 +1341,17 @@ unsigned ucp_worker_get_ep_config(ucp_worker_h worker,
     config->key = *key;
     ucp_ep_config_init(worker, config);
 
+    if (worker->context->config.ext.adaptive_thresh &&
+        (worker->context->config.features & UCP_FEATURE_TAG) &&
+        (key->am_lane != UCP_NULL_LANE) &&
+        !ucp_ep_is_tag_offload_enabled(config)) {
+        status = ucp_proto_tune_create(worker, config, config_idx,
+                                       &config->tag.tune);
+        if (status != UCS_OK) {
+            config->tag.tune = NULL;
+        }
+    }
+
 out:
     return config_idx;
 }
@@ -1401,6 +1414,7 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     ucs_list_head_init(&worker->stream_ready_eps);
     ucs_list_head_init(&worker->all_eps);
     ucp_ep_match_init(&worker->ep_match_ctx);
+    ucp_am_init(worker);
 
     UCS_STATIC_ASSERT(sizeof(ucp_ep_ext_gen_t) <= sizeof(ucp_ep_t));
     if (context->config.features & UCP_FEATURE_STREAM) {
@@ -1471,7 +1485,10 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     }
 
     /* Initialize tag matching */
-    status = ucp_tag_match_init(&worker->tm);
+    status = ucp_tag_match_init(&worker->tm, context->config.ext.tm_hash_size,
+                                context->config.ext.tm_max_hash_size,
+                                context->config.ext.tm_max_unexp_size
+                                UCS_STATS_ARG(worker->stats));
     if (status != UCS_OK) {
         goto err_wakeup_cleanup;
     }
@@ -1536,6 +1553,18 @@ static void ucp_worker_destroy_eps(ucp_worker_h worker)
     }
 }
 
+static void ucp_worker_destroy_proto_tune(ucp_worker_h worker)
+{
+    unsigned config_idx;
+
+    for (config_idx = 0; config_idx < worker->ep_config_count; ++config_idx) {
+        if (worker->ep_config[config_idx].tag.tune != NULL) {
+            ucp_proto_tune_destroy(worker->ep_config[config_idx].tag.tune);
+            worker->ep_config[config_idx].tag.tune = NULL;
+        }
+    }
+}
+
 void ucp_worker_destroy(ucp_worker_h worker)
 {
     ucs_trace_func("worker=%p", worker);
@@ -1550,6 +1579,8 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucs_mpool_cleanup(&worker->rndv_frag_mp, 1);
     ucp_worker_close_ifaces(worker);
     ucp_tag_match_cleanup(&worker->tm);
+    ucp_worker_destroy_proto_tune(worker);
+    ucp_am_cleanup(worker);
     ucp_worker_wakeup_cleanup(worker);
     ucs_mpool_cleanup(&worker->req_mp, 1);
     uct_worker_destroy(worker->uct);
@@ -1852,6 +1883,10 @@ void ucp_worker_print_info(ucp_worker_h worker, FILE *stream)
         fprintf(stream, "\n");
     }
 
+    if (context->config.features & UCP_FEATURE_TAG) {
+        ucp_tag_match_print_info(&worker->tm, stream);
+    }
+
     fprintf(stream, "#\n");
 
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
@@ -8,6 +8,7 @@
 #ifndef UCP_WORKER_H_
 #define UCP_WORKER_H_
 
+#include "ucp_am.h"
 #include "ucp_ep.h"
 #include "ucp_context.h"
 #include "ucp_thread.h"
@@ -216,6 +217,11 @@ typedef struct ucp_worker {
     ucp_tag_match_t               tm;            /* Tag-matching queues and offload info */
     ucp_ep_h                      mem_type_ep[UCT_MD_MEM_TYPE_LAST];/* memory type eps */
 
+    struct {
+        ucp_worker_am_entry_t     *cbs;          /* User active message handlers */
+        unsigned                  cbs_num;       /* Size of the handlers array */
+    } am;
+
     UCS_STATS_NODE_DECLARE(stats);
     UCS_STATS_NODE_DECLARE(tm_offload_stats);
 
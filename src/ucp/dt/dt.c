@@ -9,6 +9,7 @@
 #include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_mm.h>
+#include <ucs/config/global_opts.h>
 #include <ucs/profile/profile.h>
 
 
@@ -91,7 +92,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_mem_type_pack,
 
 size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
                    uct_memory_type_t mem_type, void *dest, const void *src,
-                   ucp_dt_state_t *state, size_t length)
+                   ucp_dt_state_t *state, size_t length, size_t total_length)
 {
     size_t result_len = 0;
     ucp_dt_generic_t *dt;
@@ -104,7 +105,9 @@ size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
     case UCP_DATATYPE_CONTIG:
         if ((ucs_likely(UCP_MEM_IS_HOST(mem_type))) ||
             (ucs_likely(UCP_MEM_IS_CUDA_MANAGED(mem_type)))) {
-            UCS_PROFILE_CALL(memcpy, dest, src + state->offset, length);
+            UCS_PROFILE_CALL_VOID(ucs_memcpy_relaxed, dest, src + state->offset,
+                                  length, total_length,
+                                  ucs_global_opts.memcpy_nt_thresh);
         } else {
             ucp_mem_type_pack(worker, dest, src + state->offset, length, mem_type);
         }
@@ -118,6 +121,12 @@ size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
         result_len = length;
         break;
 
+    case UCP_DATATYPE_STRIDED:
+        result_len = UCS_PROFILE_CALL(ucp_dt_strided_pack,
+                                      ucp_dt_strided(datatype), dest, src,
+                                      state->offset, length);
+        break;
+
     case UCP_DATATYPE_GENERIC:
         dt = ucp_dt_generic(datatype);
         result_len = UCS_PROFILE_NAMED_CALL("dt_pack", dt->ops.pack,
@@ -10,6 +10,7 @@
 
 #include "dt_contig.h"
 #include "dt_iov.h"
+#include "dt_strided.h"
 #include "dt_generic.h"
 
 #include <ucp/core/ucp_types.h>
@@ -39,6 +40,7 @@ typedef struct ucp_dt_state {
             size_t                iovcnt;         /* Number of IOV buffers */
             ucp_dt_reg_t          *dt_reg;        /* Pointer to IOV memh[iovcnt] */
         } iov;
+        ucp_dt_reg_t              strided; /* Registration of the whole span */
         struct {
             void                  *state;
         } generic;
@@ -48,7 +50,7 @@ typedef struct ucp_dt_state {
 
 size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
                    uct_memory_type_t mem_type, void *dest, const void *src,
-                   ucp_dt_state_t *state, size_t length);
+                   ucp_dt_state_t *state, size_t length, size_t total_length);
 
 ucs_status_t ucp_mem_type_unpack(ucp_worker_h worker, void *buffer,
                                  const void *recv_data, size_t recv_length,
@@ -5,6 +5,7 @@
  */
 
 #include "dt_generic.h"
+#include "dt_strided.h"
 
 #include <ucs/debug/memtrack.h>
 
@@ -32,6 +33,9 @@ void ucp_dt_destroy(ucp_datatype_t datatype)
     switch (datatype & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
         break;
+    case UCP_DATATYPE_STRIDED:
+        ucs_free(ucp_dt_strided(datatype));
+        break;
     case UCP_DATATYPE_GENERIC:
         dt = ucp_dt_generic(datatype);
         ucs_free(dt);
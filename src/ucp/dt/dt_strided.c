@@ -0,0 +1,314 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "dt_strided.h"
+#include "dt_contig.h"
+
+#include <ucs/debug/memtrack.h>
+#include <ucs/debug/log.h>
+#include <ucs/sys/compiler_def.h>
+#include <string.h>
+
+
+/* Position of a packed data offset in the strided buffer */
+typedef struct ucp_dt_strided_cursor {
+    size_t                   item_offset;   /* Buffer offset of the current item */
+    size_t                   block_offset;  /* Offset inside the current block */
+    size_t                   idx[UCP_DT_STRIDED_MAX_DIMS]; /* Block index */
+} ucp_dt_strided_cursor_t;
+
+
+/*
+ * Copy @a _count blocks of @a _size bytes. Since the size is a compile-time
+ * constant, memcpy() is expanded to plain loads and stores, and the loop can
+ * be unrolled and vectorized by the compiler.
+ */
+#define UCP_DT_STRIDED_COPY_BLOCKS(_dst, _dst_stride, _src, _src_stride, \
+                                   _size, _count) \
+    { \
+        size_t _i; \
+        for (_i = 0; _i < (_count); ++_i) { \
+            memcpy(UCS_PTR_BYTE_OFFSET(_dst, _i * (_dst_stride)), \
+                   UCS_PTR_BYTE_OFFSET(_src, _i * (_src_stride)), (_size)); \
+        } \
+    }
+
+
+static void ucp_dt_strided_copy_blocks(void *dst, size_t dst_stride,
+                                       const void *src, size_t src_stride,
+                                       size_t elem_size, size_t count)
+{
+    switch (elem_size) {
+    case 1:
+        UCP_DT_STRIDED_COPY_BLOCKS(dst, dst_stride, src, src_stride, 1, count);
+        break;
+    case 2:
+        UCP_DT_STRIDED_COPY_BLOCKS(dst, dst_stride, src, src_stride, 2, count);
+        break;
+    case 4:
+        UCP_DT_STRIDED_COPY_BLOCKS(dst, dst_stride, src, src_stride, 4, count);
+        break;
+    case 8:
+        UCP_DT_STRIDED_COPY_BLOCKS(dst, dst_stride, src, src_stride, 8, count);
+        break;
+    case 16:
+        UCP_DT_STRIDED_COPY_BLOCKS(dst, dst_stride, src, src_stride, 16, count);
+        break;
+    case 32:
+        UCP_DT_STRIDED_COPY_BLOCKS(dst, dst_stride, src, src_stride, 32, count);
+        break;
+    default:
+        UCP_DT_STRIDED_COPY_BLOCKS(dst, dst_stride, src, src_stride, elem_size,
+                                   count);
+        break;
+    }
+}
+
+static void ucp_dt_strided_cursor_init(const ucp_dt_strided_t *dt,
+                                       size_t offset,
+                                       ucp_dt_strided_cursor_t *cursor)
+{
+    size_t item_size = dt->elem_count * dt->elem_size;
+    size_t block;
+    unsigned i;
+
+    cursor->item_offset  = (offset / item_size) * dt->extent;
+    block                = (offset % item_size) / dt->elem_size;
+    cursor->block_offset = offset % dt->elem_size;
+
+    for (i = 0; i < dt->num_dims; ++i) {
+        cursor->idx[i] = block % dt->dims[i].count;
+        block         /= dt->dims[i].count;
+    }
+}
+
+static size_t ucp_dt_strided_cursor_addr(const ucp_dt_strided_t *dt,
+                                         const ucp_dt_strided_cursor_t *cursor)
+{
+    size_t offset = cursor->item_offset;
+    unsigned i;
+
+    for (i = 0; i < dt->num_dims; ++i) {
+        offset += cursor->idx[i] * dt->dims[i].stride;
+    }
+    return offset;
+}
+
+/* Move the cursor by @a count blocks, which must not cross dims[0] boundary */
+static void ucp_dt_strided_cursor_advance(const ucp_dt_strided_t *dt,
+                                          ucp_dt_strided_cursor_t *cursor,
+                                          size_t count)
+{
+    unsigned i;
+
+    ucs_assert(cursor->idx[0] + count <= dt->dims[0].count);
+
+    cursor->idx[0] += count;
+    for (i = 0; cursor->idx[i] == dt->dims[i].count; ++i) {
+        cursor->idx[i] = 0;
+        if (i + 1 == dt->num_dims) {
+            cursor->item_offset += dt->extent;
+            break;
+        }
+        ++cursor->idx[i + 1];
+    }
+}
+
+static UCS_F_ALWAYS_INLINE size_t
+ucp_dt_strided_copy(const ucp_dt_strided_t *dt, void *buffer, void *data,
+                    size_t offset, size_t length, int pack)
+{
+    size_t elem_size = dt->elem_size;
+    ucp_dt_strided_cursor_t cursor;
+    size_t copied, count;
+    void *block;
+
+    ucp_dt_strided_cursor_init(dt, offset, &cursor);
+
+    copied = 0;
+    while (copied < length) {
+        block = UCS_PTR_BYTE_OFFSET(buffer,
+                                    ucp_dt_strided_cursor_addr(dt, &cursor));
+        if ((cursor.block_offset != 0) || ((length - copied) < elem_size)) {
+            /* partial block */
+            count = ucs_min(elem_size - cursor.block_offset, length - copied);
+            block = UCS_PTR_BYTE_OFFSET(block, cursor.block_offset);
+            if (pack) {
+                memcpy(UCS_PTR_BYTE_OFFSET(data, copied), block, count);
+            } else {
+                memcpy(block, UCS_PTR_BYTE_OFFSET(data, copied), count);
+            }
+            copied              += count;
+            cursor.block_offset += count;
+            if (cursor.block_offset == elem_size) {
+                cursor.block_offset = 0;
+                ucp_dt_strided_cursor_advance(dt, &cursor, 1);
+            }
+        } else {
+            /* run of full blocks along the innermost dimension */
+            count = ucs_min(dt->dims[0].count - cursor.idx[0],
+                            (length - copied) / elem_size);
+            if (pack) {
+                ucp_dt_strided_copy_blocks(UCS_PTR_BYTE_OFFSET(data, copied),
+                                           elem_size, block, dt->dims[0].stride,
+                                           elem_size, count);
+            } else {
+                ucp_dt_strided_copy_blocks(block, dt->dims[0].stride,
+                                           UCS_PTR_BYTE_OFFSET(data, copied),
+                                           elem_size, elem_size, count);
+            }
+            copied += count * elem_size;
+            ucp_dt_strided_cursor_advance(dt, &cursor, count);
+        }
+    }
+
+    return copied;
+}
+
+size_t ucp_dt_strided_pack(const ucp_dt_strided_t *dt, void *dest,
+                           const void *src, size_t offset, size_t length)
+{
+    return ucp_dt_strided_copy(dt, (void*)src, dest, offset, length, 1);
+}
+
+void ucp_dt_strided_unpack(const ucp_dt_strided_t *dt, void *dest,
+                           const void *src, size_t offset, size_t length)
+{
+    ucp_dt_strided_copy(dt, dest, (void*)src, offset, length, 0);
+}
+
+size_t ucp_dt_strided_to_uct_iov(const ucp_dt_strided_t *dt, void *buffer,
+                                 size_t offset, size_t length, uct_mem_h memh,
+                                 uct_iov_t *iov, size_t max_iov,
+                                 size_t *iovcnt_p)
+{
+    ucp_dt_strided_cursor_t cursor;
+    size_t iovcnt, total;
+
+    ucp_dt_strided_cursor_init(dt, offset, &cursor);
+
+    total = 0;
+    for (iovcnt = 0; (iovcnt < max_iov) && (total < length); ++iovcnt) {
+        iov[iovcnt].buffer = UCS_PTR_BYTE_OFFSET(buffer, cursor.block_offset +
+                                                 ucp_dt_strided_cursor_addr(dt,
+                                                                            &cursor));
+        iov[iovcnt].length = ucs_min(dt->elem_size - cursor.block_offset,
+                                     length - total);
+        iov[iovcnt].memh   = memh;
+        iov[iovcnt].stride = 0;
+        iov[iovcnt].count  = 1;
+        total             += iov[iovcnt].length;
+
+        cursor.block_offset = 0;
+        ucp_dt_strided_cursor_advance(dt, &cursor, 1);
+    }
+
+    *iovcnt_p = iovcnt;
+    return total;
+}
+
+static void ucp_dt_strided_remove_dim(ucp_dt_strided_t *dt, unsigned dim)
+{
+    --dt->num_dims;
+    memmove(&dt->dims[dim], &dt->dims[dim + 1],
+            (dt->num_dims - dim) * sizeof(dt->dims[0]));
+}
+
+/*
+ * Fold dimensions which do not introduce gaps, so that the innermost blocks
+ * and the runs along dims[0] are as long as possible.
+ */
+static void ucp_dt_strided_normalize(ucp_dt_strided_t *dt)
+{
+    unsigned i;
+
+    for (i = 0; i < dt->num_dims;) {
+        if (dt->dims[i].count == 1) {
+            ucp_dt_strided_remove_dim(dt, i);
+        } else if ((i == 0) && (dt->dims[0].stride == dt->elem_size)) {
+            dt->elem_size *= dt->dims[0].count;
+            ucp_dt_strided_remove_dim(dt, 0);
+        } else if ((i + 1 < dt->num_dims) &&
+                   (dt->dims[i + 1].stride ==
+                    dt->dims[i].count * dt->dims[i].stride)) {
+            dt->dims[i].count *= dt->dims[i + 1].count;
+            ucp_dt_strided_remove_dim(dt, i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    if (dt->num_dims == 0) {
+        dt->dims[0].count  = 1;
+        dt->dims[0].stride = dt->elem_size;
+        dt->num_dims       = 1;
+    }
+}
+
+ucs_status_t ucp_dt_create_vector(ucp_datatype_t datatype, size_t count,
+                                  size_t stride, ucp_datatype_t *datatype_p)
+{
+    ucp_dt_strided_t tmp, *dt;
+    unsigned i;
+
+    switch (datatype & UCP_DATATYPE_CLASS_MASK) {
+    case UCP_DATATYPE_CONTIG:
+        tmp.elem_size = ucp_contig_dt_elem_size(datatype);
+        tmp.num_dims  = 0;
+        break;
+    case UCP_DATATYPE_STRIDED:
+        tmp = *ucp_dt_strided(datatype);
+        break;
+    default:
+        ucs_error("unsupported vector item datatype 0x%lx", datatype);
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    if ((count == 0) || (tmp.elem_size == 0)) {
+        ucs_error("invalid strided datatype: count %zu elem_size %zu", count,
+                  tmp.elem_size);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    /* a strided datatype of a single block has a dummy dimension */
+    if ((tmp.num_dims == 1) && (tmp.dims[0].count == 1)) {
+        tmp.num_dims = 0;
+    }
+
+    if (tmp.num_dims == UCP_DT_STRIDED_MAX_DIMS) {
+        ucs_error("strided datatype nesting level exceeds %d",
+                  UCP_DT_STRIDED_MAX_DIMS);
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    tmp.dims[tmp.num_dims].count  = count;
+    tmp.dims[tmp.num_dims].stride = stride;
+    ++tmp.num_dims;
+    ucp_dt_strided_normalize(&tmp);
+
+    tmp.elem_count = 1;
+    tmp.extent     = tmp.elem_size;
+    for (i = 0; i < tmp.num_dims; ++i) {
+        tmp.elem_count *= tmp.dims[i].count;
+        tmp.extent     += (tmp.dims[i].count - 1) * tmp.dims[i].stride;
+    }
+
+    dt = ucs_memalign(UCS_BIT(UCP_DATATYPE_SHIFT), sizeof(*dt), "strided_dt");
+    if (dt == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    *dt         = tmp;
+    *datatype_p = ((uintptr_t)dt) | UCP_DATATYPE_STRIDED;
+    return UCS_OK;
+}
+
+ucs_status_t ucp_dt_create_strided(size_t elem_size, size_t count, size_t stride,
+                                   ucp_datatype_t *datatype_p)
+{
+    return ucp_dt_create_vector(ucp_dt_make_contig(elem_size), count, stride,
+                                datatype_p);
+}
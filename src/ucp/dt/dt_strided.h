@@ -0,0 +1,126 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+
+#ifndef UCP_DT_STRIDED_H_
+#define UCP_DT_STRIDED_H_
+
+#include <ucp/api/ucp.h>
+#include <uct/api/uct.h>
+#include <ucs/sys/math.h>
+
+
+/* Maximal nesting level of a strided datatype */
+#define UCP_DT_STRIDED_MAX_DIMS   4
+
+
+#define UCP_DT_IS_STRIDED(_datatype) \
+    (((_datatype) & UCP_DATATYPE_CLASS_MASK) == UCP_DATATYPE_STRIDED)
+
+
+/**
+ * Strided datatype structure.
+ *
+ * A datatype item consists of elem_count contiguous blocks of elem_size bytes.
+ * The position of a block is defined by its index in every dimension, and
+ * dims[0] is the innermost (fastest changing) dimension. Consecutive datatype
+ * items are placed extent bytes apart.
+ */
+typedef struct ucp_dt_strided {
+    size_t                   elem_size;   /* Size of a contiguous block */
+    size_t                   elem_count;  /* Number of blocks in an item */
+    size_t                   extent;      /* Distance between consecutive items */
+    unsigned                 num_dims;    /* Number of valid entries in dims[] */
+    struct {
+        size_t               count;       /* Number of entries in the dimension */
+        size_t               stride;      /* Distance between the entries */
+    } dims[UCP_DT_STRIDED_MAX_DIMS];
+} ucp_dt_strided_t;
+
+
+static inline ucp_dt_strided_t* ucp_dt_strided(ucp_datatype_t datatype)
+{
+    return (ucp_dt_strided_t*)(void*)(datatype & ~UCP_DATATYPE_CLASS_MASK);
+}
+
+
+/**
+ * Get the packed length of @a count items of a strided datatype
+ */
+static inline size_t ucp_dt_strided_length(const ucp_dt_strided_t *dt,
+                                           size_t count)
+{
+    return count * dt->elem_count * dt->elem_size;
+}
+
+
+/**
+ * Get the size of the buffer region which holds @a length bytes of packed data
+ */
+static inline size_t ucp_dt_strided_span(const ucp_dt_strided_t *dt,
+                                         size_t length)
+{
+    return ucs_div_round_up(length, dt->elem_count * dt->elem_size) *
+           dt->extent;
+}
+
+
+/**
+ * Get the number of contiguous blocks which overlap with the packed data range
+ * [@a offset, @a offset + @a length).
+ */
+static inline size_t ucp_dt_strided_block_count(const ucp_dt_strided_t *dt,
+                                                size_t offset, size_t length)
+{
+    if (length == 0) {
+        return 0;
+    }
+
+    return ((offset + length - 1) / dt->elem_size) -
+           (offset / dt->elem_size) + 1;
+}
+
+
+/**
+ * Copy packed data range [@a offset, @a offset + @a length) from strided buffer
+ * @a src to contiguous buffer @a dest.
+ *
+ * @return Number of bytes copied, equal to @a length.
+ */
+size_t ucp_dt_strided_pack(const ucp_dt_strided_t *dt, void *dest,
+                           const void *src, size_t offset, size_t length);
+
+
+/**
+ * Copy contiguous buffer @a src to packed data range
+ * [@a offset, @a offset + @a length) of strided buffer @a dest.
+ */
+void ucp_dt_strided_unpack(const ucp_dt_strided_t *dt, void *dest,
+                           const void *src, size_t offset, size_t length);
+
+
+/**
+ * Describe the packed data range which starts at @a offset, and is at most
+ * @a length bytes long, by a list of uct_iov_t entries - one entry per
+ * contiguous block.
+ *
+ * @param [in]  dt         Strided datatype.
+ * @param [in]  buffer     User buffer.
+ * @param [in]  offset     Packed data offset to start from.
+ * @param [in]  length     Maximal length to describe.
+ * @param [in]  memh       Memory handle which covers the whole user buffer.
+ * @param [out] iov        Filled with the entries.
+ * @param [in]  max_iov    Maximal number of entries in @a iov.
+ * @param [out] iovcnt_p   Filled with the number of entries in @a iov.
+ *
+ * @return Number of bytes described by @a iov.
+ */
+size_t ucp_dt_strided_to_uct_iov(const ucp_dt_strided_t *dt, void *buffer,
+                                 size_t offset, size_t length, uct_mem_h memh,
+                                 uct_iov_t *iov, size_t max_iov,
+                                 size_t *iovcnt_p);
+
+#endif /* UCP_DT_STRIDED_H_ */
@@ -7,6 +7,7 @@
 #include "proto.h"
 #include "proto_am.inl"
 
+#include <ucp/tag/eager.h>
 #include <ucp/tag/offload.h>
 
 
@@ -15,11 +16,13 @@ static size_t ucp_proto_pack(void *dest, void *arg)
     ucp_request_t *req = arg;
     ucp_reply_hdr_t *rep_hdr;
     ucp_offload_ssend_hdr_t *off_rep_hdr;
+    ucp_eager_throttle_hdr_t *throttle_hdr;
 
     switch (req->send.proto.am_id) {
     case UCP_AM_ID_EAGER_SYNC_ACK:
     case UCP_AM_ID_RNDV_ATS:
     case UCP_AM_ID_RNDV_ATP:
+    case UCP_AM_ID_STREAM_NAK:
         rep_hdr = dest;
         rep_hdr->reqptr = req->send.proto.remote_request;
         rep_hdr->status = req->send.proto.status;
@@ -29,6 +32,11 @@ static size_t ucp_proto_pack(void *dest, void *arg)
         off_rep_hdr->sender_tag = req->send.proto.sender_tag;
         off_rep_hdr->ep_ptr     = ucp_request_get_dest_ep_ptr(req);
         return sizeof(*off_rep_hdr);
+    case UCP_AM_ID_EAGER_THROTTLE:
+    case UCP_AM_ID_EAGER_UNTHROTTLE:
+        throttle_hdr = dest;
+        throttle_hdr->ep_ptr = ucp_request_get_dest_ep_ptr(req);
+        return sizeof(*throttle_hdr);
     }
 
     ucs_bug("unexpected am_id");
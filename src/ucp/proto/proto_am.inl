@@ -112,6 +112,7 @@ void ucp_dt_iov_copy_uct(ucp_context_h context, uct_iov_t *iov, size_t *iovcnt,
     size_t iov_offset, max_src_iov, src_it, dst_it;
     size_t length_it = 0;
     ucp_md_index_t memh_index;
+    uct_mem_h memh;
 
     switch (datatype & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
@@ -164,6 +165,18 @@ void ucp_dt_iov_copy_uct(ucp_context_h context, uct_iov_t *iov, size_t *iovcnt,
         state->dt.iov.iovcnt_offset = src_it;
         *iovcnt                     = dst_it;
         break;
+    case UCP_DATATYPE_STRIDED:
+        if (context->tl_mds[md_index].attr.cap.flags & UCT_MD_FLAG_REG) {
+            memh_index = ucs_bitmap2idx(state->dt.strided.md_map, md_index);
+            memh       = state->dt.strided.memh[memh_index];
+        } else {
+            memh       = UCT_MEM_HANDLE_NULL;
+        }
+        length_it = ucp_dt_strided_to_uct_iov(ucp_dt_strided(datatype),
+                                              (void*)src_iov, state->offset,
+                                              length_max, memh, iov,
+                                              max_dst_iov, iovcnt);
+        break;
     default:
         ucs_error("Invalid data type");
     }
@@ -193,12 +206,11 @@ ucs_status_t ucp_do_am_zcopy_single(uct_pending_req_t *self, uint8_t am_id,
     status = uct_ep_am_zcopy(ep->uct_eps[req->send.lane], am_id, (void*)hdr,
                              hdr_size, iov, iovcnt, 0,
                              &req->send.state.uct_comp);
+    ucp_request_send_state_advance(req, &state,
+                                   UCP_REQUEST_SEND_PROTO_ZCOPY_AM,
+                                   status);
     if (status == UCS_OK) {
         complete(req, UCS_OK);
-    } else {
-        ucp_request_send_state_advance(req, &state,
-                                       UCP_REQUEST_SEND_PROTO_ZCOPY_AM,
-                                       status);
     }
     return UCS_STATUS_IS_ERR(status) ? status : UCS_OK;
 }
@@ -232,8 +244,9 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
             req->send.lane = ucp_ep_get_am_lane(ep);
         }
     } else {
-        ucs_assert(UCP_DT_IS_IOV(req->send.datatype));
-        /* disable multilane for IOV datatype.
+        ucs_assert(UCP_DT_IS_IOV(req->send.datatype) ||
+                   UCP_DT_IS_STRIDED(req->send.datatype));
+        /* disable multilane for IOV and strided datatypes.
          * TODO: add IOV processing for multilane */
         req->send.lane = ucp_ep_get_am_lane(ep);
     }
@@ -252,6 +265,10 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
             /* This flag should guarantee middle stage usage if iovcnt exceeded */
             flag_iov_mid = ((state.dt.iov.iovcnt_offset + max_iov) <
                             state.dt.iov.iovcnt);
+        } else if (UCP_DT_IS_STRIDED(req->send.datatype)) {
+            flag_iov_mid = ucp_dt_strided_block_count(
+                               ucp_dt_strided(req->send.datatype), offset,
+                               req->send.length - offset) > max_iov;
         } else {
             ucs_assert(UCP_DT_IS_CONTIG(req->send.datatype));
         }
@@ -302,13 +319,13 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
 
             if (!flag_iov_mid && (offset + mid_len == req->send.length)) {
                 /* Last stage */
+                ucp_request_send_state_advance(req, &state,
+                                               UCP_REQUEST_SEND_PROTO_ZCOPY_AM,
+                                               status);
                 if (status == UCS_OK) {
                     complete(req, UCS_OK);
                     return UCS_OK;
                 }
-                ucp_request_send_state_advance(req, &state,
-                                               UCP_REQUEST_SEND_PROTO_ZCOPY_AM,
-                                               status);
                 if (!UCS_STATUS_IS_ERR(status)) {
                     return UCS_OK;
                 }
@@ -355,7 +372,13 @@ ucp_proto_get_zcopy_threshold(const ucp_request_t *req,
 
     if (ucs_likely(UCP_DT_IS_CONTIG(req->send.datatype))) {
         return ucs_min(max_zcopy, msg_config->zcopy_thresh[0]);
-    } else if (UCP_DT_IS_IOV(req->send.datatype)) {
+    } else if (UCP_DT_IS_IOV(req->send.datatype) ||
+               UCP_DT_IS_STRIDED(req->send.datatype)) {
+        if (UCP_DT_IS_STRIDED(req->send.datatype)) {
+            /* every contiguous block is sent as a separate iov entry */
+            count *= ucp_dt_strided(req->send.datatype)->elem_count;
+        }
+
         if (0 == count) {
             /* disable zcopy */
             zcopy_thresh = max_zcopy;
@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "proto_tune.h"
+
+#include <ucp/core/ucp_worker.h>
+#include <ucp/core/ucp_request.h>
+#include <ucs/arch/bitops.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/math.h>
+#include <ucs/time/time.h>
+
+
+/* Every N-th send close to the threshold uses the alternative protocol */
+#define UCP_PROTO_TUNE_EXPLORE_INTERVAL  8
+
+/* Minimal number of samples of each protocol in a bucket to compare them */
+#define UCP_PROTO_TUNE_MIN_SAMPLES       8
+
+/* Weight of a new sample in the average cost is 1/2^N */
+#define UCP_PROTO_TUNE_AVG_SHIFT         3
+
+/* A protocol must be faster by this fraction to move the threshold */
+#define UCP_PROTO_TUNE_MARGIN            0.1
+
+/* The threshold is tuned within this factor of its initial value */
+#define UCP_PROTO_TUNE_MAX_SHIFT         4
+
+/* Largest threshold which can be tuned */
+#define UCP_PROTO_TUNE_MAX_THRESH        UCS_BIT(40)
+
+
+#if ENABLE_STATS
+static ucs_stats_class_t ucp_proto_tune_stats_class = {
+    .name           = "proto_tune",
+    .num_counters   = UCP_PROTO_TUNE_STAT_LAST,
+    .counter_names  = {
+        [UCP_PROTO_TUNE_STAT_SAMPLES]      = "samples",
+        [UCP_PROTO_TUNE_STAT_EXPLORE]      = "explore",
+        [UCP_PROTO_TUNE_STAT_UPDATES]      = "updates",
+        [UCP_PROTO_TUNE_STAT_ZCOPY_THRESH] = "zcopy_thresh"
+    }
+};
+#endif
+
+
+ucs_status_t ucp_proto_tune_create(ucp_worker_h worker,
+                                   const ucp_ep_config_t *config,
+                                   unsigned cfg_index,
+                                   ucp_proto_tune_t **tune_p)
+{
+    ucp_context_h context = worker->context;
+    size_t thresh         = config->tag.eager.zcopy_thresh[0];
+    ucp_proto_tune_t *tune;
+    ucs_status_t status;
+
+    /* A threshold which was set by the user is not tuned */
+    if ((context->config.ext.zcopy_thresh != UCS_CONFIG_MEMUNITS_AUTO) ||
+        (config->tag.eager.max_zcopy == 0) || (thresh == 0) ||
+        (thresh > UCP_PROTO_TUNE_MAX_THRESH)) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    tune = ucs_calloc(1, sizeof(*tune), "ucp_proto_tune");
+    if (tune == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    thresh              = ucs_roundup_pow2(thresh);
+    tune->zcopy.thresh  = thresh;
+    tune->zcopy.min     = ucs_max(thresh >> UCP_PROTO_TUNE_MAX_SHIFT, 1);
+    tune->zcopy.max     = thresh << UCP_PROTO_TUNE_MAX_SHIFT;
+    tune->interval      = ucs_max(context->config.ext.adaptive_thresh_interval, 1);
+    tune->update_count  = tune->interval;
+    tune->explore_count = UCP_PROTO_TUNE_EXPLORE_INTERVAL;
+
+    status = UCS_STATS_NODE_ALLOC(&tune->stats, &ucp_proto_tune_stats_class,
+                                  worker->stats, "-%u", cfg_index);
+    if (status != UCS_OK) {
+        ucs_free(tune);
+        return status;
+    }
+
+    UCS_STATS_SET_COUNTER(tune->stats, UCP_PROTO_TUNE_STAT_ZCOPY_THRESH,
+                          tune->zcopy.thresh);
+    *tune_p = tune;
+    return UCS_OK;
+}
+
+void ucp_proto_tune_destroy(ucp_proto_tune_t *tune)
+{
+    UCS_STATS_NODE_FREE(tune->stats);
+    ucs_free(tune);
+}
+
+void ucp_proto_tune_start(ucp_proto_tune_t *tune, ucp_request_t *req,
+                          ssize_t max_short, size_t rndv_thresh,
+                          size_t *zcopy_thresh)
+{
+    size_t length = req->send.length;
+    size_t thresh = tune->zcopy.thresh;
+    int proto;
+
+    if (!UCP_DT_IS_CONTIG(req->send.datatype) ||
+        !UCP_MEM_IS_HOST(req->send.mem_type) ||
+        (req->flags & UCP_REQUEST_FLAG_SYNC) ||
+        ((ssize_t)length <= max_short) || (length >= rndv_thresh)) {
+        return;
+    }
+
+    proto = (length >= thresh) ? UCP_PROTO_TUNE_ZCOPY : UCP_PROTO_TUNE_BCOPY;
+    if (--tune->explore_count == 0) {
+        if ((length >= (thresh / 2)) && (length < (thresh * 2))) {
+            /* use the protocol on the other side of the threshold */
+            tune->explore_count = UCP_PROTO_TUNE_EXPLORE_INTERVAL;
+            proto               = (proto == UCP_PROTO_TUNE_BCOPY) ?
+                                  UCP_PROTO_TUNE_ZCOPY : UCP_PROTO_TUNE_BCOPY;
+            UCS_STATS_UPDATE_COUNTER(tune->stats, UCP_PROTO_TUNE_STAT_EXPLORE,
+                                     1);
+        } else {
+            /* explore the next message close to the threshold */
+            tune->explore_count = 1;
+        }
+    }
+
+    *zcopy_thresh          = (proto == UCP_PROTO_TUNE_ZCOPY) ? 0 : SIZE_MAX;
+    req->flags            |= UCP_REQUEST_FLAG_PROTO_TUNE;
+    req->send.tune.proto   = proto;
+    req->send.tune.cfg_idx = req->send.ep->cfg_index;
+    req->send.tune.start   = ucs_get_time();
+}
+
+/* Get the cost of bcopy and zcopy in a bucket. Return 0 if there are not
+ * enough samples to compare them. */
+static int ucp_proto_tune_compare(const ucp_proto_tune_bucket_t *bucket,
+                                  double *bcopy_cost, double *zcopy_cost)
+{
+    if ((bucket->count[UCP_PROTO_TUNE_BCOPY] < UCP_PROTO_TUNE_MIN_SAMPLES) ||
+        (bucket->count[UCP_PROTO_TUNE_ZCOPY] < UCP_PROTO_TUNE_MIN_SAMPLES)) {
+        return 0;
+    }
+
+    *bcopy_cost = bucket->cost[UCP_PROTO_TUNE_BCOPY];
+    *zcopy_cost = bucket->cost[UCP_PROTO_TUNE_ZCOPY];
+    return 1;
+}
+
+static void ucp_proto_tune_update(ucp_proto_tune_t *tune)
+{
+    size_t thresh     = tune->zcopy.thresh;
+    size_t new_thresh = thresh;
+    unsigned bucket   = ucs_ilog2(thresh);
+    double bcopy_cost, zcopy_cost;
+
+    /* messages in [thresh/2, thresh) use bcopy */
+    if ((bucket > 0) &&
+        ucp_proto_tune_compare(&tune->buckets[bucket - 1], &bcopy_cost,
+                               &zcopy_cost) &&
+        (zcopy_cost < (bcopy_cost * (1.0 - UCP_PROTO_TUNE_MARGIN))) &&
+        (thresh / 2 >= tune->zcopy.min)) {
+        new_thresh = thresh / 2;
+    /* messages in [thresh, thresh*2) use zcopy */
+    } else if (ucp_proto_tune_compare(&tune->buckets[bucket], &bcopy_cost,
+                                      &zcopy_cost) &&
+               (bcopy_cost < (zcopy_cost * (1.0 - UCP_PROTO_TUNE_MARGIN))) &&
+               (thresh * 2 <= tune->zcopy.max)) {
+        new_thresh = thresh * 2;
+    }
+
+    if (new_thresh != thresh) {
+        ucs_debug("proto_tune %p: zcopy threshold %zu -> %zu", tune, thresh,
+                  new_thresh);
+        tune->zcopy.thresh = new_thresh;
+        UCS_STATS_UPDATE_COUNTER(tune->stats, UCP_PROTO_TUNE_STAT_UPDATES, 1);
+        UCS_STATS_SET_COUNTER(tune->stats, UCP_PROTO_TUNE_STAT_ZCOPY_THRESH,
+                              new_thresh);
+    }
+}
+
+void ucp_proto_tune_complete(ucp_request_t *req, ucs_status_t status)
+{
+    ucp_worker_h worker = req->send.ep->worker;
+    unsigned proto      = req->send.tune.proto;
+    ucp_proto_tune_bucket_t *bucket;
+    ucp_proto_tune_t *tune;
+    double cost;
+
+    req->flags &= ~UCP_REQUEST_FLAG_PROTO_TUNE;
+    tune        = worker->ep_config[req->send.tune.cfg_idx].tag.tune;
+    if ((status != UCS_OK) || (tune == NULL)) {
+        return;
+    }
+
+    cost   = (double)(ucs_get_time() - req->send.tune.start) /
+             req->send.length;
+    bucket = &tune->buckets[ucs_ilog2(req->send.length)];
+    if (bucket->count[proto]++ == 0) {
+        bucket->cost[proto]  = cost;
+    } else {
+        bucket->cost[proto] += (cost - bucket->cost[proto]) /
+                               UCS_BIT(UCP_PROTO_TUNE_AVG_SHIFT);
+    }
+
+    UCS_STATS_UPDATE_COUNTER(tune->stats, UCP_PROTO_TUNE_STAT_SAMPLES, 1);
+    if (--tune->update_count == 0) {
+        tune->update_count = tune->interval;
+        ucp_proto_tune_update(tune);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_PROTO_TUNE_H_
+#define UCP_PROTO_TUNE_H_
+
+#include <ucp/core/ucp_ep.h>
+#include <ucs/stats/stats.h>
+#include <ucs/time/time_def.h>
+#include <stdio.h>
+
+
+/* Number of message size buckets, a bucket holds sizes [2^i, 2^(i+1)) */
+#define UCP_PROTO_TUNE_NUM_BUCKETS   64
+
+
+/**
+ * Protocols which are compared by the tuner. Both complete when the send
+ * buffer may be reused, without waiting for the receiver, so their completion
+ * times are comparable. Rendezvous completes only after the receiver fetched
+ * the data, so its threshold is not tuned.
+ */
+enum {
+    UCP_PROTO_TUNE_BCOPY,
+    UCP_PROTO_TUNE_ZCOPY,
+    UCP_PROTO_TUNE_LAST
+};
+
+
+/**
+ * Tuner statistics counters
+ */
+enum {
+    UCP_PROTO_TUNE_STAT_SAMPLES,      /* Measured send operations */
+    UCP_PROTO_TUNE_STAT_EXPLORE,      /* Sends with the alternative protocol */
+    UCP_PROTO_TUNE_STAT_UPDATES,      /* Threshold changes */
+    UCP_PROTO_TUNE_STAT_ZCOPY_THRESH, /* Current zcopy threshold */
+    UCP_PROTO_TUNE_STAT_LAST
+};
+
+
+/**
+ * Measured cost of the protocols for a range of message sizes
+ */
+typedef struct {
+    double                   cost[UCP_PROTO_TUNE_LAST];  /* Average completion
+                                                            time per byte */
+    uint32_t                 count[UCP_PROTO_TUNE_LAST]; /* Number of samples */
+} ucp_proto_tune_bucket_t;
+
+
+/**
+ * Runtime tuner of the tag send zero copy threshold, per endpoint
+ * configuration. Messages close to the threshold are occasionally sent by the
+ * protocol on the other side of it, and the threshold is moved by a factor of
+ * 2 when the other protocol completes faster.
+ */
+struct ucp_proto_tune {
+    struct {
+        size_t               thresh;      /* Current threshold, power of 2 */
+        size_t               min;         /* Lowest allowed threshold */
+        size_t               max;         /* Highest allowed threshold */
+    } zcopy;
+    unsigned                 explore_count; /* Sends until the next exploration */
+    unsigned                 update_count;  /* Samples until the next update */
+    unsigned                 interval;      /* Samples between updates */
+    ucp_proto_tune_bucket_t  buckets[UCP_PROTO_TUNE_NUM_BUCKETS];
+    UCS_STATS_NODE_DECLARE(stats);
+};
+
+
+ucs_status_t ucp_proto_tune_create(ucp_worker_h worker,
+                                   const ucp_ep_config_t *config,
+                                   unsigned cfg_index,
+                                   ucp_proto_tune_t **tune_p);
+
+void ucp_proto_tune_destroy(ucp_proto_tune_t *tune);
+
+
+/**
+ * Select the protocol of an eager tag send request, and start measuring it.
+ *
+ * @param [in]    tune          Tuner of the endpoint configuration.
+ * @param [in]    req           Send request.
+ * @param [in]    max_short     Maximal message size sent by the short protocol.
+ * @param [in]    rndv_thresh   Rendezvous threshold for the request.
+ * @param [inout] zcopy_thresh  Filled with zcopy threshold for the request.
+ */
+void ucp_proto_tune_start(ucp_proto_tune_t *tune, ucp_request_t *req,
+                          ssize_t max_short, size_t rndv_thresh,
+                          size_t *zcopy_thresh);
+
+
+/**
+ * Account the completion time of a request started by @ref ucp_proto_tune_start.
+ */
+void ucp_proto_tune_complete(ucp_request_t *req, ucs_status_t status);
+
+#endif
@@ -10,6 +10,7 @@
 #include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_request.inl>
 #include <ucp/stream/stream.h>
+#include <ucp/tag/rndv.h>
 
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/profile/profile.h>
@@ -87,6 +88,32 @@ ucp_stream_rdesc_get(ucp_ep_ext_proto_t *ep_ext)
     return rdesc;
 }
 
+static void ucp_stream_rndv_send_nak(ucp_ep_h ep,
+                                     const ucp_rndv_rts_hdr_t *rts_hdr)
+{
+    ucp_request_t *req;
+
+    req = ucp_request_get(ep->worker);
+    if (req == NULL) {
+        ucs_error("failed to allocate stream rendezvous nak request");
+        return;
+    }
+
+    ucs_trace_req("ep %p: send stream rndv nak sreq 0x%lx", ep,
+                  rts_hdr->sreq.reqptr);
+
+    req->flags                     = 0;
+    req->send.ep                   = ep;
+    req->send.lane                 = ucp_ep_get_am_lane(ep);
+    req->send.uct.func             = ucp_proto_progress_am_bcopy_single;
+    req->send.proto.am_id          = UCP_AM_ID_STREAM_NAK;
+    req->send.proto.status         = UCS_OK;
+    req->send.proto.remote_request = rts_hdr->sreq.reqptr;
+    req->send.proto.comp_cb        = ucp_request_put;
+
+    ucp_request_send(req, 0);
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
 ucp_stream_recv_data_nb_nolock(ucp_ep_h ep, size_t *length)
 {
@@ -242,6 +269,7 @@ ucp_stream_recv_request_init(ucp_request_t *req, ucp_ep_h ep, void *buffer,
     req->recv.stream.cb     = cb;
     req->recv.stream.length = 0;
     req->recv.stream.offset = 0;
+    req->recv.stream.rndv_count = 0;
 
     ucp_dt_recv_state_init(&req->recv.state, buffer, datatype, count);
 
@@ -254,6 +282,95 @@ ucp_stream_recv_request_init(ucp_request_t *req, ucp_ep_h ep, void *buffer,
                                req->recv.length, &req->recv.mem_type);
 }
 
+static UCS_F_ALWAYS_INLINE int
+ucp_stream_recv_is_head(ucp_ep_ext_proto_t *ep_ext, ucp_request_t *req)
+{
+    return !ucp_stream_ep_has_data(ep_ext) &&
+           !ucs_queue_is_empty(&ep_ext->stream.match_q) &&
+           (ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
+                                          ucp_request_t, recv.queue) == req);
+}
+
+static void ucp_stream_rndv_recv_completion(void *request, ucs_status_t status,
+                                            ucp_tag_recv_info_t *info)
+{
+    ucp_request_t *rreq        = (ucp_request_t*)request - 1;
+    ucp_request_t *req         = rreq->recv.tag.stream.req;
+    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(rreq->recv.tag.stream.ep);
+
+    ucs_assert(req->recv.stream.rndv_count > 0);
+    if (--req->recv.stream.rndv_count > 0) {
+        return;
+    }
+
+    if (ucp_stream_recv_is_head(ep_ext, req)) {
+        if ((status != UCS_OK) || ucp_request_can_complete_stream_recv(req)) {
+            ucp_request_complete_stream_recv(req, ep_ext, status);
+        }
+    } else {
+        /* The request was filled and dequeued while the data was in flight */
+        req->recv.stream.length = req->recv.stream.offset;
+        ucs_trace_req("completing stream receive request %p (%p) count %zu, %s",
+                      req, req + 1, req->recv.stream.length,
+                      ucs_status_string(status));
+        ucp_request_complete(req, recv.stream.cb, status,
+                             req->recv.stream.length);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE int
+ucp_stream_rndv_fits(const ucp_request_t *req, const ucp_rndv_rts_hdr_t *rts_hdr)
+{
+    return UCP_DT_IS_CONTIG(req->recv.datatype) &&
+           UCP_MEM_IS_HOST(req->recv.mem_type) &&
+           ((req->recv.length - req->recv.stream.offset) >= rts_hdr->size);
+}
+
+/*
+ * Receive the rendezvous data directly to the user buffer of a stream receive
+ * request, after the data it has already received.
+ */
+static ucs_status_t ucp_stream_rndv_matched(ucp_ep_h ep, ucp_request_t *req,
+                                            const ucp_rndv_rts_hdr_t *rts_hdr)
+{
+    ucp_worker_h worker = ep->worker;
+    ucp_request_t *rreq;
+
+    ucs_assert(ucp_stream_rndv_fits(req, rts_hdr));
+
+    rreq = ucp_request_get(worker);
+    if (rreq == NULL) {
+        ucs_error("failed to allocate stream rendezvous request");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    rreq->flags                = UCP_REQUEST_FLAG_RECV |
+                                 UCP_REQUEST_FLAG_CALLBACK |
+                                 UCP_REQUEST_FLAG_RELEASED;
+    rreq->status               = UCS_OK;
+    rreq->recv.worker          = worker;
+    rreq->recv.buffer          = UCS_PTR_BYTE_OFFSET(req->recv.buffer,
+                                                     req->recv.stream.offset);
+    rreq->recv.datatype        = ucp_dt_make_contig(1);
+    rreq->recv.length          = rts_hdr->size;
+    rreq->recv.mem_type        = req->recv.mem_type;
+    rreq->recv.tag.cb          = ucp_stream_rndv_recv_completion;
+    rreq->recv.tag.stream.ep   = ep;
+    rreq->recv.tag.stream.req  = req;
+    ucp_dt_recv_state_init(&rreq->recv.state, rreq->recv.buffer,
+                           rreq->recv.datatype, rts_hdr->size);
+
+    ucs_trace_req("ep %p: stream rndv %zu bytes to request %p offset %zu",
+                  ep, rts_hdr->size, req, req->recv.stream.offset);
+
+    /* Reserve the space, so data which arrives later is placed after it */
+    req->recv.stream.offset += rts_hdr->size;
+    ++req->recv.stream.rndv_count;
+
+    ucp_rndv_matched(worker, rreq, rts_hdr);
+    return UCS_OK;
+}
+
 static UCS_F_ALWAYS_INLINE int
 ucp_stream_recv_nb_is_inplace(ucp_ep_ext_proto_t *ep_ext, size_t dt_length)
 {
@@ -377,6 +494,11 @@ ucp_stream_am_data_process(ucp_worker_t *worker, ucp_ep_ext_proto_t *ep_ext,
             }
             ucp_stream_rdesc_advance(&rdesc_tmp, unpacked, ep_ext);
             /* This request is full, try next one */
+            if (ucs_unlikely(req->recv.stream.rndv_count > 0)) {
+                /* Completed when the rendezvous data arrives */
+                ucs_queue_pull_non_empty(&ep_ext->stream.match_q);
+                continue;
+            }
             ucs_assert(ucp_request_can_complete_stream_recv(req));
             ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
         }
@@ -419,22 +541,32 @@ void ucp_stream_ep_init(ucp_ep_h ep)
         ep_ext->stream.ready_list.prev = NULL;
         ep_ext->stream.ready_list.next = NULL;
         ucs_queue_head_init(&ep_ext->stream.match_q);
+        ucs_queue_head_init(&ep_ext->stream.send_q);
     }
 }
 
 void ucp_stream_ep_cleanup(ucp_ep_h ep)
 {
+    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
+    ucp_request_t *req;
     size_t length;
     void *data;
 
     if (ep->worker->context->config.features & UCP_FEATURE_STREAM) {
+        while (!ucs_queue_is_empty(&ep_ext->stream.send_q)) {
+            req = ucs_queue_pull_elem_non_empty(&ep_ext->stream.send_q,
+                                                ucp_request_t,
+                                                send.stream.queue);
+            ucp_request_complete_send(req, UCS_ERR_CANCELED);
+        }
+
         while ((data = ucp_stream_recv_data_nb_nolock(ep, &length)) != NULL) {
             ucs_assert_always(!UCS_PTR_IS_ERR(data));
             ucp_stream_data_release(ep, data);
         }
 
-        if (ucp_stream_ep_is_queued(ucp_ep_ext_proto(ep))) {
-            ucp_stream_ep_dequeue(ucp_ep_ext_proto(ep));
+        if (ucp_stream_ep_is_queued(ep_ext)) {
+            ucp_stream_ep_dequeue(ep_ext);
         }
     }
 }
@@ -487,6 +619,55 @@ ucp_stream_am_handler(void *am_arg, void *am_data, size_t am_length,
     return (am_flags & UCT_CB_PARAM_FLAG_DESC) ? UCS_INPROGRESS : UCS_OK;
 }
 
+static ucs_status_t
+ucp_stream_rndv_rts_handler(void *am_arg, void *am_data, size_t am_length,
+                            unsigned am_flags)
+{
+    ucp_worker_h worker         = am_arg;
+    ucp_rndv_rts_hdr_t *rts_hdr = am_data;
+    ucp_ep_h ep;
+    ucp_ep_ext_proto_t *ep_ext;
+    ucp_request_t *req;
+
+    ep     = ucp_worker_get_ep_by_ptr(worker, rts_hdr->sreq.ep_ptr);
+    ep_ext = ucp_ep_ext_proto(ep);
+
+    if (ucs_unlikely(ep->flags & UCP_EP_FLAG_CLOSED)) {
+        ucs_trace_data("ep %p: stream is invalid", ep);
+        /* the data will be dropped */
+        ucp_stream_rndv_send_nak(ep, rts_hdr);
+        return UCS_OK;
+    }
+
+    /* Receive the data directly to a posted request if it has enough room.
+     * Otherwise the sender sends the data eagerly, so the send is not blocked
+     * until the user posts a receive. */
+    if (!ucp_stream_ep_has_data(ep_ext) &&
+        !ucs_queue_is_empty(&ep_ext->stream.match_q)) {
+        req = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
+                                            ucp_request_t, recv.queue);
+        if (ucp_stream_rndv_fits(req, rts_hdr) &&
+            (ucp_stream_rndv_matched(ep, req, rts_hdr) == UCS_OK)) {
+            return UCS_OK;
+        }
+    }
+
+    ucp_stream_rndv_send_nak(ep, rts_hdr);
+    return UCS_OK;
+}
+
+static void ucp_stream_rndv_rts_dump(ucp_worker_h worker,
+                                     uct_am_trace_type_t type, uint8_t id,
+                                     const void *data, size_t length,
+                                     char *buffer, size_t max)
+{
+    const ucp_rndv_rts_hdr_t *rts_hdr = data;
+
+    snprintf(buffer, max, "STREAM_RTS ep_ptr 0x%lx sreq 0x%lx address 0x%"
+             PRIx64" size %zu", rts_hdr->sreq.ep_ptr, rts_hdr->sreq.reqptr,
+             rts_hdr->address, rts_hdr->size);
+}
+
 static void ucp_stream_am_dump(ucp_worker_h worker, uct_am_trace_type_t type,
                                uint8_t id, const void *data, size_t length,
                                char *buffer, size_t max)
@@ -505,5 +686,8 @@ static void ucp_stream_am_dump(ucp_worker_h worker, uct_am_trace_type_t type,
 
 UCP_DEFINE_AM(UCP_FEATURE_STREAM, UCP_AM_ID_STREAM_DATA, ucp_stream_am_handler,
               ucp_stream_am_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_STREAM, UCP_AM_ID_STREAM_RTS,
+              ucp_stream_rndv_rts_handler, ucp_stream_rndv_rts_dump, 0);
 
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_STREAM_DATA);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_STREAM_RTS);
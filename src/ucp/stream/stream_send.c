@@ -11,6 +11,7 @@
 #include <ucp/proto/proto.h>
 #include <ucp/proto/proto_am.inl>
 #include <ucp/stream/stream.h>
+#include <ucp/tag/rndv.h>
 #include <ucp/dt/dt.h>
 #include <ucp/dt/dt.inl>
 
@@ -42,18 +43,77 @@ static void ucp_stream_send_req_init(ucp_request_t* req, ucp_ep_h ep,
     VALGRIND_MAKE_MEM_UNDEFINED(&req->send.tag, sizeof(req->send.tag));
 }
 
+static ucs_status_t ucp_stream_progress_rndv_rts(uct_pending_req_t *self)
+{
+    return ucp_do_am_bcopy_single(self, UCP_AM_ID_STREAM_RTS,
+                                  ucp_tag_rndv_rts_pack);
+}
+
+static ucs_status_t ucp_stream_send_start_rndv(ucp_request_t *req)
+{
+    ucp_ep_h ep = req->send.ep;
+    ucs_status_t status;
+
+    ucp_trace_req(req, "stream start_rndv to %s buffer %p length %zu",
+                  ucp_ep_peer_name(ep), req->send.buffer, req->send.length);
+
+    status = ucp_rndv_send_buffer_reg(req);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    /* Stream data is not matched, the tag of the RTS is not used. Following
+     * sends are queued until the rendezvous completes, to keep the stream
+     * order in case the receiver asks to send the data eagerly. */
+    req->send.tag.tag   = 0;
+    req->send.uct.func  = ucp_stream_progress_rndv_rts;
+    req->flags         |= UCP_REQUEST_FLAG_STREAM_RNDV;
+    ep->flags          |= UCP_EP_FLAG_STREAM_RNDV;
+    UCP_EP_STAT_TAG_OP(ep, RNDV);
+    return UCS_OK;
+}
+
+static UCS_F_ALWAYS_INLINE size_t
+ucp_stream_send_rndv_thresh(const ucp_request_t *req)
+{
+    /* The receiver fetches rendezvous data directly to the user buffer, which
+     * is worth only for a contiguous host memory send buffer */
+    if (UCP_DT_IS_CONTIG(req->send.datatype) &&
+        UCP_MEM_IS_HOST(req->send.mem_type)) {
+        return ucp_ep_config(req->send.ep)->stream.rndv_thresh;
+    }
+
+    return SIZE_MAX;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_stream_send_req_start(ucp_request_t *req, size_t count, size_t rndv_thresh)
+{
+    const ucp_ep_config_t *config = ucp_ep_config(req->send.ep);
+    size_t zcopy_thresh           = ucp_proto_get_zcopy_threshold(req,
+                                                                  &config->am,
+                                                                  count,
+                                                                  rndv_thresh);
+    ssize_t max_short             = ucp_proto_get_short_max(req, &config->am);
+    ucs_status_t status;
+
+    status = ucp_request_send_start(req, max_short, zcopy_thresh, rndv_thresh,
+                                    count, &config->am, config->stream.proto);
+    if (ucs_likely(status != UCS_ERR_NO_PROGRESS)) {
+        return status;
+    }
+
+    ucs_assert(req->send.length >= rndv_thresh);
+    return ucp_stream_send_start_rndv(req);
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
-ucp_stream_send_req(ucp_request_t *req, size_t count,
-                    const ucp_ep_msg_config_t* msg_config,
-                    ucp_send_callback_t cb, const ucp_proto_t *proto)
+ucp_stream_send_req(ucp_request_t *req, size_t count, ucp_send_callback_t cb)
 {
-    size_t zcopy_thresh = ucp_proto_get_zcopy_threshold(req, msg_config,
-                                                        count, SIZE_MAX);
-    ssize_t max_short   = ucp_proto_get_short_max(req, msg_config);
+    ucs_status_t status;
 
-    ucs_status_t status = ucp_request_send_start(req, max_short, zcopy_thresh,
-                                                 SIZE_MAX, count, msg_config,
-                                                 proto);
+    status = ucp_stream_send_req_start(req, count,
+                                       ucp_stream_send_rndv_thresh(req));
     if (status != UCS_OK) {
         return UCS_STATUS_PTR(status);
     }
@@ -76,6 +136,41 @@ ucp_stream_send_req(ucp_request_t *req, size_t count,
     return req + 1;
 }
 
+static void ucp_stream_send_req_restart(ucp_request_t *req, size_t count,
+                                        size_t rndv_thresh)
+{
+    ucs_status_t status;
+
+    status = ucp_stream_send_req_start(req, count, rndv_thresh);
+    if (status == UCS_OK) {
+        ucp_request_send(req, 0);
+    } else {
+        ucp_request_complete_send(req, status);
+    }
+}
+
+void ucp_stream_send_rndv_complete(ucp_request_t *req, ucs_status_t status)
+{
+    ucp_ep_h ep                = req->send.ep;
+    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
+    ucp_request_t *qreq;
+
+    ucs_assert(ep->flags & UCP_EP_FLAG_STREAM_RNDV);
+    ucp_request_complete(req, send.cb, status);
+
+    /* Start the queued sends in order, until one of them selects rendezvous
+     * again */
+    ep->flags &= ~UCP_EP_FLAG_STREAM_RNDV;
+    while (!(ep->flags & UCP_EP_FLAG_STREAM_RNDV) &&
+           !ucs_queue_is_empty(&ep_ext->stream.send_q)) {
+        qreq = ucs_queue_pull_elem_non_empty(&ep_ext->stream.send_q,
+                                             ucp_request_t, send.stream.queue);
+        ucs_trace_req("starting queued stream send request %p", qreq);
+        ucp_stream_send_req_restart(qreq, qreq->send.stream.count,
+                                    ucp_stream_send_rndv_thresh(qreq));
+    }
+}
+
 UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nb,
                  (ep, buffer, count, datatype, cb, flags),
                  ucp_ep_h ep, const void *buffer, size_t count,
@@ -104,7 +199,8 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nb,
         goto out;
     }
 
-    if (ucs_likely(UCP_DT_IS_CONTIG(datatype))) {
+    if (ucs_likely(UCP_DT_IS_CONTIG(datatype) &&
+                   !(ep->flags & UCP_EP_FLAG_STREAM_RNDV))) {
         length = ucp_contig_dt_length(datatype, count);
         if (ucs_likely((ssize_t)length <= ucp_ep_config(ep)->am.max_short)) {
             status = UCS_PROFILE_CALL(ucp_stream_send_am_short, ep, buffer,
@@ -125,8 +221,17 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nb,
 
     ucp_stream_send_req_init(req, ep, buffer, datatype, count, flags);
 
-    ret = ucp_stream_send_req(req, count, &ucp_ep_config(ep)->am, cb,
-                              ucp_ep_config(ep)->stream.proto);
+    if (ucs_unlikely(ep->flags & UCP_EP_FLAG_STREAM_RNDV)) {
+        /* Wait for the rendezvous send, it may fall back to eager protocol */
+        req->send.stream.count = count;
+        ucp_request_set_callback(req, send.cb, cb);
+        ucs_queue_push(&ucp_ep_ext_proto(ep)->stream.send_q,
+                       &req->send.stream.queue);
+        ucs_trace_req("queued stream send request %p", req);
+        ret = req + 1;
+    } else {
+        ret = ucp_stream_send_req(req, count, cb);
+    }
 
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
@@ -157,7 +262,8 @@ static size_t ucp_stream_pack_am_single_dt(void *dest, void *arg)
 
     length = ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                          req->send.mem_type, hdr + 1, req->send.buffer,
-                         &req->send.state.dt, req->send.length);
+                         &req->send.state.dt, req->send.length,
+                         req->send.length);
     ucs_assert(length == req->send.length);
     return sizeof(*hdr) + length;
 }
@@ -189,7 +295,8 @@ static size_t ucp_stream_pack_am_first_dt(void *dest, void *arg)
     ucs_assert(req->send.length > length);
     return sizeof(*hdr) + ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                       req->send.mem_type, hdr + 1, req->send.buffer,
-                                      &req->send.state.dt, length);
+                                      &req->send.state.dt, length,
+                                      req->send.length);
 }
 
 static size_t ucp_stream_pack_am_middle_dt(void *dest, void *arg)
@@ -203,7 +310,8 @@ static size_t ucp_stream_pack_am_middle_dt(void *dest, void *arg)
                           req->send.length - req->send.state.dt.offset);
     return sizeof(*hdr) + ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                       req->send.mem_type, hdr + 1, req->send.buffer,
-                                      &req->send.state.dt, length);
+                                      &req->send.state.dt, length,
+                                      req->send.length);
 }
 
 static ucs_status_t ucp_stream_bcopy_multi(uct_pending_req_t *self)
@@ -258,3 +366,39 @@ const ucp_proto_t ucp_stream_am_proto = {
     .first_hdr_size          = sizeof(ucp_stream_am_hdr_t),
     .mid_hdr_size            = sizeof(ucp_stream_am_hdr_t)
 };
+
+static ucs_status_t
+ucp_stream_rndv_nak_handler(void *arg, void *data, size_t length,
+                            unsigned flags)
+{
+    ucp_reply_hdr_t *rep_hdr = data;
+    ucp_request_t *sreq      = (ucp_request_t*)rep_hdr->reqptr;
+
+    ucs_assert(sreq->flags & UCP_REQUEST_FLAG_STREAM_RNDV);
+    ucp_trace_req(sreq, "stream rndv nak, sending %zu bytes eagerly",
+                  sreq->send.length);
+
+    /* The receiver has no buffer for the data, send it by eager protocol. The
+     * queued sends are started when this one completes. */
+    ucp_request_send_buffer_dereg(sreq);
+    ucp_stream_send_req_restart(sreq, sreq->send.length /
+                                ucp_contig_dt_elem_size(sreq->send.datatype),
+                                SIZE_MAX);
+    return UCS_OK;
+}
+
+static void ucp_stream_rndv_nak_dump(ucp_worker_h worker,
+                                     uct_am_trace_type_t type, uint8_t id,
+                                     const void *data, size_t length,
+                                     char *buffer, size_t max)
+{
+    const ucp_reply_hdr_t *rep_hdr = data;
+
+    snprintf(buffer, max, "STREAM_NAK sreq 0x%lx status '%s'",
+             rep_hdr->reqptr, ucs_status_string(rep_hdr->status));
+}
+
+UCP_DEFINE_AM(UCP_FEATURE_STREAM, UCP_AM_ID_STREAM_NAK,
+              ucp_stream_rndv_nak_handler, ucp_stream_rndv_nak_dump, 0);
+
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_STREAM_NAK);
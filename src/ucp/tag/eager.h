@@ -62,11 +62,21 @@ typedef struct {
 } UCS_S_PACKED ucp_eager_sync_first_hdr_t;
 
 
+/*
+ * EAGER_THROTTLE, EAGER_UNTHROTTLE
+ */
+typedef struct {
+    uintptr_t                 ep_ptr;     /* Endpoint on the sender side */
+} UCS_S_PACKED ucp_eager_throttle_hdr_t;
+
+
 extern const ucp_proto_t ucp_tag_eager_proto;
 extern const ucp_proto_t ucp_tag_eager_sync_proto;
 
 void ucp_tag_eager_sync_send_ack(ucp_worker_h worker, void *hdr, uint16_t recv_flags);
 
+void ucp_tag_eager_send_throttle(ucp_worker_h worker, int throttle);
+
 void ucp_tag_eager_sync_completion(ucp_request_t *req, uint16_t flag,
                                    ucs_status_t status);
 
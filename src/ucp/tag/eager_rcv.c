@@ -170,7 +170,8 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_middle_handler,
                                     sizeof(*hdr), UCP_RECV_DESC_FLAG_EAGER, 0,
                                     &rdesc);
         if (!UCS_STATUS_IS_ERR(status)) {
-            ucp_tag_frag_match_add_unexp(matchq, rdesc, hdr->offset);
+            ucp_tag_frag_match_add_unexp(&worker->tm, matchq, rdesc,
+                                         hdr->offset);
         }
     } else {
         /* hash entry contains a request, copy data to user buffer */
@@ -248,6 +249,30 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_sync_ack_handler,
     return UCS_OK;
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_throttle_handler,
+                 (arg, data, length, am_flags),
+                 void *arg, void *data, size_t length, unsigned am_flags)
+{
+    ucp_eager_throttle_hdr_t *hdr = data;
+    ucp_ep_h ep                   = ucp_worker_get_ep_by_ptr(arg, hdr->ep_ptr);
+
+    ucs_trace("ep %p: throttle eager tag sends", ep);
+    ep->flags |= UCP_EP_FLAG_TAG_THROTTLED;
+    return UCS_OK;
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_unthrottle_handler,
+                 (arg, data, length, am_flags),
+                 void *arg, void *data, size_t length, unsigned am_flags)
+{
+    ucp_eager_throttle_hdr_t *hdr = data;
+    ucp_ep_h ep                   = ucp_worker_get_ep_by_ptr(arg, hdr->ep_ptr);
+
+    ucs_trace("ep %p: unthrottle eager tag sends", ep);
+    ep->flags &= ~UCP_EP_FLAG_TAG_THROTTLED;
+    return UCS_OK;
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_tag_offload_unexp_eager,
                  (arg, data, length, tl_flags, stag, imm),
                  void *arg, void *data, size_t length, unsigned tl_flags,
@@ -301,6 +326,7 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
     const ucp_eager_sync_hdr_t *eagers_hdr       = data;
     const ucp_reply_hdr_t *rep_hdr               = data;
     const ucp_offload_ssend_hdr_t *off_rep_hdr   = data;
+    const ucp_eager_throttle_hdr_t *throttle_hdr = data;
     size_t header_len;
     char *p;
 
@@ -347,6 +373,14 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
                  off_rep_hdr->sender_tag, off_rep_hdr->ep_ptr);
         header_len = sizeof(*rep_hdr);
         break;
+    case UCP_AM_ID_EAGER_THROTTLE:
+        snprintf(buffer, max, "EGR_XOFF ep_ptr 0x%lx", throttle_hdr->ep_ptr);
+        header_len = sizeof(*throttle_hdr);
+        break;
+    case UCP_AM_ID_EAGER_UNTHROTTLE:
+        snprintf(buffer, max, "EGR_XON ep_ptr 0x%lx", throttle_hdr->ep_ptr);
+        header_len = sizeof(*throttle_hdr);
+        break;
     default:
         return;
     }
@@ -370,6 +404,10 @@ UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_SYNC_ACK,
               ucp_eager_sync_ack_handler, ucp_eager_dump, 0);
 UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_OFFLOAD_SYNC_ACK,
               ucp_eager_offload_sync_ack_handler, ucp_eager_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_THROTTLE,
+              ucp_eager_throttle_handler, ucp_eager_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_UNTHROTTLE,
+              ucp_eager_unthrottle_handler, ucp_eager_dump, 0);
 
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_ONLY);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_FIRST);
@@ -378,3 +416,5 @@ UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_ONLY);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_FIRST);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_ACK);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_OFFLOAD_SYNC_ACK);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_THROTTLE);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_UNTHROTTLE);
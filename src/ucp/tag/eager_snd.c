@@ -25,7 +25,8 @@ static size_t ucp_tag_pack_eager_only_dt(void *dest, void *arg)
     ucs_assert(req->send.state.dt.offset == 0);
     length = ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                          req->send.mem_type, hdr + 1, req->send.buffer,
-                         &req->send.state.dt, req->send.length);
+                         &req->send.state.dt, req->send.length,
+                         req->send.length);
     ucs_assert(length == req->send.length);
     return sizeof(*hdr) + length;
 }
@@ -43,7 +44,8 @@ static size_t ucp_tag_pack_eager_sync_only_dt(void *dest, void *arg)
     ucs_assert(req->send.state.dt.offset == 0);
     length = ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                          req->send.mem_type, hdr + 1, req->send.buffer,
-                         &req->send.state.dt, req->send.length);
+                         &req->send.state.dt, req->send.length,
+                         req->send.length);
     ucs_assert(length == req->send.length);
     return sizeof(*hdr) + length;
 }
@@ -66,7 +68,8 @@ static size_t ucp_tag_pack_eager_first_dt(void *dest, void *arg)
     ucs_assert(req->send.length > length);
     return sizeof(*hdr) + ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                       req->send.mem_type, hdr + 1, req->send.buffer,
-                                      &req->send.state.dt, length);
+                                      &req->send.state.dt, length,
+                                      req->send.length);
 }
 
 static size_t ucp_tag_pack_eager_sync_first_dt(void *dest, void *arg)
@@ -89,7 +92,8 @@ static size_t ucp_tag_pack_eager_sync_first_dt(void *dest, void *arg)
     ucs_assert(req->send.length > length);
     return sizeof(*hdr) + ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                       req->send.mem_type, hdr + 1, req->send.buffer,
-                                      &req->send.state.dt, length);
+                                      &req->send.state.dt, length,
+                                      req->send.length);
 }
 
 static size_t ucp_tag_pack_eager_middle_dt(void *dest, void *arg)
@@ -105,7 +109,8 @@ static size_t ucp_tag_pack_eager_middle_dt(void *dest, void *arg)
     hdr->offset     = req->send.state.dt.offset;
     return sizeof(*hdr) + ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                       req->send.mem_type, hdr + 1, req->send.buffer,
-                                      &req->send.state.dt, length);
+                                      &req->send.state.dt, length,
+                                      req->send.length);
 }
 
 /* eager */
@@ -355,3 +360,37 @@ void ucp_tag_eager_sync_send_ack(ucp_worker_h worker, void *hdr, uint16_t recv_f
 
     ucp_request_send(req, 0);
 }
+
+void ucp_tag_eager_send_throttle(ucp_worker_h worker, int throttle)
+{
+    ucp_ep_ext_gen_t *ep_ext;
+    ucp_request_t *req;
+    ucp_ep_h ep;
+
+    /* Eager headers do not identify the sender, so notify all peers */
+    ucs_list_for_each(ep_ext, &worker->all_eps, ep_list) {
+        ep = ucp_ep_from_ext_gen(ep_ext);
+        if ((ep->flags & (UCP_EP_FLAG_FAILED | UCP_EP_FLAG_CLOSED)) ||
+            (ucp_ep_get_am_lane(ep) == UCP_NULL_LANE) ||
+            (ucp_ep_resolve_dest_ep_ptr(ep, ucp_ep_get_am_lane(ep)) != UCS_OK)) {
+            continue;
+        }
+
+        req = ucp_request_get(worker);
+        if (req == NULL) {
+            ucs_error("could not allocate request to throttle ep %p", ep);
+            continue;
+        }
+
+        req->flags              = 0;
+        req->send.ep            = ep;
+        req->send.uct.func      = ucp_proto_progress_am_bcopy_single;
+        req->send.proto.comp_cb = ucp_request_put;
+        req->send.proto.status  = UCS_OK;
+        req->send.proto.am_id   = throttle ? UCP_AM_ID_EAGER_THROTTLE :
+                                             UCP_AM_ID_EAGER_UNTHROTTLE;
+
+        ucs_trace_req("send_throttle(%d) req %p ep %p", throttle, req, ep);
+        ucp_request_send(req, 0);
+    }
+}
@@ -124,10 +124,24 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_proto_progress_rndv_rtr, (self),
     return status;
 }
 
-ucs_status_t ucp_tag_send_start_rndv(ucp_request_t *sreq)
+ucs_status_t ucp_rndv_send_buffer_reg(ucp_request_t *sreq)
 {
     ucp_ep_h ep = sreq->send.ep;
     ucp_md_map_t md_map;
+
+    if (UCP_DT_IS_CONTIG(sreq->send.datatype) &&
+        ucp_rndv_is_get_zcopy(sreq, ep->worker->context->config.ext.rndv_mode)) {
+        /* register a contiguous buffer for rma_get */
+        md_map = ucp_ep_config(ep)->key.rma_bw_md_map;
+        return ucp_request_send_buffer_reg(sreq, md_map);
+    }
+
+    return UCS_OK;
+}
+
+ucs_status_t ucp_tag_send_start_rndv(ucp_request_t *sreq)
+{
+    ucp_ep_h ep = sreq->send.ep;
     ucs_status_t status;
 
     ucp_trace_req(sreq, "start_rndv to %s buffer %p length %zu",
@@ -146,14 +160,9 @@ ucs_status_t ucp_tag_send_start_rndv(ucp_request_t *sreq)
             return status;
         }
     } else {
-        if (UCP_DT_IS_CONTIG(sreq->send.datatype) &&
-            ucp_rndv_is_get_zcopy(sreq, ep->worker->context->config.ext.rndv_mode)) {
-            /* register a contiguous buffer for rma_get */
-            md_map = ucp_ep_config(ep)->key.rma_bw_md_map;
-            status = ucp_request_send_buffer_reg(sreq, md_map);
-            if (status != UCS_OK) {
-                return status;
-            }
+        status = ucp_rndv_send_buffer_reg(sreq);
+        if (status != UCS_OK) {
+            return status;
         }
 
         ucs_assert(sreq->send.lane == ucp_ep_get_am_lane(ep));
@@ -163,11 +172,11 @@ ucs_status_t ucp_tag_send_start_rndv(ucp_request_t *sreq)
     return UCS_OK;
 }
 
-static void ucp_rndv_complete_send(ucp_request_t *sreq)
+static void ucp_rndv_complete_send(ucp_request_t *sreq, ucs_status_t status)
 {
     ucp_request_send_generic_dt_finish(sreq);
     ucp_request_send_buffer_dereg(sreq);
-    ucp_request_complete_send(sreq, UCS_OK);
+    ucp_request_complete_send(sreq, status);
 }
 
 static void ucp_rndv_req_send_ats(ucp_request_t *rndv_req, ucp_request_t *rreq,
@@ -631,7 +640,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_ats_handler,
     if (sreq->flags & UCP_REQUEST_FLAG_OFFLOADED) {
         ucp_tag_offload_cancel_rndv(sreq);
     }
-    ucp_rndv_complete_send(sreq);
+    ucp_rndv_complete_send(sreq, rep_hdr->status);
     return UCS_OK;
 }
 
@@ -662,7 +671,8 @@ static size_t ucp_rndv_pack_data(void *dest, void *arg)
 
     return sizeof(*hdr) + ucp_dt_pack(sreq->send.ep->worker, sreq->send.datatype,
                                       sreq->send.mem_type, hdr + 1, sreq->send.buffer,
-                                      &sreq->send.state.dt, length);
+                                      &sreq->send.state.dt, length,
+                                      sreq->send.length);
 }
 
 UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_progress_am_bcopy, (self),
@@ -686,7 +696,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_progress_am_bcopy, (self),
                                        ucp_rndv_pack_data, 1);
     }
     if (status == UCS_OK) {
-        ucp_rndv_complete_send(sreq);
+        ucp_rndv_complete_send(sreq, UCS_OK);
     } else if (status == UCP_STATUS_PENDING_SWITCH) {
         status = UCS_OK;
     }
@@ -1055,14 +1065,18 @@ static void ucp_rndv_dump(ucp_worker_h worker, uct_am_trace_type_t type,
 
 UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_RTS, ucp_rndv_rts_handler,
               ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_ATS, ucp_rndv_ats_handler,
-              ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_ATP, ucp_rndv_atp_handler,
-              ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_RTR, ucp_rndv_rtr_handler,
-              ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_DATA, ucp_rndv_data_handler,
-              ucp_rndv_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_STREAM | UCP_FEATURE_AM,
+              UCP_AM_ID_RNDV_ATS,
+              ucp_rndv_ats_handler, ucp_rndv_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_STREAM | UCP_FEATURE_AM,
+              UCP_AM_ID_RNDV_ATP,
+              ucp_rndv_atp_handler, ucp_rndv_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_STREAM | UCP_FEATURE_AM,
+              UCP_AM_ID_RNDV_RTR,
+              ucp_rndv_rtr_handler, ucp_rndv_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_STREAM | UCP_FEATURE_AM,
+              UCP_AM_ID_RNDV_DATA,
+              ucp_rndv_data_handler, ucp_rndv_dump, 0);
 
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_RNDV_RTS);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_RNDV_ATS);
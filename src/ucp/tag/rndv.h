@@ -47,6 +47,8 @@ typedef struct {
 
 ucs_status_t ucp_tag_send_start_rndv(ucp_request_t *req);
 
+ucs_status_t ucp_rndv_send_buffer_reg(ucp_request_t *sreq);
+
 void ucp_rndv_matched(ucp_worker_h worker, ucp_request_t *req,
                       const ucp_rndv_rts_hdr_t *rndv_rts_hdr);
 
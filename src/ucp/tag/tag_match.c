@@ -5,38 +5,99 @@
  */
 
 #include "tag_match.inl"
+#include "eager.h"
+#include <ucp/core/ucp_worker.h>
 #include <ucp/tag/offload.h>
 
 
-ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm)
+#if ENABLE_STATS
+static ucs_stats_class_t ucp_tag_match_stats_class = {
+    .name           = "tag_match",
+    .num_counters   = UCP_TAG_MATCH_STAT_LAST,
+    .counter_names  = {
+        [UCP_TAG_MATCH_STAT_HASH_GROW]         = "hash_grow",
+        [UCP_TAG_MATCH_STAT_EXP_HASH_SEARCH]   = "exp_hash_search",
+        [UCP_TAG_MATCH_STAT_EXP_HASH_SCAN]     = "exp_hash_scan",
+        [UCP_TAG_MATCH_STAT_UNEXP_HASH_SEARCH] = "unexp_hash_search",
+        [UCP_TAG_MATCH_STAT_UNEXP_HASH_SCAN]   = "unexp_hash_scan",
+        [UCP_TAG_MATCH_STAT_UNEXP_SPILL]       = "unexp_spill",
+        [UCP_TAG_MATCH_STAT_UNEXP_THROTTLE]    = "unexp_throttle"
+    }
+};
+#endif
+
+
+static ucs_status_t
+ucp_tag_match_hash_alloc(size_t hash_size, ucp_request_queue_t **exp_hash_p,
+                         ucs_list_link_t **unexp_hash_p)
 {
-    size_t hash_size, bucket;
+    ucp_request_queue_t *exp_hash;
+    ucs_list_link_t *unexp_hash;
+    size_t bucket;
+
+    exp_hash = ucs_malloc(sizeof(*exp_hash) * hash_size, "ucp_tm_exp_hash");
+    if (exp_hash == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    unexp_hash = ucs_malloc(sizeof(*unexp_hash) * hash_size,
+                            "ucp_tm_unexp_hash");
+    if (unexp_hash == NULL) {
+        ucs_free(exp_hash);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    for (bucket = 0; bucket < hash_size; ++bucket) {
+        exp_hash[bucket].sw_count    = 0;
+        exp_hash[bucket].block_count = 0;
+        ucs_queue_head_init(&exp_hash[bucket].queue);
+        ucs_list_head_init(&unexp_hash[bucket]);
+    }
 
-    hash_size = ucs_roundup_pow2(UCP_TAG_MATCH_HASH_SIZE);
+    *exp_hash_p   = exp_hash;
+    *unexp_hash_p = unexp_hash;
+    return UCS_OK;
+}
+
+static void ucp_tag_match_hash_set_size(ucp_tag_match_t *tm, size_t hash_size)
+{
+    tm->hash.mask        = hash_size - 1;
+    tm->hash.grow_thresh = (hash_size < tm->hash.max_size) ? hash_size :
+                           SIZE_MAX;
+}
+
+ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm, size_t hash_size,
+                                size_t max_hash_size, size_t max_unexp_bytes
+                                UCS_STATS_ARG(ucs_stats_node_t *stats_parent))
+{
+    ucs_status_t status;
+
+    hash_size = ucs_roundup_pow2(ucs_max(hash_size, 1));
 
     tm->expected.sn           = 0;
     tm->expected.sw_all_count = 0;
     ucs_queue_head_init(&tm->expected.wildcard.queue);
     ucs_list_head_init(&tm->unexpected.all);
+    tm->unexpected.bytes      = 0;
+    tm->unexpected.max_bytes  = max_unexp_bytes;
+    tm->unexpected.throttled  = 0;
 
-    tm->expected.hash = ucs_malloc(sizeof(*tm->expected.hash) * hash_size,
-                                   "ucp_tm_exp_hash");
-    if (tm->expected.hash == NULL) {
-        return UCS_ERR_NO_MEMORY;
+    status = ucp_tag_match_hash_alloc(hash_size, &tm->expected.hash,
+                                      &tm->unexpected.hash);
+    if (status != UCS_OK) {
+        return status;
     }
 
-    tm->unexpected.hash = ucs_malloc(sizeof(*tm->unexpected.hash) * hash_size,
-                                     "ucp_tm_unexp_hash");
-    if (tm->unexpected.hash == NULL) {
-        ucs_free(tm->expected.hash);
-        return UCS_ERR_NO_MEMORY;
-    }
+    tm->hash.count    = 0;
+    tm->hash.max_size = ucs_max(max_hash_size, hash_size);
+    ucp_tag_match_hash_set_size(tm, hash_size);
 
-    for (bucket = 0; bucket < hash_size; ++bucket) {
-        tm->expected.hash[bucket].sw_count    = 0;
-        tm->expected.hash[bucket].block_count = 0;
-        ucs_queue_head_init(&tm->expected.hash[bucket].queue);
-        ucs_list_head_init(&tm->unexpected.hash[bucket]);
+    status = UCS_STATS_NODE_ALLOC(&tm->stats, &ucp_tag_match_stats_class,
+                                  stats_parent);
+    if (status != UCS_OK) {
+        ucs_free(tm->unexpected.hash);
+        ucs_free(tm->expected.hash);
+        return status;
     }
 
     kh_init_inplace(ucp_tag_frag_hash, &tm->frag_hash);
@@ -53,10 +114,116 @@ void ucp_tag_match_cleanup(ucp_tag_match_t *tm)
 {
     kh_destroy_inplace(ucp_tag_offload_hash, &tm->offload.tag_hash);
     kh_destroy_inplace(ucp_tag_frag_hash, &tm->frag_hash);
+    UCS_STATS_NODE_FREE(tm->stats);
     ucs_free(tm->unexpected.hash);
     ucs_free(tm->expected.hash);
 }
 
+void ucp_tag_match_hash_grow(ucp_tag_match_t *tm)
+{
+    size_t old_size = tm->hash.mask + 1;
+    size_t new_size = old_size * 2;
+    ucp_request_queue_t *exp_hash, *req_queue;
+    ucs_list_link_t *unexp_hash;
+    ucp_recv_desc_t *rdesc, *tmp;
+    ucs_status_t status;
+    ucp_request_t *req;
+    size_t bucket;
+
+    status = ucp_tag_match_hash_alloc(new_size, &exp_hash, &unexp_hash);
+    if (status != UCS_OK) {
+        /* keep using the current tables */
+        ucs_debug("failed to grow tag matching hash to %zu buckets", new_size);
+        tm->hash.grow_thresh = SIZE_MAX;
+        return;
+    }
+
+    ucp_tag_match_hash_set_size(tm, new_size);
+
+    /* Every new bucket is filled from a single old bucket, so moving the
+     * entries in order preserves the matching order within a bucket */
+    for (bucket = 0; bucket < old_size; ++bucket) {
+        while (!ucs_queue_is_empty(&tm->expected.hash[bucket].queue)) {
+            req = ucs_queue_pull_elem_non_empty(&tm->expected.hash[bucket].queue,
+                                                ucp_request_t, recv.queue);
+            req_queue = &exp_hash[ucp_tag_match_calc_hash(tm,
+                                                          req->recv.tag.tag)];
+            ucs_queue_push(&req_queue->queue, &req->recv.queue);
+            if (!(req->flags & UCP_REQUEST_FLAG_OFFLOADED)) {
+                ++req_queue->sw_count;
+                req_queue->block_count +=
+                        !!(req->flags & UCP_REQUEST_FLAG_BLOCK_OFFLOAD);
+            }
+        }
+
+        ucs_list_for_each_safe(rdesc, tmp, &tm->unexpected.hash[bucket],
+                               tag_list[UCP_RDESC_HASH_LIST]) {
+            ucs_list_add_tail(&unexp_hash[ucp_tag_match_calc_hash(tm,
+                                                    ucp_rdesc_get_tag(rdesc))],
+                              &rdesc->tag_list[UCP_RDESC_HASH_LIST]);
+        }
+    }
+
+    ucs_free(tm->unexpected.hash);
+    ucs_free(tm->expected.hash);
+    tm->expected.hash   = exp_hash;
+    tm->unexpected.hash = unexp_hash;
+
+    UCS_STATS_UPDATE_COUNTER(tm->stats, UCP_TAG_MATCH_STAT_HASH_GROW, 1);
+    ucs_debug("tag matching hash grown to %zu buckets, %zu entries", new_size,
+              tm->hash.count);
+}
+
+void ucp_tag_match_unexp_overflow(ucp_tag_match_t *tm)
+{
+    UCS_STATS_UPDATE_COUNTER(tm->stats, UCP_TAG_MATCH_STAT_UNEXP_SPILL, 1);
+    if (tm->unexpected.throttled) {
+        return;
+    }
+
+    ucs_debug("unexpected tag messages use %zu bytes (limit %zu), throttling "
+              "eager senders", tm->unexpected.bytes, tm->unexpected.max_bytes);
+    UCS_STATS_UPDATE_COUNTER(tm->stats, UCP_TAG_MATCH_STAT_UNEXP_THROTTLE, 1);
+    tm->unexpected.throttled = 1;
+    ucp_tag_eager_send_throttle(ucs_container_of(tm, ucp_worker_t, tm), 1);
+}
+
+void ucp_tag_match_unexp_unthrottle(ucp_tag_match_t *tm)
+{
+    ucs_debug("unexpected tag messages use %zu bytes (limit %zu), resuming "
+              "eager senders", tm->unexpected.bytes, tm->unexpected.max_bytes);
+    tm->unexpected.throttled = 0;
+    ucp_tag_eager_send_throttle(ucs_container_of(tm, ucp_worker_t, tm), 0);
+}
+
+void ucp_tag_match_print_info(ucp_tag_match_t *tm, FILE *stream)
+{
+    size_t hash_size = tm->hash.mask + 1;
+    size_t bucket, length, exp_used, unexp_used, exp_max, unexp_max;
+
+    exp_used = unexp_used = exp_max = unexp_max = 0;
+    for (bucket = 0; bucket < hash_size; ++bucket) {
+        length    = ucs_queue_length(&tm->expected.hash[bucket].queue);
+        exp_used += !!length;
+        exp_max   = ucs_max(exp_max, length);
+
+        length      = ucs_list_length(&tm->unexpected.hash[bucket]);
+        unexp_used += !!length;
+        unexp_max   = ucs_max(unexp_max, length);
+    }
+
+    fprintf(stream, "#          tag hash: %zu buckets (max %zu), %zu entries\n",
+            hash_size, tm->hash.max_size, tm->hash.count);
+    fprintf(stream, "#                    expected: %zu used, longest %zu\n",
+            exp_used, exp_max);
+    fprintf(stream, "#                  unexpected: %zu used, longest %zu\n",
+            unexp_used, unexp_max);
+    if (tm->unexpected.max_bytes != SIZE_MAX) {
+        fprintf(stream, "#    unexpected limit: %zu bytes\n",
+                tm->unexpected.max_bytes);
+    }
+}
+
 int ucp_tag_unexp_is_empty(ucp_tag_match_t *tm)
 {
     return ucs_list_is_empty(&tm->unexpected.all);
@@ -152,6 +319,7 @@ void ucp_tag_frag_list_process_queue(ucp_tag_match_t *tm, ucp_request_t *req,
                                    status == UCS_INPROGRESS) {
             UCS_STATS_UPDATE_COUNTER(req->recv.worker->stats, counter_idx, 1);
             hdr    = (void*)(rdesc + 1);
+            ucp_tag_unexp_sub_bytes(tm, rdesc);
             status = ucp_tag_recv_request_process_rdesc(req, rdesc, hdr->offset);
         }
         ucs_assert(ucs_queue_is_empty(&matchq->unexp_q));
@@ -18,6 +18,22 @@
 #define UCP_TAG_MASK_FULL     0xffffffffffffffffUL  /* All 1-s */
 
 
+/**
+ * Tag-matching statistics counters
+ */
+enum {
+    UCP_TAG_MATCH_STAT_HASH_GROW,         /* Hash tables were doubled */
+    UCP_TAG_MATCH_STAT_EXP_HASH_SEARCH,   /* Lookups in expected hash buckets */
+    UCP_TAG_MATCH_STAT_EXP_HASH_SCAN,     /* Requests checked by the lookups */
+    UCP_TAG_MATCH_STAT_UNEXP_HASH_SEARCH, /* Lookups in unexpected hash buckets */
+    UCP_TAG_MATCH_STAT_UNEXP_HASH_SCAN,   /* Descriptors checked by the lookups */
+    UCP_TAG_MATCH_STAT_UNEXP_SPILL,       /* Unexpected descriptors queued above
+                                             the memory limit */
+    UCP_TAG_MATCH_STAT_UNEXP_THROTTLE,    /* Senders were asked to stop eager */
+    UCP_TAG_MATCH_STAT_LAST
+};
+
+
 KHASH_INIT(ucp_tag_offload_hash, ucp_tag_t, ucp_worker_iface_t *, 1,
            kh_int64_hash_func, kh_int64_hash_equal);
 
@@ -73,8 +89,22 @@ typedef struct ucp_tag_match {
     struct {
         ucs_list_link_t       all;        /* Linked list of all tags */
         ucs_list_link_t       *hash;      /* Hash table of unexpected tags */
+        size_t                bytes;      /* Total length of unexpected
+                                             descriptors and fragments */
+        size_t                max_bytes;  /* Throttle the senders above this */
+        int                   throttled;  /* Whether the senders were throttled */
     } unexpected;
 
+    /* Size of the expected and unexpected hash tables */
+    struct {
+        size_t                mask;        /* Number of buckets minus 1 */
+        size_t                count;       /* Number of hashed expected requests
+                                              and unexpected descriptors */
+        size_t                grow_thresh; /* Double the hash tables when count
+                                              exceeds this value */
+        size_t                max_size;    /* Maximal number of buckets */
+    } hash;
+
     /* Hash for fragment assembly, the key is a globally unique tag message id */
     khash_t(ucp_tag_frag_hash) frag_hash;
 
@@ -102,13 +132,25 @@ typedef struct ucp_tag_match {
         uint64_t              message_id;       /* Unique ID for active messages */
     } am;
 
+    UCS_STATS_NODE_DECLARE(stats);
+
 } ucp_tag_match_t;
 
 
-ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm);
+ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm, size_t hash_size,
+                                size_t max_hash_size, size_t max_unexp_bytes
+                                UCS_STATS_ARG(ucs_stats_node_t *stats_parent));
 
 void ucp_tag_match_cleanup(ucp_tag_match_t *tm);
 
+void ucp_tag_match_hash_grow(ucp_tag_match_t *tm);
+
+void ucp_tag_match_unexp_overflow(ucp_tag_match_t *tm);
+
+void ucp_tag_match_unexp_unthrottle(ucp_tag_match_t *tm);
+
+void ucp_tag_match_print_info(ucp_tag_match_t *tm, FILE *stream);
+
 void ucp_tag_exp_remove(ucp_tag_match_t *tm, ucp_request_t *req);
 
 int ucp_tag_unexp_is_empty(ucp_tag_match_t *tm);
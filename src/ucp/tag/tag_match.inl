@@ -19,10 +19,6 @@
 #include <inttypes.h>
 
 
-/* Hash size is a prime number just below 1024. Prime number for even distribution,
- * and small enough to fit L1 cache. */
-#define UCP_TAG_MATCH_HASH_SIZE     1021
-
 
 static UCS_F_ALWAYS_INLINE
 int ucp_tag_is_specific_source(ucp_context_t *context, ucp_tag_t tag_mask)
@@ -41,17 +37,51 @@ int ucp_tag_is_match(ucp_tag_t tag, ucp_tag_t exp_tag, ucp_tag_t tag_mask)
 }
 
 static UCS_F_ALWAYS_INLINE size_t
-ucp_tag_match_calc_hash(ucp_tag_t tag)
+ucp_tag_match_calc_hash(ucp_tag_match_t *tm, ucp_tag_t tag)
+{
+    /* Mix all tag bits into the low bits (MurmurHash3 finalizer), since MPI
+     * libraries usually put the source rank in the high bits of the tag.
+     * Taking the low bits keeps every bucket of a doubled table a subset of
+     * a single bucket of the original table. */
+    tag ^= tag >> 33;
+    tag *= 0xff51afd7ed558ccdul;
+    tag ^= tag >> 33;
+    tag *= 0xc4ceb9fe1a85ec53ul;
+    tag ^= tag >> 33;
+    return tag & tm->hash.mask;
+}
+
+static UCS_F_ALWAYS_INLINE void ucp_tag_match_hash_add(ucp_tag_match_t *tm)
+{
+    if (ucs_unlikely(++tm->hash.count > tm->hash.grow_thresh)) {
+        ucp_tag_match_hash_grow(tm);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_unexp_add_bytes(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc)
 {
-    /* Compute two 32-bit modulo and combine their result */
-    return ((uint32_t)tag % UCP_TAG_MATCH_HASH_SIZE) ^
-           ((uint32_t)(tag >> 32) % UCP_TAG_MATCH_HASH_SIZE);
+    tm->unexpected.bytes += rdesc->length;
+    if (ucs_unlikely(tm->unexpected.bytes > tm->unexpected.max_bytes)) {
+        ucp_tag_match_unexp_overflow(tm);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_unexp_sub_bytes(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc)
+{
+    ucs_assert(tm->unexpected.bytes >= rdesc->length);
+    tm->unexpected.bytes -= rdesc->length;
+    if (ucs_unlikely(tm->unexpected.throttled) &&
+        (tm->unexpected.bytes <= (tm->unexpected.max_bytes / 2))) {
+        ucp_tag_match_unexp_unthrottle(tm);
+    }
 }
 
 static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
 ucp_tag_exp_get_queue_for_tag(ucp_tag_match_t *tm, ucp_tag_t tag)
 {
-    return &tm->expected.hash[ucp_tag_match_calc_hash(tag)];
+    return &tm->expected.hash[ucp_tag_match_calc_hash(tm, tag)];
 }
 
 static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
@@ -76,6 +106,10 @@ ucp_tag_exp_push(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
 {
     req->recv.tag.sn = tm->expected.sn++;
     ucs_queue_push(&req_queue->queue, &req->recv.queue);
+    if (req_queue != &tm->expected.wildcard) {
+        /* may rehash, so req_queue must not be used after this point */
+        ucp_tag_match_hash_add(tm);
+    }
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -95,6 +129,9 @@ ucp_tag_exp_delete(ucp_request_t *req, ucp_tag_match_t *tm,
             --req_queue->block_count;
         }
     }
+    if (req_queue != &tm->expected.wildcard) {
+        --tm->hash.count;
+    }
     ucs_queue_del_iter(&req_queue->queue, iter);
 }
 
@@ -112,8 +149,10 @@ ucp_tag_exp_search(ucp_tag_match_t *tm, ucp_tag_t tag)
 
     /* fast path - wildcard queue is empty, search only the specific queue */
     req_queue = ucp_tag_exp_get_queue_for_tag(tm, tag);
+    UCS_STATS_UPDATE_COUNTER(tm->stats, UCP_TAG_MATCH_STAT_EXP_HASH_SEARCH, 1);
     ucs_queue_for_each_safe(req, iter, &req_queue->queue, recv.queue) {
         req = ucs_container_of(*iter, ucp_request_t, recv.queue);
+        UCS_STATS_UPDATE_COUNTER(tm->stats, UCP_TAG_MATCH_STAT_EXP_HASH_SCAN, 1);
         ucs_trace_data("checking req %p tag %"PRIx64"/%"PRIx64" with tag %"PRIx64,
                        req, req->recv.tag.tag, req->recv.tag.tag_mask, tag);
         if (ucp_tag_is_match(tag, req->recv.tag.tag, req->recv.tag.tag_mask)) {
@@ -133,14 +172,16 @@ static UCS_F_ALWAYS_INLINE ucp_tag_t ucp_rdesc_get_tag(ucp_recv_desc_t *rdesc)
 static UCS_F_ALWAYS_INLINE ucs_list_link_t*
 ucp_tag_unexp_get_list_for_tag(ucp_tag_match_t *tm, ucp_tag_t tag)
 {
-    return &tm->unexpected.hash[ucp_tag_match_calc_hash(tag)];
+    return &tm->unexpected.hash[ucp_tag_match_calc_hash(tm, tag)];
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_unexp_remove(ucp_recv_desc_t *rdesc)
+ucp_tag_unexp_remove(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc)
 {
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_HASH_LIST]);
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_ALL_LIST] );
+    --tm->hash.count;
+    ucp_tag_unexp_sub_bytes(tm, rdesc);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -154,6 +195,9 @@ ucp_tag_unexp_recv(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc, ucp_tag_t tag)
 
     ucs_trace_req("unexp "UCP_RECV_DESC_FMT" tag %"PRIx64,
                   UCP_RECV_DESC_ARG(rdesc), tag);
+
+    ucp_tag_match_hash_add(tm);
+    ucp_tag_unexp_add_bytes(tm, rdesc);
 }
 
 static UCS_F_ALWAYS_INLINE ucp_recv_desc_t*
@@ -181,6 +225,8 @@ ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
 
     if (tag_mask == UCP_TAG_MASK_FULL) {
         list = ucp_tag_unexp_get_list_for_tag(tm, tag);
+        UCS_STATS_UPDATE_COUNTER(tm->stats,
+                                 UCP_TAG_MATCH_STAT_UNEXP_HASH_SEARCH, 1);
         if (ucs_list_is_empty(list)) {
             return NULL;
         }
@@ -192,6 +238,8 @@ ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
 
     rdesc = ucs_list_head(list, ucp_recv_desc_t, tag_list[i_list]);
     do {
+        UCS_STATS_UPDATE_COUNTER(tm->stats, UCP_TAG_MATCH_STAT_UNEXP_HASH_SCAN,
+                                 i_list == UCP_RDESC_HASH_LIST);
         ucs_trace_req("searching for tag %"PRIx64"/%"PRIx64" "
                       "checking "UCP_RECV_DESC_FMT" tag %"PRIx64,
                       tag, tag_mask, UCP_RECV_DESC_ARG(rdesc),
@@ -201,7 +249,7 @@ ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
                           "%s tag %"PRIx64"/%"PRIx64, UCP_RECV_DESC_ARG(rdesc),
                           title, tag, tag_mask);
             if (remove) {
-                ucp_tag_unexp_remove(rdesc);
+                ucp_tag_unexp_remove(tm, rdesc);
             }
             return rdesc;
         }
@@ -273,13 +321,14 @@ ucp_tag_frag_match_is_unexp(ucp_tag_frag_match_t *frag_list)
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_frag_match_add_unexp(ucp_tag_frag_match_t *frag_list, ucp_recv_desc_t *rdesc,
-                         size_t offset)
+ucp_tag_frag_match_add_unexp(ucp_tag_match_t *tm, ucp_tag_frag_match_t *frag_list,
+                             ucp_recv_desc_t *rdesc, size_t offset)
 {
     ucs_trace_req("unexp frag "UCP_RECV_DESC_FMT" offset %zu",
                   UCP_RECV_DESC_ARG(rdesc), offset);
     ucs_assert(ucp_tag_frag_match_is_unexp(frag_list));
     ucs_queue_push(&frag_list->unexp_q, &rdesc->tag_frag_queue);
+    ucp_tag_unexp_add_bytes(tm, rdesc);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -12,6 +12,7 @@
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_context.h>
 #include <ucp/proto/proto_am.inl>
+#include <ucp/proto/proto_tune.h>
 #include <ucs/datastruct/mpool.inl>
 #include <string.h>
 
@@ -21,7 +22,15 @@ ucp_tag_get_rndv_threshold(const ucp_request_t *req, size_t count,
                            size_t max_iov, size_t rndv_rma_thresh,
                            size_t rndv_am_thresh)
 {
+    if (ucs_unlikely(req->send.ep->flags & UCP_EP_FLAG_TAG_THROTTLED)) {
+        /* The receiver is out of memory for unexpected messages */
+        return 1;
+    }
+
     switch (req->send.datatype & UCP_DATATYPE_CLASS_MASK) {
+    case UCP_DATATYPE_STRIDED:
+        count *= ucp_dt_strided(req->send.datatype)->elem_count;
+        /* Fall through */
     case UCP_DATATYPE_IOV:
         if ((count > max_iov) &&
             ucp_ep_is_tag_offload_enabled(ucp_ep_config(req->send.ep))) {
@@ -63,6 +72,12 @@ ucp_tag_send_req(ucp_request_t *req, size_t dt_count,
         zcopy_thresh = rndv_thresh;
     }
 
+    if (ucs_unlikely(ucp_ep_config(req->send.ep)->tag.tune != NULL) &&
+        enable_zcopy) {
+        ucp_proto_tune_start(ucp_ep_config(req->send.ep)->tag.tune, req,
+                             max_short, rndv_thresh, &zcopy_thresh);
+    }
+
     ucs_trace_req("select tag request(%p) progress algorithm datatype=%lx "
                   "buffer=%p length=%zu max_short=%zd rndv_thresh=%zu "
                   "zcopy_thresh=%zu zcopy_enabled=%d",
@@ -81,6 +96,9 @@ ucp_tag_send_req(ucp_request_t *req, size_t dt_count,
             }
 
             UCP_EP_STAT_TAG_OP(req->send.ep, RNDV);
+            if (req->send.ep->flags & UCP_EP_FLAG_TAG_THROTTLED) {
+                UCP_EP_STAT_TAG_OP(req->send.ep, THROTTLED);
+            }
         } else {
             return UCS_STATUS_PTR(status);
         }
@@ -291,3 +309,118 @@ out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
     return ret;
 }
+
+static void ucp_tag_send_batch_complete_one(ucp_request_t *batch,
+                                            ucs_status_t status)
+{
+    if ((status != UCS_OK) && (batch->status == UCS_OK)) {
+        batch->status = status;
+    }
+
+    if (--batch->send_batch.comp_count == 0) {
+        ucp_request_complete(batch, send_batch.cb, batch->status);
+    }
+}
+
+static void ucp_tag_send_batch_completion(void *request, ucs_status_t status)
+{
+    ucp_request_t *req = (ucp_request_t*)request - 1;
+
+    ucs_trace_req("batch %p: send request %p completed with status %s",
+                  req->send.batch, req, ucs_status_string(status));
+    ucp_tag_send_batch_complete_one(req->send.batch, status);
+}
+
+UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_batch_nb,
+                 (worker, entries, num_entries, datatype, cb),
+                 ucp_worker_h worker, const ucp_tag_send_batch_entry_t *entries,
+                 size_t num_entries, ucp_datatype_t datatype,
+                 ucp_send_callback_t cb)
+{
+    const ucp_tag_send_batch_entry_t *entry;
+    ucp_request_t *batch, *req;
+    ucs_status_ptr_t ret;
+    ucs_status_t status;
+
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_TAG,
+                                    return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    ucs_trace_req("send_batch_nb %zu entries datatype %lx cb %p", num_entries,
+                  datatype, cb);
+
+    /* The batch request is allocated only when a send does not complete
+     * immediately, and counts the sends which are still in progress */
+    batch  = NULL;
+    status = UCS_OK;
+
+    for (entry = entries; entry < (entries + num_entries); ++entry) {
+        ucs_assert(entry->ep->worker == worker);
+
+        status = UCS_PROFILE_CALL(ucp_tag_send_inline, entry->ep,
+                                  entry->buffer, entry->count, datatype,
+                                  entry->tag);
+        if (ucs_likely(status == UCS_OK)) {
+            continue;
+        } else if (status != UCS_ERR_NO_RESOURCE) {
+            break;
+        }
+
+        if (batch == NULL) {
+            batch = ucp_request_get(worker);
+            if (batch == NULL) {
+                status = UCS_ERR_NO_MEMORY;
+                break;
+            }
+
+            batch->flags                 = 0;
+            batch->status                = UCS_OK;
+            batch->send_batch.cb         = cb;
+            batch->send_batch.comp_count = 1; /* counting starts from 1, and
+                                                 decremented when all entries
+                                                 are started */
+        }
+
+        req = ucp_request_get(worker);
+        if (req == NULL) {
+            status = UCS_ERR_NO_MEMORY;
+            break;
+        }
+
+        ucp_tag_send_req_init(req, entry->ep, entry->buffer, datatype,
+                              entry->count, entry->tag, 0);
+        req->send.batch = batch;
+
+        ret = ucp_tag_send_req(req, entry->count,
+                               &ucp_ep_config(entry->ep)->tag.eager,
+                               ucp_ep_config(entry->ep)->tag.rndv.rma_thresh,
+                               ucp_ep_config(entry->ep)->tag.rndv.am_thresh,
+                               ucp_tag_send_batch_completion,
+                               ucp_ep_config(entry->ep)->tag.proto, 1);
+        if (UCS_PTR_IS_ERR(ret)) {
+            status = UCS_PTR_STATUS(ret);
+            break;
+        } else if (ret != NULL) {
+            /* Released by the completion, nobody else holds the request */
+            req->flags |= UCP_REQUEST_FLAG_RELEASED;
+            ++batch->send_batch.comp_count;
+        }
+
+        status = UCS_OK;
+    }
+
+    if (batch == NULL) {
+        ret = UCS_STATUS_PTR(status);
+    } else if (batch->send_batch.comp_count == 1) {
+        /* All sends were completed immediately */
+        ucp_request_put(batch);
+        ret = UCS_STATUS_PTR(status);
+    } else {
+        batch->flags |= UCP_REQUEST_FLAG_CALLBACK;
+        ucp_tag_send_batch_complete_one(batch, status);
+        ret = batch + 1;
+    }
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+    return ret;
+}
@@ -64,4 +64,24 @@ void ucs_aarch64_cpuid(ucs_aarch64_cpuid_t *cpuid)
     *cpuid = cached_cpuid;
 }
 
+void ucs_arch_memcpy_nontemporal(void *dst, const void *src, size_t len)
+{
+    /* Copy 64-byte chunks with non-temporal pair stores */
+    while (len >= 64) {
+        asm volatile ("ldp q0, q1, [%1]\n\t"
+                      "ldp q2, q3, [%1, #32]\n\t"
+                      "stnp q0, q1, [%0]\n\t"
+                      "stnp q2, q3, [%0, #32]\n\t"
+                      :
+                      : "r" (dst), "r" (src)
+                      : "q0", "q1", "q2", "q3", "memory");
+        dst  = UCS_PTR_BYTE_OFFSET(dst, 64);
+        src  = UCS_PTR_BYTE_OFFSET(src, 64);
+        len -= 64;
+    }
+
+    memcpy(dst, src, len);
+    ucs_memory_cpu_store_fence();
+}
+
 #endif
@@ -87,6 +87,8 @@ static inline int ucs_arch_get_cpu_flag()
     return UCS_CPU_FLAG_UNKNOWN;
 }
 
+void ucs_arch_memcpy_nontemporal(void *dst, const void *src, size_t len);
+
 static inline void ucs_arch_wait_mem(void *address)
 {
     unsigned long tmp;
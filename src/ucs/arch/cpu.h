@@ -13,6 +13,7 @@
 #endif
 
 #include <ucs/sys/compiler_def.h>
+#include <string.h>
 
 
 /* CPU models */
@@ -43,7 +44,8 @@ typedef enum ucs_cpu_flag {
     UCS_CPU_FLAG_SSE41      = UCS_BIT(7),
     UCS_CPU_FLAG_SSE42      = UCS_BIT(8),
     UCS_CPU_FLAG_AVX        = UCS_BIT(9),
-    UCS_CPU_FLAG_AVX2       = UCS_BIT(10)
+    UCS_CPU_FLAG_AVX2       = UCS_BIT(10),
+    UCS_CPU_FLAG_AVX512F    = UCS_BIT(11)
 } ucs_cpu_flag_t;
 
 
@@ -79,12 +81,49 @@ typedef enum ucs_cpu_flag {
 static inline void ucs_clear_cache(void *start, void *end)
 {
 #if HAVE___CLEAR_CACHE
-    /* do not allow global declaration of compiler intrinsic */
-    void __clear_cache(void* beg, void* end);
-
-    __clear_cache(start, end);
+    /* use the builtin rather than declaring the intrinsic, which conflicts
+     * with the compiler's own declaration in C++ */
+    __builtin___clear_cache((char*)start, (char*)end);
 #else
     ucs_arch_clear_cache(start, end);
 #endif
 }
+
+/**
+ * Copy memory using non-temporal stores, which bypass the CPU caches. The
+ * copied data does not evict the working set from the cache, but it is not
+ * cached for subsequent accesses either. The stores are ordered before any
+ * store issued after this function returns.
+ *
+ * @param dst   destination buffer
+ * @param src   source buffer
+ * @param len   number of bytes to copy
+ */
+static inline void ucs_memcpy_nontemporal(void *dst, const void *src, size_t len)
+{
+    ucs_arch_memcpy_nontemporal(dst, src, len);
+}
+
+/**
+ * Copy a part of a data transfer. If the whole transfer is larger than the
+ * threshold, the data would not stay in the cache anyway, so it is copied
+ * using non-temporal stores.
+ *
+ * @param dst        destination buffer
+ * @param src        source buffer
+ * @param len        number of bytes to copy
+ * @param total_len  total size of the transfer which this copy is a part of
+ * @param nt_thresh  transfer size to use non-temporal stores from, usually
+ *                   the UCX_MEMCPY_NT_THRESH configuration
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_memcpy_relaxed(void *dst, const void *src, size_t len, size_t total_len,
+                   size_t nt_thresh)
+{
+    if (ucs_unlikely(total_len >= nt_thresh)) {
+        ucs_memcpy_nontemporal(dst, src, len);
+    } else {
+        memcpy(dst, src, len);
+    }
+}
 #endif
@@ -10,6 +10,10 @@
 #include <ucs/debug/log.h>
 #include <ucs/sys/math.h>
 #include <ucs/sys/sys.h>
+#include <emmintrin.h>
+#if HAVE_ATTRIBUTE_TARGET_AVX2 || HAVE_ATTRIBUTE_TARGET_AVX512
+#include <immintrin.h>
+#endif
 
 #define X86_CPUID_GET_MODEL       0x00000001u
 #define X86_CPUID_GET_BASE_VALUE  0x00000000u
@@ -259,6 +263,13 @@ int ucs_arch_get_cpu_flag()
             if ((result & UCS_CPU_FLAG_AVX) && (_ebx & (1 << 5))) {
                 result |= UCS_CPU_FLAG_AVX2;
             }
+            if ((result & UCS_CPU_FLAG_AVX) && (_ebx & (1 << 16))) {
+                /* OS must save opmask and upper ZMM registers */
+                ucs_x86_xgetbv(0, _eax, _edx);
+                if ((_eax & 0xe6) == 0xe6) {
+                    result |= UCS_CPU_FLAG_AVX512F;
+                }
+            }
         }
         cpu_flag = result;
     }
@@ -266,4 +277,105 @@ int ucs_arch_get_cpu_flag()
     return cpu_flag;
 }
 
+/*
+ * Non-temporal copy kernels: copy the head until the destination is aligned
+ * to the vector size, stream full vectors, and copy the remaining tail. The
+ * source may be unaligned.
+ */
+#define UCS_X86_MEMCPY_NT(_dst, _src, _len, _vec_size, _vec_t, _load, _stream) \
+    { \
+        size_t _head = (-(uintptr_t)(_dst)) & ((_vec_size) - 1); \
+        \
+        memcpy(_dst, _src, _head); \
+        _dst  = UCS_PTR_BYTE_OFFSET(_dst, _head); \
+        _src  = UCS_PTR_BYTE_OFFSET(_src, _head); \
+        _len -= _head; \
+        \
+        while (_len >= 4 * (_vec_size)) { \
+            _vec_t _v0 = _load((const _vec_t*)(_src)); \
+            _vec_t _v1 = _load((const _vec_t*)(_src) + 1); \
+            _vec_t _v2 = _load((const _vec_t*)(_src) + 2); \
+            _vec_t _v3 = _load((const _vec_t*)(_src) + 3); \
+            _stream((_vec_t*)(_dst), _v0); \
+            _stream((_vec_t*)(_dst) + 1, _v1); \
+            _stream((_vec_t*)(_dst) + 2, _v2); \
+            _stream((_vec_t*)(_dst) + 3, _v3); \
+            _dst  = UCS_PTR_BYTE_OFFSET(_dst, 4 * (_vec_size)); \
+            _src  = UCS_PTR_BYTE_OFFSET(_src, 4 * (_vec_size)); \
+            _len -= 4 * (_vec_size); \
+        } \
+        \
+        while (_len >= (_vec_size)) { \
+            _stream((_vec_t*)(_dst), _load((const _vec_t*)(_src))); \
+            _dst  = UCS_PTR_BYTE_OFFSET(_dst, (_vec_size)); \
+            _src  = UCS_PTR_BYTE_OFFSET(_src, (_vec_size)); \
+            _len -= (_vec_size); \
+        } \
+        \
+        memcpy(_dst, _src, _len); \
+        _mm_sfence(); \
+    }
+
+/* Copies smaller than this are not worth the head/tail handling and fence */
+#define UCS_X86_MEMCPY_NT_MIN     256
+
+static void ucs_x86_memcpy_nt_sse2(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_NT(dst, src, len, 16, __m128i, _mm_loadu_si128,
+                      _mm_stream_si128);
+}
+
+#if HAVE_ATTRIBUTE_TARGET_AVX2
+static void __attribute__((target("avx2")))
+ucs_x86_memcpy_nt_avx2(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_NT(dst, src, len, 32, __m256i, _mm256_loadu_si256,
+                      _mm256_stream_si256);
+}
+#endif
+
+#if HAVE_ATTRIBUTE_TARGET_AVX512
+static void __attribute__((target("avx512f")))
+ucs_x86_memcpy_nt_avx512(void *dst, const void *src, size_t len)
+{
+    UCS_X86_MEMCPY_NT(dst, src, len, 64, __m512i, _mm512_loadu_si512,
+                      _mm512_stream_si512);
+}
+#endif
+
+static void ucs_x86_memcpy_nt_init(void *dst, const void *src, size_t len);
+
+static void (*ucs_x86_memcpy_nt_func)(void*, const void*, size_t) =
+                ucs_x86_memcpy_nt_init;
+
+/* Select the widest kernel supported by the CPU on first use */
+static void ucs_x86_memcpy_nt_init(void *dst, const void *src, size_t len)
+{
+    void (*func)(void*, const void*, size_t) = ucs_x86_memcpy_nt_sse2;
+    int UCS_V_UNUSED cpu_flag = ucs_arch_get_cpu_flag();
+
+#if HAVE_ATTRIBUTE_TARGET_AVX2
+    if (cpu_flag & UCS_CPU_FLAG_AVX2) {
+        func = ucs_x86_memcpy_nt_avx2;
+    }
+#endif
+#if HAVE_ATTRIBUTE_TARGET_AVX512
+    if (cpu_flag & UCS_CPU_FLAG_AVX512F) {
+        func = ucs_x86_memcpy_nt_avx512;
+    }
+#endif
+
+    ucs_x86_memcpy_nt_func = func;
+    func(dst, src, len);
+}
+
+void ucs_arch_memcpy_nontemporal(void *dst, const void *src, size_t len)
+{
+    if (len < UCS_X86_MEMCPY_NT_MIN) {
+        memcpy(dst, src, len);
+    } else {
+        ucs_x86_memcpy_nt_func(dst, src, len);
+    }
+}
+
 #endif
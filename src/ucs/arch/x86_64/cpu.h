@@ -72,6 +72,8 @@ static inline uint64_t ucs_arch_read_hres_clock()
 
 #define ucs_arch_wait_mem ucs_arch_generic_wait_mem
 
+void ucs_arch_memcpy_nontemporal(void *dst, const void *src, size_t len);
+
 #if !HAVE___CLEAR_CACHE
 static inline void ucs_arch_clear_cache(void *start, void *end)
 {
@@ -12,6 +12,7 @@
 #include <ucs/debug/log.h>
 #include <ucs/sys/compiler.h>
 #include <sys/signal.h>
+#include <unistd.h>
 
 
 ucs_global_opts_t ucs_global_opts = {
@@ -40,7 +41,8 @@ ucs_global_opts_t ucs_global_opts = {
     .stats_filter          = { NULL, 0 },
     .stats_format          = UCS_STATS_FULL,
     .rcache_check_pfn      = 0,
-    .module_dir            = UCX_MODULE_DIR /* defined in Makefile.am */
+    .module_dir            = UCX_MODULE_DIR, /* defined in Makefile.am */
+    .memcpy_nt_thresh      = UCS_CONFIG_MEMUNITS_INF
 };
 
 static const char *ucs_handle_error_modes[] = {
@@ -210,12 +212,34 @@ static ucs_config_field_t ucs_global_opts_table[] = {
    "Directory to search for loadable modules",
    ucs_offsetof(ucs_global_opts_t, module_dir), UCS_CONFIG_TYPE_STRING},
 
+  {"MEMCPY_NT_THRESH", "auto",
+   "Data transfers larger than this size are copied using non-temporal stores,\n"
+   "which bypass the CPU cache and avoid evicting the working set from it.\n"
+   "\"auto\" selects the size of the last level cache, \"inf\" disables\n"
+   "non-temporal copy.",
+   ucs_offsetof(ucs_global_opts_t, memcpy_nt_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
   {NULL}
 };
 UCS_CONFIG_REGISTER_TABLE(ucs_global_opts_table, "UCS global", NULL,
                           ucs_global_opts_t)
 
 
+static size_t ucs_global_opts_llc_size()
+{
+    long size = -1;
+
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    if (size <= 0) {
+        size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    }
+#endif
+    return (size > 0) ? size : UCS_CONFIG_MEMUNITS_INF;
+}
+
 void ucs_global_opts_init()
 {
     ucs_status_t status;
@@ -225,6 +249,11 @@ void ucs_global_opts_init()
     if (status != UCS_OK) {
         ucs_fatal("failed to parse global configuration - aborting");
     }
+
+    ucs_global_opts.memcpy_nt_thresh =
+            ucs_config_memunits_get(ucs_global_opts.memcpy_nt_thresh,
+                                    ucs_global_opts_llc_size(),
+                                    UCS_CONFIG_MEMUNITS_INF);
 }
 
 ucs_status_t ucs_global_opts_set_value(const char *name, const char *value)
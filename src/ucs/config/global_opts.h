@@ -111,6 +111,9 @@ typedef struct {
 
     /* directory for loadable modules */
     char                     *module_dir;
+
+    /* Transfer size from which memory is copied using non-temporal stores */
+    size_t                   memcpy_nt_thresh;
 } ucs_global_opts_t;
 
 
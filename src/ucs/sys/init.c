@@ -38,6 +38,7 @@ static UCS_F_NOOPTIMIZE void ucs_check_cpu_flags(void)
         { "sse42", UCS_CPU_FLAG_SSE42 },
         { "avx", UCS_CPU_FLAG_AVX },
         { "avx2", UCS_CPU_FLAG_AVX2 },
+        { "avx512f", UCS_CPU_FLAG_AVX512F },
         { NULL, UCS_CPU_FLAG_UNKNOWN },
     };
 
@@ -221,6 +221,10 @@ typedef enum uct_atomic_op {
 #define UCT_IFACE_FLAG_AM_DUP         UCS_BIT(43) /**< Active messages may be received with duplicates
                                                        This happens if the transport does not keep enough
                                                        information to detect retransmissions */
+#define UCT_IFACE_FLAG_TARGET_PROGRESS UCS_BIT(49) /**< Remote memory access and atomic operations
+                                                        are executed by the progress of the target
+                                                        worker, so they complete only while the
+                                                        target is progressed */
 
         /* Callback invocation */
 #define UCT_IFACE_FLAG_CB_SYNC        UCS_BIT(44) /**< Interface supports setting a callback
@@ -613,4 +613,22 @@ size_t uct_iov_total_length(const uct_iov_t *iov, size_t iovcnt)
     return total_length;
 }
 
+/**
+ * Copies the data of the iov array to a contiguous buffer, and returns the
+ * total length which was copied.
+ */
+static UCS_F_ALWAYS_INLINE
+size_t uct_iov_to_buffer(const uct_iov_t *iov, size_t iovcnt, void *buffer)
+{
+    size_t iov_it, length, offset = 0;
+
+    for (iov_it = 0; iov_it < iovcnt; ++iov_it) {
+        length = uct_iov_get_length(&iov[iov_it]);
+        memcpy(UCS_PTR_BYTE_OFFSET(buffer, offset), iov[iov_it].buffer, length);
+        offset += length;
+    }
+
+    return offset;
+}
+
 #endif
@@ -54,6 +54,40 @@ ucs_status_t uct_sm_ep_get_bcopy(uct_ep_h tl_ep, uct_unpack_callback_t unpack_cb
     return UCS_OK;
 }
 
+ucs_status_t uct_sm_ep_put_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                 size_t iovcnt, uint64_t remote_addr,
+                                 uct_rkey_t rkey, uct_completion_t *comp)
+{
+    size_t length;
+
+    /* The remote memory is mapped, so the data is copied once and the
+     * operation is completed immediately */
+    length = uct_iov_to_buffer(iov, iovcnt, (void *)(rkey + remote_addr));
+    uct_sm_ep_trace_data(remote_addr, rkey, "PUT_ZCOPY [iovcnt %zu size %zu]",
+                         iovcnt, length);
+    UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), PUT, ZCOPY, length);
+    return UCS_OK;
+}
+
+ucs_status_t uct_sm_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                 size_t iovcnt, uint64_t remote_addr,
+                                 uct_rkey_t rkey, uct_completion_t *comp)
+{
+    size_t iov_it, length, offset = 0;
+
+    for (iov_it = 0; iov_it < iovcnt; ++iov_it) {
+        length = uct_iov_get_length(&iov[iov_it]);
+        memcpy(iov[iov_it].buffer, (void *)(rkey + remote_addr + offset),
+               length);
+        offset += length;
+    }
+
+    uct_sm_ep_trace_data(remote_addr, rkey, "GET_ZCOPY [iovcnt %zu size %zu]",
+                         iovcnt, offset);
+    UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), GET, ZCOPY, offset);
+    return UCS_OK;
+}
+
 ucs_status_t uct_sm_ep_atomic32_post(uct_ep_h ep, unsigned opcode, uint32_t value,
                                      uint64_t remote_addr, uct_rkey_t rkey)
 {
@@ -12,6 +12,7 @@
 
 #include "cma_ep.h"
 #include <uct/sm/base/sm_iface.h>
+#include <ucs/arch/atomic.h>
 #include <ucs/debug/log.h>
 
 
@@ -47,12 +48,7 @@ ucs_status_t uct_cma_ep_common_zcopy(uct_ep_h tl_ep,
                                      size_t iovcnt,
                                      uint64_t remote_addr,
                                      uct_completion_t *comp,
-                                     ssize_t (*fn_p)(pid_t,
-                                                     const struct iovec *,
-                                                     unsigned long,
-                                                     const struct iovec *,
-                                                     unsigned long,
-                                                     unsigned long),
+                                     uct_cma_copy_func_t fn_p,
                                      char *fn_name)
 {
     ssize_t ret;
@@ -120,19 +116,125 @@ ucs_status_t uct_cma_ep_common_zcopy(uct_ep_h tl_ep,
     return UCS_OK;
 }
 
+/* copy the chunks of a parallel request, until none are left */
+void uct_cma_ep_copy_req_progress(uct_cma_copy_req_t *req)
+{
+    uct_cma_iface_t *iface = ucs_derived_of(req->tl_ep->iface, uct_cma_iface_t);
+    uct_iov_t chunk_iov[UCT_SM_MAX_IOV];
+    size_t chunk_iovcnt, iov_it, iov_offset, iov_length;
+    uint64_t chunk_start, chunk_end;
+    size_t start, end, offset;
+    ucs_status_t status;
+    uint32_t chunk;
+
+    for (;;) {
+        chunk = ucs_atomic_fadd32(&req->next_chunk, 1);
+        if (chunk >= req->num_chunks) {
+            return;
+        }
+
+        /* the chunks are aligned on the remote address, so the first and the
+         * last one may be shorter */
+        chunk_start = ucs_align_down(req->remote_addr, iface->config.chunk) +
+                      (chunk * iface->config.chunk);
+        chunk_end   = chunk_start + iface->config.chunk;
+        start       = ucs_max(chunk_start, req->remote_addr) - req->remote_addr;
+        end         = ucs_min(chunk_end, req->remote_addr + req->length) -
+                      req->remote_addr;
+
+        /* the part of the local iov which corresponds to [start, end) */
+        chunk_iovcnt = 0;
+        offset       = 0;
+        for (iov_it = 0; (iov_it < req->iovcnt) && (offset < end); ++iov_it) {
+            iov_length = uct_iov_get_length(&req->iov[iov_it]);
+            if ((iov_length == 0) || (offset + iov_length <= start)) {
+                offset += iov_length;
+                continue;
+            }
+
+            iov_offset = (start > offset) ? (start - offset) : 0;
+            chunk_iov[chunk_iovcnt].buffer = (char*)req->iov[iov_it].buffer +
+                                             iov_offset;
+            chunk_iov[chunk_iovcnt].length = ucs_min(offset + iov_length, end) -
+                                             offset - iov_offset;
+            chunk_iov[chunk_iovcnt].memh   = req->iov[iov_it].memh;
+            chunk_iov[chunk_iovcnt].stride = 0;
+            chunk_iov[chunk_iovcnt].count  = 1;
+            ++chunk_iovcnt;
+            offset += iov_length;
+        }
+
+        status = uct_cma_ep_common_zcopy(req->tl_ep, chunk_iov, chunk_iovcnt,
+                                         req->remote_addr + start, NULL,
+                                         req->fn_p, req->fn_name);
+        if (status != UCS_OK) {
+            req->status = status;
+        }
+    }
+}
+
+/* split a large operation to chunks, and copy them by the helper threads */
+static ucs_status_t uct_cma_ep_parallel_zcopy(uct_ep_h tl_ep,
+                                              const uct_iov_t *iov,
+                                              size_t iovcnt,
+                                              uint64_t remote_addr,
+                                              size_t length,
+                                              uct_cma_copy_func_t fn_p,
+                                              char *fn_name)
+{
+    uct_cma_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_cma_iface_t);
+    uct_cma_copy_req_t req;
+
+    req.tl_ep       = tl_ep;
+    req.iov         = iov;
+    req.iovcnt      = iovcnt;
+    req.remote_addr = remote_addr;
+    req.length      = length;
+    req.fn_p        = fn_p;
+    req.fn_name     = fn_name;
+    req.num_chunks  = (ucs_align_up(remote_addr + length, iface->config.chunk) -
+                       ucs_align_down(remote_addr, iface->config.chunk)) /
+                      iface->config.chunk;
+    req.next_chunk  = 0;
+    req.status      = UCS_OK;
+
+    uct_cma_iface_parallel_copy(iface, &req);
+    return req.status;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+uct_cma_ep_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov, size_t iovcnt,
+                 uint64_t remote_addr, uct_completion_t *comp,
+                 uct_cma_copy_func_t fn_p, char *fn_name)
+{
+    uct_cma_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_cma_iface_t);
+    size_t length;
+
+    if (iface->copy.num_threads > 0) {
+        length = uct_iov_total_length(iov, iovcnt);
+        if (length >= iface->config.thresh) {
+            return uct_cma_ep_parallel_zcopy(tl_ep, iov, iovcnt, remote_addr,
+                                             length, fn_p, fn_name);
+        }
+    }
+
+    return uct_cma_ep_common_zcopy(tl_ep, iov, iovcnt, remote_addr, comp, fn_p,
+                                   fn_name);
+}
+
 ucs_status_t uct_cma_ep_put_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov, size_t iovcnt,
                                   uint64_t remote_addr, uct_rkey_t rkey,
                                   uct_completion_t *comp)
 {
     UCT_CHECK_IOV_SIZE(iovcnt, uct_sm_get_max_iov(), "uct_cma_ep_put_zcopy");
 
-    int ret = uct_cma_ep_common_zcopy(tl_ep,
-                                      iov,
-                                      iovcnt,
-                                      remote_addr,
-                                      comp,
-                                      process_vm_writev,
-                                      "process_vm_writev");
+    int ret = uct_cma_ep_zcopy(tl_ep,
+                               iov,
+                               iovcnt,
+                               remote_addr,
+                               comp,
+                               process_vm_writev,
+                               "process_vm_writev");
 
     UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), PUT, ZCOPY,
                       uct_iov_total_length(iov, iovcnt));
@@ -147,13 +249,13 @@ ucs_status_t uct_cma_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov, size_t i
 {
     UCT_CHECK_IOV_SIZE(iovcnt, uct_sm_get_max_iov(), "uct_cma_ep_get_zcopy");
 
-    int ret = uct_cma_ep_common_zcopy(tl_ep,
-                                      iov,
-                                      iovcnt,
-                                      remote_addr,
-                                      comp,
-                                      process_vm_readv,
-                                      "process_vm_readv");
+    int ret = uct_cma_ep_zcopy(tl_ep,
+                               iov,
+                               iovcnt,
+                               remote_addr,
+                               comp,
+                               process_vm_readv,
+                               "process_vm_readv");
 
     UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), GET, ZCOPY,
                       uct_iov_total_length(iov, iovcnt));
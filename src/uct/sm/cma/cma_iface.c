@@ -11,6 +11,7 @@
 #include <uct/base/uct_md.h>
 #include <uct/sm/base/sm_iface.h>
 #include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
 
 
 UCT_MD_REGISTER_TL(&uct_cma_md_component, &uct_cma_tl);
@@ -19,6 +20,23 @@ static ucs_config_field_t uct_cma_iface_config_table[] = {
     {"", "ALLOC=huge,thp,mmap,heap", NULL,
     ucs_offsetof(uct_cma_iface_config_t, super),
     UCS_CONFIG_TYPE_TABLE(uct_iface_config_table)},
+
+    {"COPY_THREADS", "0",
+     "Number of helper threads which copy large zero-copy PUT/GET operations\n"
+     "together with the calling thread. 0 disables the parallel copy.",
+     ucs_offsetof(uct_cma_iface_config_t, copy_threads), UCS_CONFIG_TYPE_UINT},
+
+    {"COPY_THRESH", "1m",
+     "Minimal size of a zero-copy operation which is copied in parallel by the\n"
+     "helper threads.",
+     ucs_offsetof(uct_cma_iface_config_t, copy_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"COPY_CHUNK", "256k",
+     "Size of the chunks which a parallel copy is split to. Rounded up to a\n"
+     "multiple of the page size, and chunks start on remote addresses which\n"
+     "are aligned to it.",
+     ucs_offsetof(uct_cma_iface_config_t, copy_chunk), UCS_CONFIG_TYPE_MEMUNITS},
+
     {NULL}
 };
 
@@ -89,10 +107,135 @@ static uct_iface_ops_t uct_cma_iface_ops = {
     .iface_is_reachable       = uct_sm_iface_is_reachable
 };
 
+static void *uct_cma_iface_copy_thread_func(void *arg)
+{
+    uct_cma_iface_t *iface = arg;
+    uct_cma_copy_req_t *req;
+    uint64_t last_sn = 0;
+
+    pthread_mutex_lock(&iface->copy.lock);
+    for (;;) {
+        while (!iface->copy.stop &&
+               ((iface->copy.req == NULL) || (iface->copy.req_sn == last_sn))) {
+            pthread_cond_wait(&iface->copy.cond, &iface->copy.lock);
+        }
+
+        if (iface->copy.stop) {
+            break;
+        }
+
+        req     = iface->copy.req;
+        last_sn = iface->copy.req_sn;
+        ++iface->copy.active;
+        pthread_mutex_unlock(&iface->copy.lock);
+
+        uct_cma_ep_copy_req_progress(req);
+
+        pthread_mutex_lock(&iface->copy.lock);
+        if (--iface->copy.active == 0) {
+            pthread_cond_signal(&iface->copy.done_cond);
+        }
+    }
+    pthread_mutex_unlock(&iface->copy.lock);
+
+    return NULL;
+}
+
+void uct_cma_iface_parallel_copy(uct_cma_iface_t *iface, uct_cma_copy_req_t *req)
+{
+    pthread_mutex_lock(&iface->copy.submit_lock);
+
+    pthread_mutex_lock(&iface->copy.lock);
+    iface->copy.req = req;
+    ++iface->copy.req_sn;
+    pthread_cond_broadcast(&iface->copy.cond);
+    pthread_mutex_unlock(&iface->copy.lock);
+
+    /* copy chunks in the calling thread as well */
+    uct_cma_ep_copy_req_progress(req);
+
+    /* all chunks are taken. wait for the threads which are still copying
+     * theirs, and don't let late threads see the request */
+    pthread_mutex_lock(&iface->copy.lock);
+    iface->copy.req = NULL;
+    while (iface->copy.active > 0) {
+        pthread_cond_wait(&iface->copy.done_cond, &iface->copy.lock);
+    }
+    pthread_mutex_unlock(&iface->copy.lock);
+
+    pthread_mutex_unlock(&iface->copy.submit_lock);
+}
+
+static void uct_cma_iface_stop_copy_threads(uct_cma_iface_t *iface,
+                                            unsigned num_threads)
+{
+    unsigned i;
+
+    pthread_mutex_lock(&iface->copy.lock);
+    iface->copy.stop = 1;
+    pthread_cond_broadcast(&iface->copy.cond);
+    pthread_mutex_unlock(&iface->copy.lock);
+
+    for (i = 0; i < num_threads; ++i) {
+        pthread_join(iface->copy.threads[i], NULL);
+    }
+
+    ucs_free(iface->copy.threads);
+    pthread_cond_destroy(&iface->copy.done_cond);
+    pthread_cond_destroy(&iface->copy.cond);
+    pthread_mutex_destroy(&iface->copy.lock);
+    pthread_mutex_destroy(&iface->copy.submit_lock);
+}
+
+static ucs_status_t uct_cma_iface_start_copy_threads(uct_cma_iface_t *iface,
+                                                     unsigned num_threads)
+{
+    unsigned i;
+    int ret;
+
+    iface->copy.num_threads = 0;
+    iface->copy.threads     = NULL;
+    if (num_threads == 0) {
+        return UCS_OK;
+    }
+
+    iface->copy.threads = ucs_calloc(num_threads, sizeof(*iface->copy.threads),
+                                     "cma_copy_threads");
+    if (iface->copy.threads == NULL) {
+        ucs_error("failed to allocate %u cma copy threads", num_threads);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    pthread_mutex_init(&iface->copy.submit_lock, NULL);
+    pthread_mutex_init(&iface->copy.lock, NULL);
+    pthread_cond_init(&iface->copy.cond, NULL);
+    pthread_cond_init(&iface->copy.done_cond, NULL);
+    iface->copy.req    = NULL;
+    iface->copy.req_sn = 0;
+    iface->copy.active = 0;
+    iface->copy.stop   = 0;
+
+    for (i = 0; i < num_threads; ++i) {
+        ret = pthread_create(&iface->copy.threads[i], NULL,
+                             uct_cma_iface_copy_thread_func, iface);
+        if (ret != 0) {
+            ucs_error("failed to create cma copy thread: %s", strerror(ret));
+            uct_cma_iface_stop_copy_threads(iface, i);
+            return UCS_ERR_IO_ERROR;
+        }
+    }
+
+    iface->copy.num_threads = num_threads;
+    return UCS_OK;
+}
+
 static UCS_CLASS_INIT_FUNC(uct_cma_iface_t, uct_md_h md, uct_worker_h worker,
                            const uct_iface_params_t *params,
                            const uct_iface_config_t *tl_config)
 {
+    uct_cma_iface_config_t *config = ucs_derived_of(tl_config,
+                                                    uct_cma_iface_config_t);
+
     ucs_assert(params->open_mode & UCT_IFACE_OPEN_MODE_DEVICE);
 
     UCS_CLASS_CALL_SUPER_INIT(uct_base_iface_t, &uct_cma_iface_ops, md, worker,
@@ -100,11 +243,18 @@ static UCS_CLASS_INIT_FUNC(uct_cma_iface_t, uct_md_h md, uct_worker_h worker,
                               UCS_STATS_ARG(UCT_CMA_TL_NAME));
     uct_sm_get_max_iov(); /* to initialize ucs_get_max_iov static variable */
 
-    return UCS_OK;
+    self->config.thresh = ucs_max(config->copy_thresh, 1ul);
+    self->config.chunk  = ucs_align_up(ucs_max(config->copy_chunk, 1ul),
+                                       ucs_get_page_size());
+
+    return uct_cma_iface_start_copy_threads(self, config->copy_threads);
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_cma_iface_t)
 {
+    if (self->copy.num_threads > 0) {
+        uct_cma_iface_stop_copy_threads(self, self->copy.num_threads);
+    }
 }
 
 UCS_CLASS_DEFINE(uct_cma_iface_t, uct_base_iface_t);
@@ -8,20 +8,70 @@
 #define UCT_CMA_IFACE_H
 
 #include <uct/base/uct_iface.h>
+#include <pthread.h>
+#include <sys/uio.h>
 
 #define UCT_CMA_TL_NAME "cma"
 
 
+typedef ssize_t (*uct_cma_copy_func_t)(pid_t, const struct iovec *,
+                                       unsigned long, const struct iovec *,
+                                       unsigned long, unsigned long);
+
+
 typedef struct uct_cma_iface_config {
     uct_iface_config_t      super;
+    unsigned                copy_threads;   /* Number of helper copy threads */
+    size_t                  copy_thresh;    /* Minimal size of a parallel copy */
+    size_t                  copy_chunk;     /* Size of a parallel copy chunk */
 } uct_cma_iface_config_t;
 
 
+/**
+ * Large zero-copy operation, which is split to chunks copied in parallel by
+ * the calling thread and the helper threads of the interface.
+ */
+typedef struct uct_cma_copy_req {
+    uct_ep_h                tl_ep;
+    const uct_iov_t         *iov;
+    size_t                  iovcnt;
+    uint64_t                remote_addr;
+    size_t                  length;         /* total length of the iov */
+    uct_cma_copy_func_t     fn_p;
+    char                    *fn_name;
+    unsigned                num_chunks;
+    volatile uint32_t       next_chunk;     /* next chunk to copy */
+    volatile ucs_status_t   status;         /* error of any of the chunks */
+} uct_cma_copy_req_t;
+
+
 typedef struct uct_cma_iface {
     uct_base_iface_t        super;
+
+    struct {
+        size_t              thresh;         /* minimal size of a parallel copy */
+        size_t              chunk;          /* chunk size, multiple of page size */
+    } config;
+
+    /* helper threads which copy chunks of large zero-copy operations */
+    struct {
+        pthread_t           *threads;
+        unsigned            num_threads;
+        pthread_mutex_t     submit_lock;    /* one request at a time */
+        pthread_mutex_t     lock;           /* protects the fields below */
+        pthread_cond_t      cond;           /* signals a new request or stop */
+        pthread_cond_t      done_cond;      /* signals that a thread is idle */
+        uct_cma_copy_req_t  *req;           /* current request, or NULL */
+        uint64_t            req_sn;         /* serial number of the request */
+        unsigned            active;         /* threads working on the request */
+        int                 stop;
+    } copy;
 } uct_cma_iface_t;
 
 
+void uct_cma_iface_parallel_copy(uct_cma_iface_t *iface, uct_cma_copy_req_t *req);
+
+
 extern uct_tl_component_t uct_cma_tl;
 
 #endif
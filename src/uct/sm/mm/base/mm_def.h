@@ -15,9 +15,11 @@
 typedef struct uct_mm_ep                uct_mm_ep_t;
 typedef struct uct_mm_iface             uct_mm_iface_t;
 typedef struct uct_mm_fifo_ctl          uct_mm_fifo_ctl_t;
+typedef struct uct_mm_fifo_lane_ctl     uct_mm_fifo_lane_ctl_t;
 typedef struct uct_mm_fifo_element      uct_mm_fifo_element_t;
 typedef struct uct_mm_recv_desc         uct_mm_recv_desc_t;
 typedef struct uct_mm_remote_seg        uct_mm_remote_seg_t;
+typedef struct uct_mm_remote_peer       uct_mm_remote_peer_t;
 
 #define UCT_MM_BASE_ADDRESS_HASH_SIZE    64
 
@@ -33,7 +35,11 @@ enum {
 
 #define UCT_MM_IFACE_GET_FIFO_ELEM(_iface, _fifo , _index) \
           (uct_mm_fifo_element_t*) ((char*)(_fifo) + ((_index) * \
-          (_iface)->config.fifo_elem_size));
+          (_iface)->config.fifo_elem_size))
+
+/* size of the inline data part of a FIFO element */
+#define UCT_MM_FIFO_ELEM_DATA_SIZE(_iface) \
+          ((_iface)->config.fifo_elem_size - sizeof(uct_mm_fifo_element_t))
 
 #define UCT_MM_IFACE_GET_DESC_START(_iface, _fifo_elem_p) \
           (uct_mm_recv_desc_t *) ((_fifo_elem_p)->desc_chunk_base_addr +  \
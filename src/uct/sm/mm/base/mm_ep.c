@@ -13,6 +13,10 @@ SGLIB_DEFINE_LIST_FUNCTIONS(uct_mm_remote_seg_t, uct_mm_remote_seg_compare, next
 SGLIB_DEFINE_HASHED_CONTAINER_FUNCTIONS(uct_mm_remote_seg_t,
                                         UCT_MM_BASE_ADDRESS_HASH_SIZE,
                                         uct_mm_remote_seg_hash)
+SGLIB_DEFINE_LIST_FUNCTIONS(uct_mm_remote_peer_t, uct_mm_remote_peer_compare, next)
+SGLIB_DEFINE_HASHED_CONTAINER_FUNCTIONS(uct_mm_remote_peer_t,
+                                        UCT_MM_BASE_ADDRESS_HASH_SIZE,
+                                        uct_mm_remote_peer_hash)
 
 
 /* send a signal to remote interface using Unix-domain socket */
@@ -50,16 +54,45 @@ static void uct_mm_ep_signal_remote(uct_mm_ep_t *ep)
     }
 }
 
-static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, uct_iface_t *tl_iface,
-                           const uct_device_addr_t *dev_addr,
-                           const uct_iface_addr_t *iface_addr)
+/* find the remote interface in the cache, or attach to its FIFO and add it */
+static ucs_status_t uct_mm_ep_get_peer(uct_mm_iface_t *iface,
+                                       const uct_mm_iface_addr_t *addr,
+                                       uct_mm_remote_peer_t **peer_p)
 {
-    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
-    const uct_mm_iface_addr_t *addr = (const void*)iface_addr;
-    ucs_status_t status;
+    uct_mm_remote_peer_t *peer, search;
     size_t size_to_attach;
+    ucs_status_t status;
+#if ENABLE_STATS
+    struct sglib_hashed_uct_mm_remote_seg_t_iterator iter;
+    uct_mm_remote_seg_t *remote_seg;
+#endif
+
+    search.fifo_mmid = addr->id;
+    peer = sglib_hashed_uct_mm_remote_peer_t_find_member(iface->peers_hash,
+                                                         &search);
+    if (peer != NULL) {
+        /* another endpoint is already connected to this peer, so the new one
+         * does not attach the FIFO and the descriptor segments it mapped */
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_ATTACH_HIT, 1);
+#if ENABLE_STATS
+        for (remote_seg = sglib_hashed_uct_mm_remote_seg_t_it_init(&iter,
+                                                                   peer->segments_hash);
+             remote_seg != NULL;
+             remote_seg = sglib_hashed_uct_mm_remote_seg_t_it_next(&iter)) {
+            UCS_STATS_UPDATE_COUNTER(iface->stats,
+                                     UCT_MM_IFACE_STAT_ATTACH_HIT, 1);
+        }
+#endif
+        ++peer->refcount;
+        *peer_p = peer;
+        return UCS_OK;
+    }
 
-    UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super);
+    peer = ucs_malloc(sizeof(*peer), "mm_peer");
+    if (peer == NULL) {
+        ucs_error("failed to allocate mm remote peer");
+        return UCS_ERR_NO_MEMORY;
+    }
 
     /* Connect to the remote address (remote FIFO) */
     /* Attach the address's memory */
@@ -68,53 +101,51 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, uct_iface_t *tl_iface,
         uct_mm_md_mapper_ops(iface->super.md)->attach(addr->id,
                                                       size_to_attach,
                                                       (void *)addr->vaddr,
-                                                      &self->mapped_desc.address,
-                                                      &self->mapped_desc.cookie,
+                                                      &peer->fifo_seg.address,
+                                                      &peer->fifo_seg.cookie,
                                                       iface->path);
     if (status != UCS_OK) {
         ucs_error("failed to connect to remote peer with mm. remote mm_id: %zu",
                    addr->id);
+        ucs_free(peer);
         return status;
     }
 
-    self->mapped_desc.length     = size_to_attach;
-    self->mapped_desc.mmid       = addr->id;
-
-    /* point the ep->fifo_ctl to the remote fifo.
-      * it's an aligned pointer to the beginning of the ctl struct in the remote FIFO */
-    self->fifo_ctl        = uct_mm_set_fifo_ctl(self->mapped_desc.address);
-    self->cached_tail     = self->fifo_ctl->tail;
-    self->signal.addrlen  = self->fifo_ctl->signal_addrlen;
-    self->signal.sockaddr = self->fifo_ctl->signal_sockaddr;
-
-    /* Make sure the fifo ctrl is aligned */
-    ucs_assert_always(((uintptr_t)self->fifo_ctl % UCS_SYS_CACHE_LINE_SIZE) == 0);
-
-    /* set the ep->fifo ptr to point to the beginning of the fifo elements at
-     * the remote peer */
-    uct_mm_set_fifo_elems_ptr(self->mapped_desc.address, &self->fifo);
+    peer->fifo_seg.length = size_to_attach;
+    peer->fifo_seg.mmid   = addr->id;
+    peer->fifo_mmid       = addr->id;
+    peer->refcount        = 1;
 
     /* Initiate the hash which will keep the base_adresses of remote memory
      * chunks that hold the descriptors for bcopy. */
-    sglib_hashed_uct_mm_remote_seg_t_init(self->remote_segments_hash);
+    sglib_hashed_uct_mm_remote_seg_t_init(peer->segments_hash);
+    sglib_hashed_uct_mm_remote_peer_t_add(iface->peers_hash, peer);
 
-    ucs_arbiter_group_init(&self->arb_group);
-
-    ucs_debug("mm: ep connected: %p, to remote_shmid: %zu", self, addr->id);
+    UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_ATTACH_MISS, 1);
+    UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_ACTIVE_MAPPINGS, 1);
 
+    *peer_p = peer;
     return UCS_OK;
 }
 
-static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
+/* release the endpoint's reference to the remote interface, and detach from
+ * its memory when there are no more endpoints connected to it */
+static void uct_mm_ep_put_peer(uct_mm_iface_t *iface, uct_mm_remote_peer_t *peer)
 {
-    uct_mm_iface_t *iface = ucs_derived_of(self->super.super.iface, uct_mm_iface_t);
-    ucs_status_t status;
     uct_mm_remote_seg_t *remote_seg;
     struct sglib_hashed_uct_mm_remote_seg_t_iterator iter;
+    ucs_status_t status;
+
+    ucs_assert(peer->refcount > 0);
+    if (--peer->refcount > 0) {
+        return;
+    }
 
-    for (remote_seg = sglib_hashed_uct_mm_remote_seg_t_it_init(&iter, self->remote_segments_hash);
+    sglib_hashed_uct_mm_remote_peer_t_delete(iface->peers_hash, peer);
+
+    for (remote_seg = sglib_hashed_uct_mm_remote_seg_t_it_init(&iter, peer->segments_hash);
          remote_seg != NULL; remote_seg = sglib_hashed_uct_mm_remote_seg_t_it_next(&iter)) {
-            sglib_hashed_uct_mm_remote_seg_t_delete(self->remote_segments_hash, remote_seg);
+            sglib_hashed_uct_mm_remote_seg_t_delete(peer->segments_hash, remote_seg);
             /* detach the remote proceess's descriptors segment */
             status = uct_mm_md_mapper_ops(iface->super.md)->detach(remote_seg);
             if (status != UCS_OK) {
@@ -122,14 +153,179 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
                          ucs_status_string(status));
             }
             ucs_free(remote_seg);
+            UCS_STATS_UPDATE_COUNTER(iface->stats,
+                                     UCT_MM_IFACE_STAT_ACTIVE_MAPPINGS, -1);
     }
 
     /* detach the remote proceess's shared memory segment (remote recv FIFO) */
-    status = uct_mm_md_mapper_ops(iface->super.md)->detach(&self->mapped_desc);
+    status = uct_mm_md_mapper_ops(iface->super.md)->detach(&peer->fifo_seg);
     if (status != UCS_OK) {
         ucs_error("error detaching from remote FIFO");
     }
+    UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_ACTIVE_MAPPINGS, -1);
+
+    ucs_free(peer);
+}
+
+/* take the first free lane of the remote FIFO, if there is one */
+static int uct_mm_ep_take_lane(uct_mm_ep_t *ep, uct_mm_iface_t *iface)
+{
+    uct_mm_fifo_ctl_t *fifo_ctl = ep->fifo_ctl;
+    uct_mm_fifo_lane_ctl_t *lane_ctl;
+    uint32_t index, count;
+
+    for (index = 0; index < fifo_ctl->num_lanes; ++index) {
+        lane_ctl = uct_mm_fifo_lane_ctl(iface, fifo_ctl, index);
+        if ((lane_ctl->owner == 0) &&
+            (ucs_atomic_cswap32(&lane_ctl->owner, 0, 1) == 0)) {
+            break;
+        }
+    }
+
+    if (index == fifo_ctl->num_lanes) {
+        return 0;
+    }
+
+    /* make the receiver poll the lane */
+    do {
+        count = fifo_ctl->lane_count;
+    } while ((count <= index) &&
+             (ucs_atomic_cswap32(&fifo_ctl->lane_count, count,
+                                 index + 1) != count));
+
+    /* continue from where the previous owner of the lane stopped, its last
+     * elements may still be unread */
+    ep->lane.ctl          = lane_ctl;
+    ep->lane.elems        = lane_ctl + 1;
+    ep->lane.head         = lane_ctl->head;
+    ep->lane.checked_head = ep->lane.head;
+    ep->cached_tail       = lane_ctl->tail;
+    ucs_debug("mm: ep %p uses lane %u of remote FIFO", ep, index);
+    return 1;
+}
+
+static void uct_mm_ep_release_lane(uct_mm_ep_t *ep)
+{
+    uct_mm_fifo_lane_ctl_t *lane_ctl = ep->lane.ctl;
+
+    ucs_debug("mm: ep %p releases its lane of remote FIFO", ep);
+
+    /* the head must be visible to the next owner before the lane is free */
+    lane_ctl->head = ep->lane.head;
+    ucs_memory_cpu_store_fence();
+    lane_ctl->owner = 0;
+
+    ep->lane.ctl          = NULL;
+    ep->lane.elems        = NULL;
+    ep->lane.checked_head = ep->lane.fifo_head;
+    ep->cached_tail       = ep->fifo_ctl->tail;
+}
+
+/* Called periodically by the interface progress. Messages of the ep are
+ * received in order only if it switches between its lane and the shared FIFO
+ * after the receiver has read everything it wrote to the one it leaves. */
+void uct_mm_ep_check_lane(uct_mm_ep_t *ep)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                           uct_mm_iface_t);
+
+    if (ep->lane.ctl != NULL) {
+        /* release the lane if nothing was sent on it since the last check */
+        if ((ep->lane.head == ep->lane.checked_head) &&
+            (ep->lane.ctl->tail == ep->lane.head)) {
+            uct_mm_ep_release_lane(ep);
+        } else {
+            ep->lane.checked_head = ep->lane.head;
+        }
+    } else {
+        /* an ep which sends on the shared FIFO takes a released lane. the
+         * shared tail is published in batches, so this may be postponed */
+        if ((ep->lane.fifo_head == ep->lane.checked_head) ||
+            (ep->fifo_ctl->tail < ep->lane.fifo_head) ||
+            !uct_mm_ep_take_lane(ep, iface)) {
+            ep->lane.checked_head = ep->lane.fifo_head;
+        }
+    }
+}
+
+/* lanes may be used if the remote side has the same layout, which is derived
+ * from the local configuration */
+static void uct_mm_ep_init_lane(uct_mm_ep_t *ep, uct_mm_iface_t *iface)
+{
+    uct_mm_fifo_ctl_t *fifo_ctl = ep->fifo_ctl;
+
+    ep->lane.ctl          = NULL;
+    ep->lane.elems        = NULL;
+    ep->lane.head         = 0;
+    ep->lane.fifo_head    = 0;
+    ep->lane.checked_head = 0;
+    ucs_list_head_init(&ep->lane.list);
+
+    if ((iface->config.num_lanes == 0) ||
+        (fifo_ctl->num_lanes != iface->config.num_lanes) ||
+        (fifo_ctl->lane_size != iface->config.lane_size)) {
+        return;
+    }
+
+    ucs_list_add_tail(&iface->lane_eps, &ep->lane.list);
+    if (!uct_mm_ep_take_lane(ep, iface)) {
+        ucs_debug("mm: all %u lanes of remote FIFO are taken, ep %p will "
+                  "use the shared FIFO", fifo_ctl->num_lanes, ep);
+    }
+}
+
+static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, uct_iface_t *tl_iface,
+                           const uct_device_addr_t *dev_addr,
+                           const uct_iface_addr_t *iface_addr)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+    const uct_mm_iface_addr_t *addr = (const void*)iface_addr;
+    ucs_status_t status;
+
+    UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super);
+
+    /* get the mapping of the remote FIFO, shared with other endpoints */
+    status = uct_mm_ep_get_peer(iface, addr, &self->peer);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    /* point the ep->fifo_ctl to the remote fifo.
+      * it's an aligned pointer to the beginning of the ctl struct in the remote FIFO */
+    self->fifo_ctl        = uct_mm_set_fifo_ctl(self->peer->fifo_seg.address);
+    self->cached_tail     = self->fifo_ctl->tail;
+    self->tx_span         = 1;
+    self->signal.addrlen  = self->fifo_ctl->signal_addrlen;
+    self->signal.sockaddr = self->fifo_ctl->signal_sockaddr;
+
+    /* Make sure the fifo ctrl is aligned */
+    ucs_assert_always(((uintptr_t)self->fifo_ctl % UCS_SYS_CACHE_LINE_SIZE) == 0);
+
+    /* set the ep->fifo ptr to point to the beginning of the fifo elements at
+     * the remote peer */
+    uct_mm_set_fifo_elems_ptr(self->peer->fifo_seg.address, &self->fifo);
+
+    uct_mm_ep_init_lane(self, iface);
+
+    ucs_arbiter_group_init(&self->arb_group);
+
+    ucs_debug("mm: ep connected: %p, to remote_shmid: %zu", self, addr->id);
+
+    return UCS_OK;
+}
+
+static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(self->super.super.iface, uct_mm_iface_t);
+
+    /* the receiver still reads the elements which were written to the lane,
+     * and the next owner continues after them */
+    if (self->lane.ctl != NULL) {
+        uct_mm_ep_release_lane(self);
+    }
+    ucs_list_del(&self->lane.list);
 
+    uct_mm_ep_put_peer(iface, self->peer);
     uct_mm_ep_pending_purge(&self->super.super, NULL, NULL);
 }
 
@@ -144,11 +340,12 @@ void *uct_mm_ep_attach_remote_seg(uct_mm_ep_t *ep, uct_mm_iface_t *iface, uct_mm
     ucs_status_t status;
 
     /* take the mmid of the chunk that the desc belongs to, (the desc that the fifo_elem
-     * is 'assigned' to), and check if the ep has already attached to it.
+     * is 'assigned' to), and check if an ep to this peer has already attached to it.
      */
     search.mmid = elem->desc_mmid;
-    remote_seg = sglib_hashed_uct_mm_remote_seg_t_find_member(ep->remote_segments_hash, &search);
-    if (remote_seg == NULL) {
+    remote_seg = sglib_hashed_uct_mm_remote_seg_t_find_member(ep->peer->segments_hash,
+                                                              &search);
+    if (ucs_unlikely(remote_seg == NULL)) {
         /* not in the hash. attach to the memory the mmid refers to. the attach call
          * will return the base address of the mmid's chunk -
          * save this base address in a hash table (which maps mmid to base address). */
@@ -171,8 +368,11 @@ void *uct_mm_ep_attach_remote_seg(uct_mm_ep_t *ep, uct_mm_iface_t *iface, uct_mm
         remote_seg->mmid   = elem->desc_mmid;
         remote_seg->length = elem->desc_mpool_size;
 
-        /* put the base address into the ep's hash table */
-        sglib_hashed_uct_mm_remote_seg_t_add(ep->remote_segments_hash, remote_seg);
+        /* put the base address into the peer's hash table */
+        sglib_hashed_uct_mm_remote_seg_t_add(ep->peer->segments_hash, remote_seg);
+
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_ATTACH_MISS, 1);
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_ACTIVE_MAPPINGS, 1);
     }
 
     return remote_seg->address;
@@ -180,6 +380,7 @@ void *uct_mm_ep_attach_remote_seg(uct_mm_ep_t *ep, uct_mm_iface_t *iface, uct_mm
 }
 
 static inline ucs_status_t uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t head,
+                                                     unsigned span,
                                                      uct_mm_fifo_element_t **elem)
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_mm_iface_t);
@@ -190,8 +391,9 @@ static inline ucs_status_t uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t h
     elem_index = ep->fifo_ctl->head & iface->fifo_mask;
     *elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo, elem_index);
 
-    /* try to get ownership of the head element */
-    returned_val = ucs_atomic_cswap64(&ep->fifo_ctl->head, head, head+1);
+    /* try to get ownership of the head element, and the elements after it
+     * which the message spans */
+    returned_val = ucs_atomic_cswap64(&ep->fifo_ctl->head, head, head + span);
     if (returned_val != head) {
         return UCS_ERR_NO_RESOURCE;
     }
@@ -202,7 +404,76 @@ static inline ucs_status_t uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t h
 static inline void uct_mm_ep_update_cached_tail(uct_mm_ep_t *ep)
 {
     ucs_memory_cpu_load_fence();
-    ep->cached_tail = ep->fifo_ctl->tail;
+    if (ep->lane.ctl != NULL) {
+        ep->cached_tail = ep->lane.ctl->tail;
+    } else {
+        ep->cached_tail = ep->fifo_ctl->tail;
+    }
+}
+
+/* check if there is room in the remote process's receive FIFO (or lane) */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+uct_mm_ep_check_fifo_room(uct_mm_ep_t *ep, uint64_t head, unsigned span,
+                          unsigned fifo_size)
+{
+    if (UCT_MM_EP_IS_ABLE_TO_SEND(head + span - 1, ep->cached_tail,
+                                  fifo_size)) {
+        return UCS_OK;
+    }
+
+    /* pending requests are dispatched when the send has room */
+    ep->tx_span = span;
+
+    if (!ucs_arbiter_group_is_empty(&ep->arb_group)) {
+        /* pending isn't empty. don't send now to prevent out-of-order sending */
+        UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    /* pending is empty */
+    /* update the local copy of the tail to its actual value on the remote peer */
+    uct_mm_ep_update_cached_tail(ep);
+    if (!UCT_MM_EP_IS_ABLE_TO_SEND(head + span - 1, ep->cached_tail,
+                                   fifo_size)) {
+        UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    return UCS_OK;
+}
+
+/* set the owner bit of a FIFO element according to the FIFO wraparound */
+static UCS_F_ALWAYS_INLINE void
+uct_mm_ep_set_elem_owner(uct_mm_fifo_element_t *elem, uint64_t owner)
+{
+    if (owner) {
+        elem->flags |= UCT_MM_FIFO_ELEM_FLAG_OWNER;
+    } else {
+        elem->flags &= ~UCT_MM_FIFO_ELEM_FLAG_OWNER;
+    }
+}
+
+/* scatter a buffer to the data part of consecutive FIFO elements, starting
+ * at byte 'offset' of the message which begins at element 'index' */
+static void uct_mm_ep_copy_to_fifo(uct_mm_iface_t *iface, void *fifo_elems,
+                                   unsigned fifo_mask, uint64_t index,
+                                   size_t offset, const void *src, size_t length)
+{
+    size_t elem_data_size = UCT_MM_FIFO_ELEM_DATA_SIZE(iface);
+    uct_mm_fifo_element_t *elem;
+    size_t elem_offset, chunk;
+
+    index      += offset / elem_data_size;
+    elem_offset = offset % elem_data_size;
+    while (length > 0) {
+        elem  = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, index & fifo_mask);
+        chunk = ucs_min(length, elem_data_size - elem_offset);
+        memcpy((void*)(elem + 1) + elem_offset, src, chunk);
+        src         += chunk;
+        length      -= chunk;
+        elem_offset  = 0;
+        ++index;
+    }
 }
 
 /* A common mm active message sending function.
@@ -216,50 +487,91 @@ uct_mm_ep_am_common_send(unsigned is_short, uct_mm_ep_t *ep, uct_mm_iface_t *ifa
                          const void *payload, uct_pack_callback_t pack_cb, void *arg,
                          unsigned flags)
 {
-    uct_mm_fifo_element_t *elem;
+    uct_mm_fifo_element_t *elem, *next_elem;
     ucs_status_t status;
-    void *base_address;
-    uint64_t head;
+    void *base_address, *fifo_elems;
+    uint64_t head, size;
+    unsigned span, mask, i;
 
     UCT_CHECK_AM_ID(am_id);
 
+    /* a short message which does not fit in one element continues in the
+     * next elements */
+    if (is_short &&
+        ucs_unlikely((length + sizeof(header)) > UCT_MM_FIFO_ELEM_DATA_SIZE(iface))) {
+        span = ucs_div_round_up(length + sizeof(header),
+                                UCT_MM_FIFO_ELEM_DATA_SIZE(iface));
+    } else {
+        span = 1;
+    }
+
+    if (ep->lane.ctl != NULL) {
+        /* the ep is the only writer to its lane, so the element is taken
+         * without an atomic operation */
+        head   = ep->lane.head;
+        status = uct_mm_ep_check_fifo_room(ep, head, span,
+                                           iface->config.lane_size);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        fifo_elems    = ep->lane.elems;
+        mask          = iface->lane_mask;
+        size          = iface->config.lane_size;
+        elem          = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, head & mask);
+        ep->lane.head = head + span;
+    } else {
 retry:
-    head = ep->fifo_ctl->head;
-    /* check if there is room in the remote process's receive FIFO to write */
-    if (!UCT_MM_EP_IS_ABLE_TO_SEND(head, ep->cached_tail, iface->config.fifo_size)) {
-        if (!ucs_arbiter_group_is_empty(&ep->arb_group)) {
-            /* pending isn't empty. don't send now to prevent out-of-order sending */
-            UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
-            return UCS_ERR_NO_RESOURCE;
-        } else {
-            /* pending is empty */
-            /* update the local copy of the tail to its actual value on the remote peer */
-            uct_mm_ep_update_cached_tail(ep);
-            if (!UCT_MM_EP_IS_ABLE_TO_SEND(head, ep->cached_tail, iface->config.fifo_size)) {
-                UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
-                return UCS_ERR_NO_RESOURCE;
-            }
+        head   = ep->fifo_ctl->head;
+        status = uct_mm_ep_check_fifo_room(ep, head, span,
+                                           iface->config.fifo_size);
+        if (status != UCS_OK) {
+            return status;
         }
-    }
 
-    status = uct_mm_ep_get_remote_elem(ep, head, &elem);
-    if (status != UCS_OK) {
-        ucs_assert(status == UCS_ERR_NO_RESOURCE);
-        ucs_trace_poll("couldn't get an available FIFO element. retrying");
-        goto retry;
+        status = uct_mm_ep_get_remote_elem(ep, head, span, &elem);
+        if (status != UCS_OK) {
+            ucs_assert(status == UCS_ERR_NO_RESOURCE);
+            ucs_trace_poll("couldn't get an available FIFO element. retrying");
+            goto retry;
+        }
+
+        fifo_elems         = ep->fifo;
+        mask               = iface->fifo_mask;
+        size               = iface->config.fifo_size;
+        ep->lane.fifo_head = head + span;
     }
 
     if (is_short) {
         /* AM_SHORT */
         /* write to the remote FIFO */
-        *(uint64_t*) (elem + 1) = header;
-        memcpy((void*) (elem + 1) + sizeof(header), payload, length);
+        if (ucs_likely(span == 1)) {
+            *(uint64_t*) (elem + 1) = header;
+            memcpy((void*) (elem + 1) + sizeof(header), payload, length);
+        } else {
+            uct_mm_ep_copy_to_fifo(iface, fifo_elems, mask, head, 0, &header,
+                                   sizeof(header));
+            uct_mm_ep_copy_to_fifo(iface, fifo_elems, mask, head, sizeof(header),
+                                   payload, length);
+
+            /* mark the next elements as written in their round of the FIFO,
+             * so the receiver would not take them for new messages in the
+             * next round. the receiver skips them in this round */
+            for (i = 1; i < span; ++i) {
+                next_elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems,
+                                                       (head + i) & mask);
+                uct_mm_ep_set_elem_owner(next_elem, (head + i) & size);
+            }
+        }
 
         elem->flags |= UCT_MM_FIFO_ELEM_FLAG_INLINE;
         elem->length = length + sizeof(header);
 
+        /* only the part of the message in the first element is contiguous */
         uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, am_id,
-                           elem + 1, length + sizeof(header), "TX: AM_SHORT");
+                           elem + 1, ucs_min(length + sizeof(header),
+                                             UCT_MM_FIFO_ELEM_DATA_SIZE(iface)),
+                           "TX: AM_SHORT");
         UCT_TL_EP_STAT_OP(&ep->super, AM, SHORT, sizeof(header) + length);
     } else {
         /* AM_BCOPY */
@@ -278,6 +590,7 @@ retry:
     }
 
     elem->am_id = am_id;
+    elem->span  = span;
 
     /* memory barrier - make sure that the memory is flushed before setting the
      * 'writing is complete' flag which the reader checks */
@@ -285,14 +598,16 @@ retry:
 
     /* change the owner bit to indicate that the writing is complete.
      * the owner bit flips after every FIFO wraparound */
-    if (head & iface->config.fifo_size) {
-        elem->flags |= UCT_MM_FIFO_ELEM_FLAG_OWNER;
-    } else {
-        elem->flags &= ~UCT_MM_FIFO_ELEM_FLAG_OWNER;
-    }
+    uct_mm_ep_set_elem_owner(elem, head & size);
 
     if (ucs_unlikely(flags & UCT_SEND_FLAG_SIGNALED)) {
-        uct_mm_ep_signal_remote(ep);
+        /* the receiver is signaled only if it is about to sleep. the element
+         * must be visible before the flag is read, since the receiver checks
+         * the FIFO after setting it */
+        ucs_memory_bus_fence();
+        if (ep->fifo_ctl->waiting) {
+            uct_mm_ep_signal_remote(ep);
+        }
     }
 
     if (is_short) {
@@ -308,8 +623,7 @@ ucs_status_t uct_mm_ep_am_short(uct_ep_h tl_ep, uint8_t id, uint64_t header,
     uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
     uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
 
-    UCT_CHECK_LENGTH(length + sizeof(header), 0,
-                     iface->config.fifo_elem_size - sizeof(uct_mm_fifo_element_t),
+    UCT_CHECK_LENGTH(length + sizeof(header), 0, iface->config.max_short,
                      "am_short");
 
     return uct_mm_ep_am_common_send(UCT_MM_AM_SHORT, ep, iface, id, length,
@@ -326,11 +640,18 @@ ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_
                                     pack_cb, arg, flags);
 }
 
-static inline int uct_mm_ep_has_tx_resources(uct_mm_ep_t *ep)
+/* check if there is room for a send which takes 'span' FIFO elements */
+static inline int uct_mm_ep_has_tx_resources(uct_mm_ep_t *ep, unsigned span)
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_mm_iface_t);
-    return UCT_MM_EP_IS_ABLE_TO_SEND(ep->fifo_ctl->head, ep->cached_tail,
-                                     iface->config.fifo_size);
+
+    if (ep->lane.ctl != NULL) {
+        return UCT_MM_EP_IS_ABLE_TO_SEND(ep->lane.head + span - 1,
+                                         ep->cached_tail, iface->config.lane_size);
+    }
+
+    return UCT_MM_EP_IS_ABLE_TO_SEND(ep->fifo_ctl->head + span - 1,
+                                     ep->cached_tail, iface->config.fifo_size);
 }
 
 ucs_status_t uct_mm_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *n,
@@ -339,10 +660,13 @@ ucs_status_t uct_mm_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *n,
     uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
     uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
 
-    /* check if resources became available */
-    if (uct_mm_ep_has_tx_resources(ep)) {
-        ucs_assert(ucs_arbiter_group_is_empty(&ep->arb_group));
-        return UCS_ERR_BUSY;
+    /* check if resources became available for the send which failed. If
+     * there are pending requests, the send failed to keep their order. */
+    if (ucs_arbiter_group_is_empty(&ep->arb_group)) {
+        uct_mm_ep_update_cached_tail(ep);
+        if (uct_mm_ep_has_tx_resources(ep, ep->tx_span)) {
+            return UCS_ERR_BUSY;
+        }
     }
 
     UCS_STATIC_ASSERT(sizeof(uct_pending_req_priv_arb_t) <=
@@ -366,7 +690,7 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
      * making sure that the pending sends would use the real tail value */
     uct_mm_ep_update_cached_tail(ep);
 
-    if (!uct_mm_ep_has_tx_resources(ep)) {
+    if (!uct_mm_ep_has_tx_resources(ep, ep->tx_span)) {
         return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
     }
 
@@ -420,12 +744,12 @@ ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
 {
     uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
 
-    if (!uct_mm_ep_has_tx_resources(ep)) {
+    if (!uct_mm_ep_has_tx_resources(ep, 1)) {
         if (!ucs_arbiter_group_is_empty(&ep->arb_group)) {
             return UCS_ERR_NO_RESOURCE;
         } else {
             uct_mm_ep_update_cached_tail(ep);
-            if (!uct_mm_ep_has_tx_resources(ep)) {
+            if (!uct_mm_ep_has_tx_resources(ep, 1)) {
                 return UCS_ERR_NO_RESOURCE;
             }
         }
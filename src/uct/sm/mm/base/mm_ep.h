@@ -14,19 +14,44 @@
 #include <ucs/datastruct/sglib_wrapper.h>
 
 
+/* A remote interface, shared by all the endpoints of the local interface which
+ * are connected to it, so its memory is mapped only once */
+struct uct_mm_remote_peer {
+    uct_mm_remote_peer_t *next;
+    uct_mm_id_t          fifo_mmid;  /* mmid of the remote receive FIFO */
+    unsigned             refcount;   /* number of endpoints to this peer */
+    uct_mm_remote_seg_t  fifo_seg;   /* mapping of the remote receive FIFO */
+
+    /* mapped remote memory chunks to which remote descriptors belong to.
+     * (after attaching to them) */
+    uct_mm_remote_seg_t  *segments_hash[UCT_MM_BASE_ADDRESS_HASH_SIZE];
+};
+
+
 struct uct_mm_ep {
     uct_base_ep_t       super;
 
     /* Remote peer */
+    uct_mm_remote_peer_t *peer;       /* mappings of the remote interface memory */
     uct_mm_fifo_ctl_t    *fifo_ctl;   /* pointer to the destination's ctl struct in the receive fifo */
     void                 *fifo;       /* fifo elements (destination's receive fifo) */
 
     uint64_t             cached_tail; /* the sender's own copy of the remote FIFO's tail.
                                          it is not always updated with the actual remote tail value */
+    unsigned             tx_span;     /* elements needed by the last send which
+                                         did not find room */
 
-    /* mapped remote memory chunks to which remote descriptors belong to.
-     * (after attaching to them) */
-    uct_mm_remote_seg_t  *remote_segments_hash[UCT_MM_BASE_ADDRESS_HASH_SIZE];
+    /* Private lane in the remote FIFO, written only by this ep */
+    struct {
+        uct_mm_fifo_lane_ctl_t *ctl;  /* NULL if the ep uses the shared FIFO */
+        void                   *elems;
+        uint64_t               head;  /* where to write next */
+        uint64_t               fifo_head;    /* after the last element which
+                                                was written to the shared FIFO */
+        uint64_t               checked_head; /* head at the last idle check */
+        ucs_list_link_t        list;  /* entry in the iface list of endpoints
+                                         which may use lanes */
+    } lane;
 
     ucs_arbiter_group_t  arb_group;   /* the group that holds this ep's pending operations */
 
@@ -35,9 +60,6 @@ struct uct_mm_ep {
         struct sockaddr_un  sockaddr;  /* address of signaling socket */
         socklen_t           addrlen;   /* address length of signaling socket */
     } signal;
-
-    /* Remote peer */
-    uct_mm_remote_seg_t  mapped_desc; /* pointer to the descriptor of the destination's shared_mem (FIFO) */
 };
 
 UCS_CLASS_DECLARE_NEW_FUNC(uct_mm_ep_t, uct_ep_t, uct_iface_t*,
@@ -49,6 +71,8 @@ ucs_status_t uct_mm_ep_am_short(uct_ep_h tl_ep, uint8_t id, uint64_t header,
 ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_cb,
                            void *arg, unsigned flags);
 
+void uct_mm_ep_check_lane(uct_mm_ep_t *ep);
+
 ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
                              uct_completion_t *comp);
 
@@ -72,7 +96,20 @@ static inline int64_t uct_mm_remote_seg_compare(uct_mm_remote_seg_t *seg1, uct_m
     return  seg1->mmid - seg2->mmid;
 }
 
+static inline uint64_t uct_mm_remote_peer_hash(uct_mm_remote_peer_t *peer)
+{
+    return peer->fifo_mmid % UCT_MM_BASE_ADDRESS_HASH_SIZE;
+}
+
+static inline int64_t uct_mm_remote_peer_compare(uct_mm_remote_peer_t *peer1,
+                                                 uct_mm_remote_peer_t *peer2)
+{
+    return peer1->fifo_mmid - peer2->fifo_mmid;
+}
+
 SGLIB_DEFINE_LIST_PROTOTYPES(uct_mm_remote_seg_t, uct_mm_remote_seg_compare, next)
 SGLIB_DEFINE_HASHED_CONTAINER_PROTOTYPES(uct_mm_remote_seg_t, UCT_MM_BASE_ADDRESS_HASH_SIZE, uct_mm_remote_seg_hash)
+SGLIB_DEFINE_LIST_PROTOTYPES(uct_mm_remote_peer_t, uct_mm_remote_peer_compare, next)
+SGLIB_DEFINE_HASHED_CONTAINER_PROTOTYPES(uct_mm_remote_peer_t, UCT_MM_BASE_ADDRESS_HASH_SIZE, uct_mm_remote_peer_hash)
 
 #endif
@@ -4,6 +4,8 @@
  * See file LICENSE for terms.
  */
 
+#define _GNU_SOURCE /* for sched_getcpu(3) */
+
 #include "mm_iface.h"
 #include "mm_ep.h"
 
@@ -15,12 +17,28 @@
 #include <ucs/async/async.h>
 #include <ucs/sys/string.h>
 #include <sys/poll.h>
+#include <sched.h>
 
 
 /* Maximal number of events to clear from the signaling pipe in single call */
 #define UCT_MM_IFACE_MAX_SIG_EVENTS  32
 
 
+#if ENABLE_STATS
+static ucs_stats_class_t uct_mm_iface_stats_class = {
+    .name          = "mm_iface",
+    .num_counters  = UCT_MM_IFACE_STAT_LAST,
+    .counter_names = {
+        [UCT_MM_IFACE_STAT_ATTACH_HIT]      = "attach_hit",
+        [UCT_MM_IFACE_STAT_ATTACH_MISS]     = "attach_miss",
+        [UCT_MM_IFACE_STAT_ACTIVE_MAPPINGS] = "active_mappings",
+        [UCT_MM_IFACE_STAT_NUMA_BIND]       = "numa_bind",
+        [UCT_MM_IFACE_STAT_NUMA_BIND_FAIL]  = "numa_bind_fail"
+    }
+};
+#endif
+
+
 static ucs_config_field_t uct_mm_iface_config_table[] = {
     {"", "ALLOC=md", NULL,
      ucs_offsetof(uct_mm_iface_config_t, super),
@@ -35,6 +53,48 @@ static ucs_config_field_t uct_mm_iface_config_table[] = {
      "This value refers to the percentage of the FIFO size. (must be >= 0 and < 1)",
      ucs_offsetof(uct_mm_iface_config_t, release_fifo_factor), UCS_CONFIG_TYPE_DOUBLE},
 
+    {"FIFO_MAX_POLL", "16",
+     "Maximal number of receive FIFO elements to process in a single progress\n"
+     "call. The FIFO tail is published to the senders once per progress call.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_max_poll), UCS_CONFIG_TYPE_UINT},
+
+    {"FIFO_MAX_SPAN", "16",
+     "Maximal number of consecutive receive FIFO elements which a single short\n"
+     "message may take. Short messages larger than an element continue in the\n"
+     "data part of the next elements, which raises the maximal short message\n"
+     "size without enlarging every element. The value is limited by the FIFO,\n"
+     "lane and receive descriptor sizes. 1 disables multi-element messages.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_max_span), UCS_CONFIG_TYPE_UINT},
+
+    {"FIFO_LANES", "0",
+     "Number of single-sender lanes in the receive FIFO. Each of the first\n"
+     "FIFO_LANES endpoints which connect to the interface gets a private lane,\n"
+     "so it does not compete with other senders on the shared FIFO head.\n"
+     "Endpoints which connect after all lanes were taken use the shared FIFO,\n"
+     "and take a lane when one is released. 0 disables lanes.",
+     ucs_offsetof(uct_mm_iface_config_t, num_lanes), UCS_CONFIG_TYPE_UINT},
+
+    {"FIFO_LANE_SIZE", "16",
+     "Size of each single-sender lane in the receive FIFO. Must be a power of two.",
+     ucs_offsetof(uct_mm_iface_config_t, lane_size), UCS_CONFIG_TYPE_UINT},
+
+    {"FIFO_LANE_IDLE_TIME", "10ms",
+     "An endpoint releases its lane when it did not send on it for this long,\n"
+     "and an endpoint which sends on the shared FIFO takes a released lane.\n"
+     "A lane is also released when its endpoint is destroyed.",
+     ucs_offsetof(uct_mm_iface_config_t, lane_idle_time), UCS_CONFIG_TYPE_TIME},
+
+    {"NUMA_POLICY", "preferred",
+     "NUMA policy of the receive FIFO and the receive descriptors, which are\n"
+     "written by the senders and read by the receiving process.\n"
+     " - default: Do no change existing policy.\n"
+     " - preferred/bind:\n"
+     "     Unless the memory policy of the current thread is MPOL_BIND, set the\n"
+     "     policy of the receive memory to MPOL_PREFERRED/MPOL_BIND, respectively,\n"
+     "     on the numa node of the cpu which creates the interface.",
+     ucs_offsetof(uct_mm_iface_config_t, numa_policy),
+     UCS_CONFIG_TYPE_ENUM(ucs_numa_policy_names)},
+
     UCT_IFACE_MPOOL_CONFIG_FIELDS("RX_", -1, 512, "receive",
                                   ucs_offsetof(uct_mm_iface_config_t, mp), ""),
 
@@ -93,17 +153,16 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     iface_attr->cap.put.max_zcopy       = SIZE_MAX;
     iface_attr->cap.put.opt_zcopy_align = UCS_SYS_CACHE_LINE_SIZE;
     iface_attr->cap.put.align_mtu       = iface_attr->cap.put.opt_zcopy_align;
-    iface_attr->cap.put.max_iov         = 1;
+    iface_attr->cap.put.max_iov         = uct_sm_get_max_iov();
 
     iface_attr->cap.get.max_bcopy       = SIZE_MAX;
     iface_attr->cap.get.min_zcopy       = 0;
     iface_attr->cap.get.max_zcopy       = SIZE_MAX;
     iface_attr->cap.get.opt_zcopy_align = UCS_SYS_CACHE_LINE_SIZE;
     iface_attr->cap.get.align_mtu       = iface_attr->cap.get.opt_zcopy_align;
-    iface_attr->cap.get.max_iov         = 1;
+    iface_attr->cap.get.max_iov         = uct_sm_get_max_iov();
 
-    iface_attr->cap.am.max_short        = iface->config.fifo_elem_size -
-                                          sizeof(uct_mm_fifo_element_t);
+    iface_attr->cap.am.max_short        = iface->config.max_short;
     iface_attr->cap.am.max_bcopy        = iface->config.seg_size;
     iface_attr->cap.am.min_zcopy        = 0;
     iface_attr->cap.am.max_zcopy        = 0;
@@ -117,8 +176,10 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     iface_attr->max_conn_priv           = 0;
     iface_attr->cap.flags               = UCT_IFACE_FLAG_PUT_SHORT           |
                                           UCT_IFACE_FLAG_PUT_BCOPY           |
+                                          UCT_IFACE_FLAG_PUT_ZCOPY           |
                                           UCT_IFACE_FLAG_ATOMIC_CPU          |
                                           UCT_IFACE_FLAG_GET_BCOPY           |
+                                          UCT_IFACE_FLAG_GET_ZCOPY           |
                                           UCT_IFACE_FLAG_AM_SHORT            |
                                           UCT_IFACE_FLAG_AM_BCOPY            |
                                           UCT_IFACE_FLAG_PENDING             |
@@ -148,10 +209,13 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     return UCS_OK;
 }
 
-static inline void uct_mm_progress_fifo_tail(uct_mm_iface_t *iface)
+static inline void uct_mm_progress_fifo_tail(uct_mm_iface_t *iface,
+                                             uint64_t prev_read_index)
 {
-    /* don't progress the tail every time - release in batches. improves performance */
-    if (iface->read_index & iface->fifo_release_factor_mask) {
+    /* don't progress the tail every time - release in batches, once the read
+     * index crosses a release boundary. improves performance */
+    if (!((prev_read_index ^ iface->read_index) &
+          ~iface->fifo_release_factor_mask)) {
         return;
     }
 
@@ -180,18 +244,53 @@ ucs_status_t uct_mm_assign_desc_to_fifo_elem(uct_mm_iface_t *iface,
     return UCS_OK;
 }
 
+/* gather an inline message which spans several FIFO elements */
+static void uct_mm_iface_copy_from_fifo(uct_mm_iface_t *iface, void *fifo_elems,
+                                        unsigned fifo_mask, uint64_t index,
+                                        void *dest, size_t length)
+{
+    size_t elem_data_size = UCT_MM_FIFO_ELEM_DATA_SIZE(iface);
+    uct_mm_fifo_element_t *elem;
+    size_t chunk;
+
+    while (length > 0) {
+        elem  = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, index & fifo_mask);
+        chunk = ucs_min(length, elem_data_size);
+        memcpy(dest, elem + 1, chunk);
+        dest   += chunk;
+        length -= chunk;
+        ++index;
+    }
+}
+
 static inline ucs_status_t uct_mm_iface_process_recv(uct_mm_iface_t *iface,
-                                                     uct_mm_fifo_element_t* elem)
+                                                     uct_mm_fifo_element_t* elem,
+                                                     void *fifo_elems,
+                                                     unsigned fifo_mask,
+                                                     uint64_t read_index)
 {
     ucs_status_t status;
     void         *data;
 
-    if (ucs_likely(elem->flags & UCT_MM_FIFO_ELEM_FLAG_INLINE)) {
+    if (ucs_likely((elem->flags & UCT_MM_FIFO_ELEM_FLAG_INLINE) &&
+                   (elem->span == 1))) {
         /* read short (inline) messages from the FIFO elements */
         uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_RECV, elem->am_id,
                            elem + 1, elem->length, "RX: AM_SHORT");
         status = uct_mm_iface_invoke_am(iface, elem->am_id, elem + 1,
                                         elem->length, 0);
+    } else if (elem->flags & UCT_MM_FIFO_ELEM_FLAG_INLINE) {
+        /* the message is not contiguous in the FIFO, gather it to the spare
+         * receive descriptor, which the callback is allowed to keep */
+        data = (void*)(iface->last_recv_desc + 1) + iface->rx_headroom;
+        uct_mm_iface_copy_from_fifo(iface, fifo_elems, fifo_mask, read_index,
+                                    data, elem->length);
+
+        uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_RECV, elem->am_id,
+                           data, elem->length, "RX: AM_SHORT");
+
+        status = uct_mm_iface_invoke_am(iface, elem->am_id, data, elem->length,
+                                        UCT_CB_PARAM_FLAG_DESC);
     } else {
         /* read bcopy messages from the receive descriptors */
         VALGRIND_MAKE_MEM_DEFINED(elem->desc_chunk_base_addr + elem->desc_offset,
@@ -212,11 +311,24 @@ static inline ucs_status_t uct_mm_iface_process_recv(uct_mm_iface_t *iface,
     return status;
 }
 
-static inline unsigned uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
+/* check if the FIFO element at read_index was written (checking the owner bit) */
+static UCS_F_ALWAYS_INLINE int
+uct_mm_iface_fifo_elem_ready(uct_mm_fifo_element_t *elem, uint64_t read_index,
+                             uint8_t fifo_shift)
+{
+    return ((read_index >> fifo_shift) & 1) == (elem->flags & 1);
+}
+
+static inline unsigned uct_mm_iface_poll_fifo(uct_mm_iface_t *iface,
+                                              void *fifo_elems,
+                                              uint64_t *read_index_p,
+                                              uint8_t fifo_shift,
+                                              unsigned fifo_mask)
 {
     uint64_t read_index_loc, read_index;
     uct_mm_fifo_element_t* read_index_elem;
     ucs_status_t status;
+    unsigned span;
 
     /* check the memory pool to make sure that there is a new descriptor available */
     if (ucs_unlikely(iface->last_recv_desc == NULL)) {
@@ -224,29 +336,29 @@ static inline unsigned uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
                                  iface->last_recv_desc, return 0);
     }
 
-    read_index = iface->read_index;
-    read_index_loc = (read_index & iface->fifo_mask);
+    read_index = *read_index_p;
+    read_index_loc = (read_index & fifo_mask);
     /* the fifo_element which the read_index points to */
-    read_index_elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elements ,read_index_loc);
+    read_index_elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, read_index_loc);
 
-    /* check the read_index to see if there is a new item to read (checking the owner bit) */
-    if (((read_index >> iface->fifo_shift) & 1) == ((read_index_elem->flags) & 1)) {
+    /* check the read_index to see if there is a new item to read */
+    if (uct_mm_iface_fifo_elem_ready(read_index_elem, read_index, fifo_shift)) {
 
         /* read from read_index_elem */
         ucs_memory_cpu_load_fence();
-        ucs_assert(iface->read_index <= iface->recv_fifo_ctl->head);
 
-        status = uct_mm_iface_process_recv(iface, read_index_elem);
+        span   = read_index_elem->span;
+        status = uct_mm_iface_process_recv(iface, read_index_elem, fifo_elems,
+                                           fifo_mask, read_index);
         if (status != UCS_OK) {
             /* the last_recv_desc is in use. get a new descriptor for it */
             UCT_TL_IFACE_GET_RX_DESC(&iface->super, &iface->recv_desc_mp,
                                      iface->last_recv_desc, ucs_debug("recv mpool is empty"));
         }
 
-        /* raise the read_index. */
-        iface->read_index++;
-
-        uct_mm_progress_fifo_tail(iface);
+        /* raise the read_index past all the elements of the message. the tail
+         * is published by the caller */
+        *read_index_p += span;
 
         return 1;
     } else {
@@ -254,13 +366,88 @@ static inline unsigned uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
     }
 }
 
+static unsigned uct_mm_iface_poll_lanes(uct_mm_iface_t *iface)
+{
+    unsigned num_active = ucs_min(iface->recv_fifo_ctl->lane_count,
+                                  iface->config.num_lanes);
+    uct_mm_iface_lane_t *lane;
+    uint64_t prev_read_index;
+    unsigned count, i;
+
+    /* visit the lanes which were taken by senders round-robin, starting after
+     * the last visited one, so a busy sender would not starve the others */
+    count = 0;
+    for (i = 0; (i < num_active) && (count < iface->config.fifo_max_poll); ++i) {
+        if (iface->lane_rr >= num_active) {
+            iface->lane_rr = 0;
+        }
+
+        lane            = &iface->lanes[iface->lane_rr++];
+        prev_read_index = lane->read_index;
+        while ((count < iface->config.fifo_max_poll) &&
+               uct_mm_iface_poll_fifo(iface, lane->elems, &lane->read_index,
+                                      iface->lane_shift, iface->lane_mask)) {
+            ++count;
+        }
+
+        if (lane->read_index != prev_read_index) {
+            lane->ctl->tail = lane->read_index;
+        }
+    }
+
+    return count;
+}
+
+/* move the lanes of the remote FIFOs from idle endpoints to active ones */
+static void uct_mm_iface_check_lanes(uct_mm_iface_t *iface)
+{
+    ucs_time_t now = ucs_get_time();
+    uct_mm_ep_t *ep;
+
+    if (now < iface->lane_check_time) {
+        return;
+    }
+
+    ucs_list_for_each(ep, &iface->lane_eps, lane.list) {
+        uct_mm_ep_check_lane(ep);
+    }
+
+    iface->lane_check_time = now + iface->config.lane_idle_time;
+}
+
 unsigned uct_mm_iface_progress(void *arg)
 {
-    uct_mm_iface_t *iface = arg;
+    uct_mm_iface_t *iface     = arg;
+    uint64_t prev_read_index  = iface->read_index;
     unsigned count;
 
-    /* progress receive */
-    count = uct_mm_iface_poll_fifo(iface);
+    /* the receiver is awake, senders don't have to signal it */
+    if (ucs_unlikely(iface->recv_fifo_ctl->waiting)) {
+        iface->recv_fifo_ctl->waiting = 0;
+    }
+
+    /* progress receive - drain up to fifo_max_poll ready elements, and
+     * write the shared tail cache line once for all of them */
+    count = 0;
+    while ((count < iface->config.fifo_max_poll) &&
+           uct_mm_iface_poll_fifo(iface, iface->recv_fifo_elements,
+                                  &iface->read_index, iface->fifo_shift,
+                                  iface->fifo_mask)) {
+        ++count;
+    }
+
+    if (count > 0) {
+        ucs_assert(iface->read_index <= iface->recv_fifo_ctl->head);
+        uct_mm_progress_fifo_tail(iface, prev_read_index);
+    }
+
+    if (iface->config.num_lanes > 0) {
+        count += uct_mm_iface_poll_lanes(iface);
+    }
+
+    if (ucs_unlikely(!ucs_list_is_empty(&iface->lane_eps))) {
+        uct_mm_iface_check_lanes(iface);
+    }
 
     /* progress the pending sends (if there are any) */
     ucs_arbiter_dispatch(&iface->arbiter, 1, uct_mm_ep_process_pending, NULL);
@@ -274,6 +461,34 @@ static ucs_status_t uct_mm_iface_event_fd_get(uct_iface_h tl_iface, int *fd_p)
     return UCS_OK;
 }
 
+/* check if there are FIFO elements which were not received yet */
+static int uct_mm_iface_fifo_has_new_elems(uct_mm_iface_t *iface)
+{
+    unsigned num_active, i;
+    uct_mm_iface_lane_t *lane;
+    uct_mm_fifo_element_t *elem;
+
+    /* an element of the shared FIFO may be taken by a sender but not written
+     * yet, and it would hold back the elements after it */
+    if (iface->recv_fifo_ctl->head != iface->read_index) {
+        return 1;
+    }
+
+    num_active = ucs_min(iface->recv_fifo_ctl->lane_count,
+                         iface->config.num_lanes);
+    for (i = 0; i < num_active; ++i) {
+        lane = &iface->lanes[i];
+        elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, lane->elems,
+                                          lane->read_index & iface->lane_mask);
+        if (uct_mm_iface_fifo_elem_ready(elem, lane->read_index,
+                                         iface->lane_shift)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 static ucs_status_t uct_mm_iface_event_fd_arm(uct_iface_h tl_iface,
                                               unsigned events)
 {
@@ -285,18 +500,25 @@ static ucs_status_t uct_mm_iface_event_fd_arm(uct_iface_h tl_iface,
     if (ret > 0) {
         return UCS_ERR_BUSY;
     } else if (ret == -1) {
-        if (errno == EAGAIN) {
-            return UCS_OK;
-        } else if (errno == EINTR) {
+        if (errno == EINTR) {
             return UCS_ERR_BUSY;
-        } else {
+        } else if (errno != EAGAIN) {
             ucs_error("failed to retrieve message from signal pipe: %m");
             return UCS_ERR_IO_ERROR;
         }
     } else {
         ucs_assert(ret == 0);
-        return UCS_OK;
     }
+
+    /* let the senders know they have to signal, and then check the FIFO for
+     * elements which were written before a sender could see the flag */
+    iface->recv_fifo_ctl->waiting = 1;
+    ucs_memory_bus_fence();
+    if (uct_mm_iface_fifo_has_new_elems(iface)) {
+        return UCS_ERR_BUSY;
+    }
+
+    return UCS_OK;
 }
 
 static UCS_CLASS_DECLARE_DELETE_FUNC(uct_mm_iface_t, uct_iface_t);
@@ -304,7 +526,9 @@ static UCS_CLASS_DECLARE_DELETE_FUNC(uct_mm_iface_t, uct_iface_t);
 static uct_iface_ops_t uct_mm_iface_ops = {
     .ep_put_short             = uct_sm_ep_put_short,
     .ep_put_bcopy             = uct_sm_ep_put_bcopy,
+    .ep_put_zcopy             = uct_sm_ep_put_zcopy,
     .ep_get_bcopy             = uct_sm_ep_get_bcopy,
+    .ep_get_zcopy             = uct_sm_ep_get_zcopy,
     .ep_am_short              = uct_mm_ep_am_short,
     .ep_am_bcopy              = uct_mm_ep_am_bcopy,
     .ep_atomic_cswap64        = uct_sm_ep_atomic_cswap64,
@@ -333,11 +557,109 @@ static uct_iface_ops_t uct_mm_iface_ops = {
     .iface_is_reachable       = uct_sm_iface_is_reachable
 };
 
+#if HAVE_NUMA
+static void uct_mm_iface_numa_init(uct_mm_iface_t *iface,
+                                   ucs_numa_policy_t policy)
+{
+    int cpu, ret, old_policy;
+
+    iface->numa.policy     = UCS_NUMA_POLICY_DEFAULT;
+    iface->numa.node       = -1;
+    iface->numa.last_chunk = NULL;
+
+    if ((policy == UCS_NUMA_POLICY_DEFAULT) || (numa_available() < 0)) {
+        return;
+    }
+
+    cpu = sched_getcpu();
+    if (cpu < 0) {
+        ucs_debug("sched_getcpu() failed: %m, not setting mm numa policy");
+        return;
+    }
+
+    iface->numa.node = ucs_numa_node_of_cpu(cpu);
+
+    /* if the current policy is BIND, keep it as-is */
+    ret = get_mempolicy(&old_policy, NULL, 0, NULL, 0);
+    if ((ret == 0) && (old_policy == MPOL_BIND)) {
+        ucs_debug("thread memory policy is MPOL_BIND, not setting mm numa policy");
+        return;
+    }
+
+    iface->numa.policy = policy;
+}
+
+static void uct_mm_iface_numa_bind(uct_mm_iface_t *iface, void *address,
+                                   size_t length, const char *name)
+{
+    struct bitmask *nodemask;
+    uintptr_t start, end;
+    int ret, new_policy;
+
+    if ((iface->numa.policy == UCS_NUMA_POLICY_DEFAULT) ||
+        (iface->numa.node < 0)) {
+        return;
+    }
+
+    new_policy = (iface->numa.policy == UCS_NUMA_POLICY_BIND) ? MPOL_BIND :
+                 MPOL_PREFERRED;
+
+    nodemask = numa_allocate_nodemask();
+    if (nodemask == NULL) {
+        ucs_warn("Failed to allocate numa node mask");
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_NUMA_BIND_FAIL, 1);
+        return;
+    }
+
+    numa_bitmask_clearall(nodemask);
+    numa_bitmask_setbit(nodemask, iface->numa.node);
+
+    start = ucs_align_down_pow2((uintptr_t)address, ucs_get_page_size());
+    end   = ucs_align_up_pow2((uintptr_t)address + length, ucs_get_page_size());
+
+    /* the pages may already be touched by the allocator, so move them as well */
+    ret = mbind((void*)start, end - start, new_policy, numa_nodemask_p(nodemask),
+                numa_nodemask_size(nodemask), MPOL_MF_MOVE);
+    if (ret < 0) {
+        ucs_debug("mbind(%s addr=0x%lx length=%ld policy=%d node=%d) failed: %m",
+                  name, start, end - start, new_policy, iface->numa.node);
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_NUMA_BIND_FAIL, 1);
+    } else {
+        ucs_trace("%s 0x%lx..0x%lx: bound to numa node %d with policy %d",
+                  name, start, end, iface->numa.node, new_policy);
+        UCS_STATS_UPDATE_COUNTER(iface->stats, UCT_MM_IFACE_STAT_NUMA_BIND, 1);
+    }
+
+    numa_free_nodemask(nodemask);
+}
+#else
+static void uct_mm_iface_numa_init(uct_mm_iface_t *iface,
+                                   ucs_numa_policy_t policy)
+{
+    iface->numa.policy     = UCS_NUMA_POLICY_DEFAULT;
+    iface->numa.node       = -1;
+    iface->numa.last_chunk = NULL;
+}
+
+static void uct_mm_iface_numa_bind(uct_mm_iface_t *iface, void *address,
+                                   size_t length, const char *name)
+{
+}
+#endif
+
 void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj, uct_mem_h memh)
 {
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
     uct_mm_recv_desc_t *desc = obj;
     uct_mm_seg_t *seg = memh;
 
+    /* bind every new chunk of the pool once, when its first descriptor is
+     * initialized */
+    if (seg->address != iface->numa.last_chunk) {
+        uct_mm_iface_numa_bind(iface, seg->address, seg->length, "mm_recv_desc");
+        iface->numa.last_chunk = seg->address;
+    }
+
     /* every desc in the memory pool, holds the mm_id(key) and address of the
      * mem pool it belongs to */
     desc->key          = seg->mmid;
@@ -345,19 +667,107 @@ void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj, uct_mem_h memh
     desc->mpool_length = seg->length;
 }
 
-static void uct_mm_iface_free_rx_descs(uct_mm_iface_t *iface, unsigned num_elems)
+static void uct_mm_iface_free_rx_descs(uct_mm_iface_t *iface, void *fifo_elems,
+                                       unsigned num_elems)
 {
     uct_mm_fifo_element_t* fifo_elem_p;
     uct_mm_recv_desc_t *desc;
     unsigned i;
 
     for (i = 0; i < num_elems; i++) {
-        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elements, i);
+        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, i);
         desc = UCT_MM_IFACE_GET_DESC_START(iface, fifo_elem_p);
         ucs_mpool_put(desc);
     }
 }
 
+/* initiate the owner bit in the FIFO elements and assign a receive descriptor
+ * per every FIFO element */
+static ucs_status_t uct_mm_iface_init_fifo_elems(uct_mm_iface_t *iface,
+                                                 void *fifo_elems,
+                                                 unsigned num_elems)
+{
+    uct_mm_fifo_element_t* fifo_elem_p;
+    ucs_status_t status;
+    unsigned i;
+
+    for (i = 0; i < num_elems; i++) {
+        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, i);
+        fifo_elem_p->flags = UCT_MM_FIFO_ELEM_FLAG_OWNER;
+
+        status = uct_mm_assign_desc_to_fifo_elem(iface, fifo_elem_p, 1);
+        if (status != UCS_OK) {
+            ucs_error("Failed to allocate a descriptor for MM");
+            uct_mm_iface_free_rx_descs(iface, fifo_elems, i);
+            return status;
+        }
+    }
+
+    return UCS_OK;
+}
+
+static void uct_mm_iface_cleanup_lanes(uct_mm_iface_t *iface, unsigned num_lanes)
+{
+    unsigned i;
+
+    for (i = 0; i < num_lanes; i++) {
+        uct_mm_iface_free_rx_descs(iface, iface->lanes[i].elems,
+                                   iface->config.lane_size);
+    }
+
+    ucs_free(iface->lanes);
+}
+
+static ucs_status_t uct_mm_iface_init_lanes(uct_mm_iface_t *iface)
+{
+    uct_mm_iface_lane_t *lane;
+    ucs_status_t status;
+    unsigned i;
+
+    iface->recv_fifo_ctl->lane_count = 0;
+    iface->recv_fifo_ctl->num_lanes  = iface->config.num_lanes;
+    iface->recv_fifo_ctl->lane_size  = iface->config.lane_size;
+    iface->lane_rr                   = 0;
+    iface->lanes                     = NULL;
+    iface->lane_check_time           = 0;
+    ucs_list_head_init(&iface->lane_eps);
+
+    if (iface->config.num_lanes == 0) {
+        return UCS_OK;
+    }
+
+    iface->lane_mask  = iface->config.lane_size - 1;
+    iface->lane_shift = ucs_count_trailing_zero_bits(iface->config.lane_size);
+
+    iface->lanes = ucs_calloc(iface->config.num_lanes, sizeof(*iface->lanes),
+                              "mm_lanes");
+    if (iface->lanes == NULL) {
+        ucs_error("Failed to allocate %u MM FIFO lanes", iface->config.num_lanes);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    for (i = 0; i < iface->config.num_lanes; i++) {
+        lane             = &iface->lanes[i];
+        lane->ctl        = uct_mm_fifo_lane_ctl(iface, iface->recv_fifo_ctl, i);
+        lane->elems      = lane->ctl + 1;
+        lane->read_index = 0;
+        lane->ctl->tail  = 0;
+        lane->ctl->head  = 0;
+        lane->ctl->owner = 0;
+
+        ucs_assert_always(((uintptr_t)lane->ctl % UCS_SYS_CACHE_LINE_SIZE) == 0);
+
+        status = uct_mm_iface_init_fifo_elems(iface, lane->elems,
+                                              iface->config.lane_size);
+        if (status != UCS_OK) {
+            uct_mm_iface_cleanup_lanes(iface, i);
+            return status;
+        }
+    }
+
+    return UCS_OK;
+}
+
 ucs_status_t uct_mm_allocate_fifo_mem(uct_mm_iface_t *iface,
                                       uct_mm_iface_config_t *config, uct_md_h md)
 {
@@ -390,6 +800,8 @@ ucs_status_t uct_mm_allocate_fifo_mem(uct_mm_iface_t *iface,
     iface->recv_fifo_ctl = ctl;
 
     ucs_assert(iface->shared_mem != NULL);
+
+    uct_mm_iface_numa_bind(iface, iface->shared_mem, size_to_alloc, "mm fifo");
     return UCS_OK;
 }
 
@@ -447,14 +859,41 @@ err:
     return status;
 }
 
+/* set the number of FIFO elements which a short message may span, and the
+ * resulting maximal short message size */
+static void uct_mm_iface_set_max_short(uct_mm_iface_t *iface, unsigned max_span)
+{
+    size_t elem_data_size = UCT_MM_FIFO_ELEM_DATA_SIZE(iface);
+    size_t max_short;
+
+    /* the shared FIFO must have room for a full message even when its tail
+     * lags behind by a release batch, and a lane must be able to hold it */
+    max_span = ucs_min(max_span, (unsigned)UINT8_MAX);
+    max_span = ucs_min(max_span, iface->config.fifo_size -
+                                 (unsigned)(iface->fifo_release_factor_mask + 1));
+    if (iface->config.num_lanes > 0) {
+        max_span = ucs_min(max_span, iface->config.lane_size);
+    }
+
+    max_short = elem_data_size;
+    if (max_span > 1) {
+        /* the receiver gathers such a message to a receive descriptor */
+        max_short = ucs_min(max_span * elem_data_size,
+                            (size_t)ucs_min(iface->config.seg_size,
+                                            (unsigned)UINT16_MAX));
+        max_short = ucs_max(max_short, elem_data_size);
+    }
+
+    iface->config.max_short     = max_short;
+    iface->config.fifo_max_span = ucs_div_round_up(max_short, elem_data_size);
+}
+
 static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                            const uct_iface_params_t *params,
                            const uct_iface_config_t *tl_config)
 {
     uct_mm_iface_config_t *mm_config = ucs_derived_of(tl_config, uct_mm_iface_config_t);
-    uct_mm_fifo_element_t* fifo_elem_p;
     ucs_status_t status;
-    unsigned i;
 
     ucs_assert(params->open_mode & UCT_IFACE_OPEN_MODE_DEVICE);
 
@@ -476,6 +915,14 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto err;
     }
 
+    /* check that the lane size is a power of two and bigger than 1 */
+    if ((mm_config->num_lanes > 0) &&
+        ((mm_config->lane_size <= 1) || !ucs_is_pow2(mm_config->lane_size))) {
+        ucs_error("The MM FIFO lane size must be a power of two and bigger than 1.");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
     /* check the value defining the FIFO batch release */
     if ((mm_config->release_fifo_factor < 0) || (mm_config->release_fifo_factor >= 1)) {
         ucs_error("The MM release FIFO factor must be: (0 =< factor < 1).");
@@ -495,6 +942,10 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
     self->config.fifo_size         = mm_config->fifo_size;
     self->config.fifo_elem_size    = mm_config->super.max_short;
     self->config.seg_size          = mm_config->super.max_bcopy;
+    self->config.fifo_max_poll     = ucs_max(mm_config->fifo_max_poll, 1);
+    self->config.num_lanes         = mm_config->num_lanes;
+    self->config.lane_size         = mm_config->lane_size;
+    self->config.lane_idle_time    = ucs_time_from_sec(mm_config->lane_idle_time);
     self->fifo_release_factor_mask = UCS_MASK(ucs_ilog2(ucs_max((int)
                                      (mm_config->fifo_size * mm_config->release_fifo_factor),
                                      1)));
@@ -503,17 +954,28 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
     self->rx_headroom              = params->rx_headroom;
     self->release_desc.cb          = uct_mm_iface_release_desc;
 
+    uct_mm_iface_set_max_short(self, mm_config->fifo_max_span);
+
+    status = UCS_STATS_NODE_ALLOC(&self->stats, &uct_mm_iface_stats_class,
+                                  self->super.stats);
+    if (status != UCS_OK) {
+        goto err;
+    }
+
+    uct_mm_iface_numa_init(self, mm_config->numa_policy);
+
     /* create the receive FIFO */
     /* use specific allocator to allocate and attach memory and check the
      * requested hugetlb allocation mode */
     status = uct_mm_allocate_fifo_mem(self, mm_config, md);
     if (status != UCS_OK) {
-        goto err;
+        goto err_free_stats;
     }
 
-    self->recv_fifo_ctl->head   = 0;
-    self->recv_fifo_ctl->tail   = 0;
-    self->read_index            = 0;
+    self->recv_fifo_ctl->head    = 0;
+    self->recv_fifo_ctl->tail    = 0;
+    self->recv_fifo_ctl->waiting = 0;
+    self->read_index             = 0;
 
     status = uct_mm_iface_create_signal_fd(self);
     if (status != UCS_OK) {
@@ -536,7 +998,9 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto err_close_signal_fd;
     }
 
-    ucs_mpool_grow(&self->recv_desc_mp, mm_config->fifo_size * 2);
+    ucs_mpool_grow(&self->recv_desc_mp,
+                   (mm_config->fifo_size +
+                    (self->config.num_lanes * self->config.lane_size)) * 2);
 
     /* set the first receive descriptor */
     self->last_recv_desc = ucs_mpool_get(&self->recv_desc_mp);
@@ -547,26 +1011,30 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto destroy_recv_mpool;
     }
 
-    /* initiate the owner bit in all the FIFO elements and assign a receive descriptor
-     * per every FIFO element */
-    for (i = 0; i < mm_config->fifo_size; i++) {
-        fifo_elem_p = UCT_MM_IFACE_GET_FIFO_ELEM(self, self->recv_fifo_elements, i);
-        fifo_elem_p->flags = UCT_MM_FIFO_ELEM_FLAG_OWNER;
+    status = uct_mm_iface_init_fifo_elems(self, self->recv_fifo_elements,
+                                          mm_config->fifo_size);
+    if (status != UCS_OK) {
+        goto put_last_desc;
+    }
 
-        status = uct_mm_assign_desc_to_fifo_elem(self, fifo_elem_p, 1);
-        if (status != UCS_OK) {
-            ucs_error("Failed to allocate a descriptor for MM");
-            goto destroy_descs;
-        }
+    status = uct_mm_iface_init_lanes(self);
+    if (status != UCS_OK) {
+        goto destroy_descs;
     }
 
+    sglib_hashed_uct_mm_remote_peer_t_init(self->peers_hash);
     ucs_arbiter_init(&self->arbiter);
 
-    ucs_debug("Created an MM iface. FIFO mm id: %zu", self->fifo_mm_id);
+    ucs_debug("Created an MM iface. FIFO mm id: %zu, %u lanes, max short %u "
+              "(%u elements), numa node %d", self->fifo_mm_id,
+              self->config.num_lanes, self->config.max_short,
+              self->config.fifo_max_span, self->numa.node);
     return UCS_OK;
 
 destroy_descs:
-    uct_mm_iface_free_rx_descs(self, i);
+    uct_mm_iface_free_rx_descs(self, self->recv_fifo_elements,
+                               mm_config->fifo_size);
+put_last_desc:
     ucs_mpool_put(self->last_recv_desc);
 destroy_recv_mpool:
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
@@ -575,6 +1043,8 @@ err_close_signal_fd:
 err_free_fifo:
     uct_mm_md_mapper_ops(md)->free(self->shared_mem, self->fifo_mm_id,
                                    UCT_MM_GET_FIFO_SIZE(self), self->path);
+err_free_stats:
+    UCS_STATS_NODE_FREE(self->stats);
 err:
     return status;
 }
@@ -587,9 +1057,13 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_iface_t)
     uct_base_iface_progress_disable(&self->super.super,
                                    UCT_PROGRESS_SEND | UCT_PROGRESS_RECV);
 
+    UCS_STATS_NODE_FREE(self->stats);
+
     /* return all the descriptors that are now 'assigned' to the FIFO,
      * to their mpool */
-    uct_mm_iface_free_rx_descs(self, self->config.fifo_size);
+    uct_mm_iface_free_rx_descs(self, self->recv_fifo_elements,
+                               self->config.fifo_size);
+    uct_mm_iface_cleanup_lanes(self, self->config.num_lanes);
 
     ucs_mpool_put(self->last_recv_desc);
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
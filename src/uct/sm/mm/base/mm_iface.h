@@ -14,6 +14,7 @@
 #include <uct/base/uct_iface.h>
 #include <ucs/arch/cpu.h>
 #include <ucs/debug/memtrack.h>
+#include <ucs/memory/numa.h>
 #include <ucs/datastruct/arbiter.h>
 #include <ucs/sys/compiler.h>
 #include <ucs/sys/sys.h>
@@ -22,18 +23,49 @@
 
 
 #define UCT_MM_TL_NAME "mm"
+
+
+enum {
+    UCT_MM_IFACE_STAT_ATTACH_HIT,       /* remote segment mapping reused by a
+                                           new endpoint, instead of attaching */
+    UCT_MM_IFACE_STAT_ATTACH_MISS,      /* remote segment had to be mapped */
+    UCT_MM_IFACE_STAT_ACTIVE_MAPPINGS,  /* remote segments mapped now */
+    UCT_MM_IFACE_STAT_NUMA_BIND,        /* receive segments bound to the local node */
+    UCT_MM_IFACE_STAT_NUMA_BIND_FAIL,   /* receive segments which failed to bind */
+    UCT_MM_IFACE_STAT_LAST
+};
+
 #define UCT_MM_FIFO_CTL_SIZE_ALIGNED  ucs_align_up(sizeof(uct_mm_fifo_ctl_t),UCS_SYS_CACHE_LINE_SIZE)
 
-#define UCT_MM_GET_FIFO_SIZE(iface)  (UCS_SYS_CACHE_LINE_SIZE - 1 +  \
-                                      UCT_MM_FIFO_CTL_SIZE_ALIGNED + \
-                                     ((iface)->config.fifo_size *    \
-                                     (iface)->config.fifo_elem_size))
+
+/* offset of the first lane from the FIFO ctl struct */
+#define UCT_MM_FIFO_LANES_OFFSET(iface) \
+    (UCT_MM_FIFO_CTL_SIZE_ALIGNED + \
+     ucs_align_up((iface)->config.fifo_size * (iface)->config.fifo_elem_size, \
+                  UCS_SYS_CACHE_LINE_SIZE))
+
+/* size of a single lane: its ctl cacheline followed by the lane elements */
+#define UCT_MM_FIFO_LANE_SIZE(iface) \
+    (sizeof(uct_mm_fifo_lane_ctl_t) + \
+     ucs_align_up((iface)->config.lane_size * (iface)->config.fifo_elem_size, \
+                  UCS_SYS_CACHE_LINE_SIZE))
+
+#define UCT_MM_GET_FIFO_SIZE(iface)  (UCS_SYS_CACHE_LINE_SIZE - 1 +         \
+                                      UCT_MM_FIFO_LANES_OFFSET(iface) +     \
+                                      ((iface)->config.num_lanes *          \
+                                       UCT_MM_FIFO_LANE_SIZE(iface)))
 
 
 typedef struct uct_mm_iface_config {
     uct_iface_config_t       super;
     unsigned                 fifo_size;            /* Size of the receive FIFO */
     double                   release_fifo_factor;
+    unsigned                 fifo_max_poll;        /* Elements to receive per progress */
+    unsigned                 fifo_max_span;        /* Elements of a single short message */
+    unsigned                 num_lanes;            /* Number of single-sender lanes */
+    unsigned                 lane_size;            /* Size of each lane */
+    double                   lane_idle_time;       /* Time to release an idle lane */
+    ucs_numa_policy_t        numa_policy;          /* NUMA policy of the receive memory */
     ucs_ternary_value_t      hugetlb_mode;         /* Enable using huge pages for */
                                                    /* shared memory buffers */
     uct_iface_mpool_config_t mp;
@@ -49,9 +81,33 @@ struct uct_mm_fifo_ctl {
 
     /* 2nd cacheline */
     volatile uint64_t  tail;       /* how much was read */
+    volatile uint32_t  lane_count; /* lanes which were ever taken by senders,
+                                      the receiver polls only them */
+    uint32_t           num_lanes;  /* number of lanes after the shared FIFO */
+    uint32_t           lane_size;  /* number of elements in every lane */
+    volatile uint32_t  waiting;    /* receiver is going to sleep and has to be
+                                      signaled about new elements */
 } UCS_S_PACKED UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE);
 
 
+/* Control struct of a lane - a receive ring which is written by a single
+ * sender, so the sender does not need an atomic operation to claim elements.
+ * The lane elements follow it. */
+struct uct_mm_fifo_lane_ctl {
+    volatile uint64_t  tail;       /* how much was read from the lane */
+    volatile uint64_t  head;       /* where the last owner stopped writing, so
+                                      the next owner continues from there */
+    volatile uint32_t  owner;      /* whether the lane is taken by a sender */
+} UCS_S_PACKED UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE);
+
+
+typedef struct uct_mm_iface_lane {
+    uct_mm_fifo_lane_ctl_t  *ctl;
+    void                    *elems;      /* pointer to the first lane element */
+    uint64_t                read_index;  /* actual reading location */
+} uct_mm_iface_lane_t;
+
+
 struct uct_mm_iface {
     uct_base_iface_t        super;
 
@@ -74,6 +130,14 @@ struct uct_mm_iface {
     unsigned                fifo_mask;           /* = 2^fifo_shift - 1 */
     uint64_t                fifo_release_factor_mask;
 
+    uct_mm_iface_lane_t     *lanes;              /* single-sender receive lanes */
+    unsigned                lane_rr;             /* next lane to poll */
+    uint8_t                 lane_shift;          /* = log2(lane_size) */
+    unsigned                lane_mask;           /* = 2^lane_shift - 1 */
+    ucs_list_link_t         lane_eps;            /* endpoints which may use lanes
+                                                    of their remote FIFO */
+    ucs_time_t              lane_check_time;     /* next check for idle lanes */
+
     ucs_mpool_t             recv_desc_mp;
     uct_mm_recv_desc_t      *last_recv_desc;    /* next receive descriptor to use */
 
@@ -84,10 +148,28 @@ struct uct_mm_iface {
     const char              *path;            /* path to the backing file (for 'posix') */
     uct_recv_desc_t         release_desc;
 
+    /* remote interfaces which the endpoints are connected to, with the
+     * mappings of their FIFO and descriptor segments */
+    uct_mm_remote_peer_t    *peers_hash[UCT_MM_BASE_ADDRESS_HASH_SIZE];
+    UCS_STATS_NODE_DECLARE(stats);
+
+    struct {
+        ucs_numa_policy_t policy;             /* policy to apply on receive memory */
+        int               node;               /* NUMA node of the receive memory, or -1 */
+        void              *last_chunk;        /* last descriptor chunk which was bound */
+    } numa;
+
     struct {
         unsigned fifo_size;
         unsigned fifo_elem_size;
         unsigned seg_size;                    /* size of the receive descriptor (for payload)*/
+        unsigned fifo_max_poll;               /* FIFO elements to receive per progress */
+        unsigned fifo_max_span;               /* FIFO elements of a single short message */
+        unsigned max_short;                   /* short message size, including the header */
+        unsigned num_lanes;                   /* number of single-sender lanes */
+        unsigned lane_size;                   /* number of elements in every lane */
+        ucs_time_t lane_idle_time;            /* release a lane which was not
+                                                 used for this long */
     } config;
 };
 
@@ -96,6 +178,8 @@ struct uct_mm_fifo_element {
     uint8_t         flags;
     uint8_t         am_id;          /* active message id */
     uint16_t        length;         /* length of actual data */
+    uint8_t         span;           /* number of consecutive FIFO elements which
+                                     * hold the message, for inline messages */
 
     /* bcopy parameters */
     size_t          desc_mpool_size;
@@ -105,7 +189,9 @@ struct uct_mm_fifo_element {
     size_t          desc_offset;    /* the offset of the desc (its data location for bcopy)
                                      * within the memory chunk it belongs to */
     void            *desc_chunk_base_addr;
-    /* the data follows here (in case of inline messaging) */
+    /* the data follows here (in case of inline messaging). an inline message
+     * which spans several elements continues in the data part of the next
+     * elements, whose headers are not changed except for the owner bit */
 } UCS_S_PACKED;
 
 
@@ -160,6 +246,22 @@ static inline void uct_mm_set_fifo_elems_ptr(void *mem_region, void **fifo_elems
    *fifo_elems = (void*) fifo_ctl + UCT_MM_FIFO_CTL_SIZE_ALIGNED;
 }
 
+/**
+ * Get the control struct of a lane in the FIFO.
+ *
+ * @param [in] iface     the interface which defines the FIFO layout.
+ * @param [in] fifo_ctl  the FIFO control struct.
+ * @param [in] index     the lane index.
+ */
+static inline uct_mm_fifo_lane_ctl_t*
+uct_mm_fifo_lane_ctl(uct_mm_iface_t *iface, uct_mm_fifo_ctl_t *fifo_ctl,
+                     unsigned index)
+{
+    return (uct_mm_fifo_lane_ctl_t*)((char*)fifo_ctl +
+                                     UCT_MM_FIFO_LANES_OFFSET(iface) +
+                                     (index * UCT_MM_FIFO_LANE_SIZE(iface)));
+}
+
 void uct_mm_iface_release_desc(uct_recv_desc_t *self, void *desc);
 ucs_status_t uct_mm_flush();
 
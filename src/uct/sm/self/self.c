@@ -6,6 +6,7 @@
 #include "self.h"
 
 #include <uct/sm/base/sm_ep.h>
+#include <uct/sm/base/sm_iface.h>
 #include <ucs/type/class.h>
 #include <ucs/sys/string.h>
 #include <ucs/arch/cpu.h>
@@ -44,9 +45,12 @@ static ucs_status_t uct_self_iface_query(uct_iface_h tl_iface, uct_iface_attr_t
     attr->cap.flags              = UCT_IFACE_FLAG_CONNECT_TO_IFACE |
                                    UCT_IFACE_FLAG_AM_SHORT         |
                                    UCT_IFACE_FLAG_AM_BCOPY         |
+                                   UCT_IFACE_FLAG_AM_ZCOPY         |
                                    UCT_IFACE_FLAG_PUT_SHORT        |
                                    UCT_IFACE_FLAG_PUT_BCOPY        |
+                                   UCT_IFACE_FLAG_PUT_ZCOPY        |
                                    UCT_IFACE_FLAG_GET_BCOPY        |
+                                   UCT_IFACE_FLAG_GET_ZCOPY        |
                                    UCT_IFACE_FLAG_ATOMIC_CPU       |
                                    UCT_IFACE_FLAG_PENDING          |
                                    UCT_IFACE_FLAG_CB_SYNC          |
@@ -68,26 +72,26 @@ static ucs_status_t uct_self_iface_query(uct_iface_h tl_iface, uct_iface_attr_t
     attr->cap.put.max_short       = UINT_MAX;
     attr->cap.put.max_bcopy       = SIZE_MAX;
     attr->cap.put.min_zcopy       = 0;
-    attr->cap.put.max_zcopy       = 0;
+    attr->cap.put.max_zcopy       = SIZE_MAX;
     attr->cap.put.opt_zcopy_align = 1;
     attr->cap.put.align_mtu       = attr->cap.put.opt_zcopy_align;
-    attr->cap.put.max_iov         = 1;
+    attr->cap.put.max_iov         = uct_sm_get_max_iov();
 
     attr->cap.get.max_bcopy       = SIZE_MAX;
     attr->cap.get.min_zcopy       = 0;
-    attr->cap.get.max_zcopy       = 0;
+    attr->cap.get.max_zcopy       = SIZE_MAX;
     attr->cap.get.opt_zcopy_align = 1;
     attr->cap.get.align_mtu       = attr->cap.get.opt_zcopy_align;
-    attr->cap.get.max_iov         = 1;
+    attr->cap.get.max_iov         = uct_sm_get_max_iov();
 
     attr->cap.am.max_short        = iface->send_size;
     attr->cap.am.max_bcopy        = iface->send_size;
     attr->cap.am.min_zcopy        = 0;
-    attr->cap.am.max_zcopy        = 0;
+    attr->cap.am.max_zcopy        = iface->send_size;
     attr->cap.am.opt_zcopy_align  = 1;
     attr->cap.am.align_mtu        = attr->cap.am.opt_zcopy_align;
-    attr->cap.am.max_hdr          = 0;
-    attr->cap.am.max_iov          = 1;
+    attr->cap.am.max_hdr          = iface->send_size;
+    attr->cap.am.max_iov          = uct_sm_get_max_iov();
 
     attr->latency.overhead        = 0;
     attr->latency.growth          = 0;
@@ -130,7 +134,6 @@ static void uct_self_iface_sendrecv_am(uct_self_iface_t *iface, uint8_t am_id,
     status = uct_iface_invoke_am(&iface->super, am_id, buffer,
                                  length, 0);
     ucs_assert(status == UCS_OK);
-    ucs_mpool_put_inline(buffer);
 }
 
 static ucs_mpool_ops_t uct_self_iface_mpool_ops = {
@@ -257,6 +260,7 @@ ucs_status_t uct_self_ep_am_short(uct_ep_h tl_ep, uint8_t id, uint64_t header,
 
     UCT_TL_EP_STAT_OP(&ep->super, AM, SHORT, total_length);
     uct_self_iface_sendrecv_am(iface, id, send_buffer, total_length, "SHORT");
+    ucs_mpool_put_inline(send_buffer);
     return UCS_OK;
 }
 
@@ -278,15 +282,57 @@ ssize_t uct_self_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id,
     UCT_TL_EP_STAT_OP(&ep->super, AM, BCOPY, length);
 
     uct_self_iface_sendrecv_am(iface, id, send_buffer, length, "BCOPY");
+    ucs_mpool_put_inline(send_buffer);
     return length;
 }
 
+ucs_status_t uct_self_ep_am_zcopy(uct_ep_h tl_ep, uint8_t id, const void *header,
+                                  unsigned header_length, const uct_iov_t *iov,
+                                  size_t iovcnt, unsigned flags,
+                                  uct_completion_t *comp)
+{
+    uct_self_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_self_iface_t);
+    uct_self_ep_t UCS_V_UNUSED *ep = ucs_derived_of(tl_ep, uct_self_ep_t);
+    size_t total_length;
+    void *send_buffer;
+
+    UCT_CHECK_AM_ID(id);
+    UCT_CHECK_IOV_SIZE(iovcnt, uct_sm_get_max_iov(), "uct_self_ep_am_zcopy");
+
+    total_length = header_length + uct_iov_total_length(iov, iovcnt);
+    UCT_CHECK_LENGTH(total_length, 0, iface->send_size, "am_zcopy");
+    UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY, total_length);
+
+    /* the handler is called before returning and may not keep the data, so
+     * a contiguous message is passed to it in place. This includes a header
+     * which is followed by the payload in memory. */
+    if ((iovcnt == 1) && (iov->count == 1) &&
+        ((header_length == 0) ||
+         (UCS_PTR_BYTE_OFFSET(header, header_length) == iov->buffer))) {
+        uct_self_iface_sendrecv_am(iface, id,
+                                   (header_length == 0) ? iov->buffer :
+                                   (void*)header, total_length, "ZCOPY");
+        return UCS_OK;
+    }
+
+    send_buffer = UCT_SELF_IFACE_SEND_BUFFER_GET(iface);
+    memcpy(send_buffer, header, header_length);
+    uct_iov_to_buffer(iov, iovcnt, send_buffer + header_length);
+
+    uct_self_iface_sendrecv_am(iface, id, send_buffer, total_length, "ZCOPY");
+    ucs_mpool_put_inline(send_buffer);
+    return UCS_OK;
+}
+
 static uct_iface_ops_t uct_self_iface_ops = {
     .ep_put_short             = uct_sm_ep_put_short,
     .ep_put_bcopy             = uct_sm_ep_put_bcopy,
+    .ep_put_zcopy             = uct_sm_ep_put_zcopy,
     .ep_get_bcopy             = uct_sm_ep_get_bcopy,
+    .ep_get_zcopy             = uct_sm_ep_get_zcopy,
     .ep_am_short              = uct_self_ep_am_short,
     .ep_am_bcopy              = uct_self_ep_am_bcopy,
+    .ep_am_zcopy              = uct_self_ep_am_zcopy,
     .ep_atomic_cswap64        = uct_sm_ep_atomic_cswap64,
     .ep_atomic64_post         = uct_sm_ep_atomic64_post,
     .ep_atomic64_fetch        = uct_sm_ep_atomic64_fetch,
@@ -9,6 +9,7 @@
 #include <uct/base/uct_md.h>
 #include <ucs/sys/sys.h>
 #include <net/if.h>
+#include <sys/uio.h>
 
 #define UCT_TCP_NAME "tcp"
 
@@ -17,15 +18,213 @@
 #define UCT_TCP_MAX_EVENTS        32
 
 
+/** Maximal number of iov entries in a zero-copy send, including the entry
+ *  which holds the TCP header and the user header */
+#define UCT_TCP_EP_MAX_IOV        16
+
+
+/** Maximal number of iov entries in the endpoint send queue */
+#define UCT_TCP_EP_TX_MAX_IOV     (4 * UCT_TCP_EP_MAX_IOV)
+
+
+/** Maximal number of completions in the endpoint send queue */
+#define UCT_TCP_EP_TX_MAX_COMPS   16
+
+
+/** Maximal number of sockets of an endpoint */
+#define UCT_TCP_EP_MAX_SOCKS      16
+
+
+/** Maximal size of the user private data in a sockaddr connection request */
+#define UCT_TCP_SOCKADDR_MAX_CONN_PRIV  4096
+
+
+/**
+ * Message ids used by the transport itself, following the user active
+ * message ids. Remote memory operations are executed by the receiver progress,
+ * only within the registered region of their remote key.
+ */
+enum {
+    UCT_TCP_AM_ID_PUT = UCT_AM_ID_MAX, /* Write data to remote memory */
+    UCT_TCP_AM_ID_GET,                 /* Read remote memory */
+    UCT_TCP_AM_ID_ATOMIC,              /* Atomic operation on remote memory */
+    UCT_TCP_AM_ID_FLUSH,               /* Complete all previous operations */
+    UCT_TCP_AM_ID_REPLY,               /* Reply to GET, fetching ATOMIC and
+                                          FLUSH, in the order of requests */
+    UCT_TCP_AM_ID_CONN,                /* Identifies a socket of an endpoint
+                                          which has several sockets */
+    UCT_TCP_AM_ID_STRIPED,             /* Message whose payload is split
+                                          between the endpoint sockets */
+    UCT_TCP_AM_ID_STRIPE               /* Part of a striped message payload,
+                                          sent on an additional socket */
+};
+
+
+/**
+ * Endpoint flags
+ */
+enum {
+    UCT_TCP_EP_FLAG_PASSIVE    = UCS_BIT(0), /* Created by accepting a
+                                                connection */
+    UCT_TCP_EP_FLAG_RX_BLOCKED = UCS_BIT(1), /* Receive is stopped until a
+                                                reply can be sent */
+    UCT_TCP_EP_FLAG_UNFLUSHED  = UCS_BIT(2), /* Remote memory operations
+                                                without reply were sent */
+    UCT_TCP_EP_FLAG_STRIPE     = UCS_BIT(3), /* Additional socket of another
+                                                endpoint */
+    UCT_TCP_EP_FLAG_RX_STRIPED = UCS_BIT(4), /* Receive is stopped until all
+                                                parts of a striped message
+                                                arrive */
+    UCT_TCP_EP_FLAG_RX_WAIT    = UCS_BIT(5), /* Received a striped message
+                                                part before the message */
+    UCT_TCP_EP_FLAG_RX_RESUME  = UCS_BIT(6), /* Striped message was completed
+                                                by an additional socket */
+    UCT_TCP_EP_FLAG_READY      = UCS_BIT(7), /* Endpoint is on the interface
+                                                ready list */
+    UCT_TCP_EP_FLAG_FAILED     = UCS_BIT(8)  /* Received an invalid message,
+                                                the endpoint is going to be
+                                                released or set to failed */
+};
+
+
 /**
  * TCP active message header
  */
 typedef struct uct_tcp_am_hdr {
     uint8_t                       am_id;
-    uint16_t                      length;
+    uint32_t                      length;
 } UCS_S_PACKED uct_tcp_am_hdr_t;
 
 
+/**
+ * PUT request header, followed by the data
+ */
+typedef struct uct_tcp_put_hdr {
+    uint64_t                      address;
+    uint64_t                      rkey;     /* Key of the target region */
+} UCS_S_PACKED uct_tcp_put_hdr_t;
+
+
+/**
+ * GET request header
+ */
+typedef struct uct_tcp_get_hdr {
+    uint64_t                      address;
+    uint64_t                      rkey;     /* Key of the target region */
+    uint32_t                      length;
+} UCS_S_PACKED uct_tcp_get_hdr_t;
+
+
+/**
+ * ATOMIC request header
+ */
+typedef struct uct_tcp_atomic_hdr {
+    uint64_t                      address;
+    uint64_t                      rkey;     /* Key of the target region */
+    uint64_t                      value;
+    uint64_t                      compare;  /* Used by compare-and-swap */
+    uint8_t                       opcode;   /* uct_atomic_op_t */
+    uint8_t                       fetch;    /* Whether to reply with the
+                                               previous value */
+} UCS_S_PACKED uct_tcp_atomic_hdr_t;
+
+
+/**
+ * CONN header, sent first on every socket of an endpoint which has several
+ * sockets
+ */
+typedef struct uct_tcp_conn_hdr {
+    uint64_t                      id;       /* Same for all endpoint sockets */
+    uint8_t                       index;    /* Socket index, 0 - main socket */
+    uint8_t                       count;    /* Number of sockets */
+} UCS_S_PACKED uct_tcp_conn_hdr_t;
+
+
+/**
+ * STRIPED message header, followed by the header of the original message
+ * and the first part of the payload
+ */
+typedef struct uct_tcp_striped_hdr {
+    uint8_t                       am_id;      /* Original message id */
+    uint32_t                      hdr_length; /* Original message header */
+    uint32_t                      length;     /* Original message length,
+                                                 including the header */
+} UCS_S_PACKED uct_tcp_striped_hdr_t;
+
+
+/**
+ * STRIPE message header, followed by the data
+ */
+typedef struct uct_tcp_stripe_hdr {
+    uint32_t                      offset;   /* Offset in the striped payload */
+} UCS_S_PACKED uct_tcp_stripe_hdr_t;
+
+
+/**
+ * Sockaddr connection request header, followed by the user private data.
+ * The server replies with the same header, without data.
+ */
+typedef struct uct_tcp_sockaddr_hdr {
+    uint32_t                      length;   /* Private data length */
+    int8_t                        status;   /* Reply: UCS_OK or
+                                               UCS_ERR_REJECTED */
+} UCS_S_PACKED uct_tcp_sockaddr_hdr_t;
+
+
+/**
+ * Remote memory operation which waits for a reply
+ */
+typedef struct uct_tcp_ep_rma_op {
+    ucs_queue_elem_t              queue;
+    void                          *buffer;    /* Reply data destination */
+    size_t                        length;     /* Expected reply length */
+    uct_unpack_callback_t         unpack_cb;  /* Unpacks the reply, if set */
+    uct_completion_t              *comp;      /* User completion */
+} uct_tcp_ep_rma_op_t;
+
+
+/**
+ * Descriptor of a message which is larger than the endpoint buffer, and is
+ * received directly to a dedicated buffer.
+ */
+typedef struct uct_tcp_ep_rx_large {
+    void                          *data;     /* Start of the message payload */
+    size_t                        length;    /* Message payload length */
+    size_t                        offset;    /* How much was already received */
+    uint8_t                       am_id;     /* Active message id */
+} uct_tcp_ep_rx_large_t;
+
+
+/**
+ * Completion of a queued send operation.
+ */
+typedef struct uct_tcp_ep_tx_comp {
+    uct_completion_t              *comp;     /* User completion */
+    size_t                        offset;    /* Invoke once the send queue was
+                                                sent up to this offset */
+} uct_tcp_ep_tx_comp_t;
+
+
+/**
+ * Completion of a striped send, which is queued on several sockets
+ */
+typedef struct uct_tcp_ep_stripe_comp {
+    uct_completion_t              super;
+    uct_completion_t              *comp;     /* User completion */
+} uct_tcp_ep_stripe_comp_t;
+
+
+/**
+ * Receive segment, followed by the received data. Active messages are passed
+ * to the user in place, and every message kept by the user holds a reference
+ * to the segment.
+ */
+typedef struct uct_tcp_rx_seg {
+    uct_recv_desc_t               release_desc; /* Releases user descriptors */
+    unsigned                      refcount;     /* Endpoint + user descriptors */
+} uct_tcp_rx_seg_t;
+
+
 /**
  * TCP endpoint
  */
@@ -33,36 +232,171 @@ typedef struct uct_tcp_ep {
     uct_base_ep_t                 super;
     int                           fd;        /* Socket file descriptor */
     uint32_t                      events;    /* Current notifications */
+    uint32_t                      ready;     /* Reported events which were not
+                                                consumed yet, in edge-triggered
+                                                mode */
+    unsigned                      flags;     /* Endpoint flags */
     ucs_queue_head_t              pending_q; /* Pending operations */
-    void                          *buf;      /* Partial send/recv data */
-    size_t                        length;    /* How much data in the buffer */
-    size_t                        offset;    /* Next offset to send/recv */
+    struct {
+        void                      *buf;      /* Headers and bcopy data */
+        size_t                    buf_length;/* How much of the buffer is used */
+        struct iovec              iov[UCT_TCP_EP_TX_MAX_IOV]; /* Data to send */
+        size_t                    iov_index; /* Next iov entry to send */
+        size_t                    iovcnt;    /* Number of iov entries */
+        size_t                    length;    /* Total length of queued data */
+        size_t                    offset;    /* How much was already sent */
+        unsigned                  count;     /* Number of queued messages */
+        uct_tcp_ep_tx_comp_t      comps[UCT_TCP_EP_TX_MAX_COMPS];
+        unsigned                  comp_index;/* Next completion to invoke */
+        unsigned                  comp_count;/* Number of completions */
+    } tx;
+    struct {
+        uct_tcp_rx_seg_t          *seg;      /* Current receive segment */
+        size_t                    offset;    /* Start of the next message */
+        size_t                    length;    /* End of the received data */
+        size_t                    held;      /* End of the last message which
+                                                is kept by the user */
+    } rx;
+    uct_tcp_ep_rx_large_t         rx_large;  /* Large message being received */
+    struct {
+        ucs_queue_head_t          ops;       /* Operations waiting for reply */
+        uct_tcp_ep_rma_op_t       *flush_op; /* Last flush, if no operations
+                                                were posted after it */
+    } rma;
+    struct {
+        uint64_t                  id;        /* Identifies the sockets of the
+                                                connection */
+        unsigned                  index;     /* Socket index, 0 - main */
+        unsigned                  count;     /* Number of sockets */
+        struct uct_tcp_ep         *main;     /* Main endpoint of a stripe */
+        struct uct_tcp_ep         *socks[UCT_TCP_EP_MAX_SOCKS - 1];
+                                             /* Additional sockets */
+        unsigned                  seq;       /* Striped messages started on the
+                                                main socket, or joined by an
+                                                additional socket */
+        uint8_t                   am_id;     /* Striped message being received */
+        void                      *data;     /* Message destination */
+        size_t                    length;    /* Message length */
+        void                      *base;     /* Destination of the payload */
+        size_t                    payload_length; /* Striped payload length */
+        size_t                    remaining; /* Payload still not received */
+    } stripe;
+    uct_worker_cb_id_t            prog_id;   /* Handles a failure from the
+                                                main progress */
     ucs_list_link_t               list;
+    ucs_list_link_t               ready_list;/* Element in the interface
+                                                ready list */
 } uct_tcp_ep_t;
 
 
+/**
+ * State of a sockaddr client endpoint
+ */
+typedef enum uct_tcp_sockaddr_ep_state {
+    UCT_TCP_SOCKADDR_EP_CONNECTING,  /* Waiting for the socket to connect */
+    UCT_TCP_SOCKADDR_EP_TX_REQUEST,  /* Sending the connection request */
+    UCT_TCP_SOCKADDR_EP_RX_REPLY,    /* Waiting for the server reply */
+    UCT_TCP_SOCKADDR_EP_DONE         /* Accepted, or failed */
+} uct_tcp_sockaddr_ep_state_t;
+
+
+/**
+ * Client endpoint of a connection established by socket address. It only
+ * delivers the connection request with the user private data to the server,
+ * the data is transferred by endpoints of other transports.
+ */
+typedef struct uct_tcp_sockaddr_ep {
+    uct_base_ep_t                 super;
+    int                           fd;        /* Socket file descriptor */
+    uct_tcp_sockaddr_ep_state_t   state;
+    ucs_status_t                  status;    /* UCS_INPROGRESS until the
+                                                server replies */
+    uct_sockaddr_priv_pack_callback_t pack_cb;/* Fills the private data */
+    void                          *pack_arg;
+    uct_tcp_sockaddr_hdr_t        *buf;      /* Request being sent */
+    size_t                        offset;    /* How much of the request was
+                                                sent, or of the reply was
+                                                received */
+    uct_tcp_sockaddr_hdr_t        reply;
+    ucs_queue_head_t              ops;       /* Flushes waiting for the reply */
+    uct_worker_cb_id_t            prog_id;   /* Reports a failure from the
+                                                main thread */
+} uct_tcp_sockaddr_ep_t;
+
+
+/**
+ * Flush of a sockaddr client endpoint, waiting for the server reply
+ */
+typedef struct uct_tcp_sockaddr_ep_op {
+    ucs_queue_elem_t              queue;
+    uct_completion_t              *comp;     /* User completion */
+} uct_tcp_sockaddr_ep_op_t;
+
+
+/**
+ * Connection request received by a sockaddr server interface
+ */
+typedef struct uct_tcp_sockaddr_conn_req {
+    ucs_list_link_t               list;
+    int                           fd;        /* Accepted socket */
+    size_t                        offset;    /* How much was received */
+    uct_tcp_sockaddr_hdr_t        hdr;       /* Followed by the private data */
+} uct_tcp_sockaddr_conn_req_t;
+
+
 /**
  * TCP interface
  */
 typedef struct uct_tcp_iface {
     uct_base_iface_t              super;          /* Parent class */
+    uint64_t                      open_mode;      /* UCT_IFACE_OPEN_MODE_xx */
     int                           listen_fd;      /* Server socket */
     ucs_list_link_t               ep_list;        /* List of endpoints */
     char                          if_name[IFNAMSIZ];/* Network interface name */
     int                           epfd;           /* event poll set of sockets */
+    volatile uint32_t             num_polled;     /* Sockets which wait for
+                                                     events */
+    ucs_list_link_t               ready_list;     /* Endpoints with events
+                                                     which were not consumed,
+                                                     in edge-triggered mode */
     size_t                        outstanding;
+    size_t                        rx_headroom;    /* User data headroom */
+    uct_recv_desc_t               release_desc;   /* Large message release */
+    ucs_mpool_t                   rx_mpool;       /* Receive segments */
+    ucs_mpool_t                   rma_op_mp;      /* Operations waiting for
+                                                     reply */
+    ucs_mpool_t                   stripe_comp_mp; /* Striped send
+                                                     completions */
+
+    struct {
+        uct_sockaddr_conn_request_callback_t conn_request_cb;
+        void                      *conn_request_arg;
+        ucs_list_link_t           conn_reqs;      /* Requests being received,
+                                                     or waiting for the user
+                                                     to accept or reject */
+    } sockaddr;
 
     struct {
         struct sockaddr_in        ifaddr;         /* Network address */
         struct sockaddr_in        netmask;        /* Network address mask */
         size_t                    buf_size;       /* Maximal bcopy size */
+        size_t                    max_zcopy;      /* Maximal zcopy size */
+        size_t                    tx_buf_size;    /* Send queue buffer size */
+        unsigned                  tx_aggr_count;  /* Messages to queue before
+                                                     sending */
+        size_t                    rx_seg_size;    /* Receive segment size */
         int                       prefer_default; /* prefer default gateway */
         unsigned                  max_poll;       /* number of events to poll per socket*/
+        unsigned                  num_socks;      /* Sockets per endpoint */
+        size_t                    stripe_thresh;  /* Minimal striped payload */
+        int                       epoll_et;       /* Edge-triggered events */
     } config;
 
     struct {
         int                       nodelay;        /* TCP_NODELAY */
         int                       sndbuf;         /* SO_SNDBUF */
+        int                       busy_poll;      /* SO_BUSY_POLL, usec */
+        int                       incoming_cpu;   /* SO_INCOMING_CPU, or -1 */
     } sockopt;
 } uct_tcp_iface_t;
 
@@ -75,14 +409,27 @@ typedef struct uct_tcp_iface_config {
     int                           prefer_default;
     unsigned                      backlog;
     unsigned                      max_poll;
+    size_t                        max_zcopy;
+    size_t                        tx_aggr_size;
+    unsigned                      tx_aggr_count;
+    size_t                        rx_seg_size;
+    unsigned                      num_socks;
+    size_t                        stripe_thresh;
+    int                           epoll_et;
+    uct_iface_mpool_config_t      rx_mpool;
     int                           sockopt_nodelay;
     size_t                        sockopt_sndbuf;
+    double                        sockopt_busy_poll;
+    int                           sockopt_incoming_cpu;
 } uct_tcp_iface_config_t;
 
 
 extern uct_md_component_t uct_tcp_md;
 extern const char *uct_tcp_address_type_names[];
 
+ucs_status_t uct_tcp_md_check_access(uct_md_h md, uint64_t key,
+                                     uint64_t address, size_t length);
+
 ucs_status_t uct_tcp_socket_connect(int fd, const struct sockaddr_in *dest_addr);
 
 ucs_status_t uct_tcp_netif_caps(const char *if_name, double *latency_p,
@@ -93,12 +440,49 @@ ucs_status_t uct_tcp_netif_inaddr(const char *if_name, struct sockaddr_in *ifadd
 
 ucs_status_t uct_tcp_netif_is_default(const char *if_name, int *result_p);
 
+ucs_status_t uct_tcp_netif_find(const struct in_addr *inaddr, char *if_name,
+                                size_t max);
+
 ucs_status_t uct_tcp_send(int fd, const void *data, size_t *length_p);
 
+ucs_status_t uct_tcp_sendv(int fd, const struct iovec *iov, size_t iovcnt,
+                           size_t *length_p);
+
 ucs_status_t uct_tcp_recv(int fd, void *data, size_t *length_p);
 
 ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd);
 
+ucs_status_t uct_tcp_sockaddr_iface_init(uct_tcp_iface_t *iface,
+                                         const uct_iface_params_t *params,
+                                         const uct_tcp_iface_config_t *config);
+
+void uct_tcp_sockaddr_iface_cleanup(uct_tcp_iface_t *iface);
+
+ucs_status_t uct_tcp_sockaddr_iface_query(uct_iface_h tl_iface,
+                                          uct_iface_attr_t *attr);
+
+ucs_status_t uct_tcp_sockaddr_iface_get_address(uct_iface_h tl_iface,
+                                                uct_iface_addr_t *addr);
+
+int uct_tcp_sockaddr_iface_is_reachable(const uct_iface_h tl_iface,
+                                        const uct_device_addr_t *dev_addr,
+                                        const uct_iface_addr_t *iface_addr);
+
+ucs_status_t uct_tcp_sockaddr_iface_accept(uct_iface_h tl_iface,
+                                           uct_conn_request_h conn_request);
+
+ucs_status_t uct_tcp_sockaddr_iface_reject(uct_iface_h tl_iface,
+                                           uct_conn_request_h conn_request);
+
+UCS_CLASS_DECLARE_NEW_FUNC(uct_tcp_sockaddr_ep_t, uct_ep_t, uct_iface_t*,
+                           const ucs_sock_addr_t *,
+                           uct_sockaddr_priv_pack_callback_t, void *,
+                           uint32_t);
+UCS_CLASS_DECLARE_DELETE_FUNC(uct_tcp_sockaddr_ep_t, uct_ep_t);
+
+ucs_status_t uct_tcp_sockaddr_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                                       uct_completion_t *comp);
+
 ucs_status_t uct_tcp_ep_create(uct_tcp_iface_t *iface, int fd,
                                const struct sockaddr_in *dest_addr,
                                uct_tcp_ep_t **ep_p);
@@ -114,12 +498,54 @@ unsigned uct_tcp_ep_progress_tx(uct_tcp_ep_t *ep);
 
 unsigned uct_tcp_ep_progress_rx(uct_tcp_ep_t *ep);
 
+void uct_tcp_iface_release_large_desc(uct_recv_desc_t *self, void *desc);
+
+void uct_tcp_iface_release_seg_desc(uct_recv_desc_t *self, void *desc);
+
 void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, uint32_t add, uint32_t remove);
 
 ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
                             uct_pack_callback_t pack_cb, void *arg,
                             unsigned flags);
 
+ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id,
+                                 const void *header, unsigned header_length,
+                                 const uct_iov_t *iov, size_t iovcnt,
+                                 unsigned flags, uct_completion_t *comp);
+
+ucs_status_t uct_tcp_ep_put_short(uct_ep_h tl_ep, const void *buffer,
+                                  unsigned length, uint64_t remote_addr,
+                                  uct_rkey_t rkey);
+
+ssize_t uct_tcp_ep_put_bcopy(uct_ep_h tl_ep, uct_pack_callback_t pack_cb,
+                             void *arg, uint64_t remote_addr, uct_rkey_t rkey);
+
+ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp);
+
+ucs_status_t uct_tcp_ep_get_bcopy(uct_ep_h tl_ep, uct_unpack_callback_t unpack_cb,
+                                  void *arg, size_t length, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp);
+
+ucs_status_t uct_tcp_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp);
+
+ucs_status_t uct_tcp_ep_atomic64_post(uct_ep_h tl_ep, unsigned opcode,
+                                      uint64_t value, uint64_t remote_addr,
+                                      uct_rkey_t rkey);
+
+ucs_status_t uct_tcp_ep_atomic64_fetch(uct_ep_h tl_ep, uct_atomic_op_t opcode,
+                                       uint64_t value, uint64_t *result,
+                                       uint64_t remote_addr, uct_rkey_t rkey,
+                                       uct_completion_t *comp);
+
+ucs_status_t uct_tcp_ep_atomic_cswap64(uct_ep_h tl_ep, uint64_t compare,
+                                       uint64_t swap, uint64_t remote_addr,
+                                       uct_rkey_t rkey, uint64_t *result,
+                                       uct_completion_t *comp);
+
 ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
                                     unsigned flags);
 
@@ -129,4 +555,19 @@ void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
 ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
                               uct_completion_t *comp);
 
+static inline size_t uct_tcp_iface_rx_seg_headroom(uct_tcp_iface_t *iface)
+{
+    /* Space for the release descriptor pointer and the user headroom of the
+     * first message in the segment */
+    return sizeof(uct_recv_desc_t*) + iface->rx_headroom;
+}
+
+static inline void uct_tcp_rx_seg_put(uct_tcp_rx_seg_t *seg)
+{
+    ucs_assert(seg->refcount > 0);
+    if (--seg->refcount == 0) {
+        ucs_mpool_put(seg);
+    }
+}
+
 #endif
@@ -5,9 +5,15 @@
 
 #include "tcp.h"
 
+#include <uct/base/uct_worker.h>
+#include <ucs/arch/atomic.h>
 #include <ucs/async/async.h>
 
 
+static void uct_tcp_ep_set_failed(uct_tcp_ep_t *ep);
+static void uct_tcp_ep_stripe_comp_cb(uct_completion_t *self,
+                                      ucs_status_t status);
+
 static void uct_tcp_ep_epoll_ctl(uct_tcp_ep_t *ep, int op)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
@@ -17,7 +23,8 @@ static void uct_tcp_ep_epoll_ctl(uct_tcp_ep_t *ep, int op)
 
     memset(&epoll_event, 0, sizeof(epoll_event));
     epoll_event.data.ptr = ep;
-    epoll_event.events   = ep->events;
+    epoll_event.events   = ep->events |
+                           (iface->config.epoll_et ? EPOLLET : 0);
     ret = epoll_ctl(iface->epfd, op, ep->fd, &epoll_event);
     if (ret < 0) {
         ucs_fatal("epoll_ctl(epfd=%d, op=%d, fd=%d) failed: %m",
@@ -27,9 +34,45 @@ static void uct_tcp_ep_epoll_ctl(uct_tcp_ep_t *ep, int op)
 
 static inline int uct_tcp_ep_can_send(uct_tcp_ep_t *ep)
 {
-    ucs_assert(ep->offset <= ep->length);
-    /* TODO optimize to allow partial sends/message coalescing */
-    return ep->length == 0;
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    ucs_assert(ep->tx.offset <= ep->tx.length);
+
+    if (ucs_unlikely(ep->flags & UCT_TCP_EP_FLAG_FAILED)) {
+        return 0;
+    }
+
+    /* Check there is room for the largest message: bcopy data or zcopy
+     * header, all zcopy iov entries, and a completion */
+    return (ep->tx.length == 0) ||
+           (((iface->config.tx_buf_size - ep->tx.buf_length) >=
+             iface->config.buf_size) &&
+            ((ep->tx.iovcnt + UCT_TCP_EP_MAX_IOV) <= UCT_TCP_EP_TX_MAX_IOV) &&
+            (ep->tx.comp_count < UCT_TCP_EP_TX_MAX_COMPS));
+}
+
+static inline int uct_tcp_ep_rx_large_is_desc(uint8_t am_id)
+{
+    /* Active messages are received to a dedicated descriptor, other messages
+     * directly to their destination buffer */
+    return am_id < UCT_AM_ID_MAX;
+}
+
+static unsigned uct_tcp_ep_rx_parse(uct_tcp_ep_t *ep);
+
+static void uct_tcp_ep_tx_conn(uct_tcp_ep_t *ep);
+
+static void uct_tcp_ep_tx_reset(uct_tcp_ep_t *ep)
+{
+    ep->tx.buf_length = 0;
+    ep->tx.iov_index  = 0;
+    ep->tx.iovcnt     = 0;
+    ep->tx.length     = 0;
+    ep->tx.offset     = 0;
+    ep->tx.count      = 0;
+    ep->tx.comp_index = 0;
+    ep->tx.comp_count = 0;
 }
 
 static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface,
@@ -39,15 +82,23 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface,
 
     UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super)
 
-    self->buf = ucs_malloc(iface->config.buf_size, "tcp_buf");
-    if (self->buf == NULL) {
+    self->tx.buf = ucs_malloc(iface->config.tx_buf_size, "tcp_tx_buf");
+    if (self->tx.buf == NULL) {
         return UCS_ERR_NO_MEMORY;
     }
 
-    self->events = 0;
-    self->offset = 0;
-    self->length = 0;
+    uct_tcp_ep_tx_reset(self);
+    self->events        = 0;
+    self->ready         = 0;
+    self->flags         = (fd == -1) ? 0 : UCT_TCP_EP_FLAG_PASSIVE;
+    self->rx.seg        = NULL;
+    self->rx_large.data = NULL;
+    self->rma.flush_op  = NULL;
+    self->prog_id       = UCS_CALLBACKQ_ID_NULL;
+    memset(&self->stripe, 0, sizeof(self->stripe));
+    self->stripe.count  = 1;
     ucs_queue_head_init(&self->pending_q);
+    ucs_queue_head_init(&self->rma.ops);
 
     if (fd == -1) {
         status = ucs_tcpip_socket_create(&self->fd);
@@ -86,21 +137,105 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface,
 err_close:
     close(self->fd);
 err:
+    ucs_free(self->tx.buf);
     return status;
 }
 
+/* Release the internal completions of the sends which were not completed.
+ * Completions of user operations are not invoked, as by other endpoint
+ * destruction. */
+static void uct_tcp_ep_tx_purge_comps(uct_tcp_ep_t *ep)
+{
+    uct_completion_t *comp;
+    unsigned i;
+
+    for (i = ep->tx.comp_index; i < ep->tx.comp_count; ++i) {
+        comp = ep->tx.comps[i].comp;
+        if ((comp->func == uct_tcp_ep_stripe_comp_cb) && (--comp->count == 0)) {
+            ucs_mpool_put(ucs_container_of(comp, uct_tcp_ep_stripe_comp_t,
+                                           super));
+        }
+    }
+
+    ep->tx.comp_index = ep->tx.comp_count = 0;
+}
+
+static void uct_tcp_ep_stripe_cleanup(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_t *sock_ep;
+    unsigned i;
+
+    if (ep->stripe.main != NULL) {
+        ep->stripe.main->stripe.socks[ep->stripe.index - 1] = NULL;
+    }
+
+    for (i = 0; i < ep->stripe.count - 1; ++i) {
+        sock_ep = ep->stripe.socks[i];
+        if (sock_ep == NULL) {
+            continue;
+        }
+
+        /* Additional sockets of a user endpoint are closed with it. Accepted
+         * ones cannot be used without their main socket, and are released
+         * from the progress, so the peer sees the whole connection closed. */
+        sock_ep->stripe.main = NULL;
+        if (sock_ep->flags & UCT_TCP_EP_FLAG_PASSIVE) {
+            uct_tcp_ep_set_failed(sock_ep);
+        } else {
+            uct_tcp_ep_destroy(&sock_ep->super.super);
+        }
+    }
+
+    if ((ep->flags & UCT_TCP_EP_FLAG_RX_STRIPED) &&
+        uct_tcp_ep_rx_large_is_desc(ep->stripe.am_id)) {
+        uct_tcp_iface_release_large_desc(&iface->release_desc,
+                                         ep->stripe.data - iface->rx_headroom);
+    }
+}
+
 static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(self->super.super.iface,
                                             uct_tcp_iface_t);
+    uct_tcp_ep_rma_op_t *op;
 
     ucs_debug("tcp_ep %p: destroying", self);
 
+    uct_worker_progress_unregister_safe(&iface->super.worker->super,
+                                        &self->prog_id);
+
     UCS_ASYNC_BLOCK(iface->super.worker->async);
     ucs_list_del(&self->list);
     UCS_ASYNC_UNBLOCK(iface->super.worker->async);
 
-    ucs_free(self->buf);
+    if (self->events != 0) {
+        ucs_atomic_add32(&iface->num_polled, -1);
+    }
+
+    if (self->flags & UCT_TCP_EP_FLAG_READY) {
+        ucs_list_del(&self->ready_list);
+    }
+
+    if (self->rx.seg != NULL) {
+        uct_tcp_rx_seg_put(self->rx.seg);
+    }
+
+    if ((self->rx_large.data != NULL) &&
+        uct_tcp_ep_rx_large_is_desc(self->rx_large.am_id)) {
+        uct_tcp_iface_release_large_desc(&iface->release_desc,
+                                         self->rx_large.data -
+                                         iface->rx_headroom);
+    }
+
+    ucs_queue_for_each_extract(op, &self->rma.ops, queue, 1) {
+        ucs_mpool_put(op);
+    }
+
+    uct_tcp_ep_tx_purge_comps(self);
+    uct_tcp_ep_stripe_cleanup(self);
+    ucs_free(self->tx.buf);
     close(self->fd);
 }
 
@@ -111,6 +246,38 @@ UCS_CLASS_DEFINE_NAMED_NEW_FUNC(uct_tcp_ep_create, uct_tcp_ep_t, uct_tcp_ep_t,
                                 const struct sockaddr_in*)
 UCS_CLASS_DEFINE_NAMED_DELETE_FUNC(uct_tcp_ep_destroy, uct_tcp_ep_t, uct_ep_t)
 
+static ucs_status_t uct_tcp_ep_connect_socks(uct_tcp_ep_t *ep,
+                                             const struct sockaddr_in *dest_addr)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_t *sock_ep;
+    ucs_status_t status;
+    unsigned i;
+
+    /* The receiver matches the sockets of the endpoint by the id */
+    ep->stripe.id    = ucs_generate_uuid((uintptr_t)ep);
+    ep->stripe.count = iface->config.num_socks;
+    uct_tcp_ep_tx_conn(ep);
+
+    for (i = 1; i < ep->stripe.count; ++i) {
+        status = uct_tcp_ep_create(iface, -1, dest_addr, &sock_ep);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        sock_ep->flags       |= UCT_TCP_EP_FLAG_STRIPE;
+        sock_ep->stripe.id    = ep->stripe.id;
+        sock_ep->stripe.index = i;
+        sock_ep->stripe.count = ep->stripe.count;
+        sock_ep->stripe.main  = ep;
+        ep->stripe.socks[i - 1] = sock_ep;
+        uct_tcp_ep_tx_conn(sock_ep);
+    }
+
+    return UCS_OK;
+}
+
 ucs_status_t uct_tcp_ep_create_connected(uct_iface_t *tl_iface,
                                          const uct_device_addr_t *dev_addr,
                                          const uct_iface_addr_t *iface_addr,
@@ -128,19 +295,42 @@ ucs_status_t uct_tcp_ep_create_connected(uct_iface_t *tl_iface,
 
     /* TODO try to reuse existing connection */
     status = uct_tcp_ep_create(iface, -1, &dest_addr, &tcp_ep);
-    if (status == UCS_OK) {
-        ucs_debug("tcp_ep %p: connected to %s:%d", tcp_ep,
-                  inet_ntoa(dest_addr.sin_addr), ntohs(dest_addr.sin_port));
-        *ep_p = &tcp_ep->super.super;
+    if (status != UCS_OK) {
+        return status;
     }
-    return status;
+
+    if (iface->config.num_socks > 1) {
+        status = uct_tcp_ep_connect_socks(tcp_ep, &dest_addr);
+        if (status != UCS_OK) {
+            uct_tcp_ep_destroy(&tcp_ep->super.super);
+            return status;
+        }
+    }
+
+    ucs_debug("tcp_ep %p: connected to %s:%d with %u sockets", tcp_ep,
+              inet_ntoa(dest_addr.sin_addr), ntohs(dest_addr.sin_port),
+              tcp_ep->stripe.count);
+    *ep_p = &tcp_ep->super.super;
+    return UCS_OK;
 }
 
 void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, uint32_t add, uint32_t remove)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
     int new_events = (ep->events | add) & ~remove;
 
     if (new_events != ep->events) {
+        /* Passive endpoints are enabled from the async thread */
+        if (ep->events == 0) {
+            ucs_atomic_add32(&iface->num_polled, 1);
+        } else if (new_events == 0) {
+            ucs_atomic_add32(&iface->num_polled, -1);
+        }
+
+        /* Re-enabled events are reported again by epoll_ctl if the socket
+         * is ready */
+        ep->ready &= new_events;
         ep->events = new_events;
         ucs_trace("tcp_ep %p: set events to %c%c", ep,
                   (new_events & EPOLLIN)  ? 'i' : '-',
@@ -149,30 +339,185 @@ void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, uint32_t add, uint32_t remove)
     }
 }
 
+static unsigned uct_tcp_ep_failed_progress(void *arg)
+{
+    uct_tcp_ep_t *ep       = arg;
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    ucs_trace_func("ep=%p", ep);
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+
+    ep->prog_id = UCS_CALLBACKQ_ID_NULL;
+    if (ep->flags & UCT_TCP_EP_FLAG_PASSIVE) {
+        /* Endpoints which were not created by the user are released by the
+         * transport */
+        uct_tcp_ep_destroy(&ep->super.super);
+    } else {
+        uct_set_ep_failed(&UCS_CLASS_NAME(uct_tcp_ep_t), &ep->super.super,
+                          &iface->super.super, UCS_ERR_IO_ERROR);
+    }
+
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+    return 1;
+}
+
+/* Stop all communication on an endpoint which received an invalid message.
+ * The endpoint may still be used by the caller, so it is released, or set to
+ * failed state, from the main progress. */
+static void uct_tcp_ep_set_failed(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    if (ep->flags & UCT_TCP_EP_FLAG_FAILED) {
+        return;
+    }
+
+    ucs_debug("tcp_ep %p: closing connection on fd %d", ep, ep->fd);
+    ep->flags |= UCT_TCP_EP_FLAG_FAILED;
+    uct_tcp_ep_mod_events(ep, 0, EPOLLIN | EPOLLOUT);
+
+    /* Additional sockets of a user endpoint are released with it */
+    if ((ep->flags & UCT_TCP_EP_FLAG_PASSIVE) || (ep->stripe.main == NULL)) {
+        uct_worker_progress_register_safe(&iface->super.worker->super,
+                                          uct_tcp_ep_failed_progress, ep,
+                                          UCS_CALLBACKQ_FLAG_ONESHOT,
+                                          &ep->prog_id);
+    }
+
+    if (ep->stripe.main != NULL) {
+        uct_tcp_ep_set_failed(ep->stripe.main);
+    }
+}
+
+static void uct_tcp_ep_tx_advance(uct_tcp_ep_t *ep, size_t sent_length)
+{
+    struct iovec *iov;
+
+    while (sent_length > 0) {
+        iov = &ep->tx.iov[ep->tx.iov_index];
+        if (sent_length < iov->iov_len) {
+            iov->iov_base  = UCS_PTR_BYTE_OFFSET(iov->iov_base, sent_length);
+            iov->iov_len  -= sent_length;
+            break;
+        }
+
+        sent_length -= iov->iov_len;
+        ++ep->tx.iov_index;
+    }
+}
+
+static void uct_tcp_ep_tx_add_iov(uct_tcp_ep_t *ep, void *buffer, size_t length)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    struct iovec *iov;
+
+    if (length == 0) {
+        return;
+    }
+
+    iface->outstanding += length;
+
+    /* Extend the last entry if the data is contiguous with it, which is the
+     * case for consecutive bcopy messages */
+    if (ep->tx.iovcnt > ep->tx.iov_index) {
+        iov = &ep->tx.iov[ep->tx.iovcnt - 1];
+        if (UCS_PTR_BYTE_OFFSET(iov->iov_base, iov->iov_len) == buffer) {
+            iov->iov_len += length;
+            ep->tx.length += length;
+            return;
+        }
+    }
+
+    ucs_assert(ep->tx.iovcnt < UCT_TCP_EP_TX_MAX_IOV);
+    iov           = &ep->tx.iov[ep->tx.iovcnt++];
+    iov->iov_base = buffer;
+    iov->iov_len  = length;
+    ep->tx.length += length;
+}
+
+static void uct_tcp_ep_tx_add_comp(uct_tcp_ep_t *ep, uct_completion_t *comp)
+{
+    ucs_assert(ep->tx.comp_count < UCT_TCP_EP_TX_MAX_COMPS);
+    ep->tx.comps[ep->tx.comp_count].comp   = comp;
+    ep->tx.comps[ep->tx.comp_count].offset = ep->tx.length;
+    ++ep->tx.comp_count;
+}
+
 static unsigned uct_tcp_ep_send(uct_tcp_ep_t *ep)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_tcp_iface_t);
+    uct_tcp_ep_tx_comp_t comps[UCT_TCP_EP_TX_MAX_COMPS];
+    unsigned comp_count, i;
     size_t send_length;
     ucs_status_t status;
 
-    send_length = ep->length - ep->offset;
+    /* Send all queued messages with a single system call */
+    send_length = ep->tx.length - ep->tx.offset;
     ucs_assert(send_length > 0);
 
-    status = uct_tcp_send(ep->fd, ep->buf + ep->offset, &send_length);
+    status = uct_tcp_sendv(ep->fd, &ep->tx.iov[ep->tx.iov_index],
+                           ep->tx.iovcnt - ep->tx.iov_index, &send_length);
     if (status < 0) {
         return 0;
     }
 
     ucs_trace_data("tcp_ep %p: sent %zu bytes", ep, send_length);
 
+    if (send_length < ep->tx.length - ep->tx.offset) {
+        /* The socket buffer is full */
+        ep->ready &= ~EPOLLOUT;
+    }
+
     iface->outstanding -= send_length;
-    ep->offset         += send_length;
-    if (ep->offset == ep->length) {
-        ep->offset = 0;
-        ep->length = 0;
+    ep->tx.offset      += send_length;
+    if (ep->tx.offset < ep->tx.length) {
+        uct_tcp_ep_tx_advance(ep, send_length);
+
+        /* Release user buffers of zero-copy operations which were sent */
+        while ((ep->tx.comp_index < ep->tx.comp_count) &&
+               (ep->tx.comps[ep->tx.comp_index].offset <= ep->tx.offset)) {
+            uct_invoke_completion(ep->tx.comps[ep->tx.comp_index++].comp,
+                                  UCS_OK);
+        }
+        return send_length > 0;
+    }
+
+    /* The kernel has consumed all the data. Reset the queue before invoking
+     * the completions, since they may send more data on this endpoint. */
+    comp_count = ep->tx.comp_count - ep->tx.comp_index;
+    memcpy(comps, &ep->tx.comps[ep->tx.comp_index], sizeof(*comps) * comp_count);
+    uct_tcp_ep_tx_reset(ep);
+
+    for (i = 0; i < comp_count; ++i) {
+        uct_invoke_completion(comps[i].comp, UCS_OK);
     }
 
-    return send_length > 0;
+    return 1;
+}
+
+static void uct_tcp_ep_tx_start(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    ++ep->tx.count;
+
+    /* If the socket is busy or sending is deferred, the queue is sent from
+     * progress */
+    if (ep->events & EPOLLOUT) {
+        return;
+    }
+
+    if (ep->tx.count >= iface->config.tx_aggr_count) {
+        uct_tcp_ep_send(ep);
+    }
+
+    if (ep->tx.length > 0) {
+        uct_tcp_ep_mod_events(ep, EPOLLOUT, 0);
+    }
 }
 
 unsigned uct_tcp_ep_progress_tx(uct_tcp_ep_t *ep)
@@ -182,13 +527,26 @@ unsigned uct_tcp_ep_progress_tx(uct_tcp_ep_t *ep)
 
     ucs_trace_func("ep=%p", ep);
 
-    if (ep->length > 0) {
+    if (ucs_unlikely(ep->flags & UCT_TCP_EP_FLAG_FAILED)) {
+        return 0;
+    }
+
+    if (ep->tx.length > 0) {
         count += uct_tcp_ep_send(ep);
     }
 
     uct_pending_queue_dispatch(priv, &ep->pending_q, uct_tcp_ep_can_send(ep));
 
-    if (uct_tcp_ep_can_send(ep)) {
+    /* Resume parsing requests which were waiting for a reply to be sent */
+    if ((ep->flags & UCT_TCP_EP_FLAG_RX_BLOCKED) && uct_tcp_ep_can_send(ep)) {
+        ep->flags &= ~UCT_TCP_EP_FLAG_RX_BLOCKED;
+        uct_tcp_ep_mod_events(ep, EPOLLIN, 0);
+        count += uct_tcp_ep_rx_parse(ep);
+    }
+
+    /* Keep polling for writability while there are queued messages, which
+     * could be added by pending operations */
+    if (ep->tx.length == 0) {
         ucs_assert(ucs_queue_is_empty(&ep->pending_q));
         uct_tcp_ep_mod_events(ep, 0, EPOLLOUT);
     }
@@ -196,133 +554,1610 @@ unsigned uct_tcp_ep_progress_tx(uct_tcp_ep_t *ep)
     return count;
 }
 
-unsigned uct_tcp_ep_progress_rx(uct_tcp_ep_t *ep)
+static int uct_tcp_ep_recv(uct_tcp_ep_t *ep, void *data, size_t *length_p)
 {
-    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
-                                            uct_tcp_iface_t);
-    uct_tcp_am_hdr_t *hdr;
+    size_t length = *length_p;
     ucs_status_t status;
-    size_t recv_length;
-    ssize_t remainder;
-
-    ucs_trace_func("ep=%p", ep);
-
-    /* Receive next chunk of data */
-    recv_length = iface->config.buf_size - ep->length;
-    ucs_assertv(recv_length > 0, "ep=%p", ep);
 
-    status = uct_tcp_recv(ep->fd, ep->buf + ep->length, &recv_length);
+    status = uct_tcp_recv(ep->fd, data, length_p);
     if (status != UCS_OK) {
         if (status == UCS_ERR_CANCELED) {
             ucs_debug("tcp_ep %p: remote disconnected", ep);
             uct_tcp_ep_mod_events(ep, 0, EPOLLIN);
-            uct_tcp_ep_destroy(&ep->super.super);
+            if (ep->flags & UCT_TCP_EP_FLAG_PASSIVE) {
+                /* Endpoints which were not created by the user are
+                 * released by the transport */
+                uct_tcp_ep_destroy(&ep->super.super);
+            }
         }
         return 0;
     }
 
-    ep->length += recv_length;
-    ucs_trace_data("tcp_ep %p: recvd %zu bytes", ep, recv_length);
+    ucs_trace_data("tcp_ep %p: recvd %zu bytes", ep, *length_p);
 
-    /* Parse received active messages */
-    while ((remainder = ep->length - ep->offset) >= sizeof(*hdr)) {
-        hdr = ep->buf + ep->offset;
-        ucs_assert(hdr->length <= (iface->config.buf_size - sizeof(uct_tcp_am_hdr_t)));
+    if (*length_p < length) {
+        /* The socket was drained */
+        ep->ready &= ~EPOLLIN;
+    }
+    return 1;
+}
 
-        if (remainder < sizeof(*hdr) + hdr->length) {
-            break;
-        }
+static void uct_tcp_ep_rma_op_complete(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_rma_op_t *op;
 
-        /* Full message was received */
-        ep->offset += sizeof(*hdr) + hdr->length;
+    op = ucs_queue_pull_elem_non_empty(&ep->rma.ops, uct_tcp_ep_rma_op_t,
+                                       queue);
+    if (op == ep->rma.flush_op) {
+        ep->rma.flush_op = NULL;
+    }
 
-        if (hdr->am_id >= UCT_AM_ID_MAX) {
-            ucs_error("invalid am id: %d", hdr->am_id);
-            continue;
-        }
+    /* Replies are not expected anymore */
+    if (ucs_queue_is_empty(&ep->rma.ops) &&
+        !(ep->flags & UCT_TCP_EP_FLAG_PASSIVE)) {
+        uct_tcp_ep_mod_events(ep, 0, EPOLLIN);
+    }
 
-        uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_RECV, hdr->am_id,
-                           hdr + 1, hdr->length, "RECV fd %d", ep->fd);
-        uct_iface_invoke_am(&iface->super, hdr->am_id, hdr + 1,
-                            hdr->length, 0);
+    if (op->comp != NULL) {
+        uct_invoke_completion(op->comp, UCS_OK);
     }
+    ucs_mpool_put(op);
+}
 
-    /* Move the remaining data to the beginning of the buffer
-     * TODO avoid extra copy on partial receive
-     */
-    ucs_assert(remainder >= 0);
-    memmove(ep->buf, ep->buf + ep->offset, remainder);
-    ep->offset = 0;
-    ep->length = remainder;
+static void *uct_tcp_ep_rx_desc_alloc(uct_tcp_ep_t *ep, size_t length)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    void *desc;
+
+    /* Layout: | release_desc ptr | rx_headroom | payload | */
+    desc = ucs_malloc(sizeof(uct_recv_desc_t*) + iface->rx_headroom + length,
+                      "tcp_rx_large");
+    if (desc == NULL) {
+        ucs_error("tcp_ep %p: failed to allocate receive buffer of %zu bytes",
+                  ep, length);
+        uct_tcp_ep_set_failed(ep);
+        return NULL;
+    }
 
-    return recv_length > 0;
+    return UCS_PTR_BYTE_OFFSET(desc, sizeof(uct_recv_desc_t*) +
+                                     iface->rx_headroom);
 }
 
-ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
-                            uct_pack_callback_t pack_cb, void *arg,
-                            unsigned flags)
+static void uct_tcp_ep_rx_desc_invoke_am(uct_tcp_ep_t *ep, uint8_t am_id,
+                                         void *data, size_t length)
 {
-    uct_tcp_ep_t *ep = ucs_derived_of(uct_ep, uct_tcp_ep_t);
-    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
-    uct_tcp_am_hdr_t *hdr;
-    size_t packed_length;
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    ucs_status_t status;
 
-    if (!uct_tcp_ep_can_send(ep)) {
-        return UCS_ERR_NO_RESOURCE;
+    if (am_id >= UCT_AM_ID_MAX) {
+        ucs_error("invalid am id: %d", am_id);
+        status = UCS_OK;
+    } else {
+        uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_RECV, am_id,
+                           data, length, "RECV fd %d", ep->fd);
+        status = uct_iface_invoke_am(&iface->super, am_id, data, length,
+                                     UCT_CB_PARAM_FLAG_DESC);
     }
 
-    hdr         = ep->buf;
-    hdr->am_id  = am_id;
-    hdr->length = packed_length = pack_cb(hdr + 1, arg);
-    ep->length  = sizeof(*hdr) + packed_length;
+    if (status == UCS_INPROGRESS) {
+        /* save the release_desc for later release of this desc */
+        uct_recv_desc(data - iface->rx_headroom) = &iface->release_desc;
+    } else {
+        uct_tcp_iface_release_large_desc(&iface->release_desc,
+                                         data - iface->rx_headroom);
+    }
+}
 
-    UCT_CHECK_LENGTH(hdr->length, 0,
-                     iface->config.buf_size - sizeof(uct_tcp_am_hdr_t),
-                     "am_bcopy");
-    UCT_TL_EP_STAT_OP(&ep->super, AM, BCOPY, hdr->length);
-    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, hdr->am_id,
-                       hdr + 1, hdr->length, "SEND fd %d", ep->fd);
-    iface->outstanding += ep->length;
+/* Remote memory operations may access only registered memory, a peer which
+ * asks for anything else is disconnected. Empty operations, which are allowed
+ * with an invalid key, do not access memory. */
+static int uct_tcp_ep_rx_check_access(uct_tcp_ep_t *ep, const char *name,
+                                      uint64_t rkey, uint64_t address,
+                                      size_t length)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
 
-    uct_tcp_ep_send(ep);
-    if (ep->length > 0) {
-        uct_tcp_ep_mod_events(ep, EPOLLOUT, 0);
+    if ((length == 0) ||
+        ucs_likely(uct_tcp_md_check_access(iface->super.md, rkey, address,
+                                           length) == UCS_OK)) {
+        return 1;
     }
-    return packed_length;
+
+    ucs_error("tcp_ep %p: %s of %zu bytes at 0x%"PRIx64" with rkey 0x%"PRIx64
+              " is outside of registered memory", ep, name, length, address,
+              rkey);
+    uct_tcp_ep_set_failed(ep);
+    return 0;
 }
 
-ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
-                                    unsigned flags)
+/* Returns the operation which the reply belongs to, or NULL if the reply does
+ * not match the oldest operation waiting for it */
+static uct_tcp_ep_rma_op_t *uct_tcp_ep_rx_reply_op(uct_tcp_ep_t *ep,
+                                                   size_t length)
 {
-    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_ep_rma_op_t *op;
 
-    if (uct_tcp_ep_can_send(ep)) {
-        return UCS_ERR_BUSY;
+    if (ucs_queue_is_empty(&ep->rma.ops)) {
+        ucs_error("tcp_ep %p: unexpected reply of %zu bytes", ep, length);
+        uct_tcp_ep_set_failed(ep);
+        return NULL;
     }
 
-    uct_pending_req_queue_push(&ep->pending_q, req);
-    return UCS_OK;
+    op = ucs_queue_head_elem_non_empty(&ep->rma.ops, uct_tcp_ep_rma_op_t,
+                                       queue);
+    if (op->length != length) {
+        ucs_error("tcp_ep %p: reply length %zu, expected %zu", ep, length,
+                  op->length);
+        uct_tcp_ep_set_failed(ep);
+        return NULL;
+    }
+
+    return op;
 }
 
-void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
-                             void *arg)
+static void uct_tcp_ep_rx_stripe_wake(uct_tcp_ep_t *ep)
 {
-    uct_tcp_ep_t                 *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
-    uct_pending_req_priv_queue_t *priv;
+    /* Parse the part which arrived before its striped message */
+    ep->flags &= ~UCT_TCP_EP_FLAG_RX_WAIT;
+    uct_tcp_ep_mod_events(ep, EPOLLIN, 0);
+    uct_tcp_ep_rx_parse(ep);
+}
 
-    uct_pending_queue_purge(priv, &ep->pending_q, 1, cb, arg);
+static int uct_tcp_ep_rx_stripe_ready(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_t *main_ep = ep->stripe.main;
+
+    /* Every additional socket sends one part of each striped message, after
+     * the main socket has started receiving it */
+    return (main_ep != NULL) && (main_ep->flags & UCT_TCP_EP_FLAG_RX_STRIPED) &&
+           (ep->stripe.seq != main_ep->stripe.seq);
 }
 
-ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
-                              uct_completion_t *comp)
+static void uct_tcp_ep_rx_stripe_done(uct_tcp_ep_t *ep, size_t length)
 {
-    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    ucs_assert(ep->flags & UCT_TCP_EP_FLAG_RX_STRIPED);
+    ucs_assert(ep->stripe.remaining >= length);
 
-    if (!uct_tcp_ep_can_send(ep)) {
-        return UCS_ERR_NO_RESOURCE;
+    ep->stripe.remaining -= length;
+    if (ep->stripe.remaining > 0) {
+        return;
     }
 
-    UCT_TL_EP_STAT_FLUSH(&ep->super);
-    return UCS_OK;
+    ucs_trace_data("tcp_ep %p: received striped message of %zu bytes", ep,
+                   ep->stripe.length);
+
+    /* Parsing of the main socket is resumed by the socket which received the
+     * last part */
+    ep->flags &= ~UCT_TCP_EP_FLAG_RX_STRIPED;
+    ep->flags |= UCT_TCP_EP_FLAG_RX_RESUME;
+    if (ep->stripe.am_id != UCT_TCP_AM_ID_PUT) {
+        uct_tcp_ep_rx_desc_invoke_am(ep, ep->stripe.am_id, ep->stripe.data,
+                                     ep->stripe.length);
+    }
+    uct_tcp_ep_mod_events(ep, EPOLLIN, 0);
+}
+
+static unsigned uct_tcp_ep_rx_stripe_resume(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_t *main_ep = ep->stripe.main;
+
+    if ((main_ep == NULL) || !(main_ep->flags & UCT_TCP_EP_FLAG_RX_RESUME)) {
+        return 0;
+    }
+
+    return uct_tcp_ep_rx_parse(main_ep);
+}
+
+/* Checks the header of a striped message against the limits of the sender,
+ * since the rest of the payload is written at offsets chosen by the peer */
+static int uct_tcp_ep_rx_striped_is_valid(uct_tcp_ep_t *ep,
+                                          const uct_tcp_am_hdr_t *hdr)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    const uct_tcp_striped_hdr_t *striped_hdr = (const void*)(hdr + 1);
+    size_t payload_length, part_length;
+
+    if ((striped_hdr->am_id != UCT_TCP_AM_ID_PUT) &&
+        (striped_hdr->am_id >= UCT_AM_ID_MAX)) {
+        ucs_error("tcp_ep %p: invalid striped message id %d", ep,
+                  striped_hdr->am_id);
+        goto err;
+    }
+
+    if ((striped_hdr->hdr_length > (hdr->length - sizeof(*striped_hdr))) ||
+        (striped_hdr->hdr_length > striped_hdr->length)) {
+        ucs_error("tcp_ep %p: invalid striped message header length %u", ep,
+                  striped_hdr->hdr_length);
+        goto err;
+    }
+
+    payload_length = striped_hdr->length - striped_hdr->hdr_length;
+    part_length    = hdr->length - sizeof(*striped_hdr) -
+                     striped_hdr->hdr_length;
+    if ((payload_length > iface->config.max_zcopy) ||
+        (part_length > payload_length)) {
+        ucs_error("tcp_ep %p: invalid striped payload of %zu bytes, first "
+                  "part of %zu bytes", ep, payload_length, part_length);
+        goto err;
+    }
+
+    /* The rest of the payload would never arrive */
+    if (ep->stripe.count < 2) {
+        ucs_error("tcp_ep %p: striped message on a single socket", ep);
+        goto err;
+    }
+
+    return 1;
+
+err:
+    uct_tcp_ep_set_failed(ep);
+    return 0;
+}
+
+/* Checks that a part received on an additional socket fits the payload of
+ * the striped message which is being received by the main socket */
+static int uct_tcp_ep_rx_stripe_is_valid(uct_tcp_ep_t *ep,
+                                         const uct_tcp_stripe_hdr_t *stripe_hdr,
+                                         size_t length)
+{
+    uct_tcp_ep_t *main_ep = ep->stripe.main;
+
+    if ((main_ep == NULL) || !(main_ep->flags & UCT_TCP_EP_FLAG_RX_STRIPED)) {
+        ucs_error("tcp_ep %p: unexpected striped message part", ep);
+    } else if ((stripe_hdr->offset > main_ep->stripe.payload_length) ||
+               (length > (main_ep->stripe.payload_length -
+                          stripe_hdr->offset)) ||
+               (length > main_ep->stripe.remaining)) {
+        ucs_error("tcp_ep %p: striped message part of %zu bytes at offset %u "
+                  "exceeds the payload of %zu bytes, %zu remaining", ep,
+                  length, stripe_hdr->offset, main_ep->stripe.payload_length,
+                  main_ep->stripe.remaining);
+    } else {
+        return 1;
+    }
+
+    uct_tcp_ep_set_failed(ep);
+    return 0;
+}
+
+static int uct_tcp_ep_rx_striped_start(uct_tcp_ep_t *ep,
+                                       const uct_tcp_am_hdr_t *hdr,
+                                       size_t recvd_length)
+{
+    const uct_tcp_striped_hdr_t *striped_hdr = (const void*)(hdr + 1);
+    const uct_tcp_put_hdr_t *put_hdr;
+    size_t hdr_length, part_length;
+    const void *payload;
+    uct_tcp_ep_t *sock_ep;
+    unsigned i;
+
+    /* Wait for the header of the original message */
+    if (recvd_length < sizeof(*striped_hdr)) {
+        return 0;
+    } else if (!uct_tcp_ep_rx_striped_is_valid(ep, hdr)) {
+        return 0;
+    } else if (recvd_length < (sizeof(*striped_hdr) +
+                               striped_hdr->hdr_length)) {
+        return 0;
+    }
+
+    hdr_length                = sizeof(*striped_hdr) + striped_hdr->hdr_length;
+    payload                   = UCS_PTR_BYTE_OFFSET(striped_hdr, hdr_length);
+    ep->stripe.am_id          = striped_hdr->am_id;
+    ep->stripe.length         = striped_hdr->length;
+    ep->stripe.payload_length = striped_hdr->length - striped_hdr->hdr_length;
+    ep->stripe.remaining      = ep->stripe.payload_length;
+    if (striped_hdr->am_id == UCT_TCP_AM_ID_PUT) {
+        put_hdr          = (const uct_tcp_put_hdr_t*)(striped_hdr + 1);
+        if (striped_hdr->hdr_length != sizeof(*put_hdr)) {
+            ucs_error("tcp_ep %p: invalid striped PUT header length %u", ep,
+                      striped_hdr->hdr_length);
+            uct_tcp_ep_set_failed(ep);
+            return 0;
+        } else if (!uct_tcp_ep_rx_check_access(ep, "striped PUT",
+                                               put_hdr->rkey, put_hdr->address,
+                                               ep->stripe.remaining)) {
+            return 0;
+        }
+
+        ep->stripe.data  = (void*)(uintptr_t)put_hdr->address;
+        ep->stripe.base  = ep->stripe.data;
+    } else {
+        ep->stripe.data  = uct_tcp_ep_rx_desc_alloc(ep, striped_hdr->length);
+        if (ep->stripe.data == NULL) {
+            return 0;
+        }
+
+        ep->stripe.base  = UCS_PTR_BYTE_OFFSET(ep->stripe.data,
+                                               striped_hdr->hdr_length);
+        memcpy(ep->stripe.data, striped_hdr + 1, striped_hdr->hdr_length);
+    }
+
+    ++ep->stripe.seq;
+    ep->flags |= UCT_TCP_EP_FLAG_RX_STRIPED;
+
+    /* Receive the first part, which follows the header */
+    part_length   = hdr->length - hdr_length;
+    recvd_length -= hdr_length;
+    if (recvd_length < part_length) {
+        ep->rx_large.data   = ep->stripe.base;
+        ep->rx_large.length = part_length;
+        ep->rx_large.offset = recvd_length;
+        ep->rx_large.am_id  = UCT_TCP_AM_ID_STRIPED;
+        memcpy(ep->rx_large.data, payload, recvd_length);
+    } else {
+        memcpy(ep->stripe.base, payload, part_length);
+        uct_tcp_ep_rx_stripe_done(ep, part_length);
+    }
+
+    for (i = 0; i < ep->stripe.count - 1; ++i) {
+        sock_ep = ep->stripe.socks[i];
+        if ((sock_ep != NULL) && (sock_ep->flags & UCT_TCP_EP_FLAG_RX_WAIT)) {
+            uct_tcp_ep_rx_stripe_wake(sock_ep);
+        }
+    }
+
+    return 1;
+}
+
+static void uct_tcp_ep_rx_stripe(uct_tcp_ep_t *ep,
+                                 const uct_tcp_stripe_hdr_t *stripe_hdr,
+                                 size_t length)
+{
+    uct_tcp_ep_t *main_ep = ep->stripe.main;
+
+    if (!uct_tcp_ep_rx_stripe_is_valid(ep, stripe_hdr, length)) {
+        return;
+    }
+
+    ep->stripe.seq = main_ep->stripe.seq;
+    memcpy(UCS_PTR_BYTE_OFFSET(main_ep->stripe.base, stripe_hdr->offset),
+           stripe_hdr + 1, length);
+    uct_tcp_ep_rx_stripe_done(main_ep, length);
+}
+
+static void uct_tcp_ep_rx_conn(uct_tcp_ep_t *ep,
+                               const uct_tcp_conn_hdr_t *conn_hdr)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_t *main_ep, *sock_ep, *peer;
+
+    if ((conn_hdr->count > UCT_TCP_EP_MAX_SOCKS) ||
+        (conn_hdr->index >= conn_hdr->count)) {
+        ucs_error("tcp_ep %p: invalid socket index %d of %d", ep,
+                  conn_hdr->index, conn_hdr->count);
+        return;
+    }
+
+    ep->stripe.id    = conn_hdr->id;
+    ep->stripe.index = conn_hdr->index;
+    ep->stripe.count = conn_hdr->count;
+    if (ep->stripe.index > 0) {
+        ep->flags |= UCT_TCP_EP_FLAG_STRIPE;
+    }
+
+    /* Link the main socket with the additional sockets, which may be
+     * accepted in any order */
+    ucs_list_for_each(peer, &iface->ep_list, list) {
+        if ((peer == ep) || !(peer->flags & UCT_TCP_EP_FLAG_PASSIVE) ||
+            (peer->stripe.id != ep->stripe.id) ||
+            ((peer->stripe.index == 0) == (ep->stripe.index == 0))) {
+            continue;
+        }
+
+        main_ep = (ep->stripe.index == 0) ? ep : peer;
+        sock_ep = (ep->stripe.index == 0) ? peer : ep;
+        main_ep->stripe.socks[sock_ep->stripe.index - 1] = sock_ep;
+        sock_ep->stripe.main = main_ep;
+        ucs_debug("tcp_ep %p: linked socket %u of tcp_ep %p", sock_ep,
+                  sock_ep->stripe.index, main_ep);
+    }
+}
+
+static int uct_tcp_ep_rx_large_start(uct_tcp_ep_t *ep,
+                                     const uct_tcp_am_hdr_t *hdr,
+                                     size_t recvd_length)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    const uct_tcp_stripe_hdr_t *stripe_hdr;
+    const uct_tcp_put_hdr_t *put_hdr;
+    uct_tcp_ep_rma_op_t *op;
+    uct_tcp_ep_t *main_ep;
+    const void *payload;
+
+    ucs_assert(recvd_length < hdr->length);
+
+    switch (hdr->am_id) {
+    case UCT_TCP_AM_ID_PUT:
+        /* Receive the rest of the data directly to the target memory */
+        if (recvd_length < sizeof(*put_hdr)) {
+            return 0;
+        }
+
+        if ((hdr->length - sizeof(*put_hdr)) > iface->config.max_zcopy) {
+            ucs_error("tcp_ep %p: PUT length %zu exceeds the maximum of %zu",
+                      ep, hdr->length - sizeof(*put_hdr),
+                      iface->config.max_zcopy);
+            uct_tcp_ep_set_failed(ep);
+            return 0;
+        }
+
+        put_hdr             = (const uct_tcp_put_hdr_t*)(hdr + 1);
+        if (!uct_tcp_ep_rx_check_access(ep, "PUT", put_hdr->rkey,
+                                        put_hdr->address,
+                                        hdr->length - sizeof(*put_hdr))) {
+            return 0;
+        }
+
+        payload             = put_hdr + 1;
+        ep->rx_large.data   = (void*)(uintptr_t)put_hdr->address;
+        ep->rx_large.length = hdr->length - sizeof(*put_hdr);
+        recvd_length       -= sizeof(*put_hdr);
+        break;
+    case UCT_TCP_AM_ID_REPLY:
+        /* Receive the rest of the reply directly to the user buffer. Replies
+         * which are unpacked by the user fit a receive segment. */
+        op = uct_tcp_ep_rx_reply_op(ep, hdr->length);
+        if (op == NULL) {
+            return 0;
+        } else if (op->unpack_cb != NULL) {
+            ucs_error("tcp_ep %p: unexpected large reply of %u bytes", ep,
+                      hdr->length);
+            uct_tcp_ep_set_failed(ep);
+            return 0;
+        }
+
+        payload             = hdr + 1;
+        ep->rx_large.data   = op->buffer;
+        ep->rx_large.length = hdr->length;
+        break;
+    case UCT_TCP_AM_ID_STRIPED:
+        return uct_tcp_ep_rx_striped_start(ep, hdr, recvd_length);
+    case UCT_TCP_AM_ID_STRIPE:
+        /* Receive the part directly to its offset in the striped message */
+        if (recvd_length < sizeof(*stripe_hdr)) {
+            return 0;
+        }
+
+        stripe_hdr          = (const uct_tcp_stripe_hdr_t*)(hdr + 1);
+        if (!uct_tcp_ep_rx_stripe_is_valid(ep, stripe_hdr,
+                                           hdr->length - sizeof(*stripe_hdr))) {
+            return 0;
+        }
+
+        main_ep             = ep->stripe.main;
+        ep->stripe.seq      = main_ep->stripe.seq;
+        payload             = stripe_hdr + 1;
+        ep->rx_large.data   = UCS_PTR_BYTE_OFFSET(main_ep->stripe.base,
+                                                  stripe_hdr->offset);
+        ep->rx_large.length = hdr->length - sizeof(*stripe_hdr);
+        recvd_length       -= sizeof(*stripe_hdr);
+        break;
+    default:
+        /* Only active messages may be larger than a receive segment, and not
+         * larger than the zero-copy limit of the sender */
+        if (hdr->am_id >= UCT_AM_ID_MAX) {
+            ucs_error("tcp_ep %p: invalid am id %d of a message of %u bytes",
+                      ep, hdr->am_id, hdr->length);
+            uct_tcp_ep_set_failed(ep);
+            return 0;
+        } else if (hdr->length > iface->config.max_zcopy) {
+            ucs_error("tcp_ep %p: message length %u exceeds the maximum of %zu",
+                      ep, hdr->length, iface->config.max_zcopy);
+            uct_tcp_ep_set_failed(ep);
+            return 0;
+        }
+
+        payload             = hdr + 1;
+        ep->rx_large.data   = uct_tcp_ep_rx_desc_alloc(ep, hdr->length);
+        ep->rx_large.length = hdr->length;
+        if (ep->rx_large.data == NULL) {
+            return 0;
+        }
+        break;
+    }
+
+    ep->rx_large.offset = recvd_length;
+    ep->rx_large.am_id  = hdr->am_id;
+    memcpy(ep->rx_large.data, payload, recvd_length);
+
+    ucs_trace_data("tcp_ep %p: receiving %zu bytes to a dedicated buffer", ep,
+                   ep->rx_large.length);
+    return 1;
+}
+
+static unsigned uct_tcp_ep_progress_rx_large(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_rx_large_t *rx = &ep->rx_large;
+    size_t recv_length;
+    void *data;
+
+    recv_length = rx->length - rx->offset;
+    if (!uct_tcp_ep_recv(ep, UCS_PTR_BYTE_OFFSET(rx->data, rx->offset),
+                         &recv_length)) {
+        return 0;
+    }
+
+    rx->offset += recv_length;
+    if (rx->offset < rx->length) {
+        return recv_length > 0;
+    }
+
+    /* Full message was received */
+    data     = rx->data;
+    rx->data = NULL;
+
+    if (rx->am_id == UCT_TCP_AM_ID_PUT) {
+        return 1;
+    } else if (rx->am_id == UCT_TCP_AM_ID_REPLY) {
+        uct_tcp_ep_rma_op_complete(ep);
+        return 1;
+    } else if (rx->am_id == UCT_TCP_AM_ID_STRIPED) {
+        uct_tcp_ep_rx_stripe_done(ep, rx->length);
+        return 1;
+    } else if (rx->am_id == UCT_TCP_AM_ID_STRIPE) {
+        uct_tcp_ep_rx_stripe_done(ep->stripe.main, rx->length);
+        uct_tcp_ep_rx_stripe_resume(ep);
+        return 1;
+    }
+
+    uct_tcp_ep_rx_desc_invoke_am(ep, rx->am_id, data, rx->length);
+    return 1;
+}
+
+static int uct_tcp_ep_rx_seg_prepare(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    size_t headroom        = uct_tcp_iface_rx_seg_headroom(iface);
+    uct_tcp_rx_seg_t *seg  = ep->rx.seg;
+    uct_tcp_am_hdr_t *hdr;
+    size_t remainder, required;
+
+    if (seg == NULL) {
+        seg = ucs_mpool_get(&iface->rx_mpool);
+        if (seg == NULL) {
+            return 0;
+        }
+
+        seg->refcount = 1;
+        ep->rx.seg    = seg;
+        ep->rx.offset = ep->rx.length = headroom;
+        ep->rx.held   = 0;
+        return 1;
+    }
+
+    remainder = ep->rx.length - ep->rx.offset;
+    if ((remainder == 0) && (seg->refcount == 1)) {
+        /* Nothing is kept by the user, reuse the segment from the start */
+        ep->rx.offset = ep->rx.length = headroom;
+        ep->rx.held   = 0;
+        return 1;
+    }
+
+    /* Space which is needed to receive the whole next message, messages
+     * larger than a segment are received to a dedicated buffer */
+    if (remainder >= sizeof(*hdr)) {
+        hdr      = UCS_PTR_BYTE_OFFSET(seg + 1, ep->rx.offset);
+        required = ucs_min(sizeof(*hdr) + hdr->length,
+                           iface->config.rx_seg_size - headroom);
+    } else {
+        required = iface->config.buf_size;
+    }
+
+    if ((iface->config.rx_seg_size - ep->rx.offset) >= required) {
+        return 1;
+    }
+
+    /* Copy the partially received message to the start of a segment. It
+     * happens once per segment, rather than after every receive. */
+    if (seg->refcount == 1) {
+        memmove(UCS_PTR_BYTE_OFFSET(seg + 1, headroom),
+                UCS_PTR_BYTE_OFFSET(seg + 1, ep->rx.offset), remainder);
+    } else {
+        seg = ucs_mpool_get(&iface->rx_mpool);
+        if (seg == NULL) {
+            return 0;
+        }
+
+        seg->refcount = 1;
+        memcpy(UCS_PTR_BYTE_OFFSET(seg + 1, headroom),
+               UCS_PTR_BYTE_OFFSET(ep->rx.seg + 1, ep->rx.offset), remainder);
+        uct_tcp_rx_seg_put(ep->rx.seg);
+        ep->rx.seg = seg;
+    }
+
+    ep->rx.offset = headroom;
+    ep->rx.length = headroom + remainder;
+    ep->rx.held   = 0;
+    return 1;
+}
+
+static void uct_tcp_ep_rx_seg_invoke_am(uct_tcp_ep_t *ep, uint8_t am_id,
+                                        void *payload, unsigned length)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_rx_seg_t *seg  = ep->rx.seg;
+    size_t offset          = (uintptr_t)payload - (uintptr_t)(seg + 1);
+    unsigned flags;
+    ucs_status_t status;
+
+    /* The user may write to the headroom in front of the payload, so the
+     * message can be kept only if the headroom does not overlap a message
+     * which is already kept by the user */
+    if ((offset - uct_tcp_iface_rx_seg_headroom(iface)) >= ep->rx.held) {
+        flags = UCT_CB_PARAM_FLAG_DESC;
+    } else {
+        flags = 0;
+    }
+
+    status = uct_iface_invoke_am(&iface->super, am_id, payload, length, flags);
+    if (status == UCS_INPROGRESS) {
+        /* save the release_desc for later release of this desc */
+        uct_recv_desc(payload - iface->rx_headroom) = &seg->release_desc;
+        ++seg->refcount;
+        ep->rx.held = offset + length;
+    }
+}
+
+static int uct_tcp_ep_rx_needs_reply(const uct_tcp_am_hdr_t *hdr)
+{
+    switch (hdr->am_id) {
+    case UCT_TCP_AM_ID_GET:
+    case UCT_TCP_AM_ID_FLUSH:
+        return 1;
+    case UCT_TCP_AM_ID_ATOMIC:
+        return ((const uct_tcp_atomic_hdr_t*)(hdr + 1))->fetch;
+    default:
+        return 0;
+    }
+}
+
+static void uct_tcp_ep_tx_reply(uct_tcp_ep_t *ep, const void *data,
+                                size_t length, int zcopy)
+{
+    uct_tcp_am_hdr_t *hdr;
+
+    ucs_assert(uct_tcp_ep_can_send(ep));
+
+    hdr         = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.buf_length);
+    hdr->am_id  = UCT_TCP_AM_ID_REPLY;
+    hdr->length = length;
+
+    if (zcopy) {
+        /* GET data is sent directly from the target memory */
+        ep->tx.buf_length += sizeof(*hdr);
+        uct_tcp_ep_tx_add_iov(ep, hdr, sizeof(*hdr));
+        uct_tcp_ep_tx_add_iov(ep, (void*)data, length);
+    } else {
+        memcpy(hdr + 1, data, length);
+        ep->tx.buf_length += sizeof(*hdr) + length;
+        uct_tcp_ep_tx_add_iov(ep, hdr, sizeof(*hdr) + length);
+    }
+
+    uct_tcp_ep_tx_start(ep);
+}
+
+static int uct_tcp_ep_rx_atomic(uct_tcp_ep_t *ep,
+                                const uct_tcp_atomic_hdr_t *atomic_hdr,
+                                uint64_t *result)
+{
+    volatile uint64_t *ptr = (uint64_t*)(uintptr_t)atomic_hdr->address;
+    uint64_t value         = atomic_hdr->value;
+    uint64_t prev, new_value;
+
+    if (!uct_tcp_ep_rx_check_access(ep, "ATOMIC", atomic_hdr->rkey,
+                                    atomic_hdr->address, sizeof(*ptr))) {
+        return 0;
+    }
+
+    if (atomic_hdr->address % sizeof(*ptr)) {
+        ucs_error("tcp_ep %p: unaligned atomic address 0x%"PRIx64, ep,
+                  atomic_hdr->address);
+        uct_tcp_ep_set_failed(ep);
+        return 0;
+    }
+
+    /* All operations are done with a compare-and-swap loop, since the target
+     * may be accessed concurrently by local atomics or other endpoints */
+    do {
+        prev = *ptr;
+        switch (atomic_hdr->opcode) {
+        case UCT_ATOMIC_OP_ADD:
+            new_value = prev + value;
+            break;
+        case UCT_ATOMIC_OP_AND:
+            new_value = prev & value;
+            break;
+        case UCT_ATOMIC_OP_OR:
+            new_value = prev | value;
+            break;
+        case UCT_ATOMIC_OP_XOR:
+            new_value = prev ^ value;
+            break;
+        case UCT_ATOMIC_OP_SWAP:
+            new_value = value;
+            break;
+        case UCT_ATOMIC_OP_CSWAP:
+            if (prev != atomic_hdr->compare) {
+                *result = prev;
+                return 1;
+            }
+            new_value = value;
+            break;
+        default:
+            ucs_error("tcp_ep %p: invalid atomic opcode: %d", ep,
+                      atomic_hdr->opcode);
+            uct_tcp_ep_set_failed(ep);
+            return 0;
+        }
+    } while (ucs_atomic_cswap64(ptr, prev, new_value) != prev);
+
+    *result = prev;
+    return 1;
+}
+
+/* Checks the length of a message with a transport id, which was fully
+ * received to a segment */
+static int uct_tcp_ep_rx_ctrl_is_valid(const uct_tcp_am_hdr_t *hdr)
+{
+    switch (hdr->am_id) {
+    case UCT_TCP_AM_ID_PUT:
+        return hdr->length >= sizeof(uct_tcp_put_hdr_t);
+    case UCT_TCP_AM_ID_GET:
+        return hdr->length == sizeof(uct_tcp_get_hdr_t);
+    case UCT_TCP_AM_ID_ATOMIC:
+        return hdr->length == sizeof(uct_tcp_atomic_hdr_t);
+    case UCT_TCP_AM_ID_FLUSH:
+        return hdr->length == 0;
+    case UCT_TCP_AM_ID_REPLY:
+        /* Checked against the operation which waits for it */
+        return 1;
+    case UCT_TCP_AM_ID_CONN:
+        return hdr->length == sizeof(uct_tcp_conn_hdr_t);
+    case UCT_TCP_AM_ID_STRIPED:
+        return hdr->length >= sizeof(uct_tcp_striped_hdr_t);
+    case UCT_TCP_AM_ID_STRIPE:
+        return hdr->length >= sizeof(uct_tcp_stripe_hdr_t);
+    default:
+        return 0;
+    }
+}
+
+static void uct_tcp_ep_rx_ctrl(uct_tcp_ep_t *ep, const uct_tcp_am_hdr_t *hdr)
+{
+    const uct_tcp_put_hdr_t *put_hdr;
+    const uct_tcp_get_hdr_t *get_hdr;
+    uct_tcp_ep_rma_op_t *op;
+    uint64_t result;
+
+    switch (hdr->am_id) {
+    case UCT_TCP_AM_ID_PUT:
+        put_hdr = (const uct_tcp_put_hdr_t*)(hdr + 1);
+        if (uct_tcp_ep_rx_check_access(ep, "PUT", put_hdr->rkey,
+                                       put_hdr->address,
+                                       hdr->length - sizeof(*put_hdr))) {
+            memcpy((void*)(uintptr_t)put_hdr->address, put_hdr + 1,
+                   hdr->length - sizeof(*put_hdr));
+        }
+        break;
+    case UCT_TCP_AM_ID_GET:
+        get_hdr = (const uct_tcp_get_hdr_t*)(hdr + 1);
+        if (uct_tcp_ep_rx_check_access(ep, "GET", get_hdr->rkey,
+                                       get_hdr->address, get_hdr->length)) {
+            uct_tcp_ep_tx_reply(ep, (void*)(uintptr_t)get_hdr->address,
+                                get_hdr->length, 1);
+        }
+        break;
+    case UCT_TCP_AM_ID_ATOMIC:
+        if (uct_tcp_ep_rx_atomic(ep, (const uct_tcp_atomic_hdr_t*)(hdr + 1),
+                                 &result) &&
+            ((const uct_tcp_atomic_hdr_t*)(hdr + 1))->fetch) {
+            uct_tcp_ep_tx_reply(ep, &result, sizeof(result), 0);
+        }
+        break;
+    case UCT_TCP_AM_ID_FLUSH:
+        /* Previous operations were already executed */
+        uct_tcp_ep_tx_reply(ep, NULL, 0, 0);
+        break;
+    case UCT_TCP_AM_ID_REPLY:
+        op = uct_tcp_ep_rx_reply_op(ep, hdr->length);
+        if (op == NULL) {
+            break;
+        }
+
+        if (op->unpack_cb != NULL) {
+            op->unpack_cb(op->buffer, hdr + 1, hdr->length);
+        } else {
+            memcpy(op->buffer, hdr + 1, hdr->length);
+        }
+        uct_tcp_ep_rma_op_complete(ep);
+        break;
+    case UCT_TCP_AM_ID_CONN:
+        uct_tcp_ep_rx_conn(ep, (const uct_tcp_conn_hdr_t*)(hdr + 1));
+        break;
+    case UCT_TCP_AM_ID_STRIPED:
+        uct_tcp_ep_rx_striped_start(ep, hdr, hdr->length);
+        break;
+    case UCT_TCP_AM_ID_STRIPE:
+        uct_tcp_ep_rx_stripe(ep, (const uct_tcp_stripe_hdr_t*)(hdr + 1),
+                             hdr->length - sizeof(uct_tcp_stripe_hdr_t));
+        break;
+    default:
+        ucs_error("tcp_ep %p: invalid am id: %d", ep, hdr->am_id);
+        uct_tcp_ep_set_failed(ep);
+        break;
+    }
+}
+
+static unsigned uct_tcp_ep_rx_parse(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    size_t max_length      = iface->config.rx_seg_size -
+                             uct_tcp_iface_rx_seg_headroom(iface);
+    void *data             = ep->rx.seg + 1;
+    unsigned count         = 0;
+    uct_tcp_am_hdr_t *hdr;
+    ssize_t remainder;
+
+    /* Following messages are parsed after a striped message is completed */
+    ep->flags &= ~UCT_TCP_EP_FLAG_RX_RESUME;
+    while (!(ep->flags & (UCT_TCP_EP_FLAG_RX_STRIPED |
+                          UCT_TCP_EP_FLAG_FAILED)) &&
+           ((remainder = ep->rx.length - ep->rx.offset) >= sizeof(*hdr))) {
+        hdr = UCS_PTR_BYTE_OFFSET(data, ep->rx.offset);
+
+        if ((hdr->am_id == UCT_TCP_AM_ID_STRIPE) &&
+            !uct_tcp_ep_rx_stripe_ready(ep)) {
+            ucs_trace_data("tcp_ep %p: receive waits for striped message", ep);
+            ep->flags |= UCT_TCP_EP_FLAG_RX_WAIT;
+            uct_tcp_ep_mod_events(ep, 0, EPOLLIN);
+            break;
+        }
+
+        if (remainder < sizeof(*hdr) + hdr->length) {
+            if (((sizeof(*hdr) + hdr->length) > max_length) &&
+                uct_tcp_ep_rx_large_start(ep, hdr, remainder - sizeof(*hdr))) {
+                /* The message does not fit a segment, so the rest of it is
+                 * received directly to its destination buffer */
+                ep->rx.offset += remainder;
+            }
+            break;
+        }
+
+        if (hdr->am_id < UCT_AM_ID_MAX) {
+            /* Full message was received */
+            ep->rx.offset += sizeof(*hdr) + hdr->length;
+            uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_RECV,
+                               hdr->am_id, hdr + 1, hdr->length, "RECV fd %d",
+                               ep->fd);
+            uct_tcp_ep_rx_seg_invoke_am(ep, hdr->am_id, hdr + 1, hdr->length);
+        } else {
+            if (!uct_tcp_ep_rx_ctrl_is_valid(hdr)) {
+                ucs_error("tcp_ep %p: invalid message id %d of %u bytes", ep,
+                          hdr->am_id, hdr->length);
+                uct_tcp_ep_set_failed(ep);
+                break;
+            }
+
+            /* Stop receiving until the reply can be sent, to avoid
+             * buffering an unlimited amount of replies */
+            if (uct_tcp_ep_rx_needs_reply(hdr) && !uct_tcp_ep_can_send(ep)) {
+                ucs_trace_data("tcp_ep %p: receive blocked on reply", ep);
+                ep->flags |= UCT_TCP_EP_FLAG_RX_BLOCKED;
+                uct_tcp_ep_mod_events(ep, 0, EPOLLIN);
+                break;
+            }
+
+            ep->rx.offset += sizeof(*hdr) + hdr->length;
+            uct_tcp_ep_rx_ctrl(ep, hdr);
+        }
+        ++count;
+    }
+
+    return count;
+}
+
+unsigned uct_tcp_ep_progress_rx(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    size_t recv_length;
+
+    ucs_trace_func("ep=%p", ep);
+
+    if (ucs_unlikely(ep->flags & UCT_TCP_EP_FLAG_FAILED)) {
+        return 0;
+    }
+
+    if ((ep->flags & UCT_TCP_EP_FLAG_STRIPE) && (ep->stripe.id == 0)) {
+        ucs_debug("tcp_ep %p: main socket was closed", ep);
+        uct_tcp_ep_mod_events(ep, 0, EPOLLIN);
+        uct_tcp_ep_destroy(&ep->super.super);
+        return 0;
+    }
+
+    if (ep->rx_large.data != NULL) {
+        return uct_tcp_ep_progress_rx_large(ep);
+    }
+
+    /* Receive is resumed when a reply can be sent, or when all parts of the
+     * striped message arrive */
+    if (ep->flags & (UCT_TCP_EP_FLAG_RX_BLOCKED | UCT_TCP_EP_FLAG_RX_STRIPED |
+                     UCT_TCP_EP_FLAG_RX_WAIT)) {
+        uct_tcp_ep_mod_events(ep, 0, EPOLLIN);
+        return 0;
+    }
+
+    if (!uct_tcp_ep_rx_seg_prepare(ep)) {
+        return 0;
+    }
+
+    /* Receive next chunk of data, at most buf_size bytes per call to bound
+     * the amount of messages delivered by a single progress */
+    recv_length = ucs_min(iface->config.rx_seg_size - ep->rx.length,
+                          iface->config.buf_size);
+    ucs_assertv(recv_length > 0, "ep=%p", ep);
+
+    if (!uct_tcp_ep_recv(ep, UCS_PTR_BYTE_OFFSET(ep->rx.seg + 1, ep->rx.length),
+                         &recv_length)) {
+        return 0;
+    }
+
+    ep->rx.length += recv_length;
+
+    /* Parse received messages */
+    uct_tcp_ep_rx_parse(ep);
+    uct_tcp_ep_rx_stripe_resume(ep);
+    return recv_length > 0;
+}
+
+static void *uct_tcp_ep_tx_ctrl_start(uct_tcp_ep_t *ep, uint8_t am_id,
+                                     size_t length)
+{
+    uct_tcp_am_hdr_t *hdr = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.buf_length);
+
+    hdr->am_id  = am_id;
+    hdr->length = length;
+    return hdr + 1;
+}
+
+static void uct_tcp_ep_tx_ctrl_push(uct_tcp_ep_t *ep, size_t packed_length)
+{
+    void *hdr = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.buf_length);
+
+    /* Queue the header and the part of the message which was packed to the
+     * send buffer by uct_tcp_ep_tx_ctrl_start() */
+    ep->tx.buf_length += sizeof(uct_tcp_am_hdr_t) + packed_length;
+    uct_tcp_ep_tx_add_iov(ep, hdr, sizeof(uct_tcp_am_hdr_t) + packed_length);
+}
+
+static void uct_tcp_ep_tx_conn(uct_tcp_ep_t *ep)
+{
+    uct_tcp_conn_hdr_t *conn_hdr;
+
+    conn_hdr        = uct_tcp_ep_tx_ctrl_start(ep, UCT_TCP_AM_ID_CONN,
+                                               sizeof(*conn_hdr));
+    conn_hdr->id    = ep->stripe.id;
+    conn_hdr->index = ep->stripe.index;
+    conn_hdr->count = ep->stripe.count;
+    uct_tcp_ep_tx_ctrl_push(ep, sizeof(*conn_hdr));
+    uct_tcp_ep_tx_start(ep);
+}
+
+static void uct_tcp_ep_tx_add_iov_range(uct_tcp_ep_t *ep, const uct_iov_t *iov,
+                                        size_t iovcnt, size_t offset,
+                                        size_t length)
+{
+    size_t iov_it, iov_length, chunk;
+
+    for (iov_it = 0; (iov_it < iovcnt) && (length > 0); ++iov_it) {
+        iov_length = uct_iov_get_length(&iov[iov_it]);
+        if (offset >= iov_length) {
+            offset -= iov_length;
+            continue;
+        }
+
+        chunk = ucs_min(iov_length - offset, length);
+        uct_tcp_ep_tx_add_iov(ep, UCS_PTR_BYTE_OFFSET(iov[iov_it].buffer,
+                                                      offset), chunk);
+        offset  = 0;
+        length -= chunk;
+    }
+}
+
+static int uct_tcp_ep_tx_can_stripe(uct_tcp_ep_t *ep, unsigned header_length,
+                                    size_t length)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    unsigned i;
+
+    if ((ep->stripe.count == 1) || (length < iface->config.stripe_thresh) ||
+        ((sizeof(uct_tcp_am_hdr_t) + sizeof(uct_tcp_striped_hdr_t) +
+          header_length) > iface->config.buf_size)) {
+        return 0;
+    }
+
+    /* All sockets must have room for their part */
+    for (i = 0; i < ep->stripe.count - 1; ++i) {
+        if ((ep->stripe.socks[i] == NULL) ||
+            !uct_tcp_ep_can_send(ep->stripe.socks[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static void uct_tcp_ep_stripe_comp_cb(uct_completion_t *self,
+                                      ucs_status_t status)
+{
+    uct_tcp_ep_stripe_comp_t *stripe_comp =
+                    ucs_container_of(self, uct_tcp_ep_stripe_comp_t, super);
+
+    uct_invoke_completion(stripe_comp->comp, status);
+    ucs_mpool_put(stripe_comp);
+}
+
+/* Send the payload of a zero-copy operation in parallel on all sockets of the
+ * endpoint. The receiver copies each part to its offset in the destination,
+ * and processes the message once all the parts arrived. */
+static ucs_status_t
+uct_tcp_ep_tx_striped(uct_tcp_ep_t *ep, uint8_t am_id, const void *header,
+                      unsigned header_length, const uct_iov_t *iov,
+                      size_t iovcnt, size_t length, uct_completion_t *comp)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    size_t part_length     = length / ep->stripe.count;
+    uct_tcp_ep_stripe_comp_t *stripe_comp = NULL;
+    uct_tcp_striped_hdr_t *striped_hdr;
+    uct_tcp_stripe_hdr_t *stripe_hdr;
+    uct_tcp_ep_t *sock_ep;
+    unsigned i, pending;
+    size_t offset;
+
+    if (comp != NULL) {
+        stripe_comp = ucs_mpool_get(&iface->stripe_comp_mp);
+        if (stripe_comp == NULL) {
+            return UCS_ERR_NO_MEMORY;
+        }
+    }
+
+    /* The main socket sends the header and the first part, which also gets
+     * the remainder of the division */
+    offset                  = length - (part_length * (ep->stripe.count - 1));
+    striped_hdr             = uct_tcp_ep_tx_ctrl_start(ep, UCT_TCP_AM_ID_STRIPED,
+                                                       sizeof(*striped_hdr) +
+                                                       header_length + offset);
+    striped_hdr->am_id      = am_id;
+    striped_hdr->hdr_length = header_length;
+    striped_hdr->length     = header_length + length;
+    memcpy(striped_hdr + 1, header, header_length);
+    uct_tcp_ep_tx_ctrl_push(ep, sizeof(*striped_hdr) + header_length);
+    uct_tcp_ep_tx_add_iov_range(ep, iov, iovcnt, 0, offset);
+
+    for (i = 0; i < ep->stripe.count - 1; ++i) {
+        sock_ep            = ep->stripe.socks[i];
+        stripe_hdr         = uct_tcp_ep_tx_ctrl_start(sock_ep,
+                                                      UCT_TCP_AM_ID_STRIPE,
+                                                      sizeof(*stripe_hdr) +
+                                                      part_length);
+        stripe_hdr->offset = offset;
+        uct_tcp_ep_tx_ctrl_push(sock_ep, sizeof(*stripe_hdr));
+        uct_tcp_ep_tx_add_iov_range(sock_ep, iov, iovcnt, offset, part_length);
+        uct_tcp_ep_tx_start(sock_ep);
+        offset += part_length;
+    }
+
+    /* The parts arrive on different sockets, so remote completion requires a
+     * flush request, which is processed after the whole message */
+    ep->flags       |= UCT_TCP_EP_FLAG_UNFLUSHED;
+    ep->rma.flush_op = NULL;
+    uct_tcp_ep_tx_start(ep);
+
+    pending = (ep->tx.length > 0);
+    for (i = 0; i < ep->stripe.count - 1; ++i) {
+        pending += (ep->stripe.socks[i]->tx.length > 0);
+    }
+
+    if (pending == 0) {
+        if (stripe_comp != NULL) {
+            ucs_mpool_put(stripe_comp);
+        }
+        return UCS_OK;
+    }
+
+    if (stripe_comp == NULL) {
+        return UCS_INPROGRESS;
+    }
+
+    /* The user completion is called when all sockets sent their parts */
+    stripe_comp->super.func  = uct_tcp_ep_stripe_comp_cb;
+    stripe_comp->super.count = pending;
+    stripe_comp->comp        = comp;
+    if (ep->tx.length > 0) {
+        uct_tcp_ep_tx_add_comp(ep, &stripe_comp->super);
+    }
+    for (i = 0; i < ep->stripe.count - 1; ++i) {
+        sock_ep = ep->stripe.socks[i];
+        if (sock_ep->tx.length > 0) {
+            uct_tcp_ep_tx_add_comp(sock_ep, &stripe_comp->super);
+        }
+    }
+
+    return UCS_INPROGRESS;
+}
+
+ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
+                            uct_pack_callback_t pack_cb, void *arg,
+                            unsigned flags)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    uct_tcp_am_hdr_t *hdr;
+    size_t packed_length;
+
+    if (!uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    /* Pack the message after the previously queued ones */
+    hdr         = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.buf_length);
+    hdr->am_id  = am_id;
+    hdr->length = packed_length = pack_cb(hdr + 1, arg);
+
+    UCT_CHECK_LENGTH(hdr->length, 0,
+                     iface->config.buf_size - sizeof(uct_tcp_am_hdr_t),
+                     "am_bcopy");
+    UCT_TL_EP_STAT_OP(&ep->super, AM, BCOPY, hdr->length);
+    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, hdr->am_id,
+                       hdr + 1, hdr->length, "SEND fd %d", ep->fd);
+
+    ep->tx.buf_length += sizeof(*hdr) + packed_length;
+    uct_tcp_ep_tx_add_iov(ep, hdr, sizeof(*hdr) + packed_length);
+
+    uct_tcp_ep_tx_start(ep);
+    return packed_length;
+}
+
+ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id,
+                                 const void *header, unsigned header_length,
+                                 const uct_iov_t *iov, size_t iovcnt,
+                                 unsigned flags, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    size_t length    = uct_iov_total_length(iov, iovcnt);
+    uct_tcp_am_hdr_t *hdr;
+    ucs_status_t status;
+    size_t iov_length;
+    size_t iov_it;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_TCP_EP_MAX_IOV - 1,
+                       "uct_tcp_ep_am_zcopy");
+    UCT_CHECK_LENGTH(header_length, 0,
+                     iface->config.buf_size - sizeof(uct_tcp_am_hdr_t),
+                     "am_zcopy header");
+    UCT_CHECK_LENGTH(header_length + length, 0, iface->config.max_zcopy,
+                     "am_zcopy");
+
+    if (!uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if (uct_tcp_ep_tx_can_stripe(ep, header_length, length)) {
+        status = uct_tcp_ep_tx_striped(ep, am_id, header, header_length, iov,
+                                       iovcnt, length, comp);
+        UCT_TL_EP_STAT_OP_IF_SUCCESS(status, &ep->super, AM, ZCOPY,
+                                     header_length + length);
+        uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, am_id,
+                           header, header_length, "SEND STRIPED fd %d",
+                           ep->fd);
+        return status;
+    }
+
+    /* TCP header and user header are sent from the send queue buffer, the
+     * payload is sent directly from the user buffers */
+    hdr         = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.buf_length);
+    hdr->am_id  = am_id;
+    hdr->length = header_length;
+    memcpy(hdr + 1, header, header_length);
+
+    ep->tx.buf_length += sizeof(*hdr) + header_length;
+    uct_tcp_ep_tx_add_iov(ep, hdr, sizeof(*hdr) + header_length);
+
+    for (iov_it = 0; iov_it < iovcnt; ++iov_it) {
+        iov_length = uct_iov_get_length(&iov[iov_it]);
+        uct_tcp_ep_tx_add_iov(ep, iov[iov_it].buffer, iov_length);
+        hdr->length += iov_length;
+    }
+
+    UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY, hdr->length);
+    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, am_id,
+                       header, header_length, "SEND fd %d", ep->fd);
+
+    /* The completion is called once the queue is sent up to the end of this
+     * message */
+    uct_tcp_ep_tx_start(ep);
+    if (ep->tx.length == 0) {
+        return UCS_OK;
+    }
+
+    if (comp != NULL) {
+        uct_tcp_ep_tx_add_comp(ep, comp);
+    }
+    return UCS_INPROGRESS;
+}
+
+static uct_tcp_ep_rma_op_t *
+uct_tcp_ep_rma_op_add(uct_tcp_ep_t *ep, void *buffer, size_t length,
+                      uct_unpack_callback_t unpack_cb, uct_completion_t *comp)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_rma_op_t *op;
+
+    op = ucs_mpool_get(&iface->rma_op_mp);
+    if (op == NULL) {
+        return NULL;
+    }
+
+    op->buffer    = buffer;
+    op->length    = length;
+    op->unpack_cb = unpack_cb;
+    op->comp      = comp;
+    ucs_queue_push(&ep->rma.ops, &op->queue);
+    ep->rma.flush_op = NULL;
+
+    /* The reply arrives on the same socket */
+    uct_tcp_ep_mod_events(ep, EPOLLIN, 0);
+    return op;
+}
+
+static void uct_tcp_ep_put_start(uct_tcp_ep_t *ep, uint64_t remote_addr,
+                                 uct_rkey_t rkey, size_t length)
+{
+    uct_tcp_put_hdr_t *put_hdr;
+
+    put_hdr          = uct_tcp_ep_tx_ctrl_start(ep, UCT_TCP_AM_ID_PUT,
+                                                sizeof(*put_hdr) + length);
+    put_hdr->address = remote_addr;
+    put_hdr->rkey    = rkey;
+    ep->flags       |= UCT_TCP_EP_FLAG_UNFLUSHED;
+    ep->rma.flush_op = NULL;
+}
+
+ucs_status_t uct_tcp_ep_put_short(uct_ep_h tl_ep, const void *buffer,
+                                  unsigned length, uint64_t remote_addr,
+                                  uct_rkey_t rkey)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+    uct_tcp_put_hdr_t *put_hdr;
+
+    UCT_CHECK_LENGTH(length, 0, iface->config.buf_size -
+                     sizeof(uct_tcp_am_hdr_t) - sizeof(uct_tcp_put_hdr_t),
+                     "put_short");
+
+    if (!uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    put_hdr = UCS_PTR_BYTE_OFFSET(ep->tx.buf,
+                                  ep->tx.buf_length + sizeof(uct_tcp_am_hdr_t));
+    uct_tcp_ep_put_start(ep, remote_addr, rkey, length);
+    memcpy(put_hdr + 1, buffer, length);
+    uct_tcp_ep_tx_ctrl_push(ep, sizeof(*put_hdr) + length);
+
+    UCT_TL_EP_STAT_OP(&ep->super, PUT, SHORT, length);
+    ucs_trace_data("tcp_ep %p: PUT_SHORT [buffer %p length %u remote_addr %"PRIx64"]",
+                   ep, buffer, length, remote_addr);
+    uct_tcp_ep_tx_start(ep);
+    return UCS_OK;
+}
+
+ssize_t uct_tcp_ep_put_bcopy(uct_ep_h tl_ep, uct_pack_callback_t pack_cb,
+                             void *arg, uint64_t remote_addr, uct_rkey_t rkey)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+    uct_tcp_am_hdr_t *hdr;
+    uct_tcp_put_hdr_t *put_hdr;
+    size_t length;
+
+    if (!uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    hdr     = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.buf_length);
+    put_hdr = (uct_tcp_put_hdr_t*)(hdr + 1);
+    length  = pack_cb(put_hdr + 1, arg);
+    UCT_CHECK_LENGTH(length, 0, iface->config.buf_size - sizeof(*hdr) -
+                     sizeof(*put_hdr), "put_bcopy");
+
+    uct_tcp_ep_put_start(ep, remote_addr, rkey, length);
+    uct_tcp_ep_tx_ctrl_push(ep, sizeof(*put_hdr) + length);
+
+    UCT_TL_EP_STAT_OP(&ep->super, PUT, BCOPY, length);
+    ucs_trace_data("tcp_ep %p: PUT_BCOPY [length %zu remote_addr %"PRIx64"]",
+                   ep, length, remote_addr);
+    uct_tcp_ep_tx_start(ep);
+    return length;
+}
+
+ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+    size_t length    = uct_iov_total_length(iov, iovcnt);
+    uct_tcp_put_hdr_t put_hdr;
+    ucs_status_t status;
+    size_t iov_it;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_TCP_EP_MAX_IOV - 1,
+                       "uct_tcp_ep_put_zcopy");
+    UCT_CHECK_LENGTH(length, 0, iface->config.max_zcopy, "put_zcopy");
+
+    if (!uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if (uct_tcp_ep_tx_can_stripe(ep, sizeof(put_hdr), length)) {
+        put_hdr.address = remote_addr;
+        put_hdr.rkey    = rkey;
+        status = uct_tcp_ep_tx_striped(ep, UCT_TCP_AM_ID_PUT, &put_hdr,
+                                       sizeof(put_hdr), iov, iovcnt, length,
+                                       comp);
+        UCT_TL_EP_STAT_OP_IF_SUCCESS(status, &ep->super, PUT, ZCOPY, length);
+        ucs_trace_data("tcp_ep %p: PUT_ZCOPY STRIPED [length %zu remote_addr %"
+                       PRIx64"]", ep, length, remote_addr);
+        return status;
+    }
+
+    /* Only the headers are copied, the data is sent from the user buffers */
+    uct_tcp_ep_put_start(ep, remote_addr, rkey, length);
+    uct_tcp_ep_tx_ctrl_push(ep, sizeof(uct_tcp_put_hdr_t));
+    for (iov_it = 0; iov_it < iovcnt; ++iov_it) {
+        uct_tcp_ep_tx_add_iov(ep, iov[iov_it].buffer,
+                              uct_iov_get_length(&iov[iov_it]));
+    }
+
+    UCT_TL_EP_STAT_OP(&ep->super, PUT, ZCOPY, length);
+    ucs_trace_data("tcp_ep %p: PUT_ZCOPY [length %zu remote_addr %"PRIx64"]",
+                   ep, length, remote_addr);
+    uct_tcp_ep_tx_start(ep);
+    if (ep->tx.length == 0) {
+        return UCS_OK;
+    }
+
+    if (comp != NULL) {
+        uct_tcp_ep_tx_add_comp(ep, comp);
+    }
+    return UCS_INPROGRESS;
+}
+
+static ucs_status_t uct_tcp_ep_get(uct_tcp_ep_t *ep, void *buffer,
+                                   uct_unpack_callback_t unpack_cb,
+                                   size_t length, uint64_t remote_addr,
+                                   uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_get_hdr_t *get_hdr;
+
+    if (!uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if (uct_tcp_ep_rma_op_add(ep, buffer, length, unpack_cb, comp) == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    get_hdr          = uct_tcp_ep_tx_ctrl_start(ep, UCT_TCP_AM_ID_GET,
+                                                sizeof(*get_hdr));
+    get_hdr->address = remote_addr;
+    get_hdr->rkey    = rkey;
+    get_hdr->length  = length;
+    uct_tcp_ep_tx_ctrl_push(ep, sizeof(*get_hdr));
+
+    ucs_trace_data("tcp_ep %p: GET [length %zu remote_addr %"PRIx64"]",
+                   ep, length, remote_addr);
+    uct_tcp_ep_tx_start(ep);
+    return UCS_INPROGRESS;
+}
+
+ucs_status_t uct_tcp_ep_get_bcopy(uct_ep_h tl_ep, uct_unpack_callback_t unpack_cb,
+                                  void *arg, size_t length, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+    ucs_status_t status;
+
+    UCT_CHECK_LENGTH(length, 0, iface->config.buf_size -
+                     sizeof(uct_tcp_am_hdr_t), "get_bcopy");
+
+    status = uct_tcp_ep_get(ep, arg, unpack_cb, length, remote_addr, rkey,
+                            comp);
+    if (status == UCS_INPROGRESS) {
+        UCT_TL_EP_STAT_OP(&ep->super, GET, BCOPY, length);
+    }
+    return status;
+}
+
+ucs_status_t uct_tcp_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+    size_t length    = uct_iov_total_length(iov, iovcnt);
+    ucs_status_t status;
+
+    /* The reply is received to a single buffer */
+    UCT_CHECK_IOV_SIZE(iovcnt, 1ul, "uct_tcp_ep_get_zcopy");
+    UCT_CHECK_LENGTH(length, 0, iface->config.max_zcopy, "get_zcopy");
+
+    status = uct_tcp_ep_get(ep, (iovcnt > 0) ? iov[0].buffer : NULL, NULL,
+                            length, remote_addr, rkey, comp);
+    if (status == UCS_INPROGRESS) {
+        UCT_TL_EP_STAT_OP(&ep->super, GET, ZCOPY, length);
+    }
+    return status;
+}
+
+static ucs_status_t uct_tcp_ep_atomic64(uct_tcp_ep_t *ep, unsigned opcode,
+                                        uint64_t value, uint64_t compare,
+                                        uint64_t remote_addr, uct_rkey_t rkey,
+                                        uint64_t *result,
+                                        uct_completion_t *comp)
+{
+    uct_tcp_atomic_hdr_t *atomic_hdr;
+
+    if (!uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if (result != NULL) {
+        if (uct_tcp_ep_rma_op_add(ep, result, sizeof(*result), NULL,
+                                  comp) == NULL) {
+            return UCS_ERR_NO_MEMORY;
+        }
+    } else {
+        ep->flags       |= UCT_TCP_EP_FLAG_UNFLUSHED;
+        ep->rma.flush_op = NULL;
+    }
+
+    atomic_hdr          = uct_tcp_ep_tx_ctrl_start(ep, UCT_TCP_AM_ID_ATOMIC,
+                                                   sizeof(*atomic_hdr));
+    atomic_hdr->address = remote_addr;
+    atomic_hdr->rkey    = rkey;
+    atomic_hdr->value   = value;
+    atomic_hdr->compare = compare;
+    atomic_hdr->opcode  = opcode;
+    atomic_hdr->fetch   = (result != NULL);
+    uct_tcp_ep_tx_ctrl_push(ep, sizeof(*atomic_hdr));
+
+    UCT_TL_EP_STAT_ATOMIC(&ep->super);
+    ucs_trace_data("tcp_ep %p: ATOMIC64 [opcode %u value %"PRIu64
+                   " remote_addr %"PRIx64"]", ep, opcode, value, remote_addr);
+    uct_tcp_ep_tx_start(ep);
+    return (result != NULL) ? UCS_INPROGRESS : UCS_OK;
+}
+
+ucs_status_t uct_tcp_ep_atomic64_post(uct_ep_h tl_ep, unsigned opcode,
+                                      uint64_t value, uint64_t remote_addr,
+                                      uct_rkey_t rkey)
+{
+    return uct_tcp_ep_atomic64(ucs_derived_of(tl_ep, uct_tcp_ep_t), opcode,
+                               value, 0, remote_addr, rkey, NULL, NULL);
+}
+
+ucs_status_t uct_tcp_ep_atomic64_fetch(uct_ep_h tl_ep, uct_atomic_op_t opcode,
+                                       uint64_t value, uint64_t *result,
+                                       uint64_t remote_addr, uct_rkey_t rkey,
+                                       uct_completion_t *comp)
+{
+    return uct_tcp_ep_atomic64(ucs_derived_of(tl_ep, uct_tcp_ep_t), opcode,
+                               value, 0, remote_addr, rkey, result, comp);
+}
+
+ucs_status_t uct_tcp_ep_atomic_cswap64(uct_ep_h tl_ep, uint64_t compare,
+                                       uint64_t swap, uint64_t remote_addr,
+                                       uct_rkey_t rkey, uint64_t *result,
+                                       uct_completion_t *comp)
+{
+    return uct_tcp_ep_atomic64(ucs_derived_of(tl_ep, uct_tcp_ep_t),
+                               UCT_ATOMIC_OP_CSWAP, swap, compare, remote_addr,
+                               rkey, result, comp);
+}
+
+ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
+                                    unsigned flags)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+
+    if (uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_BUSY;
+    }
+
+    uct_pending_req_queue_push(&ep->pending_q, req);
+    return UCS_OK;
+}
+
+void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
+                             void *arg)
+{
+    uct_tcp_ep_t                 *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_pending_req_priv_queue_t *priv;
+
+    uct_pending_queue_purge(priv, &ep->pending_q, 1, cb, arg);
+}
+
+ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                              uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    uct_tcp_ep_rma_op_t *op;
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_UNFLUSHED) &&
+        ucs_queue_is_empty(&ep->rma.ops)) {
+        if (ep->tx.length == 0) {
+            UCT_TL_EP_STAT_FLUSH(&ep->super);
+            return UCS_OK;
+        }
+
+        if (!uct_tcp_ep_can_send(ep)) {
+            return UCS_ERR_NO_RESOURCE;
+        }
+
+        /* Complete when all currently queued data is sent */
+        if (comp != NULL) {
+            uct_tcp_ep_tx_add_comp(ep, comp);
+        }
+
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        return UCS_INPROGRESS;
+    }
+
+    /* Remote memory operations are complete when the reply to a flush
+     * request arrives. Reuse the last flush if nothing was posted after it. */
+    op = ep->rma.flush_op;
+    if ((op != NULL) && ((comp == NULL) || (op->comp == NULL))) {
+        if (comp != NULL) {
+            op->comp = comp;
+        }
+
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        return UCS_INPROGRESS;
+    }
+
+    if (!uct_tcp_ep_can_send(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    op = uct_tcp_ep_rma_op_add(ep, NULL, 0, NULL, comp);
+    if (op == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ep->rma.flush_op = op;
+    ep->flags       &= ~UCT_TCP_EP_FLAG_UNFLUSHED;
+    uct_tcp_ep_tx_ctrl_start(ep, UCT_TCP_AM_ID_FLUSH, 0);
+    uct_tcp_ep_tx_ctrl_push(ep, 0);
+    uct_tcp_ep_tx_start(ep);
+
+    UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+    return UCS_INPROGRESS;
 }
 
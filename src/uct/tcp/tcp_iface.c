@@ -3,6 +3,8 @@
  * See file LICENSE for terms.
  */
 
+#define _GNU_SOURCE /* for sched_getcpu(3) */
+
 #include "tcp.h"
 
 #include <uct/base/uct_worker.h>
@@ -12,6 +14,7 @@
 #include <sys/poll.h>
 #include <netinet/tcp.h>
 #include <dirent.h>
+#include <sched.h>
 
 
 static ucs_config_field_t uct_tcp_iface_config_table[] = {
@@ -31,6 +34,48 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Number of times to poll on a ready socket. 0 - no polling, -1 - until drained",
    ucs_offsetof(uct_tcp_iface_config_t, max_poll), UCS_CONFIG_TYPE_UINT},
 
+  {"MAX_ZCOPY", "8m",
+   "Maximal size of a zero-copy active message. Messages which are larger than\n"
+   "the bcopy buffer are received directly to a dedicated buffer.",
+   ucs_offsetof(uct_tcp_iface_config_t, max_zcopy), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"TX_AGGR_SIZE", "64k",
+   "Maximal amount of data which is queued on an endpoint. Messages which are\n"
+   "queued while the socket is busy are sent together with a single system call.",
+   ucs_offsetof(uct_tcp_iface_config_t, tx_aggr_size), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"TX_AGGR_COUNT", "1",
+   "Number of queued active messages which triggers a send. 1 - send every\n"
+   "message immediately; larger values defer sending until this many messages\n"
+   "are queued or until the next progress, trading latency for message rate.",
+   ucs_offsetof(uct_tcp_iface_config_t, tx_aggr_count), UCS_CONFIG_TYPE_UINT},
+
+  {"RX_SEG_SIZE", "64k",
+   "Size of a receive segment. Active messages are parsed in place, and a\n"
+   "partially received message is copied to a new segment only when the\n"
+   "current segment does not have enough space for it.",
+   ucs_offsetof(uct_tcp_iface_config_t, rx_seg_size), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"NUM_SOCKETS", "1",
+   "Number of sockets of an endpoint. Payloads of zero-copy operations which\n"
+   "are larger than STRIPE_THRESH are split between the sockets and sent in\n"
+   "parallel, and the receiver assembles them in the original order.",
+   ucs_offsetof(uct_tcp_iface_config_t, num_socks), UCS_CONFIG_TYPE_UINT},
+
+  {"STRIPE_THRESH", "256k",
+   "Minimal payload size of a zero-copy operation which is split between the\n"
+   "sockets of an endpoint.",
+   ucs_offsetof(uct_tcp_iface_config_t, stripe_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"EPOLL_ET", "n",
+   "Register the sockets for edge-triggered events. Endpoints with events that\n"
+   "were not consumed by a single progress call are kept on a ready list, so\n"
+   "epoll_wait() only reports the sockets whose state changed.",
+   ucs_offsetof(uct_tcp_iface_config_t, epoll_et), UCS_CONFIG_TYPE_BOOL},
+
+  UCT_IFACE_MPOOL_CONFIG_FIELDS("RX_", -1, 16, "receive",
+                                ucs_offsetof(uct_tcp_iface_config_t, rx_mpool), ""),
+
   {"NODELAY", "y",
    "Set TCP_NODELAY socket option to disable Nagle algorithm. Setting this\n"
    "option usually provides better performance",
@@ -40,6 +85,17 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Socket send buffer size.",
    ucs_offsetof(uct_tcp_iface_config_t, sockopt_sndbuf), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"BUSY_POLL", "0",
+   "Set SO_BUSY_POLL socket option, to poll the device for incoming data for up\n"
+   "to this time when the socket receive queue is empty. 0 - disabled. Setting\n"
+   "a value larger than net.core.busy_read requires CAP_NET_ADMIN.",
+   ucs_offsetof(uct_tcp_iface_config_t, sockopt_busy_poll), UCS_CONFIG_TYPE_TIME},
+
+  {"INCOMING_CPU", "n",
+   "Set SO_INCOMING_CPU socket option to the CPU of the thread which opens the\n"
+   "interface, to process the incoming packets on that CPU where possible.",
+   ucs_offsetof(uct_tcp_iface_config_t, sockopt_incoming_cpu), UCS_CONFIG_TYPE_BOOL},
+
   {NULL}
 };
 
@@ -85,6 +141,14 @@ static ucs_status_t uct_tcp_iface_query(uct_iface_h tl_iface, uct_iface_attr_t *
     attr->device_addr_len  = sizeof(struct in_addr);
     attr->cap.flags        = UCT_IFACE_FLAG_CONNECT_TO_IFACE |
                              UCT_IFACE_FLAG_AM_BCOPY         |
+                             UCT_IFACE_FLAG_AM_ZCOPY         |
+                             UCT_IFACE_FLAG_PUT_SHORT        |
+                             UCT_IFACE_FLAG_PUT_BCOPY        |
+                             UCT_IFACE_FLAG_PUT_ZCOPY        |
+                             UCT_IFACE_FLAG_GET_BCOPY        |
+                             UCT_IFACE_FLAG_GET_ZCOPY        |
+                             UCT_IFACE_FLAG_ATOMIC_CPU       |
+                             UCT_IFACE_FLAG_TARGET_PROGRESS  |
                              UCT_IFACE_FLAG_PENDING          |
                              UCT_IFACE_FLAG_CB_SYNC          |
                              UCT_IFACE_FLAG_EVENT_SEND_COMP  |
@@ -92,6 +156,41 @@ static ucs_status_t uct_tcp_iface_query(uct_iface_h tl_iface, uct_iface_attr_t *
 
     attr->cap.am.max_bcopy = iface->config.buf_size - sizeof(uct_tcp_am_hdr_t);
 
+    attr->cap.am.max_zcopy        = iface->config.max_zcopy;
+    attr->cap.am.max_hdr          = iface->config.buf_size -
+                                    sizeof(uct_tcp_am_hdr_t);
+    attr->cap.am.max_iov          = UCT_TCP_EP_MAX_IOV - 1;
+    attr->cap.am.opt_zcopy_align  = 1;
+    attr->cap.am.align_mtu        = attr->cap.am.opt_zcopy_align;
+
+    /* Remote memory operations are executed by the target progress */
+    attr->cap.put.max_short       = iface->config.buf_size -
+                                    sizeof(uct_tcp_am_hdr_t) -
+                                    sizeof(uct_tcp_put_hdr_t);
+    attr->cap.put.max_bcopy       = attr->cap.put.max_short;
+    attr->cap.put.max_zcopy       = iface->config.max_zcopy;
+    attr->cap.put.opt_zcopy_align = 1;
+    attr->cap.put.align_mtu       = attr->cap.put.opt_zcopy_align;
+    attr->cap.put.max_iov         = UCT_TCP_EP_MAX_IOV - 1;
+
+    attr->cap.get.max_bcopy       = iface->config.buf_size -
+                                    sizeof(uct_tcp_am_hdr_t);
+    attr->cap.get.max_zcopy       = iface->config.max_zcopy;
+    attr->cap.get.opt_zcopy_align = 1;
+    attr->cap.get.align_mtu       = attr->cap.get.opt_zcopy_align;
+    attr->cap.get.max_iov         = 1;
+
+    attr->cap.atomic64.op_flags   = UCS_BIT(UCT_ATOMIC_OP_ADD)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_AND)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_OR)      |
+                                    UCS_BIT(UCT_ATOMIC_OP_XOR);
+    attr->cap.atomic64.fop_flags  = UCS_BIT(UCT_ATOMIC_OP_ADD)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_AND)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_OR)      |
+                                    UCS_BIT(UCT_ATOMIC_OP_XOR)     |
+                                    UCS_BIT(UCT_ATOMIC_OP_SWAP)    |
+                                    UCS_BIT(UCT_ATOMIC_OP_CSWAP);
+
     status = uct_tcp_netif_caps(iface->if_name, &attr->latency.overhead,
                                 &attr->bandwidth);
     if (status != UCS_OK) {
@@ -123,6 +222,40 @@ static ucs_status_t uct_tcp_iface_event_fd_get(uct_iface_h tl_iface, int *fd_p)
     return UCS_OK;
 }
 
+static unsigned uct_tcp_iface_progress_ready(uct_tcp_iface_t *iface)
+{
+    ucs_list_link_t ready_list;
+    unsigned count = 0;
+    uint32_t events;
+    uct_tcp_ep_t *ep;
+
+    ucs_list_head_init(&ready_list);
+    ucs_list_splice_tail(&ready_list, &iface->ready_list);
+    ucs_list_head_init(&iface->ready_list);
+
+    /* An endpoint is put back to the interface list before it is progressed,
+     * since the progress may destroy it. It leaves the list once a short
+     * read or write shows that the socket was drained. */
+    while (!ucs_list_is_empty(&ready_list)) {
+        ep     = ucs_list_extract_head(&ready_list, uct_tcp_ep_t, ready_list);
+        events = ep->ready;
+        if (events == 0) {
+            ep->flags &= ~UCT_TCP_EP_FLAG_READY;
+            continue;
+        }
+
+        ucs_list_add_tail(&iface->ready_list, &ep->ready_list);
+        if (events & EPOLLIN) {
+            count += uct_tcp_ep_progress_rx(ep);
+        }
+        if (events & EPOLLOUT) {
+            count += uct_tcp_ep_progress_tx(ep);
+        }
+    }
+
+    return count;
+}
+
 unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
@@ -134,12 +267,29 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
 
     ucs_trace_poll("iface=%p", iface);
 
-    max_events = ucs_min(UCT_TCP_MAX_EVENTS, iface->config.max_poll);
-    nevents = epoll_wait(iface->epfd, events, max_events, 0);
-    if ((nevents < 0) && (errno != EINTR)) {
-        ucs_error("epoll_wait(epfd=%d max=%d) failed: %m", iface->epfd,
-                  max_events);
-        return 0;
+    /* Skip the system call if no socket waits for events */
+    if (iface->num_polled == 0) {
+        nevents = 0;
+    } else {
+        max_events = ucs_min(UCT_TCP_MAX_EVENTS, iface->config.max_poll);
+        nevents = epoll_wait(iface->epfd, events, max_events, 0);
+        if ((nevents < 0) && (errno != EINTR)) {
+            ucs_error("epoll_wait(epfd=%d max=%d) failed: %m", iface->epfd,
+                      max_events);
+            return 0;
+        }
+    }
+
+    if (iface->config.epoll_et) {
+        for (i = 0; i < nevents; ++i) {
+            ep         = events[i].data.ptr;
+            ep->ready |= events[i].events & (EPOLLIN | EPOLLOUT);
+            if (!(ep->flags & UCT_TCP_EP_FLAG_READY)) {
+                ep->flags |= UCT_TCP_EP_FLAG_READY;
+                ucs_list_add_tail(&iface->ready_list, &ep->ready_list);
+            }
+        }
+        return uct_tcp_iface_progress_ready(iface);
     }
 
     count = 0;
@@ -159,12 +309,23 @@ static ucs_status_t uct_tcp_iface_flush(uct_iface_h tl_iface, unsigned flags,
                                         uct_completion_t *comp)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+    ucs_status_t status    = UCS_OK;
+    uct_tcp_ep_t *ep;
 
     if (comp != NULL) {
         return UCS_ERR_UNSUPPORTED;
     }
 
-    if (iface->outstanding) {
+    /* Request remote completion of memory operations */
+    ucs_list_for_each(ep, &iface->ep_list, list) {
+        if ((ep->flags & UCT_TCP_EP_FLAG_UNFLUSHED) ||
+            !ucs_queue_is_empty(&ep->rma.ops)) {
+            uct_tcp_ep_flush(&ep->super.super, 0, NULL);
+            status = UCS_INPROGRESS;
+        }
+    }
+
+    if (iface->outstanding || (status != UCS_OK)) {
         UCT_TL_IFACE_STAT_FLUSH_WAIT(&iface->super);
         return UCS_INPROGRESS;
     }
@@ -173,6 +334,31 @@ static ucs_status_t uct_tcp_iface_flush(uct_iface_h tl_iface, unsigned flags,
     return UCS_OK;
 }
 
+void uct_tcp_iface_release_large_desc(uct_recv_desc_t *self, void *desc)
+{
+    ucs_free(UCS_PTR_BYTE_OFFSET(desc, -sizeof(uct_recv_desc_t*)));
+}
+
+void uct_tcp_iface_release_seg_desc(uct_recv_desc_t *self, void *desc)
+{
+    uct_tcp_rx_seg_put(ucs_container_of(self, uct_tcp_rx_seg_t, release_desc));
+}
+
+static void uct_tcp_iface_rx_seg_init(uct_iface_h tl_iface, void *obj,
+                                      uct_mem_h memh)
+{
+    uct_tcp_rx_seg_t *seg = obj;
+
+    seg->release_desc.cb = uct_tcp_iface_release_seg_desc;
+}
+
+static ucs_mpool_ops_t uct_tcp_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_malloc,
+    .chunk_release = ucs_mpool_chunk_free,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL
+};
+
 static void uct_tcp_iface_listen_close(uct_tcp_iface_t *iface)
 {
     if (iface->listen_fd != -1) {
@@ -232,11 +418,42 @@ ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd)
         return UCS_ERR_IO_ERROR;
     }
 
+#ifdef SO_BUSY_POLL
+    if (iface->sockopt.busy_poll > 0) {
+        ret = setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL,
+                         (void*)&iface->sockopt.busy_poll, sizeof(int));
+        if (ret < 0) {
+            ucs_error("Failed to set SO_BUSY_POLL on fd %d: %m", fd);
+            return UCS_ERR_IO_ERROR;
+        }
+    }
+#endif
+
+#ifdef SO_INCOMING_CPU
+    if (iface->sockopt.incoming_cpu >= 0) {
+        ret = setsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU,
+                         (void*)&iface->sockopt.incoming_cpu, sizeof(int));
+        if (ret < 0) {
+            ucs_error("Failed to set SO_INCOMING_CPU on fd %d: %m", fd);
+            return UCS_ERR_IO_ERROR;
+        }
+    }
+#endif
+
     return UCS_OK;
 }
 
 static uct_iface_ops_t uct_tcp_iface_ops = {
     .ep_am_bcopy              = uct_tcp_ep_am_bcopy,
+    .ep_am_zcopy              = uct_tcp_ep_am_zcopy,
+    .ep_put_short             = uct_tcp_ep_put_short,
+    .ep_put_bcopy             = uct_tcp_ep_put_bcopy,
+    .ep_put_zcopy             = uct_tcp_ep_put_zcopy,
+    .ep_get_bcopy             = uct_tcp_ep_get_bcopy,
+    .ep_get_zcopy             = uct_tcp_ep_get_zcopy,
+    .ep_atomic64_post         = uct_tcp_ep_atomic64_post,
+    .ep_atomic64_fetch        = uct_tcp_ep_atomic64_fetch,
+    .ep_atomic_cswap64        = uct_tcp_ep_atomic_cswap64,
     .ep_pending_add           = uct_tcp_ep_pending_add,
     .ep_pending_purge         = uct_tcp_ep_pending_purge,
     .ep_flush                 = uct_tcp_ep_flush,
@@ -257,6 +474,26 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .iface_is_reachable       = uct_tcp_iface_is_reachable
 };
 
+static uct_iface_ops_t uct_tcp_sockaddr_iface_ops = {
+    .ep_create_sockaddr       = UCS_CLASS_NEW_FUNC_NAME(uct_tcp_sockaddr_ep_t),
+    .ep_destroy               = UCS_CLASS_DELETE_FUNC_NAME(uct_tcp_sockaddr_ep_t),
+    .ep_flush                 = uct_tcp_sockaddr_ep_flush,
+    .ep_fence                 = uct_base_ep_fence,
+    .ep_pending_purge         = ucs_empty_function,
+    .iface_accept             = uct_tcp_sockaddr_iface_accept,
+    .iface_reject             = uct_tcp_sockaddr_iface_reject,
+    .iface_progress_enable    = (void*)ucs_empty_function_return_success,
+    .iface_progress_disable   = (void*)ucs_empty_function_return_success,
+    .iface_progress           = ucs_empty_function_return_zero,
+    .iface_flush              = uct_base_iface_flush,
+    .iface_fence              = uct_base_iface_fence,
+    .iface_close              = UCS_CLASS_DELETE_FUNC_NAME(uct_tcp_iface_t),
+    .iface_query              = uct_tcp_sockaddr_iface_query,
+    .iface_is_reachable       = uct_tcp_sockaddr_iface_is_reachable,
+    .iface_get_device_address = (void*)ucs_empty_function_return_success,
+    .iface_get_address        = uct_tcp_sockaddr_iface_get_address
+};
+
 static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
                            const uct_iface_params_t *params,
                            const uct_iface_config_t *tl_config)
@@ -267,38 +504,118 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     socklen_t addrlen;
     int ret;
 
-    ucs_assert(params->open_mode & UCT_IFACE_OPEN_MODE_DEVICE);
-
-    UCS_CLASS_CALL_SUPER_INIT(uct_base_iface_t, &uct_tcp_iface_ops, md, worker,
-                              params, tl_config UCS_STATS_ARG(params->stats_root)
-                              UCS_STATS_ARG(params->mode.device.dev_name));
+    UCS_CLASS_CALL_SUPER_INIT(uct_base_iface_t,
+                              (params->open_mode & UCT_IFACE_OPEN_MODE_DEVICE) ?
+                              &uct_tcp_iface_ops : &uct_tcp_sockaddr_iface_ops,
+                              md, worker, params, tl_config
+                              UCS_STATS_ARG(params->stats_root)
+                              UCS_STATS_ARG((params->open_mode &
+                                             UCT_IFACE_OPEN_MODE_DEVICE) ?
+                                            params->mode.device.dev_name :
+                                            UCT_TCP_NAME));
+
+    self->open_mode = params->open_mode;
+    if (!(params->open_mode & UCT_IFACE_OPEN_MODE_DEVICE)) {
+        /* Connection establishment by socket address */
+        return uct_tcp_sockaddr_iface_init(self, params, config);
+    }
 
     ucs_strncpy_zero(self->if_name, params->mode.device.dev_name,
                      sizeof(self->if_name));
     self->outstanding            = 0;
+    self->rx_headroom            = params->rx_headroom;
+    self->release_desc.cb        = uct_tcp_iface_release_large_desc;
     self->config.buf_size        = config->super.max_bcopy +
                                    sizeof(uct_tcp_am_hdr_t);
+    self->config.max_zcopy       = ucs_max(config->max_zcopy,
+                                           config->super.max_bcopy);
+    self->config.tx_buf_size     = ucs_max(config->tx_aggr_size,
+                                           self->config.buf_size);
+    self->config.tx_aggr_count   = ucs_max(config->tx_aggr_count, 1);
+    self->config.rx_seg_size     = ucs_max(config->rx_seg_size,
+                                           self->config.buf_size) +
+                                   uct_tcp_iface_rx_seg_headroom(self);
     self->config.prefer_default  = config->prefer_default;
     self->config.max_poll        = config->max_poll;
+    self->config.num_socks       = config->num_socks;
+    self->config.stripe_thresh   = ucs_max(config->stripe_thresh,
+                                           config->num_socks);
+    self->config.epoll_et        = config->epoll_et;
     self->sockopt.nodelay        = config->sockopt_nodelay;
     self->sockopt.sndbuf         = config->sockopt_sndbuf;
+    self->sockopt.busy_poll      = ucs_max(config->sockopt_busy_poll * 1e6, 0);
+    self->sockopt.incoming_cpu   = config->sockopt_incoming_cpu ?
+                                   sched_getcpu() : -1;
+    self->num_polled             = 0;
     ucs_list_head_init(&self->ep_list);
+    ucs_list_head_init(&self->ready_list);
+
+    if (self->config.max_zcopy > UINT32_MAX) {
+        ucs_error("TCP maximal zcopy size (%zu) is larger than %u",
+                  self->config.max_zcopy, UINT32_MAX);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if ((config->num_socks == 0) || (config->num_socks > UCT_TCP_EP_MAX_SOCKS)) {
+        ucs_error("TCP number of sockets per endpoint (%u) must be between 1 "
+                  "and %d", config->num_socks, UCT_TCP_EP_MAX_SOCKS);
+        return UCS_ERR_INVALID_PARAM;
+    }
 
     if (ucs_derived_of(worker, uct_priv_worker_t)->thread_mode == UCS_THREAD_MODE_MULTI) {
         ucs_error("TCP transport does not support multi-threaded worker");
         return UCS_ERR_INVALID_PARAM;
     }
 
+#ifndef SO_BUSY_POLL
+    if (self->sockopt.busy_poll > 0) {
+        ucs_error("TCP busy polling is not supported");
+        return UCS_ERR_UNSUPPORTED;
+    }
+#endif
+
+#ifndef SO_INCOMING_CPU
+    if (self->sockopt.incoming_cpu >= 0) {
+        ucs_error("TCP incoming CPU is not supported");
+        return UCS_ERR_UNSUPPORTED;
+    }
+#endif
+
     status = uct_tcp_netif_inaddr(self->if_name, &self->config.ifaddr,
                                   &self->config.netmask);
     if (status != UCS_OK) {
         goto err;
     }
 
+    status = uct_iface_mpool_init(&self->super, &self->rx_mpool,
+                                  sizeof(uct_tcp_rx_seg_t) +
+                                  self->config.rx_seg_size,
+                                  0, UCS_SYS_CACHE_LINE_SIZE,
+                                  &config->rx_mpool, 16,
+                                  uct_tcp_iface_rx_seg_init, "tcp_rx_seg");
+    if (status != UCS_OK) {
+        goto err;
+    }
+
+    status = ucs_mpool_init(&self->rma_op_mp, 0, sizeof(uct_tcp_ep_rma_op_t),
+                            0, 1, 128, UINT_MAX, &uct_tcp_mpool_ops,
+                            "tcp_rma_ops");
+    if (status != UCS_OK) {
+        goto err_mpool_cleanup;
+    }
+
+    status = ucs_mpool_init(&self->stripe_comp_mp, 0,
+                            sizeof(uct_tcp_ep_stripe_comp_t), 0, 1, 32,
+                            UINT_MAX, &uct_tcp_mpool_ops, "tcp_stripe_comps");
+    if (status != UCS_OK) {
+        goto err_rma_op_mpool_cleanup;
+    }
+
     self->epfd = epoll_create(1);
     if (self->epfd < 0) {
         ucs_error("epoll_create() failed: %m");
-        goto err;
+        status = UCS_ERR_IO_ERROR;
+        goto err_stripe_comp_mpool_cleanup;
     }
 
     /* Create the server socket for accepting incoming connections */
@@ -313,6 +630,13 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         goto err_close_sock;
     }
 
+    /* Report unsupported or not permitted socket options when the interface
+     * is opened, rather than on every connection */
+    status = uct_tcp_iface_set_sockopt(self, self->listen_fd);
+    if (status != UCS_OK) {
+        goto err_close_sock;
+    }
+
     /* Bind socket to random available port */
     bind_addr = self->config.ifaddr;
     bind_addr.sin_port = 0;
@@ -357,17 +681,28 @@ err_close_sock:
     close(self->listen_fd);
 err_close_epfd:
     close(self->epfd);
+err_stripe_comp_mpool_cleanup:
+    ucs_mpool_cleanup(&self->stripe_comp_mp, 0);
+err_rma_op_mpool_cleanup:
+    ucs_mpool_cleanup(&self->rma_op_mp, 0);
+err_mpool_cleanup:
+    ucs_mpool_cleanup(&self->rx_mpool, 0);
 err:
     return status;
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_tcp_iface_t)
 {
-    uct_tcp_ep_t *ep, *tmp;
+    uct_tcp_ep_t *ep;
     ucs_status_t status;
 
     ucs_debug("tcp_iface %p: destroying", self);
 
+    if (!(self->open_mode & UCT_IFACE_OPEN_MODE_DEVICE)) {
+        uct_tcp_sockaddr_iface_cleanup(self);
+        return;
+    }
+
     uct_base_iface_progress_disable(&self->super.super, UCT_PROGRESS_SEND|
                                                         UCT_PROGRESS_RECV);
 
@@ -376,12 +711,18 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_iface_t)
         ucs_warn("failed to remove handler for server socket fd=%d", self->listen_fd);
     }
 
-    ucs_list_for_each_safe(ep, tmp, &self->ep_list, list) {
+    /* Destroying an endpoint also destroys its additional sockets, so the
+     * next list element may be released as well */
+    while (!ucs_list_is_empty(&self->ep_list)) {
+        ep = ucs_list_head(&self->ep_list, uct_tcp_ep_t, list);
         uct_tcp_ep_destroy(&ep->super.super);
     }
 
     uct_tcp_iface_listen_close(self);
     close(self->epfd);
+    ucs_mpool_cleanup(&self->stripe_comp_mp, 1);
+    ucs_mpool_cleanup(&self->rma_op_mp, 1);
+    ucs_mpool_cleanup(&self->rx_mpool, 1);
 }
 
 UCS_CLASS_DEFINE(uct_tcp_iface_t, uct_base_iface_t);
@@ -5,49 +5,238 @@
 
 #include "tcp.h"
 
+#include <ucs/datastruct/khash.h>
+#include <ucs/type/spinlock.h>
+
+
+/**
+ * Registered memory region. The key is packed to the remote key, and remote
+ * memory operations are executed only within the region of their key.
+ */
+typedef struct uct_tcp_mem {
+    uint64_t                      key;
+    void                          *address;
+    size_t                        length;
+} uct_tcp_mem_t;
+
+
+KHASH_MAP_INIT_INT64(uct_tcp_mem, uct_tcp_mem_t*)
+
+
+/**
+ * TCP memory domain
+ */
+typedef struct uct_tcp_md {
+    uct_md_t                      super;
+    ucs_spinlock_t                lock;     /* Protects the regions hash,
+                                               which is looked up by the
+                                               progress of any interface */
+    khash_t(uct_tcp_mem)          mems;     /* Registered regions by key */
+} uct_tcp_md_t;
+
 
 static ucs_status_t uct_tcp_md_query(uct_md_h md, uct_md_attr_t *attr)
 {
-    attr->cap.flags         = 0;
+    /* Registration does not pin memory, it only allows remote access */
+    attr->cap.flags         = UCT_MD_FLAG_REG | UCT_MD_FLAG_NEED_RKEY |
+                              UCT_MD_FLAG_SOCKADDR;
     attr->cap.max_alloc     = 0;
-    attr->cap.reg_mem_types = 0;
-    attr->cap.mem_type      = 0;
-    attr->cap.max_reg       = 0;
-    attr->rkey_packed_size  = 0;
+    attr->cap.reg_mem_types = UCS_BIT(UCT_MD_MEM_TYPE_HOST);
+    attr->cap.mem_type      = UCT_MD_MEM_TYPE_HOST;
+    attr->cap.max_reg       = ULONG_MAX;
+    attr->rkey_packed_size  = sizeof(uint64_t);
     attr->reg_cost.overhead = 0;
     attr->reg_cost.growth   = 0;
     memset(&attr->local_cpus, 0xff, sizeof(attr->local_cpus));
     return UCS_OK;
 }
 
+static ucs_status_t uct_tcp_mem_reg(uct_md_h uct_md, void *address,
+                                    size_t length, unsigned flags,
+                                    uct_mem_h *memh_p)
+{
+    uct_tcp_md_t *md = ucs_derived_of(uct_md, uct_tcp_md_t);
+    uct_tcp_mem_t *mem;
+    khiter_t iter;
+    int ret;
+
+    mem = ucs_malloc(sizeof(*mem), "tcp_mem");
+    if (mem == NULL) {
+        ucs_error("failed to allocate tcp memory region");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    mem->address = address;
+    mem->length  = length;
+
+    /* The key must not be guessed by a peer which did not get the remote key,
+     * and must not be reused by the regions of the memory domain */
+    ucs_spin_lock(&md->lock);
+    do {
+        mem->key = ucs_generate_uuid((uintptr_t)mem);
+    } while ((mem->key == 0) || (mem->key == UCT_INVALID_RKEY) ||
+             (kh_get(uct_tcp_mem, &md->mems, mem->key) != kh_end(&md->mems)));
+
+    iter = kh_put(uct_tcp_mem, &md->mems, mem->key, &ret);
+    if (ret < 0) {
+        ucs_spin_unlock(&md->lock);
+        ucs_error("failed to add tcp memory region to the hash");
+        ucs_free(mem);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    kh_value(&md->mems, iter) = mem;
+    ucs_spin_unlock(&md->lock);
+
+    ucs_trace("tcp md %p: registered address %p length %zu key 0x%"PRIx64,
+              md, address, length, mem->key);
+    *memh_p = mem;
+    return UCS_OK;
+}
+
+static ucs_status_t uct_tcp_mem_dereg(uct_md_h uct_md, uct_mem_h memh)
+{
+    uct_tcp_md_t *md   = ucs_derived_of(uct_md, uct_tcp_md_t);
+    uct_tcp_mem_t *mem = memh;
+    khiter_t iter;
+
+    ucs_spin_lock(&md->lock);
+    iter = kh_get(uct_tcp_mem, &md->mems, mem->key);
+    ucs_assert_always(iter != kh_end(&md->mems));
+    kh_del(uct_tcp_mem, &md->mems, iter);
+    ucs_spin_unlock(&md->lock);
+
+    ucs_free(mem);
+    return UCS_OK;
+}
+
+static ucs_status_t uct_tcp_mkey_pack(uct_md_h md, uct_mem_h memh,
+                                      void *rkey_buffer)
+{
+    uct_tcp_mem_t *mem = memh;
+
+    *(uint64_t*)rkey_buffer = mem->key;
+    return UCS_OK;
+}
+
+static ucs_status_t uct_tcp_rkey_unpack(uct_md_component_t *mdc,
+                                        const void *rkey_buffer,
+                                        uct_rkey_t *rkey_p, void **handle_p)
+{
+    *rkey_p   = *(const uint64_t*)rkey_buffer;
+    *handle_p = NULL;
+    return UCS_OK;
+}
+
+ucs_status_t uct_tcp_md_check_access(uct_md_h uct_md, uint64_t key,
+                                     uint64_t address, size_t length)
+{
+    uct_tcp_md_t *md = ucs_derived_of(uct_md, uct_tcp_md_t);
+    ucs_status_t status;
+    uct_tcp_mem_t *mem;
+    uint64_t start;
+    khiter_t iter;
+
+    ucs_spin_lock(&md->lock);
+    iter = kh_get(uct_tcp_mem, &md->mems, key);
+    if (iter == kh_end(&md->mems)) {
+        status = UCS_ERR_INVALID_ADDR;
+    } else {
+        /* Written so that none of the terms can overflow */
+        mem    = kh_value(&md->mems, iter);
+        start  = (uintptr_t)mem->address;
+        status = ((address >= start) && (length <= mem->length) &&
+                  ((address - start) <= (mem->length - length))) ?
+                 UCS_OK : UCS_ERR_INVALID_ADDR;
+    }
+    ucs_spin_unlock(&md->lock);
+
+    return status;
+}
+
+static int uct_tcp_is_sockaddr_accessible(uct_md_h md,
+                                          const ucs_sock_addr_t *sockaddr,
+                                          uct_sockaddr_accessibility_t mode)
+{
+    const struct sockaddr_in *addr_in;
+
+    if ((mode != UCT_SOCKADDR_ACC_LOCAL) && (mode != UCT_SOCKADDR_ACC_REMOTE)) {
+        ucs_error("Unknown sockaddr accessibility mode %d", mode);
+        return 0;
+    }
+
+    /* Only IPv4 is supported, as by the rest of the transport */
+    if (sockaddr->addr->sa_family != AF_INET) {
+        return 0;
+    }
+
+    /* Any remote address may be routed by the kernel. A local address must
+     * belong to an active network interface, so it could be listened on. */
+    addr_in = (const struct sockaddr_in*)sockaddr->addr;
+    return (mode == UCT_SOCKADDR_ACC_REMOTE) ||
+           (addr_in->sin_addr.s_addr == INADDR_ANY) ||
+           (uct_tcp_netif_find(&addr_in->sin_addr, NULL, 0) == UCS_OK);
+}
+
 static ucs_status_t uct_tcp_query_md_resources(uct_md_resource_desc_t **resources_p,
                                                 unsigned *num_resources_p)
 {
     return uct_single_md_resource(&uct_tcp_md, resources_p, num_resources_p);
 }
 
+static void uct_tcp_md_close(uct_md_h uct_md)
+{
+    uct_tcp_md_t *md = ucs_derived_of(uct_md, uct_tcp_md_t);
+    uct_tcp_mem_t *mem;
+
+    if (kh_size(&md->mems) > 0) {
+        ucs_warn("tcp md %p: %u memory regions were not deregistered", md,
+                 kh_size(&md->mems));
+    }
+
+    kh_foreach_value(&md->mems, mem, ucs_free(mem));
+    kh_destroy_inplace(uct_tcp_mem, &md->mems);
+    ucs_spinlock_destroy(&md->lock);
+    ucs_free(md);
+}
+
 static ucs_status_t uct_tcp_md_open(const char *md_name, const uct_md_config_t *md_config,
                                     uct_md_h *md_p)
 {
     static uct_md_ops_t md_ops = {
-        .close        = ucs_empty_function,
+        .close        = uct_tcp_md_close,
         .query        = uct_tcp_md_query,
-        .mkey_pack    = ucs_empty_function_return_unsupported,
-        .mem_reg      = ucs_empty_function_return_unsupported,
-        .mem_dereg    = ucs_empty_function_return_unsupported,
+        .mkey_pack    = uct_tcp_mkey_pack,
+        .mem_reg      = uct_tcp_mem_reg,
+        .mem_dereg    = uct_tcp_mem_dereg,
+        .is_sockaddr_accessible = uct_tcp_is_sockaddr_accessible,
         .is_mem_type_owned = (void *)ucs_empty_function_return_zero,
     };
-    static uct_md_t md = {
-        .ops          = &md_ops,
-        .component    = &uct_tcp_md
-    };
+    uct_tcp_md_t *md;
+    ucs_status_t status;
+
+    md = ucs_malloc(sizeof(*md), "tcp_md");
+    if (md == NULL) {
+        ucs_error("failed to allocate tcp md");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    status = ucs_spinlock_init(&md->lock);
+    if (status != UCS_OK) {
+        ucs_free(md);
+        return status;
+    }
+
+    md->super.ops       = &md_ops;
+    md->super.component = &uct_tcp_md;
+    kh_init_inplace(uct_tcp_mem, &md->mems);
 
-    *md_p = &md;
+    *md_p = &md->super;
     return UCS_OK;
 }
 
 UCT_MD_COMPONENT_DEFINE(uct_tcp_md, UCT_TCP_NAME,
                         uct_tcp_query_md_resources, uct_tcp_md_open, NULL,
-                        ucs_empty_function_return_unsupported,
+                        uct_tcp_rkey_unpack,
                         ucs_empty_function_return_success, "TCP_",
                         uct_md_config_table, uct_md_config_t);
@@ -22,6 +22,7 @@
 #include <net/if_arp.h>
 #include <net/if.h>
 #include <netdb.h>
+#include <ifaddrs.h>
 
 
 typedef ssize_t (*uct_tcp_io_func_t)(int fd, void *data, size_t size, int flags);
@@ -184,13 +185,38 @@ ucs_status_t uct_tcp_netif_is_default(const char *if_name, int *result_p)
     return UCS_OK;
 }
 
-static ucs_status_t uct_tcp_do_io(int fd, void *data, size_t *length_p,
-                                  uct_tcp_io_func_t io_func, const char *name)
+ucs_status_t uct_tcp_netif_find(const struct in_addr *inaddr, char *if_name,
+                                size_t max)
 {
-    ssize_t ret;
+    struct ifaddrs *ifaddrs, *ifa;
+    ucs_status_t status;
 
-    ucs_assert(*length_p > 0);
-    ret = io_func(fd, data, *length_p, 0);
+    if (getifaddrs(&ifaddrs) < 0) {
+        ucs_error("getifaddrs() failed: %m");
+        return UCS_ERR_IO_ERROR;
+    }
+
+    status = UCS_ERR_NO_DEVICE;
+    for (ifa = ifaddrs; ifa != NULL; ifa = ifa->ifa_next) {
+        if ((ifa->ifa_addr != NULL) && (ifa->ifa_addr->sa_family == AF_INET) &&
+            (((struct sockaddr_in*)ifa->ifa_addr)->sin_addr.s_addr ==
+             inaddr->s_addr) &&
+            ucs_netif_is_active(ifa->ifa_name)) {
+            if (if_name != NULL) {
+                ucs_strncpy_zero(if_name, ifa->ifa_name, max);
+            }
+            status = UCS_OK;
+            break;
+        }
+    }
+
+    freeifaddrs(ifaddrs);
+    return status;
+}
+
+static ucs_status_t uct_tcp_io_status(int fd, ssize_t ret, size_t *length_p,
+                                      const char *name)
+{
     if (ret == 0) {
         ucs_trace("fd %d is closed", fd);
         return UCS_ERR_CANCELED; /* Connection closed */
@@ -199,8 +225,7 @@ static ucs_status_t uct_tcp_do_io(int fd, void *data, size_t *length_p,
             *length_p = 0;
             return UCS_OK;
         } else {
-            ucs_error("%s(fd=%d data=%p length=%zu) failed: %m",
-                      name, fd, data, *length_p);
+            ucs_error("%s(fd=%d length=%zu) failed: %m", name, fd, *length_p);
             return UCS_ERR_IO_ERROR;
         }
     } else {
@@ -209,12 +234,32 @@ static ucs_status_t uct_tcp_do_io(int fd, void *data, size_t *length_p,
     }
 }
 
+static ucs_status_t uct_tcp_do_io(int fd, void *data, size_t *length_p,
+                                  uct_tcp_io_func_t io_func, const char *name)
+{
+    ucs_assert(*length_p > 0);
+    return uct_tcp_io_status(fd, io_func(fd, data, *length_p, 0), length_p,
+                             name);
+}
+
 ucs_status_t uct_tcp_send(int fd, const void *data, size_t *length_p)
 {
     return uct_tcp_do_io(fd, (void*)data, length_p, (uct_tcp_io_func_t)send,
                          "send");
 }
 
+ucs_status_t uct_tcp_sendv(int fd, const struct iovec *iov, size_t iovcnt,
+                           size_t *length_p)
+{
+    struct msghdr msg;
+
+    ucs_assert(iovcnt > 0);
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov    = (struct iovec*)iov;
+    msg.msg_iovlen = iovcnt;
+    return uct_tcp_io_status(fd, sendmsg(fd, &msg, 0), length_p, "sendmsg");
+}
+
 ucs_status_t uct_tcp_recv(int fd, void *data, size_t *length_p)
 {
     return uct_tcp_do_io(fd, data, length_p, recv, "recv");
@@ -0,0 +1,743 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+ * See file LICENSE for terms.
+ */
+
+#include "tcp.h"
+
+#include <uct/base/uct_worker.h>
+#include <ucs/async/async.h>
+#include <ucs/sys/string.h>
+#include <sys/socket.h>
+#include <sys/poll.h>
+
+
+static void uct_tcp_sockaddr_epoll_ctl(uct_tcp_iface_t *iface, int op, int fd,
+                                       uint32_t events, void *ptr)
+{
+    struct epoll_event epoll_event;
+    int ret;
+
+    memset(&epoll_event, 0, sizeof(epoll_event));
+    epoll_event.data.ptr = ptr;
+    epoll_event.events   = events;
+    ret = epoll_ctl(iface->epfd, op, fd, &epoll_event);
+    if (ret < 0) {
+        ucs_fatal("epoll_ctl(epfd=%d, op=%d, fd=%d) failed: %m",
+                  iface->epfd, op, fd);
+    }
+}
+
+static void uct_tcp_sockaddr_ep_close(uct_tcp_sockaddr_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    if (ep->fd != -1) {
+        uct_tcp_sockaddr_epoll_ctl(iface, EPOLL_CTL_DEL, ep->fd, 0, NULL);
+        close(ep->fd);
+        ep->fd = -1;
+    }
+
+    ucs_free(ep->buf);
+    ep->buf   = NULL;
+    ep->state = UCT_TCP_SOCKADDR_EP_DONE;
+}
+
+static void uct_tcp_sockaddr_ep_invoke_completions(ucs_queue_head_t *ops,
+                                                   ucs_status_t status)
+{
+    uct_tcp_sockaddr_ep_op_t *op;
+
+    ucs_queue_for_each_extract(op, ops, queue, 1) {
+        uct_invoke_completion(op->comp, status);
+        ucs_free(op);
+    }
+}
+
+static unsigned uct_tcp_sockaddr_ep_err_handle_progress(void *arg);
+
+static UCS_CLASS_INIT_FUNC(uct_tcp_sockaddr_ep_t, uct_iface_t *tl_iface,
+                           const ucs_sock_addr_t *sockaddr,
+                           uct_sockaddr_priv_pack_callback_t pack_cb,
+                           void *arg, uint32_t cb_flags)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+    char ip_port_str[UCS_SOCKADDR_STRING_LEN];
+    ucs_status_t status;
+    int ret;
+
+    UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super);
+
+    if (!(iface->open_mode & UCT_IFACE_OPEN_MODE_SOCKADDR_CLIENT)) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    /* The private data is packed from the async event handler */
+    UCT_CB_FLAGS_CHECK(cb_flags);
+    if (!(cb_flags & UCT_CB_FLAG_ASYNC)) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    if (sockaddr->addr->sa_family != AF_INET) {
+        ucs_error("tcp sockaddr client supports only IPv4 addresses");
+        return UCS_ERR_INVALID_ADDR;
+    }
+
+    self->state    = UCT_TCP_SOCKADDR_EP_CONNECTING;
+    self->status   = UCS_INPROGRESS;
+    self->pack_cb  = pack_cb;
+    self->pack_arg = arg;
+    self->buf      = NULL;
+    self->offset   = 0;
+    self->prog_id  = UCS_CALLBACKQ_ID_NULL;
+    ucs_queue_head_init(&self->ops);
+
+    status = ucs_tcpip_socket_create(&self->fd);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucs_sys_fcntl_modfl(self->fd, O_NONBLOCK, 0);
+    if (status != UCS_OK) {
+        close(self->fd);
+        return status;
+    }
+
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+
+    ret = connect(self->fd, sockaddr->addr, sizeof(struct sockaddr_in));
+    if ((ret == 0) || (errno == EINPROGRESS)) {
+        /* The connection request is sent by the async event handler once the
+         * socket is connected */
+        uct_tcp_sockaddr_epoll_ctl(iface, EPOLL_CTL_ADD, self->fd, EPOLLOUT,
+                                   self);
+    } else {
+        /* Report the failure the same way as an asynchronous one, since the
+         * endpoint is valid only after this function returns */
+        ucs_debug("connect(fd=%d) to %s failed: %m", self->fd,
+                  ucs_sockaddr_str(sockaddr->addr, ip_port_str,
+                                   UCS_SOCKADDR_STRING_LEN));
+        close(self->fd);
+        self->fd     = -1;
+        self->state  = UCT_TCP_SOCKADDR_EP_DONE;
+        self->status = UCS_ERR_UNREACHABLE;
+        uct_worker_progress_register_safe(&iface->super.worker->super,
+                                          uct_tcp_sockaddr_ep_err_handle_progress,
+                                          self, UCS_CALLBACKQ_FLAG_ONESHOT,
+                                          &self->prog_id);
+    }
+
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+
+    ucs_debug("tcp_iface %p: created sockaddr ep %p fd %d to %s", iface, self,
+              self->fd, ucs_sockaddr_str(sockaddr->addr, ip_port_str,
+                                         UCS_SOCKADDR_STRING_LEN));
+    return UCS_OK;
+}
+
+static UCS_CLASS_CLEANUP_FUNC(uct_tcp_sockaddr_ep_t)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(self->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_sockaddr_ep_op_t *op;
+
+    ucs_debug("tcp_sockaddr_ep %p: destroying", self);
+
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+
+    /* remove the slow progress function in case it was placed on the slow
+     * progress chain but wasn't invoked yet */
+    uct_worker_progress_unregister_safe(&iface->super.worker->super,
+                                        &self->prog_id);
+
+    if (!ucs_queue_is_empty(&self->ops)) {
+        ucs_warn("destroying endpoint %p with not completed operations", self);
+        ucs_queue_for_each_extract(op, &self->ops, queue, 1) {
+            ucs_free(op);
+        }
+    }
+
+    uct_tcp_sockaddr_ep_close(self);
+
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+}
+
+UCS_CLASS_DEFINE(uct_tcp_sockaddr_ep_t, uct_base_ep_t)
+UCS_CLASS_DEFINE_NEW_FUNC(uct_tcp_sockaddr_ep_t, uct_ep_t, uct_iface_t*,
+                          const ucs_sock_addr_t *,
+                          uct_sockaddr_priv_pack_callback_t, void *,
+                          uint32_t);
+UCS_CLASS_DEFINE_DELETE_FUNC(uct_tcp_sockaddr_ep_t, uct_ep_t);
+
+static unsigned uct_tcp_sockaddr_ep_err_handle_progress(void *arg)
+{
+    uct_tcp_sockaddr_ep_t *ep = arg;
+    uct_tcp_iface_t *iface    = ucs_derived_of(ep->super.super.iface,
+                                               uct_tcp_iface_t);
+
+    ucs_trace_func("err_handle ep=%p", ep);
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+
+    ep->prog_id = UCS_CALLBACKQ_ID_NULL;
+    uct_set_ep_failed(&UCS_CLASS_NAME(uct_tcp_sockaddr_ep_t), &ep->super.super,
+                      &iface->super.super, ep->status);
+
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+    return 0;
+}
+
+static void uct_tcp_sockaddr_ep_set_failed(uct_tcp_sockaddr_ep_t *ep,
+                                           ucs_status_t status)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    ucs_queue_head_t ops;
+
+    /* The endpoint may be released by the error handler, so take the pending
+     * flushes out of it first */
+    ucs_queue_head_init(&ops);
+    ucs_queue_splice(&ops, &ep->ops);
+
+    uct_tcp_sockaddr_ep_close(ep);
+    ep->status = status;
+
+    if (iface->super.err_handler_flags & UCT_CB_FLAG_ASYNC) {
+        uct_set_ep_failed(&UCS_CLASS_NAME(uct_tcp_sockaddr_ep_t),
+                          &ep->super.super, &iface->super.super, status);
+    } else {
+        /* invoke the error handling flow from the main thread */
+        uct_worker_progress_register_safe(&iface->super.worker->super,
+                                          uct_tcp_sockaddr_ep_err_handle_progress,
+                                          ep, UCS_CALLBACKQ_FLAG_ONESHOT,
+                                          &ep->prog_id);
+    }
+
+    uct_tcp_sockaddr_ep_invoke_completions(&ops, status);
+}
+
+static void uct_tcp_sockaddr_ep_tx(uct_tcp_sockaddr_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    size_t length          = sizeof(*ep->buf) + ep->buf->length;
+    ssize_t ret;
+
+    ret = send(ep->fd, UCS_PTR_BYTE_OFFSET(ep->buf, ep->offset),
+               length - ep->offset, MSG_NOSIGNAL);
+    if (ret < 0) {
+        if ((errno != EAGAIN) && (errno != EINTR)) {
+            ucs_debug("tcp_sockaddr_ep %p: send(fd=%d) failed: %m", ep, ep->fd);
+            uct_tcp_sockaddr_ep_set_failed(ep, UCS_ERR_UNREACHABLE);
+        }
+        return;
+    }
+
+    ep->offset += ret;
+    if (ep->offset < length) {
+        return; /* Continue when the socket becomes writable */
+    }
+
+    ucs_debug("tcp_sockaddr_ep %p: sent connection request with %u bytes of "
+              "private data", ep, ep->buf->length);
+
+    ucs_free(ep->buf);
+    ep->buf    = NULL;
+    ep->offset = 0;
+    ep->state  = UCT_TCP_SOCKADDR_EP_RX_REPLY;
+    uct_tcp_sockaddr_epoll_ctl(iface, EPOLL_CTL_MOD, ep->fd, EPOLLIN, ep);
+}
+
+static void uct_tcp_sockaddr_ep_connected(uct_tcp_sockaddr_ep_t *ep)
+{
+    char dev_name[UCT_DEVICE_NAME_MAX];
+    struct sockaddr_in local_addr;
+    ssize_t priv_length;
+    socklen_t optlen;
+    int ret, error;
+
+    optlen = sizeof(error);
+    ret    = getsockopt(ep->fd, SOL_SOCKET, SO_ERROR, &error, &optlen);
+    if ((ret < 0) || (error != 0)) {
+        ucs_debug("tcp_sockaddr_ep %p: connect(fd=%d) failed: %s", ep, ep->fd,
+                  strerror((ret < 0) ? errno : error));
+        uct_tcp_sockaddr_ep_set_failed(ep, UCS_ERR_UNREACHABLE);
+        return;
+    }
+
+    /* Pass the network interface which the connection goes through */
+    optlen = sizeof(local_addr);
+    if ((getsockname(ep->fd, (struct sockaddr*)&local_addr, &optlen) < 0) ||
+        (uct_tcp_netif_find(&local_addr.sin_addr, dev_name,
+                            sizeof(dev_name)) != UCS_OK)) {
+        dev_name[0] = '\0';
+    }
+
+    ep->buf = ucs_malloc(sizeof(*ep->buf) + UCT_TCP_SOCKADDR_MAX_CONN_PRIV,
+                         "tcp_sockaddr_request");
+    if (ep->buf == NULL) {
+        uct_tcp_sockaddr_ep_set_failed(ep, UCS_ERR_NO_MEMORY);
+        return;
+    }
+
+    priv_length = ep->pack_cb(ep->pack_arg, dev_name,
+                              UCS_PTR_BYTE_OFFSET(ep->buf, sizeof(*ep->buf)));
+    if (priv_length < 0) {
+        ucs_debug("tcp_sockaddr_ep %p: failed to fill private data: %s", ep,
+                  ucs_status_string((ucs_status_t)priv_length));
+        uct_tcp_sockaddr_ep_set_failed(ep, (ucs_status_t)priv_length);
+        return;
+    }
+
+    ucs_assert(priv_length <= UCT_TCP_SOCKADDR_MAX_CONN_PRIV);
+    ep->buf->length = priv_length;
+    ep->buf->status = UCS_OK;
+    ep->offset      = 0;
+    ep->state       = UCT_TCP_SOCKADDR_EP_TX_REQUEST;
+    uct_tcp_sockaddr_ep_tx(ep);
+}
+
+static void uct_tcp_sockaddr_ep_rx(uct_tcp_sockaddr_ep_t *ep)
+{
+    ucs_queue_head_t ops;
+    ssize_t ret;
+
+    ret = recv(ep->fd, UCS_PTR_BYTE_OFFSET(&ep->reply, ep->offset),
+               sizeof(ep->reply) - ep->offset, 0);
+    if (ret < 0) {
+        if ((errno != EAGAIN) && (errno != EINTR)) {
+            ucs_debug("tcp_sockaddr_ep %p: recv(fd=%d) failed: %m", ep, ep->fd);
+            uct_tcp_sockaddr_ep_set_failed(ep, UCS_ERR_UNREACHABLE);
+        }
+        return;
+    } else if (ret == 0) {
+        ucs_debug("tcp_sockaddr_ep %p: server closed the connection", ep);
+        uct_tcp_sockaddr_ep_set_failed(ep, UCS_ERR_UNREACHABLE);
+        return;
+    }
+
+    ep->offset += ret;
+    if (ep->offset < sizeof(ep->reply)) {
+        return;
+    }
+
+    if (ep->reply.status != UCS_OK) {
+        ucs_debug("tcp_sockaddr_ep %p: connection request was rejected", ep);
+        uct_tcp_sockaddr_ep_set_failed(ep, UCS_ERR_REJECTED);
+        return;
+    }
+
+    ucs_debug("tcp_sockaddr_ep %p: connection request was accepted", ep);
+    ucs_queue_head_init(&ops);
+    ucs_queue_splice(&ops, &ep->ops);
+    uct_tcp_sockaddr_ep_close(ep);
+    ep->status = UCS_OK;
+    uct_tcp_sockaddr_ep_invoke_completions(&ops, UCS_OK);
+}
+
+static void uct_tcp_sockaddr_ep_progress(uct_tcp_sockaddr_ep_t *ep)
+{
+    switch (ep->state) {
+    case UCT_TCP_SOCKADDR_EP_CONNECTING:
+        uct_tcp_sockaddr_ep_connected(ep);
+        break;
+    case UCT_TCP_SOCKADDR_EP_TX_REQUEST:
+        uct_tcp_sockaddr_ep_tx(ep);
+        break;
+    case UCT_TCP_SOCKADDR_EP_RX_REPLY:
+        uct_tcp_sockaddr_ep_rx(ep);
+        break;
+    default:
+        break;
+    }
+}
+
+ucs_status_t uct_tcp_sockaddr_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                                       uct_completion_t *comp)
+{
+    uct_tcp_sockaddr_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_sockaddr_ep_t);
+    uct_tcp_iface_t *iface    = ucs_derived_of(tl_ep->iface, uct_tcp_iface_t);
+    uct_tcp_sockaddr_ep_op_t *op;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+
+    status = ep->status;
+    if ((status == UCS_INPROGRESS) && (comp != NULL)) {
+        op = ucs_malloc(sizeof(*op), "tcp_sockaddr_ep_flush");
+        if (op != NULL) {
+            op->comp = comp;
+            ucs_queue_push(&ep->ops, &op->queue);
+        } else {
+            status = UCS_ERR_NO_MEMORY;
+        }
+    }
+
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+    return status;
+}
+
+static void uct_tcp_sockaddr_conn_req_destroy(uct_tcp_sockaddr_conn_req_t *req)
+{
+    ucs_list_del(&req->list);
+    close(req->fd);
+    ucs_free(req);
+}
+
+static void uct_tcp_sockaddr_iface_accept_conns(uct_tcp_iface_t *iface)
+{
+    uct_tcp_sockaddr_conn_req_t *req;
+    struct sockaddr_in peer_addr;
+    socklen_t addrlen;
+    int fd;
+
+    for (;;) {
+        addrlen = sizeof(peer_addr);
+        fd      = accept(iface->listen_fd, (struct sockaddr*)&peer_addr,
+                         &addrlen);
+        if (fd < 0) {
+            if ((errno == EINTR) || (errno == ECONNABORTED)) {
+                continue;
+            } else if (errno != EAGAIN) {
+                ucs_error("accept(fd=%d) failed: %m", iface->listen_fd);
+            }
+            return;
+        }
+
+        ucs_debug("tcp_iface %p: accepted connection request from %s:%d to "
+                  "fd %d", iface, inet_ntoa(peer_addr.sin_addr),
+                  ntohs(peer_addr.sin_port), fd);
+
+        if (ucs_sys_fcntl_modfl(fd, O_NONBLOCK, 0) != UCS_OK) {
+            close(fd);
+            continue;
+        }
+
+        req = ucs_malloc(sizeof(*req) + UCT_TCP_SOCKADDR_MAX_CONN_PRIV,
+                         "tcp_conn_request");
+        if (req == NULL) {
+            ucs_error("failed to allocate connection request");
+            close(fd);
+            continue;
+        }
+
+        req->fd     = fd;
+        req->offset = 0;
+        ucs_list_add_tail(&iface->sockaddr.conn_reqs, &req->list);
+        uct_tcp_sockaddr_epoll_ctl(iface, EPOLL_CTL_ADD, fd, EPOLLIN, req);
+    }
+}
+
+static void uct_tcp_sockaddr_conn_req_progress(uct_tcp_iface_t *iface,
+                                               uct_tcp_sockaddr_conn_req_t *req)
+{
+    size_t length;
+    ssize_t ret;
+
+    length = sizeof(req->hdr);
+    if (req->offset >= sizeof(req->hdr)) {
+        length += req->hdr.length;
+    }
+
+    ret = recv(req->fd, UCS_PTR_BYTE_OFFSET(&req->hdr, req->offset),
+               length - req->offset, 0);
+    if (ret < 0) {
+        if ((errno == EAGAIN) || (errno == EINTR)) {
+            return;
+        }
+        ucs_debug("tcp_iface %p: recv(fd=%d) failed: %m", iface, req->fd);
+        goto err_destroy;
+    } else if (ret == 0) {
+        ucs_debug("tcp_iface %p: client closed the connection on fd %d", iface,
+                  req->fd);
+        goto err_destroy;
+    }
+
+    req->offset += ret;
+    if (req->offset < sizeof(req->hdr)) {
+        return;
+    }
+
+    if (req->hdr.length > UCT_TCP_SOCKADDR_MAX_CONN_PRIV) {
+        ucs_error("tcp_iface %p: invalid connection request length %u on fd %d",
+                  iface, req->hdr.length, req->fd);
+        goto err_destroy;
+    }
+
+    if (req->offset < (sizeof(req->hdr) + req->hdr.length)) {
+        return; /* The private data is still not received */
+    }
+
+    /* Stop watching the socket until the request is accepted or rejected.
+     * The callback may reply immediately, which releases the request. */
+    uct_tcp_sockaddr_epoll_ctl(iface, EPOLL_CTL_DEL, req->fd, 0, NULL);
+    ucs_trace("tcp_iface %p: connection request %p with %u bytes of private "
+              "data", iface, req, req->hdr.length);
+    iface->sockaddr.conn_request_cb(&iface->super.super,
+                                    iface->sockaddr.conn_request_arg, req,
+                                    UCS_PTR_BYTE_OFFSET(&req->hdr,
+                                                        sizeof(req->hdr)),
+                                    req->hdr.length);
+    return;
+
+err_destroy:
+    uct_tcp_sockaddr_epoll_ctl(iface, EPOLL_CTL_DEL, req->fd, 0, NULL);
+    uct_tcp_sockaddr_conn_req_destroy(req);
+}
+
+static void uct_tcp_sockaddr_iface_event_handler(int fd, void *arg)
+{
+    uct_tcp_iface_t *iface = arg;
+    struct epoll_event events[UCT_TCP_MAX_EVENTS];
+    int i, nevents;
+
+    ucs_assert(fd == iface->epfd);
+
+    do {
+        nevents = epoll_wait(iface->epfd, events, UCT_TCP_MAX_EVENTS, 0);
+        if (nevents < 0) {
+            if (errno != EINTR) {
+                ucs_error("epoll_wait(epfd=%d) failed: %m", iface->epfd);
+            }
+            return;
+        }
+
+        for (i = 0; i < nevents; ++i) {
+            if (iface->open_mode & UCT_IFACE_OPEN_MODE_SOCKADDR_CLIENT) {
+                uct_tcp_sockaddr_ep_progress(events[i].data.ptr);
+            } else if (events[i].data.ptr == NULL) {
+                uct_tcp_sockaddr_iface_accept_conns(iface);
+            } else {
+                uct_tcp_sockaddr_conn_req_progress(iface, events[i].data.ptr);
+            }
+        }
+    } while (nevents == UCT_TCP_MAX_EVENTS);
+}
+
+static ucs_status_t uct_tcp_sockaddr_iface_reply(uct_iface_h tl_iface,
+                                                 uct_conn_request_h conn_request,
+                                                 ucs_status_t reply_status)
+{
+    uct_tcp_iface_t *iface           = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+    uct_tcp_sockaddr_conn_req_t *req = conn_request;
+    uct_tcp_sockaddr_hdr_t hdr;
+    ucs_status_t status;
+    ssize_t ret;
+
+    hdr.length = 0;
+    hdr.status = reply_status;
+
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+
+    /* The reply is much smaller than the send buffer of a new socket, so it is
+     * sent at once */
+    ret = send(req->fd, &hdr, sizeof(hdr), MSG_NOSIGNAL);
+    if (ret == sizeof(hdr)) {
+        status = UCS_OK;
+    } else {
+        ucs_error("tcp_iface %p: failed to send connection reply on fd %d: %m",
+                  iface, req->fd);
+        status = UCS_ERR_IO_ERROR;
+    }
+
+    uct_tcp_sockaddr_conn_req_destroy(req);
+
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+    return status;
+}
+
+ucs_status_t uct_tcp_sockaddr_iface_accept(uct_iface_h tl_iface,
+                                           uct_conn_request_h conn_request)
+{
+    ucs_trace("accepting connection request %p", conn_request);
+    return uct_tcp_sockaddr_iface_reply(tl_iface, conn_request, UCS_OK);
+}
+
+ucs_status_t uct_tcp_sockaddr_iface_reject(uct_iface_h tl_iface,
+                                           uct_conn_request_h conn_request)
+{
+    ucs_trace("rejecting connection request %p", conn_request);
+    return uct_tcp_sockaddr_iface_reply(tl_iface, conn_request,
+                                        UCS_ERR_REJECTED);
+}
+
+ucs_status_t uct_tcp_sockaddr_iface_query(uct_iface_h tl_iface,
+                                          uct_iface_attr_t *attr)
+{
+    memset(attr, 0, sizeof(*attr));
+
+    attr->iface_addr_len  = sizeof(ucs_sock_addr_t);
+    attr->device_addr_len = 0;
+    attr->cap.flags       = UCT_IFACE_FLAG_CONNECT_TO_SOCKADDR |
+                            UCT_IFACE_FLAG_CB_ASYNC            |
+                            UCT_IFACE_FLAG_ERRHANDLE_PEER_FAILURE;
+    attr->max_conn_priv   = UCT_TCP_SOCKADDR_MAX_CONN_PRIV;
+    return UCS_OK;
+}
+
+ucs_status_t uct_tcp_sockaddr_iface_get_address(uct_iface_h tl_iface,
+                                                uct_iface_addr_t *addr)
+{
+    ucs_sock_addr_t *sockaddr = (ucs_sock_addr_t*)addr;
+
+    sockaddr->addr    = NULL;
+    sockaddr->addrlen = 0;
+    return UCS_OK;
+}
+
+int uct_tcp_sockaddr_iface_is_reachable(const uct_iface_h tl_iface,
+                                        const uct_device_addr_t *dev_addr,
+                                        const uct_iface_addr_t *iface_addr)
+{
+    /* Reachability is checked by uct_md_is_sockaddr_accessible */
+    return 1;
+}
+
+static ucs_status_t uct_tcp_sockaddr_iface_listen(uct_tcp_iface_t *iface,
+                                                  const struct sockaddr *addr,
+                                                  unsigned backlog)
+{
+    char ip_port_str[UCS_SOCKADDR_STRING_LEN];
+    ucs_status_t status;
+    int ret, optval;
+
+    if (addr->sa_family != AF_INET) {
+        ucs_error("tcp sockaddr server supports only IPv4 addresses");
+        return UCS_ERR_INVALID_ADDR;
+    }
+
+    status = ucs_tcpip_socket_create(&iface->listen_fd);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucs_sys_fcntl_modfl(iface->listen_fd, O_NONBLOCK, 0);
+    if (status != UCS_OK) {
+        goto err_close_sock;
+    }
+
+    /* Allow listening again on the address of a previous server */
+    optval = 1;
+    ret    = setsockopt(iface->listen_fd, SOL_SOCKET, SO_REUSEADDR, &optval,
+                        sizeof(optval));
+    if (ret < 0) {
+        ucs_error("failed to set SO_REUSEADDR on fd %d: %m", iface->listen_fd);
+        status = UCS_ERR_IO_ERROR;
+        goto err_close_sock;
+    }
+
+    ret = bind(iface->listen_fd, addr, sizeof(struct sockaddr_in));
+    if (ret < 0) {
+        ucs_error("bind(fd=%d addr=%s) failed: %m", iface->listen_fd,
+                  ucs_sockaddr_str(addr, ip_port_str, UCS_SOCKADDR_STRING_LEN));
+        status = (errno == EADDRINUSE) ? UCS_ERR_BUSY : UCS_ERR_IO_ERROR;
+        goto err_close_sock;
+    }
+
+    ret = listen(iface->listen_fd, backlog);
+    if (ret < 0) {
+        ucs_error("listen(fd=%d backlog=%d) failed: %m", iface->listen_fd,
+                  backlog);
+        status = UCS_ERR_IO_ERROR;
+        goto err_close_sock;
+    }
+
+    ucs_debug("tcp_iface %p: listening for connection requests on %s", iface,
+              ucs_sockaddr_str(addr, ip_port_str, UCS_SOCKADDR_STRING_LEN));
+
+    uct_tcp_sockaddr_epoll_ctl(iface, EPOLL_CTL_ADD, iface->listen_fd, EPOLLIN,
+                               NULL);
+    return UCS_OK;
+
+err_close_sock:
+    close(iface->listen_fd);
+    iface->listen_fd = -1;
+    return status;
+}
+
+ucs_status_t uct_tcp_sockaddr_iface_init(uct_tcp_iface_t *iface,
+                                         const uct_iface_params_t *params,
+                                         const uct_tcp_iface_config_t *config)
+{
+    ucs_status_t status;
+
+    if (iface->super.worker->async == NULL) {
+        ucs_error("tcp sockaddr interface must have async != NULL");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    iface->listen_fd = -1;
+    ucs_list_head_init(&iface->sockaddr.conn_reqs);
+
+    iface->epfd = epoll_create(1);
+    if (iface->epfd < 0) {
+        ucs_error("epoll_create() failed: %m");
+        return UCS_ERR_IO_ERROR;
+    }
+
+    if (params->open_mode & UCT_IFACE_OPEN_MODE_SOCKADDR_SERVER) {
+        if (!(params->mode.sockaddr.cb_flags & UCT_CB_FLAG_ASYNC)) {
+            ucs_error("tcp sockaddr server supports only asynchronous "
+                      "connection request callback");
+            status = UCS_ERR_UNSUPPORTED;
+            goto err_close_epfd;
+        }
+
+        iface->sockaddr.conn_request_cb  = params->mode.sockaddr.conn_request_cb;
+        iface->sockaddr.conn_request_arg = params->mode.sockaddr.conn_request_arg;
+
+        status = uct_tcp_sockaddr_iface_listen(iface,
+                                               params->mode.sockaddr.listen_sockaddr.addr,
+                                               config->backlog);
+        if (status != UCS_OK) {
+            goto err_close_epfd;
+        }
+    } else {
+        iface->sockaddr.conn_request_cb  = NULL;
+        iface->sockaddr.conn_request_arg = NULL;
+    }
+
+    /* Connection requests and replies are progressed by the async context,
+     * which is notified by the event set of the interface */
+    status = ucs_async_set_event_handler(iface->super.worker->async->mode,
+                                         iface->epfd, POLLIN,
+                                         uct_tcp_sockaddr_iface_event_handler,
+                                         iface, iface->super.worker->async);
+    if (status != UCS_OK) {
+        goto err_close_listen;
+    }
+
+    ucs_debug("tcp_iface %p: created sockaddr %s, epfd %d", iface,
+              (params->open_mode & UCT_IFACE_OPEN_MODE_SOCKADDR_SERVER) ?
+              "server" : "client", iface->epfd);
+    return UCS_OK;
+
+err_close_listen:
+    if (iface->listen_fd != -1) {
+        close(iface->listen_fd);
+    }
+err_close_epfd:
+    close(iface->epfd);
+    return status;
+}
+
+void uct_tcp_sockaddr_iface_cleanup(uct_tcp_iface_t *iface)
+{
+    uct_tcp_sockaddr_conn_req_t *req;
+
+    ucs_async_remove_handler(iface->epfd, 1);
+
+    /* Requests which were not accepted or rejected are reset */
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+    while (!ucs_list_is_empty(&iface->sockaddr.conn_reqs)) {
+        req = ucs_list_head(&iface->sockaddr.conn_reqs,
+                            uct_tcp_sockaddr_conn_req_t, list);
+        uct_tcp_sockaddr_conn_req_destroy(req);
+    }
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+
+    if (iface->listen_fd != -1) {
+        close(iface->listen_fd);
+    }
+    close(iface->epfd);
+}
@@ -0,0 +1,250 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#include <list>
+#include <vector>
+
+#include "ucp_test.h"
+
+extern "C" {
+#include <ucp/api/ucpx.h>
+}
+
+
+class test_ucp_am : public ucp_test {
+public:
+    enum {
+        AM_ID       = 5,
+        AM_REPLY_ID = 9
+    };
+
+    struct am_message {
+        std::vector<char> data;
+        ucp_ep_h          reply_ep;
+        unsigned          flags;
+    };
+
+    static ucp_params_t get_ctx_params() {
+        ucp_params_t params = ucp_test::get_ctx_params();
+        params.field_mask  |= UCP_PARAM_FIELD_FEATURES;
+        params.features     = UCP_FEATURE_AM;
+        return params;
+    }
+
+    virtual void init() {
+        ucp_test::init();
+
+        sender().connect(&receiver(), get_ep_params());
+        if (!is_loopback()) {
+            receiver().connect(&sender(), get_ep_params());
+        }
+
+        m_keep_data        = false;
+        m_keep_data_always = false;
+        m_reply            = false;
+        set_handler(receiver(), AM_ID, am_handler);
+    }
+
+    virtual void cleanup() {
+        for (std::list<void*>::iterator iter = m_kept_data.begin();
+             iter != m_kept_data.end(); ++iter) {
+            ucp_am_data_release(receiver().worker(), *iter);
+        }
+        m_kept_data.clear();
+        ucp_test::cleanup();
+    }
+
+protected:
+    static void send_cb(void *request, ucs_status_t status) {}
+
+    static ucs_status_t am_handler(void *arg, void *data, size_t length,
+                                   ucp_ep_h reply_ep, unsigned flags) {
+        test_ucp_am *self = reinterpret_cast<test_ucp_am*>(arg);
+        am_message msg;
+
+        msg.data.assign((char*)data, (char*)data + length);
+        msg.reply_ep = reply_ep;
+        msg.flags    = flags;
+        self->m_received.push_back(msg);
+
+        if (self->m_reply && (reply_ep != NULL)) {
+            /* Reply from the copy, since the data is released on return */
+            std::vector<char> &rdata = self->m_received.back().data;
+            void *sreq = ucp_am_send_nb(reply_ep, AM_REPLY_ID,
+                                        rdata.empty() ? NULL : &rdata[0],
+                                        rdata.size(), DATATYPE, send_cb, 0);
+            EXPECT_FALSE(UCS_PTR_IS_ERR(sreq));
+            if (UCS_PTR_IS_PTR(sreq)) {
+                self->m_reply_reqs.push_back(sreq);
+            }
+        }
+
+        if ((self->m_keep_data || self->m_keep_data_always) &&
+            (flags & UCP_CB_PARAM_FLAG_DATA)) {
+            self->m_kept_data.push_back(data);
+            self->m_kept_copies.push_back(msg.data);
+            return UCS_INPROGRESS;
+        }
+
+        if (self->m_keep_data_always) {
+            return UCS_INPROGRESS;
+        }
+
+        return UCS_OK;
+    }
+
+    static ucs_status_t am_reply_handler(void *arg, void *data, size_t length,
+                                         ucp_ep_h reply_ep, unsigned flags) {
+        test_ucp_am *self = reinterpret_cast<test_ucp_am*>(arg);
+        am_message msg;
+
+        msg.data.assign((char*)data, (char*)data + length);
+        msg.reply_ep = reply_ep;
+        msg.flags    = flags;
+        self->m_replies.push_back(msg);
+        return UCS_OK;
+    }
+
+    void set_handler(entity &e, uint16_t id, ucp_am_callback_t cb) {
+        ucs_status_t status = ucp_worker_set_am_handler(e.worker(), id, cb,
+                                                        this, 0);
+        ASSERT_UCS_OK(status);
+    }
+
+    void wait_for_messages(const std::list<am_message> &list, size_t count) {
+        ucs_time_t deadline = ucs_get_time() + ucs_time_from_sec(10.0);
+        while ((list.size() < count) && (ucs_get_time() < deadline)) {
+            progress();
+        }
+        ASSERT_EQ(count, list.size());
+    }
+
+    void send_recv(size_t size, unsigned flags, ucp_datatype_t dt) {
+        std::vector<char> sbuf(size);
+        char *base = sbuf.empty() ? NULL : &sbuf[0];
+        ucp_dt_iov_t iov[2];
+        void *buffer;
+        size_t count;
+
+        ucs::fill_random(sbuf);
+        if ((dt & UCP_DATATYPE_CLASS_MASK) == UCP_DATATYPE_IOV) {
+            iov[0].buffer = base;
+            iov[0].length = size / 2;
+            iov[1].buffer = base + size / 2;
+            iov[1].length = size - size / 2;
+            buffer        = iov;
+            count         = 2;
+        } else {
+            buffer        = base;
+            count         = size;
+        }
+
+        m_received.clear();
+        m_replies.clear();
+
+        void *sreq = ucp_am_send_nb(sender().ep(), AM_ID, buffer, count, dt,
+                                    send_cb, flags);
+        ASSERT_FALSE(UCS_PTR_IS_ERR(sreq));
+        wait(sreq);
+
+        wait_for_messages(m_received, 1);
+        const am_message &msg = m_received.front();
+        EXPECT_EQ(sbuf, msg.data) << "size=" << size;
+        if (flags & UCP_AM_SEND_REPLY) {
+            EXPECT_TRUE(msg.reply_ep != NULL);
+        } else {
+            EXPECT_TRUE(msg.reply_ep == NULL);
+        }
+
+        if (m_reply && (flags & UCP_AM_SEND_REPLY)) {
+            wait_for_messages(m_replies, 1);
+            EXPECT_EQ(sbuf, m_replies.front().data) << "size=" << size;
+            EXPECT_TRUE(m_replies.front().reply_ep == NULL);
+
+            while (!m_reply_reqs.empty()) {
+                wait(m_reply_reqs.front());
+                m_reply_reqs.pop_front();
+            }
+        }
+    }
+
+    void test_sizes(unsigned flags, ucp_datatype_t dt) {
+        for (size_t size = 1; size <= UCS_MBYTE; size *= 3) {
+            send_recv(size, flags, dt);
+        }
+        send_recv(0, flags, dt);
+        send_recv(4 * UCS_MBYTE, flags, dt);
+    }
+
+    bool                   m_keep_data;
+    bool                   m_keep_data_always;
+    bool                   m_reply;
+    std::list<am_message>  m_received;
+    std::list<am_message>  m_replies;
+    std::list<void*>       m_kept_data;
+    std::list<std::vector<char> > m_kept_copies;
+    std::list<void*>       m_reply_reqs;
+};
+
+UCS_TEST_P(test_ucp_am, send_recv) {
+    test_sizes(0, DATATYPE);
+}
+
+UCS_TEST_P(test_ucp_am, send_recv_iov) {
+    test_sizes(0, DATATYPE_IOV);
+}
+
+UCS_TEST_P(test_ucp_am, send_reply) {
+    m_reply = true;
+    set_handler(sender(), AM_REPLY_ID, am_reply_handler);
+    test_sizes(UCP_AM_SEND_REPLY, DATATYPE);
+}
+
+UCS_TEST_P(test_ucp_am, keep_data) {
+    m_keep_data = true;
+
+    for (size_t size = 1; size <= 4 * UCS_MBYTE; size *= 4) {
+        send_recv(size, 0, DATATYPE);
+    }
+
+    /* The kept data must still be valid after more messages arrived */
+    EXPECT_FALSE(m_kept_data.empty());
+    std::list<std::vector<char> >::iterator copy = m_kept_copies.begin();
+    for (std::list<void*>::iterator iter = m_kept_data.begin();
+         iter != m_kept_data.end(); ++iter, ++copy) {
+        EXPECT_EQ(0, memcmp(*iter, &(*copy)[0], copy->size()));
+        ucp_am_data_release(receiver().worker(), *iter);
+    }
+    m_kept_data.clear();
+}
+
+UCS_TEST_P(test_ucp_am, keep_data_not_allowed) {
+    /* Data which cannot be kept is released anyway, with an error */
+    m_keep_data_always = true;
+
+    for (int i = 0; i < 10; ++i) {
+        size_t num_errors = m_errors.size();
+        {
+            scoped_log_handler wrap_err(wrap_errors_logger);
+            send_recv(64, 0, DATATYPE);
+        }
+
+        size_t expected = (m_received.front().flags & UCP_CB_PARAM_FLAG_DATA) ?
+                          0 : 1;
+        EXPECT_EQ(expected, m_errors.size() - num_errors);
+    }
+}
+
+UCS_TEST_P(test_ucp_am, rndv, "RNDV_THRESH=1024") {
+    m_reply = true;
+    set_handler(sender(), AM_REPLY_ID, am_reply_handler);
+    for (size_t size = 512; size <= 256 * UCS_KBYTE; size *= 2) {
+        send_recv(size, 0, DATATYPE);
+        send_recv(size, UCP_AM_SEND_REPLY, DATATYPE);
+    }
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am)
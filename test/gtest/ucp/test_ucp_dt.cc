@@ -46,3 +46,126 @@ UCS_TEST_F(test_ucp_dt_iov, seek)
         }
     }
 }
+
+class test_ucp_dt_strided : public ucs::test {
+protected:
+    /* reference packing of a 2-dimensional strided layout */
+    void ref_pack(const std::vector<char> &buf, size_t count, size_t elem_size,
+                  size_t count0, size_t stride0, size_t count1, size_t stride1,
+                  std::vector<char> &packed) {
+        size_t extent = elem_size + ((count0 - 1) * stride0) +
+                        ((count1 - 1) * stride1);
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < count1; ++j) {
+                for (size_t k = 0; k < count0; ++k) {
+                    size_t offset = (i * extent) + (j * stride1) + (k * stride0);
+                    packed.insert(packed.end(), buf.begin() + offset,
+                                  buf.begin() + offset + elem_size);
+                }
+            }
+        }
+    }
+};
+
+UCS_TEST_F(test_ucp_dt_strided, pack_unpack)
+{
+    static const size_t elem_sizes[] = { 1, 2, 4, 8, 12, 16, 32, 40 };
+
+    for (int iter = 0; iter < 200; ++iter) {
+        size_t elem_size = elem_sizes[ucs::rand() %
+                                      ucs_static_array_size(elem_sizes)];
+        size_t count0    = (ucs::rand() % 10) + 1;
+        size_t stride0   = elem_size + (ucs::rand() % 3) * 4;
+        size_t count1    = (ucs::rand() % 4) + 1;
+        size_t stride1   = (count0 * stride0) + (ucs::rand() % 3) * 8;
+        size_t count     = (ucs::rand() % 5) + 1;
+        ucp_datatype_t inner_dt, dt;
+        ucs_status_t status;
+
+        status = ucp_dt_create_strided(elem_size, count0, stride0, &inner_dt);
+        ASSERT_UCS_OK(status);
+        status = ucp_dt_create_vector(inner_dt, count1, stride1, &dt);
+        ASSERT_UCS_OK(status);
+        ucp_dt_destroy(inner_dt);
+
+        ucp_dt_strided_t *dt_strided = ucp_dt_strided(dt);
+        size_t length                = ucp_dt_strided_length(dt_strided, count);
+        size_t span                  = ucp_dt_strided_span(dt_strided, length);
+        ASSERT_EQ(count * count0 * count1 * elem_size, length);
+
+        std::vector<char> buf(span), packed, expected;
+        ucs::fill_random(buf);
+        ref_pack(buf, count, elem_size, count0, stride0, count1, stride1,
+                 expected);
+        ASSERT_EQ(length, expected.size());
+
+        /* pack in random fragments */
+        packed.resize(length);
+        for (size_t offset = 0, frag; offset < length; offset += frag) {
+            frag = ucs_min((size_t)(ucs::rand() % 100) + 1, length - offset);
+            EXPECT_EQ(frag, ucp_dt_strided_pack(dt_strided, &packed[offset],
+                                                &buf[0], offset, frag));
+        }
+        EXPECT_TRUE(packed == expected);
+
+        /* unpack fragments in reverse order */
+        std::vector<char> unpacked(span, 0);
+        size_t frag = (ucs::rand() % 50) + 1;
+        for (size_t i = ucs_div_round_up(length, frag); i > 0; --i) {
+            size_t offset = (i - 1) * frag;
+            ucp_dt_strided_unpack(dt_strided, &unpacked[0], &expected[offset],
+                                  offset, ucs_min(frag, length - offset));
+        }
+        packed.clear();
+        ref_pack(unpacked, count, elem_size, count0, stride0, count1, stride1,
+                 packed);
+        EXPECT_TRUE(packed == expected);
+
+        /* describe by uct iov */
+        std::vector<uct_iov_t> iov(ucp_dt_strided_block_count(dt_strided, 0,
+                                                              length));
+        size_t iovcnt;
+        EXPECT_EQ(length, ucp_dt_strided_to_uct_iov(dt_strided, &buf[0], 0,
+                                                    length, NULL, &iov[0],
+                                                    iov.size(), &iovcnt));
+        EXPECT_EQ(iov.size(), iovcnt);
+        packed.clear();
+        for (size_t i = 0; i < iovcnt; ++i) {
+            packed.insert(packed.end(), (char*)iov[i].buffer,
+                          (char*)iov[i].buffer + iov[i].length);
+        }
+        EXPECT_TRUE(packed == expected);
+
+        ucp_dt_destroy(dt);
+    }
+}
+
+UCS_TEST_F(test_ucp_dt_strided, normalize)
+{
+    ucp_datatype_t dt, vec_dt;
+    ucs_status_t status;
+
+    /* contiguous blocks are merged */
+    status = ucp_dt_create_strided(8, 4, 8, &dt);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(32ul, ucp_dt_strided(dt)->elem_size);
+    EXPECT_EQ(1ul, ucp_dt_strided(dt)->elem_count);
+    ucp_dt_destroy(dt);
+
+    /* a vector of evenly spaced items is a single dimension */
+    status = ucp_dt_create_strided(8, 4, 24, &dt);
+    ASSERT_UCS_OK(status);
+    status = ucp_dt_create_vector(dt, 3, 96, &vec_dt);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(1u, ucp_dt_strided(vec_dt)->num_dims);
+    EXPECT_EQ(12ul, ucp_dt_strided(vec_dt)->elem_count);
+    EXPECT_EQ(11ul * 24 + 8, ucp_dt_strided(vec_dt)->extent);
+    ucp_dt_destroy(vec_dt);
+    ucp_dt_destroy(dt);
+
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        status = ucp_dt_create_vector(ucp_dt_make_iov(), 3, 96, &vec_dt);
+    }
+    EXPECT_EQ(UCS_ERR_UNSUPPORTED, status);
+}
@@ -74,7 +74,8 @@ public:
                 (strstr(err_str.c_str(), "sockaddr aux resources addresses")) ||
                 (strstr(err_str.c_str(), "no peer failure handler")) ||
                 /* when the "peer failure" error happens, it is followed by: */
-                (strstr(err_str.c_str(), "received event RDMA_CM_EVENT_UNREACHABLE"))) {
+                (strstr(err_str.c_str(), "received event RDMA_CM_EVENT_UNREACHABLE")) ||
+                (strstr(err_str.c_str(), "connection request failed on listener"))) {
                 UCS_TEST_MESSAGE << err_str;
                 return UCS_LOG_FUNC_RC_STOP;
             }
@@ -87,15 +88,19 @@ public:
         int ret = getifaddrs(&ifaddrs);
         ASSERT_EQ(ret, 0);
 
-        for (struct ifaddrs *ifa = ifaddrs; ifa != NULL; ifa = ifa->ifa_next) {
-            if (ucs_netif_is_active(ifa->ifa_name) &&
-                ucs::is_inet_addr(ifa->ifa_addr)   &&
-                ucs::is_rdmacm_netdev(ifa->ifa_name))
-            {
-                *listen_addr = *(struct sockaddr_in*)(void*)ifa->ifa_addr;
-                listen_addr->sin_port = ucs::get_port();
-                freeifaddrs(ifaddrs);
-                return;
+        /* Prefer an interface which can be used by rdmacm, otherwise use any
+         * IPv4 interface, which can be used by tcp */
+        for (int rdmacm = 1; rdmacm >= 0; --rdmacm) {
+            for (struct ifaddrs *ifa = ifaddrs; ifa != NULL; ifa = ifa->ifa_next) {
+                if (ucs_netif_is_active(ifa->ifa_name) &&
+                    ucs::is_inet_addr(ifa->ifa_addr)   &&
+                    (!rdmacm || ucs::is_rdmacm_netdev(ifa->ifa_name)))
+                {
+                    *listen_addr = *(struct sockaddr_in*)(void*)ifa->ifa_addr;
+                    listen_addr->sin_port = ucs::get_port();
+                    freeifaddrs(ifaddrs);
+                    return;
+                }
             }
         }
         freeifaddrs(ifaddrs);
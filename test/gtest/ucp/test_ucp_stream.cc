@@ -561,6 +561,90 @@ UCS_TEST_P(test_ucp_stream, send_zero_ending_iov_recv_data) {
     }
 }
 
+UCS_TEST_P(test_ucp_stream, send_recv_data_rndv, "STREAM_RNDV_THRESH=1024") {
+    do_send_recv_data_test(DATATYPE);
+}
+
+UCS_TEST_P(test_ucp_stream, send_recv_rndv, "STREAM_RNDV_THRESH=1024") {
+    do_send_recv_test<uint8_t, 0>(DATATYPE);
+}
+
+UCS_TEST_P(test_ucp_stream, send_exp_recv_rndv, "STREAM_RNDV_THRESH=1024") {
+    do_send_exp_recv_test<uint8_t, 0>(DATATYPE);
+}
+
+UCS_TEST_P(test_ucp_stream, send_exp_recv_rndv_waitall, "STREAM_RNDV_THRESH=1024") {
+    static const size_t sizes[] = { 100, 64 * 1024, 8, 300 * 1024, 2000, 1024,
+                                    16 * 1024 };
+    const size_t num_sizes      = sizeof(sizes) / sizeof(sizes[0]);
+    std::vector<std::vector<char> > sbufs(num_sizes);
+    std::vector<char> check_pattern;
+    std::vector<void*> sreqs;
+    size_t length;
+
+    for (size_t i = 0; i < num_sizes; ++i) {
+        sbufs[i].resize(sizes[i]);
+        ucs::fill_random(sbufs[i]);
+        check_pattern.insert(check_pattern.end(), sbufs[i].begin(),
+                             sbufs[i].end());
+    }
+
+    /* A single receive gets the eager and the rendezvous data in order */
+    std::vector<char> rbuf(check_pattern.size(), 'r');
+    void *rreq = ucp_stream_recv_nb(receiver().ep(), &rbuf[0], rbuf.size(),
+                                    DATATYPE, ucp_recv_cb, &length,
+                                    UCP_STREAM_RECV_FLAG_WAITALL);
+    ASSERT_TRUE(UCS_PTR_IS_PTR(rreq));
+
+    /* Send without waiting, so sends are queued behind the rendezvous */
+    for (size_t i = 0; i < num_sizes; ++i) {
+        void *sreq = ucp_stream_send_nb(sender().ep(), &sbufs[i][0],
+                                        sbufs[i].size(), DATATYPE,
+                                        ucp_send_cb, 0);
+        ASSERT_FALSE(UCS_PTR_IS_ERR(sreq));
+        sreqs.push_back(sreq);
+    }
+
+    EXPECT_EQ(rbuf.size(), wait_stream_recv(rreq));
+    for (size_t i = 0; i < num_sizes; ++i) {
+        wait(sreqs[i]);
+    }
+    EXPECT_EQ(check_pattern, rbuf);
+}
+
+UCS_TEST_P(test_ucp_stream, send_exp_recv_rndv_small, "STREAM_RNDV_THRESH=1024") {
+    std::vector<char> sbuf(256 * 1024), rbuf(sbuf.size(), 'r');
+    size_t roffset, length;
+    void *rreq, *sreq;
+
+    ucs::fill_random(sbuf);
+
+    /* The posted receive has no room for the message, so it is sent eagerly */
+    rreq = ucp_stream_recv_nb(receiver().ep(), &rbuf[0], 1000, DATATYPE,
+                              ucp_recv_cb, &length, 0);
+    ASSERT_TRUE(UCS_PTR_IS_PTR(rreq));
+
+    sreq = ucp_stream_send_nb(sender().ep(), &sbuf[0], sbuf.size(), DATATYPE,
+                              ucp_send_cb, 0);
+    ASSERT_FALSE(UCS_PTR_IS_ERR(sreq));
+
+    roffset = wait_stream_recv(rreq);
+    while (roffset < sbuf.size()) {
+        rreq = ucp_stream_recv_nb(receiver().ep(), &rbuf[roffset],
+                                  sbuf.size() - roffset, DATATYPE, ucp_recv_cb,
+                                  &length, 0);
+        ASSERT_FALSE(UCS_PTR_IS_ERR(rreq));
+        if (UCS_PTR_IS_PTR(rreq)) {
+            length = wait_stream_recv(rreq);
+        }
+        roffset += length;
+    }
+
+    wait(sreq);
+    EXPECT_EQ(sbuf.size(), roffset);
+    EXPECT_EQ(sbuf, rbuf);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_stream)
 
 class test_ucp_stream_many2one : public test_ucp_stream_base {
@@ -0,0 +1,131 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#include "test_ucp_tag.h"
+
+extern "C" {
+#include <ucp/api/ucpx.h>
+}
+
+
+class test_ucp_tag_batch : public test_ucp_tag {
+protected:
+    request* send_batch(const std::vector<ucp_tag_send_batch_entry_t> &entries) {
+        request *req;
+
+        req = (request*)ucp_tag_send_batch_nb(sender().worker(),
+                                              entries.empty() ? NULL : &entries[0],
+                                              entries.size(), DATATYPE,
+                                              send_callback);
+        if (UCS_PTR_IS_ERR(req)) {
+            ASSERT_UCS_OK(UCS_PTR_STATUS(req));
+        }
+        return req;
+    }
+
+    void wait_batch(request *req) {
+        if (req != NULL) {
+            wait(req);
+            EXPECT_UCS_OK(req->status);
+            request_release(req);
+        }
+    }
+
+    void test_sizes(const std::vector<size_t> &sizes) {
+        std::vector<std::vector<char> > sbufs(sizes.size());
+        std::vector<ucp_tag_send_batch_entry_t> entries(sizes.size());
+        ucp_tag_recv_info_t info;
+        ucs_status_t status;
+        request *req;
+
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            sbufs[i].resize(sizes[i]);
+            ucs::fill_random(sbufs[i]);
+            entries[i].ep     = sender().ep();
+            entries[i].buffer = sbufs[i].empty() ? NULL : &sbufs[i][0];
+            entries[i].count  = sbufs[i].size();
+            entries[i].tag    = 0x1000 + i;
+        }
+
+        req = send_batch(entries);
+
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            std::vector<char> rbuf(sizes[i], 0);
+
+            status = recv_b(rbuf.empty() ? NULL : &rbuf[0], rbuf.size(),
+                            DATATYPE, 0x1000 + i, (ucp_tag_t)-1, &info);
+            ASSERT_UCS_OK(status);
+            EXPECT_EQ(sizes[i], info.length);
+            EXPECT_EQ(sbufs[i], rbuf) << "size=" << sizes[i];
+        }
+
+        wait_batch(req);
+    }
+};
+
+UCS_TEST_P(test_ucp_tag_batch, send_small) {
+    std::vector<size_t> sizes;
+
+    for (size_t i = 0; i < 64; ++i) {
+        sizes.push_back(i * 8);
+    }
+    test_sizes(sizes);
+}
+
+UCS_TEST_P(test_ucp_tag_batch, send_mixed) {
+    std::vector<size_t> sizes;
+
+    for (size_t size = 1; size <= 4 * UCS_MBYTE; size *= 7) {
+        sizes.push_back(size);
+        sizes.push_back(8);
+    }
+    test_sizes(sizes);
+}
+
+UCS_TEST_P(test_ucp_tag_batch, send_rndv, "RNDV_THRESH=1024") {
+    std::vector<size_t> sizes;
+
+    for (size_t size = 256; size <= 256 * UCS_KBYTE; size *= 4) {
+        sizes.push_back(size);
+    }
+    test_sizes(sizes);
+}
+
+UCS_TEST_P(test_ucp_tag_batch, same_buffer) {
+    static const size_t count = 100;
+    std::vector<ucp_tag_send_batch_entry_t> entries(count);
+    std::vector<char> sbuf(10000), rbuf(sbuf.size());
+    ucp_tag_recv_info_t info;
+    ucs_status_t status;
+    request *req;
+
+    ucs::fill_random(sbuf);
+    for (size_t i = 0; i < count; ++i) {
+        entries[i].ep     = sender().ep();
+        entries[i].buffer = &sbuf[0];
+        entries[i].count  = sbuf.size();
+        entries[i].tag    = 0x1337;
+    }
+
+    req = send_batch(entries);
+
+    for (size_t i = 0; i < count; ++i) {
+        std::fill(rbuf.begin(), rbuf.end(), 0);
+        status = recv_b(&rbuf[0], rbuf.size(), DATATYPE, 0x1337, (ucp_tag_t)-1,
+                        &info);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(sbuf, rbuf);
+    }
+
+    wait_batch(req);
+}
+
+UCS_TEST_P(test_ucp_tag_batch, empty) {
+    std::vector<ucp_tag_send_batch_entry_t> entries;
+    EXPECT_TRUE(send_batch(entries) == NULL);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_batch)
@@ -8,6 +8,8 @@
 #include "test_ucp_tag.h"
 
 #include <common/test_helpers.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucp/tag/tag_match.h>
 
 using namespace ucs; /* For vector<char> serialization */
 
@@ -52,6 +54,16 @@ protected:
         m_req_status = status;
     }
 
+    void wait_for_throttle(bool throttled)
+    {
+        ucs_time_t deadline = ucs::get_deadline();
+
+        while ((!!(sender().ep()->flags & UCP_EP_FLAG_TAG_THROTTLED) !=
+                throttled) && (ucs_get_time() < deadline)) {
+            short_progress_loop();
+        }
+    }
+
     static ucs_status_t m_req_status;
     ucs::ptr_vector<ucs::scoped_setenv> m_env;
 };
@@ -640,4 +652,137 @@ UCS_TEST_P(test_ucp_tag_match, rndv_exp_huge_mix) {
     }
 }
 
+UCS_TEST_P(test_ucp_tag_match, hash_grow_exp, "TM_HASH_SIZE=4") {
+    const unsigned num_ranks = 8, num_tags = 16;
+    const ucp_tag_t dup_tag  = UCS_BIT(63) | 1;
+    std::vector<uint64_t> recv_data(num_ranks * num_tags + 2, 0);
+    std::vector<request*> reqs;
+    ucp_tag_t tag;
+    uint64_t send_data;
+
+    /* two receives with the same tag, should be matched in posting order */
+    reqs.push_back(recv_nb(&recv_data[0], sizeof(uint64_t), DATATYPE, dup_tag,
+                           UCP_TAG_MASK_FULL));
+    reqs.push_back(recv_nb(&recv_data[1], sizeof(uint64_t), DATATYPE, dup_tag,
+                           UCP_TAG_MASK_FULL));
+
+    /* MPI-like tags: source rank in the high bits */
+    for (unsigned rank = 0; rank < num_ranks; ++rank) {
+        for (unsigned i = 0; i < num_tags; ++i) {
+            tag = ((ucp_tag_t)rank << 32) | i;
+            reqs.push_back(recv_nb(&recv_data[reqs.size()], sizeof(uint64_t),
+                                   DATATYPE, tag, UCP_TAG_MASK_FULL));
+        }
+    }
+
+    EXPECT_GT(receiver().worker()->tm.hash.mask + 1, 4ul);
+
+    for (int rank = num_ranks - 1; rank >= 0; --rank) {
+        for (unsigned i = 0; i < num_tags; ++i) {
+            tag       = ((ucp_tag_t)rank << 32) | i;
+            send_data = tag;
+            send_b(&send_data, sizeof(send_data), DATATYPE, tag);
+        }
+    }
+
+    for (send_data = 1; send_data <= 2; ++send_data) {
+        send_b(&send_data, sizeof(send_data), DATATYPE, dup_tag);
+    }
+
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(reqs[i]));
+        wait(reqs[i]);
+        EXPECT_EQ(UCS_OK, reqs[i]->status);
+        request_release(reqs[i]);
+    }
+
+    EXPECT_EQ(1ul, recv_data[0]);
+    EXPECT_EQ(2ul, recv_data[1]);
+    for (size_t i = 2; i < recv_data.size(); ++i) {
+        tag = (((i - 2) / num_tags) << 32) | ((i - 2) % num_tags);
+        EXPECT_EQ(tag, recv_data[i]);
+    }
+}
+
+UCS_TEST_P(test_ucp_tag_match, hash_grow_unexp, "TM_HASH_SIZE=4") {
+    const unsigned num_msgs = 100;
+    ucp_tag_recv_info_t info;
+    uint64_t send_data, recv_data;
+    ucs_status_t status;
+    ucp_tag_t tag;
+
+    for (unsigned i = 0; i < num_msgs; ++i) {
+        send_data = i;
+        send_b(&send_data, sizeof(send_data), DATATYPE, (ucp_tag_t)i << 32);
+    }
+
+    /* same tag sent twice, should be received in sending order */
+    for (send_data = num_msgs; send_data < num_msgs + 2; ++send_data) {
+        send_b(&send_data, sizeof(send_data), DATATYPE, 1);
+    }
+
+    short_progress_loop();
+    EXPECT_GT(receiver().worker()->tm.hash.mask + 1, 4ul);
+
+    for (unsigned i = 0; i < num_msgs + 2; ++i) {
+        tag = (i < num_msgs) ? ((ucp_tag_t)((i * 7) % num_msgs) << 32) : 1;
+        status = recv_b(&recv_data, sizeof(recv_data), DATATYPE, tag,
+                        UCP_TAG_MASK_FULL, &info);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(tag, info.sender_tag);
+        EXPECT_EQ((i < num_msgs) ? ((i * 7) % num_msgs) : i, recv_data);
+    }
+}
+
+UCS_TEST_P(test_ucp_tag_match, unexp_throttle, "TM_MAX_UNEXP_SIZE=16k") {
+    const size_t msg_size   = 1024;
+    const unsigned num_msgs = 32;
+    std::vector<std::vector<char> > send_data(num_msgs + 1);
+    std::vector<char> recv_data;
+    ucp_tag_recv_info_t info;
+    ucs_status_t status;
+    request *req;
+
+    /* the receiver needs an endpoint to notify the sender */
+    if (!is_loopback()) {
+        receiver().connect(&sender(), get_ep_params());
+    }
+
+    for (unsigned i = 0; i < num_msgs; ++i) {
+        send_data[i].resize(msg_size);
+        ucs::fill_random(send_data[i]);
+        send_b(&send_data[i][0], msg_size, DATATYPE, i);
+    }
+
+    wait_for_throttle(true);
+    EXPECT_TRUE(receiver().worker()->tm.unexpected.throttled);
+    EXPECT_TRUE(sender().ep()->flags & UCP_EP_FLAG_TAG_THROTTLED);
+
+    /* large message while the sender is throttled */
+    send_data[num_msgs].resize(msg_size * 16);
+    ucs::fill_random(send_data[num_msgs]);
+    req = send_nb(&send_data[num_msgs][0], send_data[num_msgs].size(),
+                  DATATYPE, num_msgs);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(req));
+
+    for (unsigned i = 0; i <= num_msgs; ++i) {
+        recv_data.resize(send_data[i].size());
+        status = recv_b(&recv_data[0], recv_data.size(), DATATYPE, i,
+                        UCP_TAG_MASK_FULL, &info);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(send_data[i].size(), info.length);
+        EXPECT_EQ(send_data[i], recv_data);
+    }
+
+    if (req != NULL) {
+        wait(req);
+        request_release(req);
+    }
+
+    EXPECT_FALSE(receiver().worker()->tm.unexpected.throttled);
+    EXPECT_EQ(0ul, receiver().worker()->tm.unexpected.bytes);
+    wait_for_throttle(false);
+    EXPECT_FALSE(sender().ep()->flags & UCP_EP_FLAG_TAG_THROTTLED);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match)
@@ -11,6 +11,7 @@
 
 extern "C" {
 #include <ucp/core/ucp_ep.inl>
+#include <ucp/proto/proto_tune.h>
 #include <ucs/datastruct/queue.h>
 }
 
@@ -88,6 +89,7 @@ public:
     void test_xfer_contig(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_generic(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_iov(size_t size, bool expected, bool sync, bool truncated);
+    void test_xfer_strided(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_generic_err(size_t size, bool expected, bool sync, bool truncated);
 
 protected:
@@ -391,6 +393,55 @@ void test_ucp_tag_xfer::test_xfer_iov(size_t size, bool expected, bool sync,
                                "IOV"));
 }
 
+void test_ucp_tag_xfer::test_xfer_strided(size_t size, bool expected,
+                                          bool sync, bool truncated)
+{
+    /* the sender has 3 blocks of 8 bytes in every 56 bytes, and the receiver
+     * has 3 pairs of 4-byte blocks in every 96 bytes */
+    const size_t item_size = 24;
+    size_t count           = size / item_size;
+    ucp_datatype_t send_dt, recv_dt, tmp_dt;
+    ucs_status_t status;
+
+    status = ucp_dt_create_strided(8, 3, 24, &send_dt);
+    ASSERT_UCS_OK(status);
+    status = ucp_dt_create_strided(4, 2, 12, &tmp_dt);
+    ASSERT_UCS_OK(status);
+    status = ucp_dt_create_vector(tmp_dt, 3, 40, &recv_dt);
+    ASSERT_UCS_OK(status);
+    ucp_dt_destroy(tmp_dt);
+
+    std::vector<char> sendbuf(count * 56 + 1, 0);
+    std::vector<char> recvbuf(count * 96 + 1, 0);
+    std::vector<char> send_packed, recv_packed;
+
+    ucs::fill_random(sendbuf);
+
+    size_t recvd = do_xfer(&sendbuf[0], &recvbuf[0], count, send_dt, recv_dt,
+                           expected, sync, truncated);
+    if (!truncated) {
+        ASSERT_EQ(count * item_size, recvd);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            size_t offset = (i * 56) + (j * 24);
+            send_packed.insert(send_packed.end(), sendbuf.begin() + offset,
+                               sendbuf.begin() + offset + 8);
+            for (size_t k = 0; k < 2; ++k) {
+                offset = (i * 96) + (j * 40) + (k * 12);
+                recv_packed.insert(recv_packed.end(), recvbuf.begin() + offset,
+                                   recvbuf.begin() + offset + 4);
+            }
+        }
+    }
+    EXPECT_TRUE(!check_buffers(send_packed, recv_packed, recvd, 1, 1, size,
+                               expected, sync, "strided"));
+
+    ucp_dt_destroy(send_dt);
+    ucp_dt_destroy(recv_dt);
+}
+
 void test_ucp_tag_xfer::test_xfer_generic_err(size_t size, bool expected,
                                               bool sync, bool truncated)
 {
@@ -559,6 +610,28 @@ UCS_TEST_P(test_ucp_tag_xfer, contig_unexp) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_contig, false, false, false);
 }
 
+UCS_TEST_P(test_ucp_tag_xfer, contig_adaptive_thresh, "ADAPTIVE_THRESH=y",
+           "ADAPTIVE_THRESH_INTERVAL=16") {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_contig, true, false, false);
+    test_xfer(&test_ucp_tag_xfer::test_xfer_contig, false, false, false);
+
+    const ucp_proto_tune_t *tune = ucp_ep_config(sender().ep())->tag.tune;
+    if (tune == NULL) {
+        UCS_TEST_SKIP_R("thresholds are not tuned");
+    }
+
+    /* send more messages around the threshold */
+    size_t thresh = tune->zcopy.thresh;
+    for (int i = 0; i < 200 / ucs::test_time_multiplier(); ++i) {
+        test_xfer_contig(thresh / 2 + ucs::rand() % (thresh * 3 / 2), i % 2,
+                         false, false);
+    }
+
+    EXPECT_TRUE(ucs_is_pow2(tune->zcopy.thresh)) << tune->zcopy.thresh;
+    EXPECT_GE(tune->zcopy.thresh, tune->zcopy.min);
+    EXPECT_LE(tune->zcopy.thresh, tune->zcopy.max);
+}
+
 UCS_TEST_P(test_ucp_tag_xfer, generic_exp) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_generic, true, false, false);
 }
@@ -583,6 +656,18 @@ UCS_TEST_P(test_ucp_tag_xfer, iov_unexp) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_iov, false, false, false);
 }
 
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_unexp) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, false, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp_sync) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, true, false);
+}
+
 UCS_TEST_P(test_ucp_tag_xfer, generic_err_exp) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_generic_err, true, false, false);
 }
@@ -993,6 +1078,38 @@ UCS_TEST_P(test_ucp_tag_xfer, iov_with_empty_buffers, "ZCOPY_THRESH=512") {
                                "IOV"));
 }
 
+/* a rendezvous message to self is copied once, directly from the send buffer
+ * to the receive buffer, when the receive is matched */
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_self_no_copy,
+           "RNDV_THRESH=1000") {
+    static const size_t size = 1148544 / ucs::test_time_multiplier();
+    static const ucp_tag_t tag = 0x1337;
+    std::vector<uint8_t> sendbuf(size, 1), recvbuf(size, 0);
+
+    if (!is_self()) {
+        UCS_TEST_SKIP_R("not self transport");
+    }
+
+    request *sreq = send_nb(&sendbuf[0], size, DATATYPE, tag);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(sreq));
+    ASSERT_TRUE(sreq != NULL);
+    short_progress_loop();
+    EXPECT_FALSE(sreq->completed);
+
+    /* the send buffer is not staged, so the receiver gets the data which is
+     * in it when the receive is posted */
+    std::fill(sendbuf.begin(), sendbuf.end(), 2);
+
+    request *rreq = recv_nb(&recvbuf[0], size, DATATYPE, tag, (ucp_tag_t)-1);
+    wait(rreq);
+    wait(sreq);
+    EXPECT_EQ(UCS_OK, rreq->status);
+    EXPECT_EQ(size, rreq->info.length);
+    EXPECT_TRUE(sendbuf == recvbuf);
+    request_release(rreq);
+    request_release(sreq);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_xfer)
 
 
@@ -0,0 +1,78 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2019.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#include <common/test.h>
+extern "C" {
+#include <ucs/arch/cpu.h>
+#include <ucs/config/global_opts.h>
+}
+
+#include <vector>
+
+class test_arch : public ucs::test {
+protected:
+    typedef void (*copy_func_t)(void *dst, const void *src, size_t len);
+
+    static void memcpy_relaxed_small(void *dst, const void *src, size_t len) {
+        ucs_memcpy_relaxed(dst, src, len, len, SIZE_MAX);
+    }
+
+    static void memcpy_relaxed_large(void *dst, const void *src, size_t len) {
+        ucs_memcpy_relaxed(dst, src, len, len, 0);
+    }
+
+    /* copy with all combinations of source and destination misalignment, and
+     * check that the bytes around the destination are not modified */
+    void test_copy(copy_func_t func) {
+        static const size_t sizes[] = { 0, 1, 7, 63, 64, 255, 256, 257, 1000,
+                                        4096, 65537 };
+        static const size_t max_misalign = 64;
+        static const size_t guard        = 16;
+
+        for (unsigned i = 0; i < ucs_static_array_size(sizes); ++i) {
+            size_t size = sizes[i];
+            std::vector<uint8_t> src(size + max_misalign);
+            std::vector<uint8_t> dst(size + max_misalign + 2 * guard);
+
+            for (size_t k = 0; k < src.size(); ++k) {
+                src[k] = ucs::rand();
+            }
+
+            for (size_t src_off = 0; src_off < max_misalign; src_off += 9) {
+                for (size_t dst_off = 0; dst_off < max_misalign; dst_off += 5) {
+                    std::fill(dst.begin(), dst.end(), 0xa5);
+                    func(&dst[guard + dst_off], &src[src_off], size);
+
+                    for (size_t k = 0; k < guard + dst_off; ++k) {
+                        ASSERT_EQ(0xa5, dst[k]) << "size " << size;
+                    }
+                    for (size_t k = 0; k < size; ++k) {
+                        ASSERT_EQ(src[src_off + k], dst[guard + dst_off + k])
+                            << "size " << size << " src_off " << src_off
+                            << " dst_off " << dst_off << " offset " << k;
+                    }
+                    for (size_t k = guard + dst_off + size; k < dst.size(); ++k) {
+                        ASSERT_EQ(0xa5, dst[k]) << "size " << size;
+                    }
+                }
+            }
+        }
+    }
+};
+
+UCS_TEST_F(test_arch, memcpy_nontemporal) {
+    test_copy(ucs_memcpy_nontemporal);
+}
+
+UCS_TEST_F(test_arch, memcpy_relaxed) {
+    test_copy(memcpy_relaxed_small);
+    test_copy(memcpy_relaxed_large);
+}
+
+UCS_TEST_F(test_arch, memcpy_nt_thresh) {
+    /* "auto" is resolved during initialization */
+    EXPECT_NE(UCS_CONFIG_MEMUNITS_AUTO, ucs_global_opts.memcpy_nt_thresh);
+}
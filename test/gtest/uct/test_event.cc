@@ -168,4 +168,60 @@ UCS_TEST_P(test_uct_event_fd, sig_am)
     test_recv_am(true);
 }
 
+UCS_TEST_P(test_uct_event_fd, sig_am_polling)
+{
+    uint64_t send_data = 0xdeadbeef;
+    recv_desc_t *recv_buffer;
+    struct pollfd wakeup_fd;
+    ucs_status_t status;
+
+    /* mm signals the receiver only when it is going to sleep */
+    if (GetParam()->tl_name != "mm") {
+        UCS_TEST_SKIP_R("Test does not apply to the current transport");
+    }
+
+    initialize();
+    check_caps(UCT_IFACE_FLAG_EVENT_RECV_SIG | UCT_IFACE_FLAG_CB_SYNC |
+               UCT_IFACE_FLAG_AM_BCOPY);
+
+    recv_buffer = (recv_desc_t *) malloc(sizeof(*recv_buffer) + sizeof(send_data));
+    recv_buffer->length = 0;
+    uct_iface_set_am_handler(m_e2->iface(), 0, am_handler, recv_buffer, 0);
+
+    status = uct_iface_event_fd_get(m_e2->iface(), &wakeup_fd.fd);
+    ASSERT_EQ(UCS_OK, status);
+    wakeup_fd.events = POLLIN;
+
+    /* the receiver was not armed, so a signaled send does not wake it up */
+    uct_ep_am_bcopy(m_e1->ep(0), 0, pack_u64, &send_data, UCT_SEND_FLAG_SIGNALED);
+    EXPECT_EQ(0, poll(&wakeup_fd, 1, 0));
+
+    while (m_am_count < 1) {
+        progress();
+    }
+
+    /* after arming, it does */
+    arm(m_e2, UCT_EVENT_RECV_SIG);
+    uct_ep_am_bcopy(m_e1->ep(0), 0, pack_u64, &send_data, UCT_SEND_FLAG_SIGNALED);
+    ASSERT_EQ(1, poll(&wakeup_fd, 1, 1000*ucs::test_time_multiplier()));
+
+    while (m_am_count < 2) {
+        progress();
+    }
+
+    /* consume the signal */
+    EXPECT_EQ(UCS_ERR_BUSY, uct_iface_event_arm(m_e2->iface(), UCT_EVENT_RECV_SIG));
+    EXPECT_EQ(0, poll(&wakeup_fd, 1, 0));
+
+    /* and the receiver which woke up does not get more signals */
+    uct_ep_am_bcopy(m_e1->ep(0), 0, pack_u64, &send_data, UCT_SEND_FLAG_SIGNALED);
+    while (m_am_count < 3) {
+        progress();
+    }
+    EXPECT_EQ(0, poll(&wakeup_fd, 1, 0));
+
+    m_e1->flush();
+    free(recv_buffer);
+}
+
 UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_uct_event_fd);
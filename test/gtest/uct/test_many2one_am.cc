@@ -4,10 +4,11 @@
 * See file LICENSE for terms.
 */
 
-#include "uct_test.h"
+#include "uct_p2p_test.h"
 
 extern "C" {
 #include <ucs/arch/atomic.h>
+#include <uct/sm/mm/base/mm_ep.h>
 }
 
 class test_many2one_am : public uct_test {
@@ -71,12 +72,39 @@ public:
     static const size_t NUM_SENDERS = 10;
 
 protected:
+    void test_am_bcopy();
+
+    /* send a message, progressing the sender and the receiver until there
+     * are resources, unless 'retry' is false; returns whether it was sent */
+    bool send_am_bcopy(entity *sender, unsigned ep_index, entity *receiver,
+                       mapped_buffer &buffer, bool retry = true) {
+        ssize_t packed_len;
+
+        for (;;) {
+            packed_len = uct_ep_am_bcopy(sender->ep(ep_index), AM_ID,
+                                         mapped_buffer::pack, (void*)&buffer,
+                                         0);
+            if ((packed_len != UCS_ERR_NO_RESOURCE) || !retry) {
+                break;
+            }
+            sender->progress();
+            receiver->progress();
+        }
+
+        if (packed_len == UCS_ERR_NO_RESOURCE) {
+            return false;
+        }
+
+        EXPECT_GE(packed_len, 0) << ucs_status_string((ucs_status_t)packed_len);
+        return true;
+    }
+
     volatile uint32_t            m_am_count;
     std::vector<receive_desc_t*> m_backlog;
 };
 
 
-UCS_TEST_P(test_many2one_am, am_bcopy, "MAX_BCOPY=16384")
+void test_many2one_am::test_am_bcopy()
 {
     const unsigned num_sends = 1000 / ucs::test_time_multiplier();
     ucs_status_t status;
@@ -141,4 +169,207 @@ UCS_TEST_P(test_many2one_am, am_bcopy, "MAX_BCOPY=16384")
     buffers.clear();
 }
 
+UCS_TEST_P(test_many2one_am, am_bcopy, "MAX_BCOPY=16384")
+{
+    test_am_bcopy();
+}
+
+UCS_TEST_P(test_many2one_am, am_bcopy_ep_destroy, "MAX_BCOPY=16384")
+{
+    const unsigned num_sends = 100;
+    ucs_status_t status;
+
+    entity *receiver = create_entity(sizeof(receive_desc_t));
+    m_entities.push_back(receiver);
+
+    check_caps(UCT_IFACE_FLAG_AM_BCOPY);
+    check_caps(UCT_IFACE_FLAG_CB_SYNC);
+
+    /* two endpoints of the same interface to the same remote interface, so
+     * they may share the resources of the remote peer */
+    entity *sender = create_entity(0);
+    m_entities.push_back(sender);
+    mapped_buffer buffer(sender->iface_attr().cap.am.max_bcopy, 0, *sender);
+    sender->connect(0, *receiver, 0);
+    sender->connect(1, *receiver, 1);
+
+    m_am_count = 0;
+
+    status = uct_iface_set_am_handler(receiver->iface(), AM_ID, am_handler,
+                                      (void*)this, 0);
+    ASSERT_UCS_OK(status);
+
+    for (unsigned ep_index = 0; ep_index < 2; ++ep_index) {
+        for (unsigned i = 0; i < num_sends; ++i) {
+            buffer.pattern_fill(i);
+
+            ssize_t packed_len;
+            for (;;) {
+                packed_len = uct_ep_am_bcopy(sender->ep(ep_index), AM_ID,
+                                             mapped_buffer::pack,
+                                             (void*)&buffer, 0);
+                if (packed_len != UCS_ERR_NO_RESOURCE) {
+                    break;
+                }
+                progress();
+            }
+            if (packed_len < 0) {
+                ASSERT_UCS_OK((ucs_status_t)packed_len);
+            }
+        }
+
+        while (m_am_count < (ep_index + 1) * num_sends) {
+            progress();
+        }
+
+        /* the remaining endpoint must keep sending after the first one is
+         * destroyed */
+        sender->flush();
+        sender->destroy_ep(ep_index);
+    }
+
+    status = uct_iface_set_am_handler(receiver->iface(), AM_ID, NULL, NULL, 0);
+    ASSERT_UCS_OK(status);
+
+    check_backlog();
+}
+
 UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_many2one_am)
+
+
+/* some of the senders get a private lane, the rest share the FIFO */
+static const char *test_many2one_am_lanes_config[] = {
+    "FIFO_LANES=4", "FIFO_LANE_SIZE=4", NULL
+};
+
+class test_many2one_am_lanes : public uct_iface_config_test<test_many2one_am> {
+public:
+    test_many2one_am_lanes() :
+        uct_iface_config_test<test_many2one_am>(test_many2one_am_lanes_config) {
+    }
+
+    static uct_mm_fifo_lane_ctl_t *lane_of(entity *e, unsigned ep_index) {
+        return ucs_derived_of(e->ep(ep_index), uct_mm_ep_t)->lane.ctl;
+    }
+};
+
+UCS_TEST_P(test_many2one_am_lanes, am_bcopy, "MAX_BCOPY=16384")
+{
+    test_am_bcopy();
+}
+
+/* an endpoint destroyed while its lane has unread messages returns the lane,
+ * and the next endpoint continues after those messages */
+UCS_TEST_P(test_many2one_am_lanes, ep_destroy_with_lane, "MAX_BCOPY=16384")
+{
+    const unsigned num_lanes = 4;
+    const unsigned num_sends = 100;
+    unsigned num_unread;
+    ucs_status_t status;
+
+    entity *receiver = create_entity(sizeof(receive_desc_t));
+    m_entities.push_back(receiver);
+    entity *sender = create_entity(0);
+    m_entities.push_back(sender);
+    mapped_buffer buffer(sender->iface_attr().cap.am.max_bcopy, 0, *sender);
+
+    for (unsigned i = 0; i <= num_lanes; ++i) {
+        sender->connect(i, *receiver, i);
+        EXPECT_EQ(i < num_lanes, lane_of(sender, i) != NULL);
+    }
+
+    m_am_count = 0;
+    status = uct_iface_set_am_handler(receiver->iface(), AM_ID, am_handler,
+                                      (void*)this, 0);
+    ASSERT_UCS_OK(status);
+
+    /* fill the lane without receiving */
+    for (num_unread = 0; ; ++num_unread) {
+        buffer.pattern_fill(num_unread);
+        if (!send_am_bcopy(sender, 0, receiver, buffer, false)) {
+            break;
+        }
+    }
+    EXPECT_GT(num_unread, 0u);
+
+    sender->destroy_ep(0);
+    sender->connect(num_lanes + 1, *receiver, num_lanes + 1);
+    EXPECT_TRUE(lane_of(sender, num_lanes + 1) != NULL);
+
+    for (unsigned i = 0; i < num_sends; ++i) {
+        buffer.pattern_fill(i);
+        send_am_bcopy(sender, num_lanes + 1, receiver, buffer);
+    }
+
+    while (m_am_count < (num_unread + num_sends)) {
+        progress();
+    }
+
+    status = uct_iface_set_am_handler(receiver->iface(), AM_ID, NULL, NULL, 0);
+    ASSERT_UCS_OK(status);
+
+    check_backlog();
+}
+
+/* a lane moves from an idle endpoint to an active endpoint which sends on the
+ * shared FIFO. There is one lane, and the shared FIFO tail is published after
+ * every message, so the active endpoint may switch to the lane as soon as it
+ * is released */
+UCS_TEST_P(test_many2one_am_lanes, idle_lane_release, "MAX_BCOPY=16384",
+           "FIFO_LANES?=1", "FIFO_LANE_IDLE_TIME?=1ms",
+           "FIFO_RELEASE_FACTOR?=0")
+{
+    const unsigned num_sends = 100;
+    unsigned count;
+    ucs_status_t status;
+
+    entity *receiver = create_entity(sizeof(receive_desc_t));
+    m_entities.push_back(receiver);
+    entity *sender = create_entity(0);
+    m_entities.push_back(sender);
+    mapped_buffer buffer(sender->iface_attr().cap.am.max_bcopy, 0, *sender);
+
+    sender->connect(0, *receiver, 0);
+    sender->connect(1, *receiver, 1);
+    ASSERT_TRUE(lane_of(sender, 0) != NULL);
+    ASSERT_TRUE(lane_of(sender, 1) == NULL);
+
+    m_am_count = 0;
+    status = uct_iface_set_am_handler(receiver->iface(), AM_ID, am_handler,
+                                      (void*)this, 0);
+    ASSERT_UCS_OK(status);
+
+    for (count = 0; count < num_sends; ++count) {
+        buffer.pattern_fill(count);
+        send_am_bcopy(sender, 0, receiver, buffer);
+    }
+
+    /* keep only the second endpoint busy */
+    ucs_time_t deadline = ucs_get_time() +
+                          ucs_time_from_sec(10.0 * ucs::test_time_multiplier());
+    while ((lane_of(sender, 1) == NULL) && (ucs_get_time() < deadline)) {
+        buffer.pattern_fill(count++);
+        send_am_bcopy(sender, 1, receiver, buffer);
+        progress();
+    }
+
+    EXPECT_TRUE(lane_of(sender, 0) == NULL);
+    EXPECT_TRUE(lane_of(sender, 1) != NULL);
+
+    /* both endpoints keep sending, on the shared FIFO and on the lane */
+    for (unsigned i = 0; i < num_sends; ++i) {
+        buffer.pattern_fill(count++);
+        send_am_bcopy(sender, i % 2, receiver, buffer);
+    }
+
+    while (m_am_count < count) {
+        progress();
+    }
+
+    status = uct_iface_set_am_handler(receiver->iface(), AM_ID, NULL, NULL, 0);
+    ASSERT_UCS_OK(status);
+
+    check_backlog();
+}
+
+UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_many2one_am_lanes)
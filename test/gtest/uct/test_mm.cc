@@ -51,6 +51,46 @@ public:
         return UCS_OK;
     }
 
+    static ucs_status_t mm_am_check_handler(void *arg, void *data,
+                                            size_t length, unsigned flags) {
+        std::vector<uint8_t> *recv_data = (std::vector<uint8_t>*)arg;
+
+        recv_data->assign((uint8_t*)data, (uint8_t*)data + length);
+        return UCS_OK;
+    }
+
+    static ucs_status_t mm_am_count_handler(void *arg, void *data,
+                                            size_t length, unsigned flags) {
+        ++(*(unsigned*)arg);
+        return UCS_OK;
+    }
+
+    typedef struct {
+        uct_pending_req_t    uct;
+        uct_ep_h             ep;
+        std::vector<uint8_t> *data;
+    } pending_send_t;
+
+    static ucs_status_t pending_send(uct_pending_req_t *self) {
+        pending_send_t *req = ucs_container_of(self, pending_send_t, uct);
+
+        return uct_ep_am_short(req->ep, 0, 0, &req->data->at(0),
+                               req->data->size());
+    }
+
+    /* fill the FIFO with single-element messages, then receive one of them;
+     * returns the number of messages sent */
+    unsigned fill_fifo_but_one() {
+        unsigned num_sent = 0;
+
+        while (uct_ep_am_short(m_e1->ep(0), 0, 0, NULL, 0) == UCS_OK) {
+            ++num_sent;
+        }
+
+        m_e2->progress();
+        return num_sent;
+    }
+
     void cleanup() {
         uct_test::cleanup();
     }
@@ -99,4 +139,91 @@ UCS_TEST_P(test_uct_mm, open_for_posix) {
     }
 }
 
+UCS_TEST_P(test_uct_mm, am_short_multi_elem) {
+    std::vector<uint8_t> recv_data;
+    size_t max_length, length;
+    uint64_t header;
+    ucs_status_t status;
+
+    initialize();
+    check_caps(UCT_IFACE_FLAG_AM_SHORT | UCT_IFACE_FLAG_CB_SYNC);
+
+    /* a message may take several FIFO elements of the default size (128) */
+    ASSERT_GT(m_e1->iface_attr().cap.am.max_short, 128ul);
+    max_length = m_e1->iface_attr().cap.am.max_short - sizeof(header);
+
+    std::vector<uint8_t> send_data(max_length);
+    uct_iface_set_am_handler(m_e2->iface(), 0, mm_am_check_handler, &recv_data,
+                             0);
+
+    /* send messages of various sizes, which wrap around the FIFO many times */
+    for (unsigned i = 0; i < 1000; ++i) {
+        length = (i * 97) % (max_length + 1);
+        header = i;
+        for (size_t j = 0; j < length; ++j) {
+            send_data[j] = i + j;
+        }
+
+        recv_data.clear();
+        do {
+            status = uct_ep_am_short(m_e1->ep(0), 0, header, &send_data[0],
+                                     length);
+            progress();
+        } while (status == UCS_ERR_NO_RESOURCE);
+        ASSERT_UCS_OK(status);
+
+        while (recv_data.empty()) {
+            progress();
+        }
+
+        ASSERT_EQ(sizeof(header) + length, recv_data.size());
+        EXPECT_EQ(header, *(uint64_t*)&recv_data[0]);
+        EXPECT_TRUE(std::equal(send_data.begin(), send_data.begin() + length,
+                               recv_data.begin() + sizeof(header)))
+            << "length " << length;
+    }
+}
+
+/* Pending requests are added and dispatched according to the room needed by
+ * the send which failed, rather than by the largest message */
+UCS_TEST_P(test_uct_mm, pending_add_span, "FIFO_MAX_POLL=1",
+           "FIFO_RELEASE_FACTOR=0") {
+    unsigned count = 0, num_sent;
+    pending_send_t req;
+    ucs_status_t status;
+
+    initialize();
+    check_caps(UCT_IFACE_FLAG_AM_SHORT | UCT_IFACE_FLAG_PENDING |
+               UCT_IFACE_FLAG_CB_SYNC);
+
+    std::vector<uint8_t> send_data(m_e1->iface_attr().cap.am.max_short -
+                                   sizeof(uint64_t));
+    ASSERT_GT(send_data.size(), 128ul);
+    uct_iface_set_am_handler(m_e2->iface(), 0, mm_am_count_handler, &count,
+                             0);
+
+    req.uct.func = pending_send;
+    req.ep       = m_e1->ep(0);
+    req.data     = &send_data;
+
+    /* a single-element message fits in the single free element */
+    num_sent = fill_fifo_but_one();
+    EXPECT_EQ(UCS_ERR_BUSY, uct_ep_pending_add(m_e1->ep(0), &req.uct, 0));
+    ASSERT_UCS_OK(uct_ep_am_short(m_e1->ep(0), 0, 0, NULL, 0));
+    ++num_sent;
+
+    /* a multi-element message does not, so it waits in the pending queue
+     * until there is room for it */
+    num_sent += fill_fifo_but_one();
+    status = uct_ep_am_short(m_e1->ep(0), 0, 0, &send_data[0],
+                             send_data.size());
+    ASSERT_EQ(UCS_ERR_NO_RESOURCE, status);
+    ASSERT_UCS_OK(uct_ep_pending_add(m_e1->ep(0), &req.uct, 0));
+    ++num_sent;
+
+    /* all messages are received, including the pending one */
+    wait_for_value(&count, num_sent, true);
+    EXPECT_EQ(num_sent, count);
+}
+
 _UCT_INSTANTIATE_TEST_CASE(test_uct_mm, mm)
@@ -648,6 +648,65 @@ UCS_TEST_P(uct_p2p_am_misc, am_max_short_multi) {
     EXPECT_EQ(UCS_OK, status);
 }
 
+static ucs_status_t am_in_place_handler(void *arg, void *data, size_t length,
+                                        unsigned flags)
+{
+    std::pair<void*, size_t> *recv = (std::pair<void*, size_t>*)arg;
+
+    recv->first  = data;
+    recv->second = length;
+    return UCS_OK;
+}
+
+UCS_TEST_P(uct_p2p_am_misc, am_zcopy_in_place) {
+    if (GetParam()->tl_name != "self") {
+        UCS_TEST_SKIP_R("Test does not apply to the current transport");
+    }
+
+    check_caps(UCT_IFACE_FLAG_AM_ZCOPY);
+
+    std::pair<void*, size_t> recv(NULL, 0);
+    ucs_status_t status;
+
+    status = uct_iface_set_am_handler(receiver().iface(), AM_ID,
+                                      am_in_place_handler, &recv, 0);
+    ASSERT_UCS_OK(status);
+
+    mapped_buffer sendbuf(sender().iface_attr().cap.am.max_zcopy, SEED1,
+                          sender());
+
+    /* a contiguous message without a header is passed to the handler as-is */
+    UCS_TEST_GET_BUFFER_IOV(iov, iovcnt, sendbuf.ptr(), sendbuf.length(),
+                            sendbuf.memh(), 1);
+    status = uct_ep_am_zcopy(sender_ep(), AM_ID, NULL, 0, iov, iovcnt, 0, NULL);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(sendbuf.ptr(), recv.first);
+    EXPECT_EQ(sendbuf.length(), recv.second);
+
+    /* so is a header which is followed by the payload in memory */
+    {
+        UCS_TEST_GET_BUFFER_IOV(hdr_iov, hdr_iovcnt,
+                                (char*)sendbuf.ptr() + sizeof(uint64_t),
+                                sendbuf.length() - sizeof(uint64_t),
+                                sendbuf.memh(), 1);
+        status = uct_ep_am_zcopy(sender_ep(), AM_ID, sendbuf.ptr(),
+                                 sizeof(uint64_t), hdr_iov, hdr_iovcnt, 0,
+                                 NULL);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(sendbuf.ptr(), recv.first);
+        EXPECT_EQ(sendbuf.length(), recv.second);
+    }
+
+    /* a separate header is gathered with the payload to a single buffer */
+    uint64_t hdr = SEED2;
+    status = uct_ep_am_zcopy(sender_ep(), AM_ID, &hdr, sizeof(hdr), iov, 0, 0,
+                             NULL);
+    ASSERT_UCS_OK(status);
+    EXPECT_NE(sendbuf.ptr(), recv.first);
+    ASSERT_EQ(sizeof(hdr), recv.second);
+    EXPECT_EQ(hdr, *(uint64_t*)recv.first);
+}
+
 UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_misc)
 
 class uct_p2p_am_tx_bufs : public uct_p2p_am_test
@@ -717,3 +776,57 @@ UCS_TEST_P(uct_p2p_am_tx_bufs, am_tx_max_bufs) {
 }
 
 UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_tx_bufs)
+
+/* split large zero-copy messages between several sockets */
+static const char *uct_p2p_am_striped_config[] = {
+    "NUM_SOCKETS=4", "STRIPE_THRESH=1k", NULL
+};
+
+class uct_p2p_am_striped : public uct_iface_config_test<uct_p2p_am_test>
+{
+public:
+    uct_p2p_am_striped() :
+        uct_iface_config_test<uct_p2p_am_test>(uct_p2p_am_striped_config) {
+    }
+};
+
+UCS_TEST_P(uct_p2p_am_striped, am_zcopy) {
+    check_caps(UCT_IFACE_FLAG_AM_ZCOPY, UCT_IFACE_FLAG_AM_DUP);
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_am_test::am_zcopy),
+                    0ul,
+                    sender().iface_attr().cap.am.max_zcopy,
+                    TEST_UCT_FLAG_DIR_SEND_TO_RECV);
+}
+
+UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_striped)
+
+/* consume socket events reported only once by epoll */
+static const char *uct_p2p_am_edge_triggered_config[] = {
+    "EPOLL_ET=y", NULL
+};
+
+class uct_p2p_am_edge_triggered : public uct_iface_config_test<uct_p2p_am_test>
+{
+public:
+    uct_p2p_am_edge_triggered() :
+        uct_iface_config_test<uct_p2p_am_test>(uct_p2p_am_edge_triggered_config) {
+    }
+};
+
+UCS_TEST_P(uct_p2p_am_edge_triggered, am_bcopy) {
+    check_caps(UCT_IFACE_FLAG_AM_BCOPY, UCT_IFACE_FLAG_AM_DUP);
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_am_test::am_bcopy),
+                    0ul,
+                    sender().iface_attr().cap.am.max_bcopy,
+                    TEST_UCT_FLAG_DIR_SEND_TO_RECV);
+}
+
+UCS_TEST_P(uct_p2p_am_edge_triggered, am_zcopy) {
+    check_caps(UCT_IFACE_FLAG_AM_ZCOPY, UCT_IFACE_FLAG_AM_DUP);
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_am_test::am_zcopy),
+                    0ul,
+                    sender().iface_attr().cap.am.max_zcopy,
+                    TEST_UCT_FLAG_DIR_SEND_TO_RECV);
+}
+
+UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_edge_triggered)
@@ -134,3 +134,54 @@ UCS_TEST_P(uct_p2p_rma_test, get_zcopy) {
 }
 
 UCT_INSTANTIATE_TEST_CASE(uct_p2p_rma_test)
+
+/* split large zero-copy writes between several sockets */
+static const char *uct_p2p_rma_striped_config[] = {
+    "NUM_SOCKETS=4", "STRIPE_THRESH=1k", NULL
+};
+
+class uct_p2p_rma_striped : public uct_iface_config_test<uct_p2p_rma_test>
+{
+public:
+    uct_p2p_rma_striped() :
+        uct_iface_config_test<uct_p2p_rma_test>(uct_p2p_rma_striped_config) {
+    }
+};
+
+UCS_TEST_P(uct_p2p_rma_striped, put_zcopy) {
+    check_caps(UCT_IFACE_FLAG_PUT_ZCOPY);
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                    0ul, sender().iface_attr().cap.put.max_zcopy,
+                    TEST_UCT_FLAG_SEND_ZCOPY);
+}
+
+UCT_INSTANTIATE_TEST_CASE(uct_p2p_rma_striped)
+
+/* copy large zero-copy operations by several threads */
+static const char *uct_p2p_rma_copy_threads_config[] = {
+    "COPY_THREADS=3", "COPY_THRESH=16k", "COPY_CHUNK=4k", NULL
+};
+
+class uct_p2p_rma_copy_threads : public uct_iface_config_test<uct_p2p_rma_test>
+{
+public:
+    uct_p2p_rma_copy_threads() :
+        uct_iface_config_test<uct_p2p_rma_test>(uct_p2p_rma_copy_threads_config) {
+    }
+};
+
+UCS_TEST_P(uct_p2p_rma_copy_threads, put_zcopy) {
+    check_caps(UCT_IFACE_FLAG_PUT_ZCOPY);
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                    0ul, sender().iface_attr().cap.put.max_zcopy,
+                    TEST_UCT_FLAG_SEND_ZCOPY);
+}
+
+UCS_TEST_P(uct_p2p_rma_copy_threads, get_zcopy) {
+    check_caps(UCT_IFACE_FLAG_GET_ZCOPY);
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::get_zcopy),
+                    1ul, sender().iface_attr().cap.get.max_zcopy,
+                    TEST_UCT_FLAG_RECV_ZCOPY);
+}
+
+UCT_INSTANTIATE_TEST_CASE(uct_p2p_rma_copy_threads)
@@ -0,0 +1,651 @@
+/**
+* Copyright (C) Mellanox Technologies Ltd. 2001-2018.  ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+extern "C" {
+#include <uct/api/uct.h>
+#include <uct/tcp/tcp.h>
+}
+#include <common/test.h>
+#include "uct_test.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+
+class test_uct_tcp : public uct_test {
+public:
+    enum {
+        AM_ID        = 1,
+        REGION_WORDS = 8,
+        GUARD_WORDS  = 4
+    };
+
+    virtual void init() {
+        uct_test::init();
+
+        m_region_memh = UCT_MEM_HANDLE_NULL;
+        m_region_buf.assign(REGION_WORDS + (2 * GUARD_WORDS), 0);
+
+        m_sender = uct_test::create_entity(0);
+        m_entities.push_back(m_sender);
+
+        m_receiver = uct_test::create_entity(0);
+        m_entities.push_back(m_receiver);
+
+        m_sender->connect(0, *m_receiver, 0);
+
+        uct_iface_set_am_handler(m_receiver->iface(), AM_ID, am_handler, this,
+                                 0);
+    }
+
+    virtual void cleanup() {
+        if (m_region_memh != UCT_MEM_HANDLE_NULL) {
+            uct_rkey_release(&m_region_rkey);
+            uct_md_mem_dereg(m_receiver->md(), m_region_memh);
+        }
+        uct_test::cleanup();
+    }
+
+    uint64_t *region() {
+        return &m_region_buf[GUARD_WORDS];
+    }
+
+    size_t region_length() {
+        return REGION_WORDS * sizeof(uint64_t);
+    }
+
+    /* Register a receiver memory region with exact bounds, which is
+     * surrounded by unregistered memory */
+    void register_region() {
+        std::vector<uint8_t> rkey_buffer(m_receiver->md_attr().rkey_packed_size);
+        ucs_status_t status;
+
+        status = uct_md_mem_reg(m_receiver->md(), region(), region_length(),
+                                UCT_MD_MEM_ACCESS_ALL, &m_region_memh);
+        ASSERT_UCS_OK(status);
+
+        status = uct_md_mkey_pack(m_receiver->md(), m_region_memh,
+                                  &rkey_buffer[0]);
+        ASSERT_UCS_OK(status);
+
+        status = uct_rkey_unpack(&rkey_buffer[0], &m_region_rkey);
+        ASSERT_UCS_OK(status);
+    }
+
+    void check_region_unmodified() {
+        for (size_t i = 0; i < m_region_buf.size(); ++i) {
+            EXPECT_EQ(0ul, m_region_buf[i]) << "word " << i;
+        }
+    }
+
+    static ucs_status_t am_handler(void *arg, void *data, size_t length,
+                                   unsigned flags) {
+        test_uct_tcp *self = reinterpret_cast<test_uct_tcp*>(arg);
+
+        self->m_am_data.push_back(std::vector<uint8_t>((uint8_t*)data,
+                                                       (uint8_t*)data + length));
+        return UCS_OK;
+    }
+
+    static size_t pack_cb(void *dest, void *arg) {
+        const std::vector<uint8_t> *data =
+                        reinterpret_cast<const std::vector<uint8_t>*>(arg);
+
+        std::copy(data->begin(), data->end(), (uint8_t*)dest);
+        return data->size();
+    }
+
+    void wait_for_am(size_t count) {
+        ucs_time_t deadline = ucs_get_time() +
+                              ucs_time_from_sec(DEFAULT_TIMEOUT_SEC) *
+                              ucs::test_time_multiplier();
+
+        while ((m_am_data.size() < count) && (ucs_get_time() < deadline)) {
+            progress();
+        }
+        ASSERT_EQ(count, m_am_data.size());
+    }
+
+    void check_am(const void *header, size_t header_length,
+                  const void *payload, size_t length) {
+        ASSERT_FALSE(m_am_data.empty());
+        const std::vector<uint8_t>& data = m_am_data.front();
+
+        ASSERT_EQ(header_length + length, data.size());
+        if (header_length > 0) {
+            EXPECT_EQ(0, memcmp(&data[0], header, header_length));
+        }
+        if (length > 0) {
+            EXPECT_EQ(0, memcmp(&data[header_length], payload, length))
+                << "length " << length;
+        }
+        m_am_data.erase(m_am_data.begin());
+    }
+
+    void send_am_bcopy(size_t length) {
+        std::vector<uint8_t> data(length);
+        ssize_t packed_length;
+
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = i * 7 + length;
+        }
+
+        do {
+            packed_length = uct_ep_am_bcopy(m_sender->ep(0), AM_ID, pack_cb,
+                                            &data, 0);
+            progress();
+        } while (packed_length == UCS_ERR_NO_RESOURCE);
+        ASSERT_EQ((ssize_t)length, packed_length);
+
+        wait_for_am(1);
+        check_am(NULL, 0, data.empty() ? NULL : &data[0], length);
+    }
+
+    void send_am_zcopy(size_t header_length, size_t length, size_t iovcnt) {
+        mapped_buffer sendbuf(length, length, *m_sender);
+        std::vector<uint8_t> header(header_length + 1, 0xa5);
+        std::vector<uct_iov_t> iov(iovcnt);
+        size_t offset = 0;
+        ucs_status_t status;
+
+        /* Split the payload between the iov entries */
+        for (size_t i = 0; i < iovcnt; ++i) {
+            iov[i].buffer = (char*)sendbuf.ptr() + offset;
+            iov[i].length = (i == iovcnt - 1) ? (length - offset) :
+                            (length / iovcnt);
+            iov[i].memh   = sendbuf.memh();
+            iov[i].stride = 0;
+            iov[i].count  = 1;
+            offset       += iov[i].length;
+        }
+
+        m_comp.count = 2;
+        m_comp.func  = NULL;
+        do {
+            status = uct_ep_am_zcopy(m_sender->ep(0), AM_ID, &header[0],
+                                     header_length, &iov[0], iovcnt, 0,
+                                     &m_comp);
+            progress();
+        } while (status == UCS_ERR_NO_RESOURCE);
+        ASSERT_UCS_OK_OR_INPROGRESS(status);
+
+        wait_for_am(1);
+        check_am(&header[0], header_length, sendbuf.ptr(), length);
+
+        /* The user buffer must not be released before the data is sent */
+        if (status == UCS_INPROGRESS) {
+            wait_for_value(&m_comp.count, 1, true);
+            EXPECT_EQ(1, m_comp.count);
+        }
+    }
+
+    /* Connect a plain socket to the receiver interface, as a peer which sends
+     * arbitrary data would */
+    int raw_connect() {
+        struct sockaddr_in addr;
+        ucs_status_t status;
+        int fd, ret;
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        status = uct_iface_get_device_address(m_receiver->iface(),
+                                              (uct_device_addr_t*)
+                                              &addr.sin_addr);
+        EXPECT_UCS_OK(status);
+        status = uct_iface_get_address(m_receiver->iface(),
+                                       (uct_iface_addr_t*)&addr.sin_port);
+        EXPECT_UCS_OK(status);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            UCS_TEST_ABORT("socket() failed: " << strerror(errno));
+        }
+
+        ret = connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+        if (ret < 0) {
+            close(fd);
+            UCS_TEST_ABORT("connect() failed: " << strerror(errno));
+        }
+        return fd;
+    }
+
+    void raw_send(int fd, const void *data, size_t length) {
+        ssize_t ret = send(fd, data, length, MSG_NOSIGNAL);
+        ASSERT_EQ((ssize_t)length, ret) << strerror(errno);
+    }
+
+    /* Wait until the receiver closes the connection of the socket */
+    void wait_for_close(int fd) {
+        ucs_time_t deadline = ucs_get_time() +
+                              ucs_time_from_sec(DEFAULT_TIMEOUT_SEC) *
+                              ucs::test_time_multiplier();
+        bool closed = false;
+        ssize_t ret = -1;
+        char buf[64];
+
+        while (ucs_get_time() < deadline) {
+            progress();
+            ret = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if ((ret >= 0) || ((errno != EAGAIN) && (errno != EINTR))) {
+                /* Either end-of-file, or a reset by the receiver */
+                closed = (ret <= 0);
+                break;
+            }
+        }
+
+        EXPECT_TRUE(closed) << "receiver did not close the connection";
+    }
+
+    /* Send a message with a transport id from a plain socket, and expect the
+     * receiver to close the connection */
+    void expect_rejected(uint8_t am_id, const void *data, size_t length) {
+        std::vector<uint8_t> msg(sizeof(uct_tcp_am_hdr_t) + length);
+        uct_tcp_am_hdr_t *hdr = (uct_tcp_am_hdr_t*)&msg[0];
+        int fd;
+
+        hdr->am_id  = am_id;
+        hdr->length = length;
+        memcpy(hdr + 1, data, length);
+
+        fd = raw_connect();
+        {
+            scoped_log_handler slh(hide_errors_logger);
+            raw_send(fd, &msg[0], msg.size());
+            wait_for_close(fd);
+        }
+        close(fd);
+    }
+
+    /* Connect two plain sockets as the main and the additional socket of a
+     * striped connection */
+    void raw_connect_striped(int *fds) {
+        struct {
+            uct_tcp_am_hdr_t   hdr;
+            uct_tcp_conn_hdr_t conn_hdr;
+        } UCS_S_PACKED conn;
+
+        for (unsigned i = 0; i < 2; ++i) {
+            fds[i]              = raw_connect();
+            conn.hdr.am_id      = UCT_TCP_AM_ID_CONN;
+            conn.hdr.length     = sizeof(conn.conn_hdr);
+            conn.conn_hdr.id    = 0xabcdef12345ul;
+            conn.conn_hdr.index = i;
+            conn.conn_hdr.count = 2;
+            raw_send(fds[i], &conn, sizeof(conn));
+        }
+
+        /* Let the receiver link the sockets */
+        short_progress_loop();
+    }
+
+    /* Send a striped active message with a header of 8 bytes, and the first
+     * part of the payload */
+    void raw_send_striped(int fd, uint32_t hdr_length, uint32_t length,
+                          size_t part_length) {
+        std::vector<uint8_t> msg(sizeof(uct_tcp_am_hdr_t) +
+                                 sizeof(uct_tcp_striped_hdr_t) + 8 +
+                                 part_length, 0x11);
+        uct_tcp_am_hdr_t *hdr              = (uct_tcp_am_hdr_t*)&msg[0];
+        uct_tcp_striped_hdr_t *striped_hdr = (uct_tcp_striped_hdr_t*)(hdr + 1);
+
+        hdr->am_id              = UCT_TCP_AM_ID_STRIPED;
+        hdr->length             = msg.size() - sizeof(*hdr);
+        striped_hdr->am_id      = AM_ID;
+        striped_hdr->hdr_length = hdr_length;
+        striped_hdr->length     = length;
+        raw_send(fd, &msg[0], msg.size());
+    }
+
+    void raw_send_stripe(int fd, uint32_t offset, size_t length) {
+        std::vector<uint8_t> msg(sizeof(uct_tcp_am_hdr_t) +
+                                 sizeof(uct_tcp_stripe_hdr_t) + length, 0x22);
+        uct_tcp_am_hdr_t *hdr            = (uct_tcp_am_hdr_t*)&msg[0];
+        uct_tcp_stripe_hdr_t *stripe_hdr = (uct_tcp_stripe_hdr_t*)(hdr + 1);
+
+        hdr->am_id         = UCT_TCP_AM_ID_STRIPE;
+        hdr->length        = msg.size() - sizeof(*hdr);
+        stripe_hdr->offset = offset;
+        raw_send(fd, &msg[0], msg.size());
+    }
+
+    /* Send a striped message of 8 bytes header and 64 bytes payload, whose
+     * second part is described by the given offset and length */
+    void test_striped_part(uint32_t offset, size_t length, bool valid) {
+        int fds[2];
+
+        raw_connect_striped(fds);
+        raw_send_striped(fds[0], 8, 8 + 64, 32);
+        if (valid) {
+            raw_send_stripe(fds[1], offset, length);
+            wait_for_am(1);
+        } else {
+            scoped_log_handler slh(hide_errors_logger);
+            raw_send_stripe(fds[1], offset, length);
+            wait_for_close(fds[1]);
+            wait_for_close(fds[0]);
+            EXPECT_TRUE(m_am_data.empty());
+        }
+
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+protected:
+    entity                            *m_sender, *m_receiver;
+    std::vector<uint64_t>             m_region_buf;
+    uct_mem_h                         m_region_memh;
+    uct_rkey_bundle_t                 m_region_rkey;
+    std::vector< std::vector<uint8_t> > m_am_data;
+    uct_completion_t                  m_comp;
+};
+
+UCS_TEST_P(test_uct_tcp, am_bcopy_sizes, "RX_SEG_SIZE=16k") {
+    size_t max_bcopy = m_sender->iface_attr().cap.am.max_bcopy;
+
+    send_am_bcopy(0);
+    send_am_bcopy(1);
+    send_am_bcopy(max_bcopy - 1);
+    send_am_bcopy(max_bcopy);
+}
+
+/* Messages which are larger than a receive segment are received directly to
+ * a dedicated buffer */
+UCS_TEST_P(test_uct_tcp, am_zcopy_sizes, "RX_SEG_SIZE=16k", "MAX_ZCOPY=256k") {
+    size_t max_zcopy = m_sender->iface_attr().cap.am.max_zcopy;
+    size_t max_iov   = m_sender->iface_attr().cap.am.max_iov;
+    size_t max_bcopy = m_sender->iface_attr().cap.am.max_bcopy;
+    size_t seg_size  = 16 * UCS_KBYTE;
+    const size_t header_length = 8;
+
+    send_am_zcopy(0, 1, 1);
+    send_am_zcopy(header_length, max_bcopy - header_length, 1);
+    send_am_zcopy(header_length, max_bcopy + 1, 1);
+    send_am_zcopy(header_length, seg_size - 1, 2);
+    send_am_zcopy(header_length, seg_size, 3);
+    send_am_zcopy(header_length, seg_size + 1, max_iov);
+    send_am_zcopy(header_length, max_zcopy - header_length, max_iov);
+}
+
+/* Several messages are queued and sent by a single system call */
+UCS_TEST_P(test_uct_tcp, am_aggregated, "TX_AGGR_COUNT=4", "RX_SEG_SIZE=16k") {
+    const unsigned count = 16;
+    std::vector<uint8_t> data(1000);
+    ssize_t packed_length;
+
+    for (unsigned i = 0; i < count; ++i) {
+        data[0] = i;
+        do {
+            packed_length = uct_ep_am_bcopy(m_sender->ep(0), AM_ID, pack_cb,
+                                            &data, 0);
+            if (packed_length == UCS_ERR_NO_RESOURCE) {
+                progress();
+            }
+        } while (packed_length == UCS_ERR_NO_RESOURCE);
+        ASSERT_EQ((ssize_t)data.size(), packed_length);
+    }
+
+    wait_for_am(count);
+    for (unsigned i = 0; i < count; ++i) {
+        data[0] = i;
+        check_am(NULL, 0, &data[0], data.size());
+    }
+}
+
+/* A header announcing more than the maximal message size must close the
+ * connection, rather than allocate a buffer of that size */
+UCS_TEST_P(test_uct_tcp, oversized_header) {
+    uct_tcp_am_hdr_t hdr;
+    int fd;
+
+    fd = raw_connect();
+    hdr.am_id  = AM_ID;
+    hdr.length = UINT32_MAX;
+
+    {
+        scoped_log_handler slh(hide_errors_logger);
+        raw_send(fd, &hdr, sizeof(hdr));
+        wait_for_close(fd);
+    }
+    close(fd);
+
+    EXPECT_TRUE(m_am_data.empty());
+
+    /* Other connections are not affected */
+    send_am_bcopy(100);
+}
+
+/* A connection which is closed in the middle of a large message must not
+ * deliver it */
+UCS_TEST_P(test_uct_tcp, truncated_message, "RX_SEG_SIZE=16k") {
+    std::vector<uint8_t> data(32 * UCS_KBYTE, 0x5a);
+    uct_tcp_am_hdr_t hdr;
+    int fd;
+
+    fd = raw_connect();
+    hdr.am_id  = AM_ID;
+    hdr.length = data.size();
+    raw_send(fd, &hdr, sizeof(hdr));
+    raw_send(fd, &data[0], data.size() / 2);
+    short_progress_loop();
+    close(fd);
+    short_progress_loop(100.0);
+
+    EXPECT_TRUE(m_am_data.empty());
+
+    /* Also a partial header */
+    fd = raw_connect();
+    raw_send(fd, &hdr, sizeof(hdr) - 1);
+    close(fd);
+    short_progress_loop(100.0);
+
+    EXPECT_TRUE(m_am_data.empty());
+    send_am_bcopy(100);
+}
+
+/* Messages with transport ids must not be larger than a receive segment */
+UCS_TEST_P(test_uct_tcp, oversized_ctrl_message, "RX_SEG_SIZE=16k") {
+    std::vector<uint8_t> data(64 * UCS_KBYTE);
+    uct_tcp_am_hdr_t hdr;
+    int fd;
+
+    fd = raw_connect();
+    hdr.am_id  = UCT_TCP_AM_ID_FLUSH;
+    hdr.length = data.size();
+
+    {
+        scoped_log_handler slh(hide_errors_logger);
+        raw_send(fd, &hdr, sizeof(hdr));
+        raw_send(fd, &data[0], data.size());
+        wait_for_close(fd);
+    }
+    close(fd);
+}
+
+/* Remote memory operations are executed only within a registered region, and
+ * only with its remote key */
+UCS_TEST_P(test_uct_tcp, put_outside_region) {
+    struct {
+        uct_tcp_put_hdr_t put_hdr;
+        uint64_t          data;
+    } UCS_S_PACKED msg;
+
+    register_region();
+    msg.data            = 0xdeadbeef;
+    msg.put_hdr.rkey    = m_region_rkey.rkey;
+
+    msg.put_hdr.address = (uintptr_t)region() + region_length() -
+                          (sizeof(msg.data) / 2);
+    expect_rejected(UCT_TCP_AM_ID_PUT, &msg, sizeof(msg));
+
+    msg.put_hdr.address = (uintptr_t)region() - 1;
+    expect_rejected(UCT_TCP_AM_ID_PUT, &msg, sizeof(msg));
+
+    msg.put_hdr.address = (uintptr_t)region();
+    msg.put_hdr.rkey    = m_region_rkey.rkey + 1;
+    expect_rejected(UCT_TCP_AM_ID_PUT, &msg, sizeof(msg));
+
+    check_region_unmodified();
+}
+
+UCS_TEST_P(test_uct_tcp, get_outside_region) {
+    uct_tcp_get_hdr_t get_hdr;
+
+    register_region();
+    get_hdr.rkey    = m_region_rkey.rkey;
+
+    get_hdr.address = (uintptr_t)region();
+    get_hdr.length  = region_length() + 1;
+    expect_rejected(UCT_TCP_AM_ID_GET, &get_hdr, sizeof(get_hdr));
+
+    get_hdr.address = (uintptr_t)region() - 1;
+    get_hdr.length  = 1;
+    expect_rejected(UCT_TCP_AM_ID_GET, &get_hdr, sizeof(get_hdr));
+
+    get_hdr.address = (uintptr_t)region();
+    get_hdr.rkey    = 0;
+    expect_rejected(UCT_TCP_AM_ID_GET, &get_hdr, sizeof(get_hdr));
+}
+
+UCS_TEST_P(test_uct_tcp, atomic_outside_region) {
+    uct_tcp_atomic_hdr_t atomic_hdr;
+
+    register_region();
+    atomic_hdr.rkey    = m_region_rkey.rkey;
+    atomic_hdr.value   = 1;
+    atomic_hdr.compare = 0;
+    atomic_hdr.opcode  = UCT_ATOMIC_OP_ADD;
+    atomic_hdr.fetch   = 0;
+
+    atomic_hdr.address = (uintptr_t)(region() + REGION_WORDS);
+    expect_rejected(UCT_TCP_AM_ID_ATOMIC, &atomic_hdr, sizeof(atomic_hdr));
+
+    atomic_hdr.address = (uintptr_t)region() + 1;
+    expect_rejected(UCT_TCP_AM_ID_ATOMIC, &atomic_hdr, sizeof(atomic_hdr));
+
+    check_region_unmodified();
+}
+
+/* Operations within the region are executed */
+UCS_TEST_P(test_uct_tcp, rma_in_region) {
+    uint64_t data = 0xdeadbeef;
+    ucs_status_t status;
+
+    register_region();
+    do {
+        status = uct_ep_put_short(m_sender->ep(0), &data, sizeof(data),
+                                  (uintptr_t)(region() + REGION_WORDS - 1),
+                                  m_region_rkey.rkey);
+        progress();
+    } while (status == UCS_ERR_NO_RESOURCE);
+    ASSERT_UCS_OK(status);
+
+    wait_for_value(&m_region_buf[GUARD_WORDS + REGION_WORDS - 1], data, true);
+    EXPECT_EQ(data, region()[REGION_WORDS - 1]);
+}
+
+/* Parts of a striped message are written only within its payload */
+UCS_TEST_P(test_uct_tcp, striped_part_valid) {
+    std::vector<uint8_t> header(8, 0x11), payload(64, 0x11);
+
+    std::fill(payload.begin() + 32, payload.end(), 0x22);
+    test_striped_part(32, 32, true);
+    check_am(&header[0], header.size(), &payload[0], payload.size());
+}
+
+UCS_TEST_P(test_uct_tcp, striped_part_outside_payload) {
+    test_striped_part(UCS_MBYTE, 32, false);
+}
+
+UCS_TEST_P(test_uct_tcp, striped_part_exceeds_payload) {
+    test_striped_part(48, 32, false);
+}
+
+UCS_TEST_P(test_uct_tcp, striped_part_exceeds_remaining) {
+    test_striped_part(0, 64, false);
+}
+
+UCS_TEST_P(test_uct_tcp, striped_invalid_header) {
+    int fds[2];
+
+    raw_connect_striped(fds);
+    {
+        scoped_log_handler slh(hide_errors_logger);
+        /* Header longer than the message. The additional socket is closed
+         * with the main one. */
+        raw_send_striped(fds[0], 100, 8 + 64, 32);
+        wait_for_close(fds[0]);
+        wait_for_close(fds[1]);
+    }
+    close(fds[0]);
+    close(fds[1]);
+
+    raw_connect_striped(fds);
+    {
+        scoped_log_handler slh(hide_errors_logger);
+        /* First part larger than the payload */
+        raw_send_striped(fds[0], 8, 8 + 16, 32);
+        wait_for_close(fds[0]);
+    }
+    close(fds[0]);
+    close(fds[1]);
+
+    EXPECT_TRUE(m_am_data.empty());
+}
+
+/* Destroying an endpoint while a striped message is sent closes all its
+ * sockets, and the receiver releases the endpoints of all of them */
+UCS_TEST_P(test_uct_tcp, ep_destroy_striped, "NUM_SOCKETS=4",
+           "STRIPE_THRESH=16k", "MAX_ZCOPY=4m") {
+    uct_tcp_iface_t *iface = ucs_derived_of(m_receiver->iface(),
+                                            uct_tcp_iface_t);
+    const size_t length    = 4 * UCS_MBYTE;
+    mapped_buffer sendbuf(length, 0, *m_sender);
+    uct_iov_t iov;
+    ucs_status_t status;
+
+    iov.buffer = sendbuf.ptr();
+    iov.length = length;
+    iov.memh   = sendbuf.memh();
+    iov.stride = 0;
+    iov.count  = 1;
+
+    m_comp.count = 2;
+    m_comp.func  = NULL;
+    do {
+        status = uct_ep_am_zcopy(m_sender->ep(0), AM_ID, NULL, 0, &iov, 1, 0,
+                                 &m_comp);
+        progress();
+    } while (status == UCS_ERR_NO_RESOURCE);
+    ASSERT_UCS_OK_OR_INPROGRESS(status);
+
+    /* Let the receiver accept the connection and get part of the message */
+    ucs_time_t deadline = ucs_get_time() +
+                          ucs_time_from_sec(DEFAULT_TIMEOUT_SEC) *
+                          ucs::test_time_multiplier();
+    while (ucs_list_is_empty(&iface->ep_list) && (ucs_get_time() < deadline)) {
+        progress();
+    }
+    ASSERT_FALSE(ucs_list_is_empty(&iface->ep_list));
+
+    m_sender->destroy_ep(0);
+
+    while (!ucs_list_is_empty(&iface->ep_list) &&
+           (ucs_get_time() < deadline)) {
+        progress();
+    }
+    EXPECT_TRUE(ucs_list_is_empty(&iface->ep_list));
+}
+
+/* A reply which does not match a request is rejected */
+UCS_TEST_P(test_uct_tcp, unexpected_reply) {
+    uint64_t value = 0;
+
+    expect_rejected(UCT_TCP_AM_ID_REPLY, &value, sizeof(value));
+    expect_rejected(UCT_TCP_AM_ID_FLUSH, &value, sizeof(value));
+    send_am_bcopy(100);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_tcp, tcp)
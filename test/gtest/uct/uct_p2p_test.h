@@ -79,4 +79,37 @@ private:
 };
 
 
+/**
+ * Test fixture which applies a list of "NAME=VALUE" iface configuration
+ * modifications, terminated by NULL. The tests are skipped on transports which
+ * do not have one of the modified parameters.
+ */
+template <typename T>
+class uct_iface_config_test : public T {
+public:
+    uct_iface_config_test(const char *const *config) : m_config_applied(true) {
+        for (; *config != NULL; ++config) {
+            std::string config_str(*config);
+            std::string::size_type pos = config_str.find("=");
+            ucs_status_t status;
+
+            status = uct_config_modify(this->m_iface_config,
+                                       config_str.substr(0, pos).c_str(),
+                                       config_str.substr(pos + 1).c_str());
+            m_config_applied = m_config_applied && (status == UCS_OK);
+        }
+    }
+
+    virtual void init() {
+        if (!m_config_applied) {
+            UCS_TEST_SKIP_R("Test does not apply to the current transport");
+        }
+        T::init();
+    }
+
+private:
+    bool m_config_applied;
+};
+
+
 #endif
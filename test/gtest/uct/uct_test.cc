@@ -390,6 +390,12 @@ uct_test::entity::entity(const resource& resource, uct_iface_config_t *iface_con
     params->stats_root = ucs_stats_get_root();
     UCS_CPU_ZERO(&params->cpu_mask);
 
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&m_progress_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+
     UCS_TEST_CREATE_HANDLE(uct_worker_h, m_worker, uct_worker_destroy,
                            uct_worker_create, &m_async.m_async, UCS_THREAD_MODE_SINGLE);
 
@@ -517,9 +523,36 @@ void uct_test::entity::mem_free(const uct_allocated_memory_t *mem,
     }
 }
 
-unsigned uct_test::entity::progress() const {
-    unsigned count = uct_worker_progress(m_worker);
+uct_test::entity::~entity() {
+    for (std::set<entity*>::iterator iter = m_peers.begin();
+         iter != m_peers.end(); ++iter) {
+        (*iter)->m_peers.erase(this);
+    }
+    pthread_mutex_destroy(&m_progress_lock);
+}
+
+unsigned uct_test::entity::progress_worker() const {
+    unsigned count;
+
+    /* The worker may be progressed by the threads of the peers */
+    pthread_mutex_lock(&m_progress_lock);
+    count = uct_worker_progress(m_worker);
     m_async.check_miss();
+    pthread_mutex_unlock(&m_progress_lock);
+    return count;
+}
+
+unsigned uct_test::entity::progress() const {
+    unsigned count = progress_worker();
+
+    /* Remote operations complete only while the target is progressed, so
+     * waiting for them on the initiator side progresses the peers too */
+    if (iface_attr().cap.flags & UCT_IFACE_FLAG_TARGET_PROGRESS) {
+        for (std::set<entity*>::const_iterator iter = m_peers.begin();
+             iter != m_peers.end(); ++iter) {
+            count += (*iter)->progress_worker();
+        }
+    }
     return count;
 }
 
@@ -756,6 +789,11 @@ void uct_test::entity::connect(unsigned index, entity& other,
                                unsigned other_index,
                                ucs_sock_addr_t *remote_addr)
 {
+    if (&other != this) {
+        m_peers.insert(&other);
+        other.m_peers.insert(this);
+    }
+
     if (iface_attr().cap.flags & UCT_IFACE_FLAG_CONNECT_TO_EP) {
         connect_to_ep(index, other, other_index);
     } else if (iface_attr().cap.flags & UCT_IFACE_FLAG_CONNECT_TO_IFACE) {
@@ -14,6 +14,7 @@
 #include <ucs/sys/sys.h>
 #include <ucs/async/async.h>
 #include <common/test.h>
+#include <set>
 #include <vector>
 #if HAVE_CUDA
 #include <cuda.h>
@@ -69,6 +70,8 @@ protected:
         entity(const resource& resource, uct_iface_config_t *iface_config,
                uct_iface_params_t *params, uct_md_config_t *md_config);
 
+        ~entity();
+
         void mem_alloc(size_t length, uct_allocated_memory_t *mem,
                        uct_rkey_bundle *rkey_bundle, int mem_type) const;
 
@@ -128,6 +131,8 @@ protected:
 
         void reserve_ep(unsigned index);
 
+        unsigned progress_worker() const;
+
         void connect_p2p_ep(uct_ep_h from, uct_ep_h to);
         void cuda_mem_alloc(size_t length, uct_allocated_memory_t *mem) const;
         void cuda_mem_free(const uct_allocated_memory_t *mem) const;
@@ -142,6 +147,8 @@ protected:
         eps_vec_t                  m_eps;
         uct_iface_attr_t           m_iface_attr;
         uct_iface_params_t         m_iface_params;
+        std::set<entity*>          m_peers;
+        mutable pthread_mutex_t    m_progress_lock;
     };
 
     class mapped_buffer {